@@ -36,6 +36,12 @@ macro (SetCompilerOptions)
 		add_definitions(-DCC_USE_NAVMESH=0)
 	endif()
 
+    # definitions for the action pools, they allocate their pages from the allocator
+	if (USE_ACTION_POOL)
+		add_definitions(-DCC_ENABLE_ALLOCATOR=1)
+		add_definitions(-DCC_ENABLE_ACTION_POOL=1)
+	endif()
+
 	# Compiler options
 	if(MSVC)
 	  add_definitions(-D_CRT_SECURE_NO_WARNINGS -D_SCL_SECURE_NO_WARNINGS
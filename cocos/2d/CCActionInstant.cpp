@@ -29,6 +29,10 @@
 #include "2d/CCNode.h"
 #include "2d/CCSprite.h"
 
+#if CC_ENABLE_ACTION_POOL
+#include "base/allocator/CCAllocatorStrategyPool.h"
+#endif
+
 #if defined(__GNUC__) && ((__GNUC__ >= 4) || ((__GNUC__ == 3) && (__GNUC_MINOR__ >= 1)))
 #pragma GCC diagnostic ignored "-Wdeprecated-declarations"
 #elif _MSC_VER >= 1400 //vs 2005 or higher
@@ -37,6 +41,13 @@
 #endif
 
 NS_CC_BEGIN
+
+// the pools of the common actions, see CC_ENABLE_ACTION_POOL
+CC_ACTION_POOL_IMPL(Show)
+CC_ACTION_POOL_IMPL(Hide)
+CC_ACTION_POOL_IMPL(RemoveSelf)
+CC_ACTION_POOL_IMPL(CallFunc)
+CC_ACTION_POOL_IMPL(CallFuncN)
 //
 // InstantAction
 //
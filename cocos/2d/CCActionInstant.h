@@ -30,6 +30,7 @@ THE SOFTWARE.
 
 #include <functional>
 #include "2d/CCAction.h"
+#include "2d/CCActionPool.h"
 
 NS_CC_BEGIN
 
@@ -103,6 +104,7 @@ CC_CONSTRUCTOR_ACCESS:
 
 private:
     CC_DISALLOW_COPY_AND_ASSIGN(Show);
+    CC_ACTION_POOL_DECL(Show)
 };
 
 /** @class Hide
@@ -133,6 +135,7 @@ CC_CONSTRUCTOR_ACCESS:
 
 private:
     CC_DISALLOW_COPY_AND_ASSIGN(Hide);
+    CC_ACTION_POOL_DECL(Hide)
 };
 
 /** @class ToggleVisibility
@@ -200,6 +203,7 @@ protected:
 
 private:
     CC_DISALLOW_COPY_AND_ASSIGN(RemoveSelf);
+    CC_ACTION_POOL_DECL(RemoveSelf)
 };
 
 /** @class FlipX
@@ -415,6 +419,7 @@ protected:
 
 private:
     CC_DISALLOW_COPY_AND_ASSIGN(CallFunc);
+    CC_ACTION_POOL_DECL(CallFunc)
 };
 
 /** @class CallFuncN
@@ -465,6 +470,7 @@ protected:
 
 private:
     CC_DISALLOW_COPY_AND_ASSIGN(CallFuncN);
+    CC_ACTION_POOL_DECL(CallFuncN)
 };
 
 /** @class __CCCallFuncND
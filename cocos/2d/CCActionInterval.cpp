@@ -39,8 +39,30 @@ THE SOFTWARE.
 #include "platform/CCStdC.h"
 #include "base/CCScriptSupport.h"
 
+#if CC_ENABLE_ACTION_POOL
+#include "base/allocator/CCAllocatorStrategyPool.h"
+#endif
+
 NS_CC_BEGIN
 
+// the pools of the common actions, see CC_ENABLE_ACTION_POOL
+CC_ACTION_POOL_IMPL(Sequence)
+CC_ACTION_POOL_IMPL(Repeat)
+CC_ACTION_POOL_IMPL(RepeatForever)
+CC_ACTION_POOL_IMPL(Spawn)
+CC_ACTION_POOL_IMPL(RotateTo)
+CC_ACTION_POOL_IMPL(RotateBy)
+CC_ACTION_POOL_IMPL(MoveBy)
+CC_ACTION_POOL_IMPL(MoveTo)
+CC_ACTION_POOL_IMPL(ScaleTo)
+CC_ACTION_POOL_IMPL(ScaleBy)
+CC_ACTION_POOL_IMPL(FadeTo)
+CC_ACTION_POOL_IMPL(FadeIn)
+CC_ACTION_POOL_IMPL(FadeOut)
+CC_ACTION_POOL_IMPL(TintTo)
+CC_ACTION_POOL_IMPL(TintBy)
+CC_ACTION_POOL_IMPL(DelayTime)
+
 // Extra action for making a Sequence or Spawn when only adding one action to it.
 class ExtraAction : public FiniteTimeAction
 {
@@ -32,6 +32,7 @@ THE SOFTWARE.
 
 #include "2d/CCAction.h"
 #include "2d/CCAnimation.h"
+#include "2d/CCActionPool.h"
 #include "base/CCProtocols.h"
 #include "base/CCVector.h"
 
@@ -119,6 +120,9 @@ protected:
     
 protected:
     bool sendUpdateEventToScript(float dt, Action *actionObject);
+
+    // steps the common actions without virtual calls
+    friend class ActionManager;
 };
 
 /** @class Sequence
@@ -205,6 +209,7 @@ protected:
 
 private:
     CC_DISALLOW_COPY_AND_ASSIGN(Sequence);
+    CC_ACTION_POOL_DECL(Sequence)
 };
 
 /** @class Repeat
@@ -275,6 +280,7 @@ protected:
 
 private:
     CC_DISALLOW_COPY_AND_ASSIGN(Repeat);
+    CC_ACTION_POOL_DECL(Repeat)
 };
 
 /** @class RepeatForever
@@ -342,6 +348,7 @@ protected:
 
 private:
     CC_DISALLOW_COPY_AND_ASSIGN(RepeatForever);
+    CC_ACTION_POOL_DECL(RepeatForever)
 };
 
 /** @class Spawn
@@ -430,6 +437,7 @@ protected:
 
 private:
     CC_DISALLOW_COPY_AND_ASSIGN(Spawn);
+    CC_ACTION_POOL_DECL(Spawn)
 };
 
 /** @class RotateTo
@@ -508,6 +516,7 @@ protected:
 
 private:
     CC_DISALLOW_COPY_AND_ASSIGN(RotateTo);
+    CC_ACTION_POOL_DECL(RotateTo)
 };
 
 /** @class RotateBy
@@ -574,6 +583,7 @@ protected:
 
 private:
     CC_DISALLOW_COPY_AND_ASSIGN(RotateBy);
+    CC_ACTION_POOL_DECL(RotateBy)
 };
 
 /** @class MoveBy
@@ -630,6 +640,7 @@ protected:
 
 private:
     CC_DISALLOW_COPY_AND_ASSIGN(MoveBy);
+    CC_ACTION_POOL_DECL(MoveBy)
 };
 
 /** @class MoveTo
@@ -683,6 +694,7 @@ protected:
 
 private:
     CC_DISALLOW_COPY_AND_ASSIGN(MoveTo);
+    CC_ACTION_POOL_DECL(MoveTo)
 };
 
 /** @class SkewTo
@@ -1125,6 +1137,7 @@ protected:
 
 private:
     CC_DISALLOW_COPY_AND_ASSIGN(ScaleTo);
+    CC_ACTION_POOL_DECL(ScaleTo)
 };
 
 /** @class ScaleBy
@@ -1174,6 +1187,7 @@ CC_CONSTRUCTOR_ACCESS:
 
 private:
     CC_DISALLOW_COPY_AND_ASSIGN(ScaleBy);
+    CC_ACTION_POOL_DECL(ScaleBy)
 };
 
 /** @class Blink
@@ -1264,6 +1278,7 @@ protected:
     friend class FadeIn;
 private:
     CC_DISALLOW_COPY_AND_ASSIGN(FadeTo);
+    CC_ACTION_POOL_DECL(FadeTo)
 };
 
 /** @class FadeIn
@@ -1299,6 +1314,7 @@ CC_CONSTRUCTOR_ACCESS:
 private:
     CC_DISALLOW_COPY_AND_ASSIGN(FadeIn);
     FadeTo* _reverseAction;
+    CC_ACTION_POOL_DECL(FadeIn)
 };
 
 /** @class FadeOut
@@ -1332,6 +1348,7 @@ CC_CONSTRUCTOR_ACCESS:
 private:
     CC_DISALLOW_COPY_AND_ASSIGN(FadeOut);
     FadeTo* _reverseAction;
+    CC_ACTION_POOL_DECL(FadeOut)
 };
 
 /** @class TintTo
@@ -1383,6 +1400,7 @@ protected:
 
 private:
     CC_DISALLOW_COPY_AND_ASSIGN(TintTo);
+    CC_ACTION_POOL_DECL(TintTo)
 };
 
 /** @class TintBy
@@ -1431,6 +1449,7 @@ protected:
 
 private:
     CC_DISALLOW_COPY_AND_ASSIGN(TintBy);
+    CC_ACTION_POOL_DECL(TintBy)
 };
 
 /** @class DelayTime
@@ -1462,6 +1481,7 @@ CC_CONSTRUCTOR_ACCESS:
 
 private:
     CC_DISALLOW_COPY_AND_ASSIGN(DelayTime);
+    CC_ACTION_POOL_DECL(DelayTime)
 };
 
 /** @class ReverseTime
@@ -27,20 +27,55 @@ THE SOFTWARE.
 ****************************************************************************/
 
 #include "2d/CCActionManager.h"
+
+#include <typeinfo>
+#include <vector>
+
 #include "2d/CCNode.h"
 #include "2d/CCAction.h"
+#include "2d/CCActionInterval.h"
+#include "2d/CCActionEase.h"
+#include "2d/CCTweenFunction.h"
 #include "base/CCScheduler.h"
 #include "base/ccMacros.h"
-#include "base/ccCArray.h"
 #include "base/uthash.h"
 
 NS_CC_BEGIN
+
+// the update of the interval actions stepped by the ActionManager
+enum class ActionUpdate : unsigned char
+{
+    NONE,
+    MOVE_BY,
+    SCALE_TO,
+    ROTATE_TO,
+    ROTATE_BY,
+    FADE_TO,
+    TINT_TO,
+    TINT_BY,
+};
+
+typedef float (*EaseFunction)(float time);
+typedef float (*EaseParamFunction)(float time, float param);
+
+struct _actionSlot
+{
+    Action              *action;
+    // when update isn't NONE, the action is stepped by the ActionManager:
+    // the update of the action, or of the inner action of its ease
+    ActionInterval      *updated;
+    ActionUpdate        update;
+    EaseFunction        ease;
+    EaseParamFunction   easeWithRate;
+    EaseParamFunction   easeWithPeriod;
+};
+
 //
 // singleton stuff
 //
 typedef struct _hashElement
 {
-    struct _ccArray     *actions;
+    std::vector<_actionSlot> actions;
     Node                *target;
     int                 actionIndex;
     Action              *currentAction;
@@ -49,10 +84,130 @@ typedef struct _hashElement
     UT_hash_handle      hh;
 } tHashElement;
 
+static ActionUpdate getActionUpdate(const Action *action)
+{
+    // only the exact types, a subclass may override update()
+    static const struct { const std::type_info *type; ActionUpdate update; } updates[] = {
+        { &typeid(MoveBy), ActionUpdate::MOVE_BY },
+        { &typeid(MoveTo), ActionUpdate::MOVE_BY },
+        { &typeid(ScaleTo), ActionUpdate::SCALE_TO },
+        { &typeid(ScaleBy), ActionUpdate::SCALE_TO },
+        { &typeid(RotateTo), ActionUpdate::ROTATE_TO },
+        { &typeid(RotateBy), ActionUpdate::ROTATE_BY },
+        { &typeid(FadeTo), ActionUpdate::FADE_TO },
+        { &typeid(FadeIn), ActionUpdate::FADE_TO },
+        { &typeid(FadeOut), ActionUpdate::FADE_TO },
+        { &typeid(TintTo), ActionUpdate::TINT_TO },
+        { &typeid(TintBy), ActionUpdate::TINT_BY },
+    };
+
+    const std::type_info& type = typeid(*action);
+    for (const auto& entry : updates)
+    {
+        if (*entry.type == type)
+            return entry.update;
+    }
+    return ActionUpdate::NONE;
+}
+
+static void initActionSlot(_actionSlot *slot, Action *action)
+{
+    memset(slot, 0, sizeof(*slot));
+    slot->action = action;
+
+    slot->update = getActionUpdate(action);
+    if (slot->update != ActionUpdate::NONE)
+    {
+        slot->updated = static_cast<ActionInterval*>(action);
+        return;
+    }
+
+    // an ease is stepped when its inner action is
+
+    // the eases of CCActionEase.cpp, whose update() is the tween function of the inner action's update()
+    static const struct { const std::type_info *type; EaseFunction function; } eases[] = {
+        { &typeid(EaseExponentialIn), tweenfunc::expoEaseIn },
+        { &typeid(EaseExponentialOut), tweenfunc::expoEaseOut },
+        { &typeid(EaseExponentialInOut), tweenfunc::expoEaseInOut },
+        { &typeid(EaseSineIn), tweenfunc::sineEaseIn },
+        { &typeid(EaseSineOut), tweenfunc::sineEaseOut },
+        { &typeid(EaseSineInOut), tweenfunc::sineEaseInOut },
+        { &typeid(EaseBounceIn), tweenfunc::bounceEaseIn },
+        { &typeid(EaseBounceOut), tweenfunc::bounceEaseOut },
+        { &typeid(EaseBounceInOut), tweenfunc::bounceEaseInOut },
+        { &typeid(EaseBackIn), tweenfunc::backEaseIn },
+        { &typeid(EaseBackOut), tweenfunc::backEaseOut },
+        { &typeid(EaseBackInOut), tweenfunc::backEaseInOut },
+        { &typeid(EaseQuadraticActionIn), tweenfunc::quadraticIn },
+        { &typeid(EaseQuadraticActionOut), tweenfunc::quadraticOut },
+        { &typeid(EaseQuadraticActionInOut), tweenfunc::quadraticInOut },
+        { &typeid(EaseQuarticActionIn), tweenfunc::quartEaseIn },
+        { &typeid(EaseQuarticActionOut), tweenfunc::quartEaseOut },
+        { &typeid(EaseQuarticActionInOut), tweenfunc::quartEaseInOut },
+        { &typeid(EaseQuinticActionIn), tweenfunc::quintEaseIn },
+        { &typeid(EaseQuinticActionOut), tweenfunc::quintEaseOut },
+        { &typeid(EaseQuinticActionInOut), tweenfunc::quintEaseInOut },
+        { &typeid(EaseCircleActionIn), tweenfunc::circEaseIn },
+        { &typeid(EaseCircleActionOut), tweenfunc::circEaseOut },
+        { &typeid(EaseCircleActionInOut), tweenfunc::circEaseInOut },
+        { &typeid(EaseCubicActionIn), tweenfunc::cubicEaseIn },
+        { &typeid(EaseCubicActionOut), tweenfunc::cubicEaseOut },
+        { &typeid(EaseCubicActionInOut), tweenfunc::cubicEaseInOut },
+    };
+    static const struct { const std::type_info *type; EaseParamFunction function; } rateEases[] = {
+        { &typeid(EaseIn), tweenfunc::easeIn },
+        { &typeid(EaseOut), tweenfunc::easeOut },
+        { &typeid(EaseInOut), tweenfunc::easeInOut },
+    };
+    static const struct { const std::type_info *type; EaseParamFunction function; } periodEases[] = {
+        { &typeid(EaseElasticIn), tweenfunc::elasticEaseIn },
+        { &typeid(EaseElasticOut), tweenfunc::elasticEaseOut },
+        { &typeid(EaseElasticInOut), tweenfunc::elasticEaseInOut },
+    };
+
+    EaseFunction ease = nullptr;
+    EaseParamFunction easeWithRate = nullptr;
+    EaseParamFunction easeWithPeriod = nullptr;
+
+    const std::type_info& type = typeid(*action);
+    for (const auto& entry : eases)
+    {
+        if (*entry.type == type)
+            ease = entry.function;
+    }
+    for (const auto& entry : rateEases)
+    {
+        if (*entry.type == type)
+            easeWithRate = entry.function;
+    }
+    for (const auto& entry : periodEases)
+    {
+        if (*entry.type == type)
+            easeWithPeriod = entry.function;
+    }
+
+    if (ease || easeWithRate || easeWithPeriod)
+    {
+        ActionInterval *inner = static_cast<ActionEase*>(action)->getInnerAction();
+        if (inner)
+        {
+            slot->update = getActionUpdate(inner);
+            if (slot->update != ActionUpdate::NONE)
+            {
+                slot->updated = inner;
+                slot->ease = ease;
+                slot->easeWithRate = easeWithRate;
+                slot->easeWithPeriod = easeWithPeriod;
+            }
+        }
+    }
+}
+
 ActionManager::ActionManager()
 : _targets(nullptr),
   _currentTarget(nullptr),
-  _currentTargetSalvaged(false)
+  _currentTargetSalvaged(false),
+  _specializedSteppingEnabled(true)
 {
 
 }
@@ -68,29 +223,27 @@ ActionManager::~ActionManager()
 
 void ActionManager::deleteHashElement(tHashElement *element)
 {
-    ccArrayFree(element->actions);
+    for (auto& slot : element->actions)
+    {
+        slot.action->release();
+    }
     HASH_DEL(_targets, element);
     element->target->release();
-    free(element);
+    delete element;
 }
 
 void ActionManager::actionAllocWithHashElement(tHashElement *element)
 {
     // 4 actions per Node by default
-    if (element->actions == nullptr)
+    if (element->actions.capacity() == 0)
     {
-        element->actions = ccArrayNew(4);
-    }else 
-    if (element->actions->num == element->actions->max)
-    {
-        ccArrayDoubleCapacity(element->actions);
+        element->actions.reserve(4);
     }
-
 }
 
 void ActionManager::removeActionAtIndex(ssize_t index, tHashElement *element)
 {
-    Action *action = static_cast<Action*>(element->actions->arr[index]);
+    Action *action = element->actions[index].action;
 
     if (action == element->currentAction && (! element->currentActionSalvaged))
     {
@@ -98,7 +251,8 @@ void ActionManager::removeActionAtIndex(ssize_t index, tHashElement *element)
         element->currentActionSalvaged = true;
     }
 
-    ccArrayRemoveObjectAtIndex(element->actions, index, true);
+    element->actions.erase(element->actions.begin() + index);
+    action->release();
 
     // update actionIndex in case we are in tick. looping over the actions
     if (element->actionIndex >= index)
@@ -106,7 +260,7 @@ void ActionManager::removeActionAtIndex(ssize_t index, tHashElement *element)
         element->actionIndex--;
     }
 
-    if (element->actions->num == 0)
+    if (element->actions.empty())
     {
         if (_currentTarget == element)
         {
@@ -119,6 +273,76 @@ void ActionManager::removeActionAtIndex(ssize_t index, tHashElement *element)
     }
 }
 
+ssize_t ActionManager::getIndexOfAction(const tHashElement *element, const Action *action)
+{
+    for (size_t i = 0, count = element->actions.size(); i < count; ++i)
+    {
+        if (element->actions[i].action == action)
+        {
+            return i;
+        }
+    }
+    return CC_INVALID_INDEX;
+}
+
+bool ActionManager::stepSpecialized(const _actionSlot& slot, float dt)
+{
+    // ActionInterval::step() with the update of the inner action called directly
+    ActionInterval *interval = static_cast<ActionInterval*>(slot.action);
+    if (interval->_firstTick)
+    {
+        interval->_firstTick = false;
+        interval->_elapsed = 0;
+    }
+    else
+    {
+        interval->_elapsed += dt;
+    }
+
+    float time = MAX (0,                                  // needed for rewind. elapsed could be negative
+                      MIN(1, interval->_elapsed / interval->getDuration())
+                      );
+
+    if (interval->sendUpdateEventToScript(time, interval)) return interval->_done;
+
+    if (slot.ease)
+        time = slot.ease(time);
+    else if (slot.easeWithRate)
+        time = slot.easeWithRate(time, static_cast<EaseRateAction*>(interval)->getRate());
+    else if (slot.easeWithPeriod)
+        time = slot.easeWithPeriod(time, static_cast<EaseElastic*>(interval)->getPeriod());
+
+    switch (slot.update)
+    {
+        case ActionUpdate::MOVE_BY:
+            static_cast<MoveBy*>(slot.updated)->MoveBy::update(time);
+            break;
+        case ActionUpdate::SCALE_TO:
+            static_cast<ScaleTo*>(slot.updated)->ScaleTo::update(time);
+            break;
+        case ActionUpdate::ROTATE_TO:
+            static_cast<RotateTo*>(slot.updated)->RotateTo::update(time);
+            break;
+        case ActionUpdate::ROTATE_BY:
+            static_cast<RotateBy*>(slot.updated)->RotateBy::update(time);
+            break;
+        case ActionUpdate::FADE_TO:
+            static_cast<FadeTo*>(slot.updated)->FadeTo::update(time);
+            break;
+        case ActionUpdate::TINT_TO:
+            static_cast<TintTo*>(slot.updated)->TintTo::update(time);
+            break;
+        case ActionUpdate::TINT_BY:
+            static_cast<TintBy*>(slot.updated)->TintBy::update(time);
+            break;
+        default:
+            break;
+    }
+
+    interval->_done = interval->_elapsed >= interval->getDuration();
+    return interval->_done;
+}
+
 // pause / resume
 
 void ActionManager::pauseTarget(Node *target)
@@ -180,7 +404,7 @@ void ActionManager::addAction(Action *action, Node *target, bool paused)
     HASH_FIND_PTR(_targets, &tmp, element);
     if (! element)
     {
-        element = (tHashElement*)calloc(sizeof(*element), 1);
+        element = new (std::nothrow) tHashElement();
         element->paused = paused;
         target->retain();
         element->target = target;
@@ -189,8 +413,11 @@ void ActionManager::addAction(Action *action, Node *target, bool paused)
 
      actionAllocWithHashElement(element);
  
-     CCASSERT(! ccArrayContainsObject(element->actions, action), "action already be added!");
-     ccArrayAppendObject(element->actions, action);
+     CCASSERT(getIndexOfAction(element, action) == CC_INVALID_INDEX, "action already be added!");
+     _actionSlot slot;
+     initActionSlot(&slot, action);
+     element->actions.push_back(slot);
+     action->retain();
  
      action->startWithTarget(target);
 }
@@ -219,13 +446,20 @@ void ActionManager::removeAllActionsFromTarget(Node *target)
     HASH_FIND_PTR(_targets, &target, element);
     if (element)
     {
-        if (ccArrayContainsObject(element->actions, element->currentAction) && (! element->currentActionSalvaged))
+        if (getIndexOfAction(element, element->currentAction) != CC_INVALID_INDEX && (! element->currentActionSalvaged))
         {
             element->currentAction->retain();
             element->currentActionSalvaged = true;
         }
 
-        ccArrayRemoveAllObjects(element->actions);
+        // release them after clearing the slots, in case an action destructor runs actions
+        std::vector<_actionSlot> actions;
+        actions.swap(element->actions);
+        for (auto& slot : actions)
+        {
+            slot.action->release();
+        }
+
         if (_currentTarget == element)
         {
             _currentTargetSalvaged = true;
@@ -250,7 +484,7 @@ void ActionManager::removeAction(Action *action)
     HASH_FIND_PTR(_targets, &target, element);
     if (element)
     {
-        auto i = ccArrayGetIndexOfObject(element->actions, action);
+        auto i = getIndexOfAction(element, action);
         if (i != CC_INVALID_INDEX)
         {
             removeActionAtIndex(i, element);
@@ -272,10 +506,10 @@ void ActionManager::removeActionByTag(int tag, Node *target)
 
     if (element)
     {
-        auto limit = element->actions->num;
+        auto limit = (int)element->actions.size();
         for (int i = 0; i < limit; ++i)
         {
-            Action *action = static_cast<Action*>(element->actions->arr[i]);
+            Action *action = element->actions[i].action;
 
             if (action->getTag() == (int)tag && action->getOriginalTarget() == target)
             {
@@ -300,10 +534,10 @@ void ActionManager::removeAllActionsByTag(int tag, Node *target)
     
     if (element)
     {
-        auto limit = element->actions->num;
+        auto limit = (int)element->actions.size();
         for (int i = 0; i < limit;)
         {
-            Action *action = static_cast<Action*>(element->actions->arr[i]);
+            Action *action = element->actions[i].action;
 
             if (action->getTag() == (int)tag && action->getOriginalTarget() == target)
             {
@@ -335,10 +569,10 @@ void ActionManager::removeActionsByFlags(unsigned int flags, Node *target)
 
     if (element)
     {
-        auto limit = element->actions->num;
+        auto limit = (int)element->actions.size();
         for (int i = 0; i < limit;)
         {
-            Action *action = static_cast<Action*>(element->actions->arr[i]);
+            Action *action = element->actions[i].action;
 
             if ((action->getFlags() & flags) != 0 && action->getOriginalTarget() == target)
             {
@@ -366,17 +600,11 @@ Action* ActionManager::getActionByTag(int tag, const Node *target) const
 
     if (element)
     {
-        if (element->actions != nullptr)
+        for (const auto& slot : element->actions)
         {
-            auto limit = element->actions->num;
-            for (int i = 0; i < limit; ++i)
+            if (slot.action->getTag() == (int)tag)
             {
-                Action *action = static_cast<Action*>(element->actions->arr[i]);
-
-                if (action->getTag() == (int)tag)
-                {
-                    return action;
-                }
+                return slot.action;
             }
         }
     }
@@ -392,7 +620,7 @@ ssize_t ActionManager::getNumberOfRunningActionsInTarget(const Node *target) con
     HASH_FIND_PTR(_targets, &target, element);
     if (element)
     {
-        return element->actions ? element->actions->num : 0;
+        return element->actions.size();
     }
 
     return 0;
@@ -408,15 +636,13 @@ size_t ActionManager::getNumberOfRunningActionsInTargetByTag(const Node *target,
     tHashElement *element = nullptr;
     HASH_FIND_PTR(_targets, &target, element);
 
-    if(!element || !element->actions)
+    if(!element)
         return 0;
 
     int count = 0;
-    auto limit = element->actions->num;
-    for(int i = 0; i < limit; ++i)
+    for (const auto& slot : element->actions)
     {
-        auto action = static_cast<Action*>(element->actions->arr[i]);
-        if(action->getTag() == tag)
+        if(slot.action->getTag() == tag)
             ++count;
     }
 
@@ -427,6 +653,8 @@ size_t ActionManager::getNumberOfRunningActionsInTargetByTag(const Node *target,
 // main loop
 void ActionManager::update(float dt)
 {
+    const bool specialized = _specializedSteppingEnabled;
+
     for (tHashElement *elt = _targets; elt != nullptr; )
     {
         _currentTarget = elt;
@@ -434,19 +662,25 @@ void ActionManager::update(float dt)
 
         if (! _currentTarget->paused)
         {
-            // The 'actions' MutableArray may change while inside this loop.
-            for (_currentTarget->actionIndex = 0; _currentTarget->actionIndex < _currentTarget->actions->num;
+            // The actions may change while inside this loop.
+            for (_currentTarget->actionIndex = 0; _currentTarget->actionIndex < (int)_currentTarget->actions.size();
                 _currentTarget->actionIndex++)
             {
-                _currentTarget->currentAction = static_cast<Action*>(_currentTarget->actions->arr[_currentTarget->actionIndex]);
-                if (_currentTarget->currentAction == nullptr)
-                {
-                    continue;
-                }
-
+                // a copy, the slots may be reallocated by the actions added during the step
+                const _actionSlot slot = _currentTarget->actions[_currentTarget->actionIndex];
+                _currentTarget->currentAction = slot.action;
                 _currentTarget->currentActionSalvaged = false;
 
-                _currentTarget->currentAction->step(dt);
+                const bool stepped = specialized && slot.update != ActionUpdate::NONE;
+                bool done = false;
+                if (stepped)
+                {
+                    done = stepSpecialized(slot, dt);
+                }
+                else
+                {
+                    slot.action->step(dt);
+                }
 
                 if (_currentTarget->currentActionSalvaged)
                 {
@@ -455,7 +689,7 @@ void ActionManager::update(float dt)
                     // it. Now that step is done, it's safe to release it.
                     _currentTarget->currentAction->release();
                 } else
-                if (_currentTarget->currentAction->isDone())
+                if (stepped ? done : _currentTarget->currentAction->isDone())
                 {
                     _currentTarget->currentAction->stop();
 
@@ -474,7 +708,7 @@ void ActionManager::update(float dt)
         elt = (tHashElement*)(elt->hh.next);
 
         // only delete currentTarget if no actions were scheduled during the cycle (issue #481)
-        if (_currentTargetSalvaged && _currentTarget->actions->num == 0)
+        if (_currentTargetSalvaged && _currentTarget->actions.empty())
         {
             deleteHashElement(_currentTarget);
         }
@@ -38,6 +38,7 @@ NS_CC_BEGIN
 class Action;
 
 struct _hashElement;
+struct _actionSlot;
 
 /**
  * @addtogroup actions
@@ -191,6 +192,22 @@ public:
      * @param dt    In seconds.
      */
     virtual void update(float dt);
+
+    /** Sets whether the common interval actions are stepped by the ActionManager itself.
+     * MoveBy, MoveTo, ScaleTo, ScaleBy, RotateTo, RotateBy, FadeTo, FadeIn, FadeOut, TintTo and TintBy,
+     * run directly or wrapped in one of the tween eases, are then updated without the virtual calls
+     * of step(), the ease and update(). Their subclasses and the other actions are stepped as before.
+     * It is enabled by default.
+     *
+     * @param enabled   Whether the actions are stepped by the ActionManager.
+     * @since v3.16
+     */
+    void setSpecializedSteppingEnabled(bool enabled) { _specializedSteppingEnabled = enabled; }
+
+    /** Whether the common interval actions are stepped by the ActionManager itself.
+     * @since v3.16
+     */
+    bool isSpecializedSteppingEnabled() const { return _specializedSteppingEnabled; }
     
 protected:
     // declared in ActionManager.m
@@ -198,11 +215,14 @@ protected:
     void removeActionAtIndex(ssize_t index, struct _hashElement *element);
     void deleteHashElement(struct _hashElement *element);
     void actionAllocWithHashElement(struct _hashElement *element);
+    static ssize_t getIndexOfAction(const struct _hashElement *element, const Action *action);
+    static bool stepSpecialized(const struct _actionSlot& slot, float dt);
 
 protected:
     struct _hashElement    *_targets;
     struct _hashElement    *_currentTarget;
     bool            _currentTargetSalvaged;
+    bool            _specializedSteppingEnabled;
 };
 
 // end of actions group
@@ -0,0 +1,97 @@
+/****************************************************************************
+Copyright (c) 2017 Chukong Technologies Inc.
+
+http://www.cocos2d-x.org
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+****************************************************************************/
+
+#ifndef __ACTION_CCACTION_POOL_H__
+#define __ACTION_CCACTION_POOL_H__
+
+#include "base/ccConfig.h"
+
+#if CC_ENABLE_ACTION_POOL
+
+#if !CC_ENABLE_ALLOCATOR
+#error "CC_ENABLE_ACTION_POOL requires CC_ENABLE_ALLOCATOR, the pools allocate their pages from the global allocator"
+#endif
+
+#include <new>
+
+/// @cond DO_NOT_SHOW
+
+/** The pool of the memory of an Action subclass.
+ * The objects are constructed and destroyed by new and delete, the pool only recycles their memory.
+ * Objects of another size, the subclasses without a pool of their own, are allocated by the global allocator.
+ * The pool is locked, the actions may be created and released on any thread.
+ */
+#define CC_ACTION_POOL_TYPE(CLASSNAME) \
+    NS_CC_ALLOCATOR::AllocatorStrategyPool<CLASSNAME, NS_CC_ALLOCATOR::MemoryObjectTraits<CLASSNAME>, NS_CC_ALLOCATOR::locking_semantics>
+
+/** Declares the operators new and delete of an Action subclass, recycling its memory in a pool.
+ * Put it at the end of the class declaration, and CC_ACTION_POOL_IMPL in the implementation file.
+ */
+#define CC_ACTION_POOL_DECL(CLASSNAME) \
+public: \
+    static void* operator new(size_t size); \
+    static void* operator new(size_t size, const std::nothrow_t&); \
+    static void operator delete(void* address, size_t size); \
+    static void operator delete(void* address, const std::nothrow_t&);
+
+/** Defines the pool of an Action subclass and its operators new and delete.
+ * The implementation file includes "base/allocator/CCAllocatorStrategyPool.h".
+ * The pool is created by the first allocation, its page size is read from the
+ * "cocos2d.x.action_pool.CLASSNAME" key of the Configuration, 100 by default.
+ * It is never deleted, as the actions may be released after the static destructors.
+ */
+#define CC_ACTION_POOL_IMPL(CLASSNAME) \
+static CC_ACTION_POOL_TYPE(CLASSNAME)& get##CLASSNAME##Pool() \
+{ \
+    static auto pool = new CC_ACTION_POOL_TYPE(CLASSNAME)("cocos2d.x.action_pool." #CLASSNAME); \
+    return *pool; \
+} \
+void* CLASSNAME::operator new(size_t size) \
+{ \
+    return get##CLASSNAME##Pool().allocate(size); \
+} \
+void* CLASSNAME::operator new(size_t size, const std::nothrow_t&) \
+{ \
+    return get##CLASSNAME##Pool().allocate(size); \
+} \
+void CLASSNAME::operator delete(void* address, size_t size) \
+{ \
+    get##CLASSNAME##Pool().deallocate(address, size); \
+} \
+void CLASSNAME::operator delete(void* address, const std::nothrow_t&) \
+{ \
+    auto& pool = get##CLASSNAME##Pool(); \
+    pool.deallocate(address, pool.owns(address) ? sizeof(CLASSNAME) : 0); \
+}
+
+/// @endcond
+
+#else
+
+#define CC_ACTION_POOL_DECL(CLASSNAME)
+#define CC_ACTION_POOL_IMPL(CLASSNAME)
+
+#endif // CC_ENABLE_ACTION_POOL
+
+#endif // __ACTION_CCACTION_POOL_H__
@@ -148,9 +148,11 @@ void FontAtlas::purgeTexturesAtlas()
     if (_fontFreeType)
     {
         reset();
+        static const auto purgeEventID = EventListener::internListenerID(CMD_PURGE_FONTATLAS);
+        static const auto resetEventID = EventListener::internListenerID(CMD_RESET_FONTATLAS);
         auto eventDispatcher = Director::getInstance()->getEventDispatcher();
-        eventDispatcher->dispatchCustomEvent(CMD_PURGE_FONTATLAS,this);
-        eventDispatcher->dispatchCustomEvent(CMD_RESET_FONTATLAS,this);
+        eventDispatcher->dispatchCustomEvent(purgeEventID,this);
+        eventDispatcher->dispatchCustomEvent(resetEventID,this);
     }
 }
 
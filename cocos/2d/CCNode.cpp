@@ -29,6 +29,7 @@ THE SOFTWARE.
 #include "2d/CCNode.h"
 
 #include <algorithm>
+#include <cstring>
 #include <string>
 #include <regex>
 
@@ -36,6 +37,7 @@ THE SOFTWARE.
 #include "base/CCScheduler.h"
 #include "base/CCEventDispatcher.h"
 #include "base/ccUTF8.h"
+#include "base/CCWorkerPool.h"
 #include "2d/CCCamera.h"
 #include "2d/CCActionManager.h"
 #include "2d/CCScene.h"
@@ -43,6 +45,7 @@ THE SOFTWARE.
 #include "renderer/CCGLProgram.h"
 #include "renderer/CCGLProgramState.h"
 #include "renderer/CCMaterial.h"
+#include "renderer/CCRenderer.h"
 #include "math/TransformUtils.h"
 
 
@@ -85,6 +88,9 @@ Node::Node()
 , _localZOrderAndArrival(0)
 , _localZOrder(0)
 , _globalZOrder(0)
+, _transformHierarchy(nullptr)
+, _transformHierarchyRoot(nullptr)
+, _transformHierarchyIndex(-1)
 , _parent(nullptr)
 // "whole screen" objects. like Scenes and Layers, should set _ignoreAnchorPointForPosition to true
 , _tag(Node::INVALID_TAG)
@@ -98,7 +104,10 @@ Node::Node()
 , _visible(true)
 , _ignoreAnchorPointForPosition(false)
 , _reorderChildDirty(false)
+, _siblingOrderDirty(false)
 , _isTransitionFinished(false)
+, _parallelVisitEnabled(false)
+, _touchBoundsIndexed(false)
 #if CC_ENABLE_SCRIPT_BINDING
 , _updateScriptHandler(0)
 #endif
@@ -166,7 +175,9 @@ Node::~Node()
     for (auto& child : _children)
     {
         child->_parent = nullptr;
+        child->leaveTransformHierarchy();
     }
+    CC_SAFE_DELETE(_transformHierarchy);
 
     removeAllComponents();
     
@@ -260,10 +271,13 @@ void Node::setLocalZOrder(int z)
     _setLocalZOrder(z);
     if (_parent)
     {
+        // also sets the node dirty for the event dispatcher
         _parent->reorderChild(this, z);
     }
-
-    _eventDispatcher->setDirtyForNode(this);
+    else
+    {
+        _eventDispatcher->setDirtyForNode(this);
+    }
 }
 
 /// zOrder setter : private method
@@ -1105,9 +1119,11 @@ void Node::removeAllChildrenWithCleanup(bool cleanup)
 #endif // CC_ENABLE_GC_FOR_NATIVE_OBJECTS
         // set parent nil at the end
         child->setParent(nullptr);
+        child->leaveTransformHierarchy();
     }
     
     _children.clear();
+    setTransformHierarchyStructureDirty();
 }
 
 void Node::detachChild(Node *child, ssize_t childIndex, bool doCleanup)
@@ -1137,8 +1153,10 @@ void Node::detachChild(Node *child, ssize_t childIndex, bool doCleanup)
 #endif // CC_ENABLE_GC_FOR_NATIVE_OBJECTS
     // set parent nil at the end
     child->setParent(nullptr);
+    child->leaveTransformHierarchy();
 
     _children.erase(childIndex);
+    setTransformHierarchyStructureDirty();
 }
 
 
@@ -1156,6 +1174,8 @@ void Node::insertChild(Node* child, int z)
     _reorderChildDirty = true;
     _children.pushBack(child);
     child->_setLocalZOrder(z);
+    child->_siblingOrderDirty = true;
+    setTransformHierarchyStructureDirty();
 }
 
 void Node::reorderChild(Node *child, int zOrder)
@@ -1164,15 +1184,84 @@ void Node::reorderChild(Node *child, int zOrder)
     _reorderChildDirty = true;
     child->updateOrderOfArrival();
     child->_setLocalZOrder(zOrder);
+    child->_siblingOrderDirty = true;
+    // the draw order of the child and its descendants changed
+    _eventDispatcher->setDirtyForNode(child);
 }
 
 void Node::sortAllChildren()
 {
     if (_reorderChildDirty)
     {
-        sortNodes(_children);
+        sortChildrenIncrementally();
         _reorderChildDirty = false;
-        _eventDispatcher->setDirtyForNode(this);
+    }
+}
+
+void Node::sortChildrenIncrementally()
+{
+    struct SortEntry
+    {
+        std::int64_t key;
+        ssize_t index;
+        Node* node;
+    };
+    // the index breaks ties, which keeps the order of sortNodes(): stable on 32 bits, by arrival on 64 bits
+    auto compare = [](const SortEntry& e1, const SortEntry& e2) {
+        return e1.key < e2.key || (e1.key == e2.key && e1.index < e2.index);
+    };
+
+    // children are sorted while visiting, which may happen on the worker pool, see setParallelVisitEnabled()
+    static thread_local std::vector<SortEntry> s_unchanged;
+    static thread_local std::vector<SortEntry> s_changed;
+    s_unchanged.clear();
+    s_changed.clear();
+
+    // split the children, the ones not reordered since the last sort are still in order
+    bool unchangedInOrder = true;
+    const ssize_t count = _children.size();
+    for (ssize_t i = 0; i < count; ++i)
+    {
+        auto child = _children.at(i);
+#if CC_64BITS
+        SortEntry entry = { child->_localZOrderAndArrival, i, child };
+#else
+        SortEntry entry = { child->_localZOrder, i, child };
+#endif
+        if (child->_siblingOrderDirty)
+        {
+            child->_siblingOrderDirty = false;
+            s_changed.push_back(entry);
+        }
+        else
+        {
+            // _setLocalZOrder() or updateOrderOfArrival() were used directly
+            if (!s_unchanged.empty() && compare(entry, s_unchanged.back()))
+                unchangedInOrder = false;
+            s_unchanged.push_back(entry);
+        }
+    }
+
+    if (s_changed.empty() && unchangedInOrder)
+        return;
+
+    // with many changes merging is not cheaper than a full sort
+    if (!unchangedInOrder || s_changed.size() * 4 > static_cast<size_t>(count))
+    {
+        sortNodes(_children);
+        return;
+    }
+
+    std::sort(s_changed.begin(), s_changed.end(), compare);
+
+    auto unchanged = s_unchanged.begin();
+    auto changed = s_changed.begin();
+    for (auto iter = _children.begin(); iter != _children.end(); ++iter)
+    {
+        if (changed == s_changed.end() || (unchanged != s_unchanged.end() && !compare(*changed, *unchanged)))
+            *iter = (unchanged++)->node;
+        else
+            *iter = (changed++)->node;
     }
 }
 
@@ -1195,24 +1284,30 @@ void Node::visit()
     visit(renderer, parentTransform, true);
 }
 
-uint32_t Node::processParentFlags(const Mat4& parentTransform, uint32_t parentFlags)
+void Node::updateNormalizedPosition(uint32_t parentFlags)
 {
-    if(_usingNormalizedPosition)
+    CCASSERT(_parent, "setPositionNormalized() doesn't work with orphan nodes");
+    if ((parentFlags & FLAGS_CONTENT_SIZE_DIRTY) || _normalizedPositionDirty)
     {
-        CCASSERT(_parent, "setPositionNormalized() doesn't work with orphan nodes");
-        if ((parentFlags & FLAGS_CONTENT_SIZE_DIRTY) || _normalizedPositionDirty)
-        {
-            auto& s = _parent->getContentSize();
-            _position.x = _normalizedPosition.x * s.width;
-            _position.y = _normalizedPosition.y * s.height;
-            _transformUpdated = _transformDirty = _inverseDirty = true;
-            _normalizedPositionDirty = false;
-        }
+        auto& s = _parent->getContentSize();
+        _position.x = _normalizedPosition.x * s.width;
+        _position.y = _normalizedPosition.y * s.height;
+        _transformUpdated = _transformDirty = _inverseDirty = true;
+        _normalizedPositionDirty = false;
     }
+}
+
+uint32_t Node::processParentFlags(const Mat4& parentTransform, uint32_t parentFlags)
+{
+    if(_usingNormalizedPosition)
+        updateNormalizedPosition(parentFlags);
 
     // Fixes Github issue #16100. Basically when having two cameras, one camera might set as dirty the
     // node that is not visited by it, and might affect certain calculations. Besides, it is faster to do this.
-    if (!isVisitableByVisitingCamera())
+    // The root of a transform hierarchy is still updated, without clearing its flags, since the descendants
+    // visited by the camera copy their transforms from it.
+    const bool visitable = isVisitableByVisitingCamera();
+    if (!visitable && !_transformHierarchy)
         return parentFlags;
 
     uint32_t flags = parentFlags;
@@ -1221,7 +1316,21 @@ uint32_t Node::processParentFlags(const Mat4& parentTransform, uint32_t parentFl
     
 
     if(flags & FLAGS_DIRTY_MASK)
-        _modelViewTransform = this->transform(parentTransform);
+    {
+        if (_transformHierarchyRoot && isCachedTransformValid(parentTransform, flags))
+            _modelViewTransform = _transformHierarchyRoot->_transformHierarchy->modelViewTransforms[_transformHierarchyIndex];
+        else
+            _modelViewTransform = this->transform(parentTransform);
+    }
+
+    if (_transformHierarchy)
+        updateTransformHierarchy(flags);
+
+    if (!visitable)
+        return parentFlags;
+
+    if (_touchBoundsIndexed && (flags & FLAGS_DIRTY_MASK))
+        _eventDispatcher->setTouchBoundsDirtyForNode(this);
     
     _transformUpdated = false;
     _contentSizeDirty = false;
@@ -1229,6 +1338,148 @@ uint32_t Node::processParentFlags(const Mat4& parentTransform, uint32_t parentFl
     return flags;
 }
 
+void Node::setTransformHierarchyEnabled(bool enabled)
+{
+    if (enabled == (_transformHierarchy != nullptr))
+        return;
+
+    if (enabled)
+    {
+        _transformHierarchy = new (std::nothrow) TransformHierarchy();
+        // lay out the arrays on the next update
+        _transformHierarchy->structureDirty = true;
+    }
+    else
+    {
+        for (const auto& child : _children)
+            child->leaveTransformHierarchy();
+        CC_SAFE_DELETE(_transformHierarchy);
+    }
+
+    // an enclosing hierarchy has to skip or take back the subtree
+    if (_parent)
+        _parent->setTransformHierarchyStructureDirty();
+}
+
+void Node::updateTransformHierarchy(uint32_t flags)
+{
+    if (_transformHierarchy->structureDirty)
+    {
+        buildTransformHierarchy();
+        // every cached transform has to be computed
+        flags |= FLAGS_TRANSFORM_DIRTY;
+    }
+
+    auto& hierarchy = *_transformHierarchy;
+    const size_t count = hierarchy.nodes.size();
+    Node** nodes = hierarchy.nodes.data();
+    const int* parents = hierarchy.parents.data();
+    uint32_t* nodeFlags = hierarchy.flags.data();
+    Mat4* modelViewTransforms = hierarchy.modelViewTransforms.data();
+
+    // parents come first, so a single pass computes the same flags and transforms as processParentFlags() would
+    for (size_t i = 0; i < count; ++i)
+    {
+        auto node = nodes[i];
+        const int parent = parents[i];
+        const uint32_t parentFlags = parent < 0 ? flags : nodeFlags[parent];
+
+        if (node->_usingNormalizedPosition)
+            node->updateNormalizedPosition(parentFlags);
+
+        uint32_t dirtyFlags = parentFlags;
+        dirtyFlags |= (node->_transformUpdated ? FLAGS_TRANSFORM_DIRTY : 0);
+        dirtyFlags |= (node->_contentSizeDirty ? FLAGS_CONTENT_SIZE_DIRTY : 0);
+        nodeFlags[i] = dirtyFlags;
+
+        if (dirtyFlags & FLAGS_DIRTY_MASK)
+        {
+            const Mat4& parentTransform = parent < 0 ? _modelViewTransform : modelViewTransforms[parent];
+            Mat4::multiply(parentTransform, node->getNodeToParentTransform(), &modelViewTransforms[i]);
+        }
+    }
+}
+
+void Node::buildTransformHierarchy()
+{
+    auto& hierarchy = *_transformHierarchy;
+    hierarchy.nodes.clear();
+    hierarchy.parents.clear();
+
+    // depth-first, the subtrees of nodes managing their own hierarchy are skipped
+    std::vector<std::pair<Node*, int>> stack;
+    for (auto it = _children.crbegin(); it != _children.crend(); ++it)
+        stack.push_back(std::make_pair(*it, -1));
+
+    while (!stack.empty())
+    {
+        auto node = stack.back().first;
+        const int parent = stack.back().second;
+        stack.pop_back();
+
+        const int index = (int)hierarchy.nodes.size();
+        node->_transformHierarchyRoot = this;
+        node->_transformHierarchyIndex = index;
+        hierarchy.nodes.push_back(node);
+        hierarchy.parents.push_back(parent);
+
+        if (node->_transformHierarchy)
+            continue;
+        for (auto it = node->_children.crbegin(); it != node->_children.crend(); ++it)
+            stack.push_back(std::make_pair(*it, index));
+    }
+
+    hierarchy.flags.resize(hierarchy.nodes.size());
+    hierarchy.modelViewTransforms.resize(hierarchy.nodes.size());
+    hierarchy.structureDirty = false;
+}
+
+void Node::setTransformHierarchyStructureDirty()
+{
+    // the children of this node are in its own hierarchy, or in the one of the nearest ancestor managing one
+    Node* node = this;
+    while (node && node->_transformHierarchy == nullptr)
+    {
+        if (node->_transformHierarchyRoot)
+        {
+            node = node->_transformHierarchyRoot;
+            break;
+        }
+        node = node->_parent;
+    }
+
+    if (node)
+        node->_transformHierarchy->structureDirty = true;
+}
+
+bool Node::isCachedTransformValid(const Mat4& parentTransform, uint32_t flags) const
+{
+    const auto& hierarchy = *_transformHierarchyRoot->_transformHierarchy;
+
+    // the node was moved after the hierarchy was updated in this visit, e.g. by the visit of an ancestor
+    if (_transformDirty || (flags & ~hierarchy.flags[_transformHierarchyIndex] & FLAGS_DIRTY_MASK))
+        return false;
+
+    // or its parent was, the cached transform was computed from another parent transform then
+    const int parent = hierarchy.parents[_transformHierarchyIndex];
+    const Mat4& cachedParentTransform = parent < 0 ? _transformHierarchyRoot->_modelViewTransform : hierarchy.modelViewTransforms[parent];
+    return memcmp(cachedParentTransform.m, parentTransform.m, sizeof(parentTransform.m)) == 0;
+}
+
+void Node::leaveTransformHierarchy()
+{
+    if (_transformHierarchyRoot == nullptr)
+        return;
+
+    _transformHierarchyRoot = nullptr;
+    _transformHierarchyIndex = -1;
+    // the descendants of a node managing its own hierarchy stay in it
+    if (_transformHierarchy)
+        return;
+    for (const auto& child : _children)
+        child->leaveTransformHierarchy();
+}
+
 bool Node::isVisitableByVisitingCamera() const
 {
     auto camera = Camera::getVisitingCamera();
@@ -1256,7 +1507,19 @@ void Node::visit(Renderer* renderer, const Mat4 &parentTransform, uint32_t paren
 
     int i = 0;
 
-    if(!_children.empty())
+    if(!_children.empty() && _parallelVisitEnabled && !Renderer::isRecordingCommands())
+    {
+        sortAllChildren();
+        // children zOrder < 0
+        for(auto size = _children.size(); i < size && _children.at(i)->_localZOrder < 0; ++i) {}
+
+        visitChildrenInParallel(renderer, 0, i, flags);
+        // self draw
+        if (visibleByCamera)
+            this->draw(renderer, _modelViewTransform, flags);
+        visitChildrenInParallel(renderer, i, _children.size(), flags);
+    }
+    else if(!_children.empty())
     {
         sortAllChildren();
         // draw children zOrder < 0
@@ -1289,6 +1552,33 @@ void Node::visit(Renderer* renderer, const Mat4 &parentTransform, uint32_t paren
     // _orderOfArrival = 0;
 }
 
+void Node::visitChildrenInParallel(Renderer* renderer, ssize_t begin, ssize_t end, uint32_t parentFlags)
+{
+    const int count = (int)(end - begin);
+    if (count <= 0)
+        return;
+
+    // contiguous runs of children, each recorded separately and merged back in order,
+    // so the render queues end up exactly as if the children were visited one after the other
+    auto workerPool = WorkerPool::getInstance();
+    const int chunks = std::min(count, workerPool->getConcurrency() * 4);
+    auto recorders = renderer->getCommandRecorders(chunks);
+
+    workerPool->parallelFor(chunks, [&](int chunk) {
+        renderer->beginRecordingCommands(&recorders[chunk]);
+        for (ssize_t index = begin + (ssize_t)count * chunk / chunks, last = begin + (ssize_t)count * (chunk + 1) / chunks; index < last; ++index)
+        {
+            _children.at(index)->visit(renderer, _modelViewTransform, parentFlags);
+        }
+        renderer->endRecordingCommands();
+    });
+
+    for (int chunk = 0; chunk < chunks; ++chunk)
+    {
+        renderer->mergeRecordedCommands(&recorders[chunk]);
+    }
+}
+
 Mat4 Node::transform(const Mat4& parentTransform)
 {
     return parentTransform * this->getNodeToParentTransform();
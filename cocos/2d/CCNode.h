@@ -1177,6 +1177,55 @@ public:
     virtual void visit(Renderer *renderer, const Mat4& parentTransform, uint32_t parentFlags);
     virtual void visit() final;
 
+    /**
+     * Sets whether the children of this node are visited concurrently, on the WorkerPool.
+     * The render commands of each child are recorded and added to the renderer in the children order,
+     * so the result is the same as visiting them one after the other.
+     * The nodes under a parallel node must only add render commands in their visit() and draw(): they must not
+     * call OpenGL, create or retain/release objects, nor rely on the Director's matrix stacks.
+     * Parallel nodes under a parallel node visit their children serially.
+     *
+     * @param enabled Whether the children are visited in parallel. Default is false.
+     * @since v3.16
+     */
+    void setParallelVisitEnabled(bool enabled) { _parallelVisitEnabled = enabled; }
+    /**
+     * Returns whether the children of this node are visited concurrently.
+     *
+     * @return Whether the children are visited in parallel.
+     * @since v3.16
+     */
+    bool isParallelVisitEnabled() const { return _parallelVisitEnabled; }
+
+    /**
+     * Sets whether the model view transforms of the nodes under this node are cached in contiguous arrays.
+     * The nodes are laid out in depth-first order, so a parent always comes before its children, and
+     * updateTransformHierarchy() recomputes the dirty transforms in a single pass over the arrays instead of
+     * one by one while visiting. The layout is rebuilt when nodes are added to or removed from the subtree.
+     * The nodes under this node must be visited with the model view transform of their parent, as Node::visit() does.
+     * Nodes moved after this node was visited, by the visit of an ancestor for instance, compute their transform as usual.
+     * Nodes under this node that enable it too manage their own subtree.
+     *
+     * @param enabled Whether the transforms of the subtree are cached. Default is false.
+     * @since v3.16
+     */
+    void setTransformHierarchyEnabled(bool enabled);
+    /**
+     * Returns whether the model view transforms of the nodes under this node are cached.
+     *
+     * @return Whether the transforms of the subtree are cached.
+     * @since v3.16
+     */
+    bool isTransformHierarchyEnabled() const { return _transformHierarchy != nullptr; }
+    /**
+     * Recomputes the dirty cached model view transforms of the nodes under this node, see setTransformHierarchyEnabled().
+     * It is called when this node is visited, after its own model view transform was updated.
+     *
+     * @param flags The flags of this node, as returned by processParentFlags().
+     * @since v3.16
+     */
+    void updateTransformHierarchy(uint32_t flags);
+
 
     /** Returns the Scene that contains the Node.
      It returns `nullptr` if the node doesn't belong to any Scene.
@@ -1868,6 +1917,12 @@ protected:
     /// helper that reorder a child
     void insertChild(Node* child, int z);
 
+    /** Sorts _children like sortNodes() does. Only the children added or reordered since the last sort are
+     * moved, by merging them into the others, unless so many of them changed that a full sort is cheaper.
+     * @since v3.16
+     */
+    void sortChildrenIncrementally();
+
     /// Removes a child, call child->onExit(), do cleanup, remove it from children array.
     void detachChild(Node *child, ssize_t index, bool doCleanup);
 
@@ -1877,6 +1932,20 @@ protected:
     Mat4 transform(const Mat4 &parentTransform);
     uint32_t processParentFlags(const Mat4& parentTransform, uint32_t parentFlags);
 
+    /// Updates the position of a node using a normalized position, see setPositionNormalized()
+    void updateNormalizedPosition(uint32_t parentFlags);
+    /// Lays out the nodes of the subtree in the transform hierarchy arrays, see setTransformHierarchyEnabled()
+    void buildTransformHierarchy();
+    /// Whether the transform cached by the hierarchy of this node is still the one computed from parentTransform
+    bool isCachedTransformValid(const Mat4& parentTransform, uint32_t flags) const;
+    /// Detaches this node and its descendants from the transform hierarchy they belong to
+    void leaveTransformHierarchy();
+    /// Lays out again the transform hierarchy the children of this node belong to, if any
+    void setTransformHierarchyStructureDirty();
+
+    /// Visits the children in [begin, end) on the worker pool, see setParallelVisitEnabled()
+    void visitChildrenInParallel(Renderer* renderer, ssize_t begin, ssize_t end, uint32_t parentFlags);
+
     virtual void updateCascadeOpacity();
     virtual void disableCascadeOpacity();
     virtual void updateCascadeColor();
@@ -1945,6 +2014,19 @@ protected:
 
     static unsigned int s_globalOrderOfArrival;
 
+    /// The cached transforms of a subtree, see setTransformHierarchyEnabled()
+    struct TransformHierarchy
+    {
+        bool structureDirty;                 ///< whether nodes were added to or removed from the subtree since the arrays were laid out
+        std::vector<Node*> nodes;            ///< the nodes of the subtree, in depth-first order
+        std::vector<int> parents;            ///< index of the parent of each node, -1 for the children of the root
+        std::vector<uint32_t> flags;         ///< dirty flags of each node during the last update
+        std::vector<Mat4> modelViewTransforms; ///< model view transform of each node
+    };
+    TransformHierarchy* _transformHierarchy;  ///< the cached transforms of the subtree if this node manages one
+    Node* _transformHierarchyRoot;            ///< the node that manages the cached transform of this node, if any
+    int _transformHierarchyIndex;             ///< index of this node in the arrays of _transformHierarchyRoot
+
     Vector<Node*> _children;        ///< array of children nodes
     Node *_parent;                  ///< weak reference to parent node
     Director* _director;            //cached director pointer to improve rendering performance
@@ -1972,7 +2054,10 @@ protected:
                                           ///< Used by Layer and Scene.
 
     bool _reorderChildDirty;          ///< children order dirty flag
+    bool _siblingOrderDirty;          ///< z order changed since the parent last sorted its children
     bool _isTransitionFinished;       ///< flag to indicate whether the transition was finished
+    bool _parallelVisitEnabled;       ///< children are visited on the worker pool
+    bool _touchBoundsIndexed;         ///< the event dispatcher indexes the bounding box of this node for touches
 
 #if CC_ENABLE_SCRIPT_BINDING
     int _scriptHandler;               ///< script handler for onEnter() & onExit(), used in Javascript binding and Lua binding.
@@ -2016,6 +2101,8 @@ public:
     friend class PhysicsBody;
 #endif
 
+    friend class EventDispatcher;
+
 private:
     CC_DISALLOW_COPY_AND_ASSIGN(Node);
 };
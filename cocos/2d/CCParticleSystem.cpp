@@ -46,12 +46,19 @@ THE SOFTWARE.
 
 #include <string>
 
+#if defined(__SSE__)
+#include <xmmintrin.h>
+#elif defined(__aarch64__) || defined(__arm64__)
+#include <arm_neon.h>
+#endif
+
 #include "2d/CCParticleBatchNode.h"
 #include "renderer/CCTextureAtlas.h"
 #include "base/base64.h"
 #include "base/ZipUtils.h"
 #include "base/CCDirector.h"
 #include "base/CCProfiling.h"
+#include "base/CCWorkerPool.h"
 #include "base/ccUTF8.h"
 #include "renderer/CCTextureCache.h"
 #include "platform/CCFileUtils.h"
@@ -64,6 +71,8 @@ using namespace std;
 
 NS_CC_BEGIN
 
+bool ParticleSystem::s_simdUpdateEnabled = true;
+
 // ideas taken from:
 //     . The ocean spray in your face [Jeff Lander]
 //        http://www.double.co.nz/dust/col0798.pdf
@@ -99,17 +108,241 @@ inline void normalize_point(float x, float y, particle_point* out)
     out->y = y * n;
 }
 
-/**
- A more effect random number getter function, get from ejoy2d.
- */
-inline static float RANDOM_M11(unsigned int *seed) {
-    *seed = *seed * 134775813 + 1;
-    union {
-        uint32_t d;                                     
-        float f;
-    } u;
-    u.d = (((uint32_t)(*seed) & 0x7fff) << 8) | 0x40000000;
-    return u.f - 3.0f;
+// Counter based random numbers of the emitted particles.
+// A value only depends on the seed, on the attribute it is used for and on the emission number of the particle,
+// so the particles can be generated attribute by attribute, chunk by chunk, on any thread, and still be reproduced.
+enum ParticleRandomStream : uint32_t
+{
+    RANDOM_LIFE, RANDOM_POS_X, RANDOM_POS_Y,
+    RANDOM_START_R, RANDOM_START_G, RANDOM_START_B, RANDOM_START_A,
+    RANDOM_END_R, RANDOM_END_G, RANDOM_END_B, RANDOM_END_A,
+    RANDOM_START_SIZE, RANDOM_END_SIZE, RANDOM_START_SPIN, RANDOM_END_SPIN,
+    RANDOM_RADIAL_ACCEL, RANDOM_TANGENTIAL_ACCEL, RANDOM_ANGLE, RANDOM_SPEED,
+    RANDOM_START_RADIUS, RANDOM_END_RADIUS, RANDOM_ROTATE_PER_SECOND,
+};
+
+// number of particles generated together, so that the arrays of a chunk stay in the cache
+static const int EMISSION_CHUNK_SIZE = 256;
+
+// values[i] = base + variance * random, with random in [-1, 1).
+// The loop only has integer operations and a conversion, the compiler vectorizes it.
+static void generateRandomValues(float* values, int count, float base, float variance,
+                                 uint32_t seed, uint32_t stream, uint32_t counter)
+{
+    const uint32_t key = seed ^ (stream * 0x85ebca6bu);
+    for (int i = 0; i < count; ++i)
+    {
+        // lowbias32 hash of the counter
+        uint32_t x = (counter + (uint32_t)i) * 0x9e3779b9u + key;
+        x ^= x >> 16;
+        x *= 0x7feb352du;
+        x ^= x >> 15;
+        x *= 0x846ca68bu;
+        x ^= x >> 16;
+        // 24 bits of the hash, exactly converted, scaled to [-1, 1)
+        const float random = (float)(int32_t)(x >> 8) * (1.0f / 8388608.0f) - 1.0f;
+        values[i] = base + variance * random;
+    }
+}
+
+// SIMD update of the particles.
+// The vector kernels perform the same operations as the scalar ones, in the same order, so they compute the
+// same values as long as the compiler doesn't contract the scalar multiplications and additions.
+#if defined(__SSE__)
+#define CC_PARTICLE_SIMD 1
+
+typedef __m128 float4;
+
+static inline float4 load4(const float* p) { return _mm_loadu_ps(p); }
+static inline void store4(float* p, float4 v) { _mm_storeu_ps(p, v); }
+static inline float4 set4(float v) { return _mm_set1_ps(v); }
+static inline float4 add4(float4 a, float4 b) { return _mm_add_ps(a, b); }
+static inline float4 sub4(float4 a, float4 b) { return _mm_sub_ps(a, b); }
+static inline float4 mul4(float4 a, float4 b) { return _mm_mul_ps(a, b); }
+static inline float4 div4(float4 a, float4 b) { return _mm_div_ps(a, b); }
+static inline float4 sqrt4(float4 a) { return _mm_sqrt_ps(a); }
+static inline float4 neg4(float4 a) { return _mm_xor_ps(a, _mm_set1_ps(-0.0f)); }
+// masks, true when the comparison of C++ would be true, including with NaN
+static inline float4 notEqual4(float4 a, float4 b) { return _mm_cmpneq_ps(a, b); }
+static inline float4 notLess4(float4 a, float4 b) { return _mm_cmpnlt_ps(a, b); }
+static inline float4 greater4(float4 a, float4 b) { return _mm_cmpgt_ps(a, b); }
+static inline float4 and4(float4 a, float4 b) { return _mm_and_ps(a, b); }
+static inline float4 or4(float4 a, float4 b) { return _mm_or_ps(a, b); }
+static inline float4 select4(float4 mask, float4 a, float4 b) { return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b)); }
+
+#elif defined(__aarch64__) || defined(__arm64__)
+// ARMv7 NEON has neither IEEE division and square root nor denormals, so it uses the scalar kernels
+#define CC_PARTICLE_SIMD 1
+
+typedef float32x4_t float4;
+
+static inline float4 load4(const float* p) { return vld1q_f32(p); }
+static inline void store4(float* p, float4 v) { vst1q_f32(p, v); }
+static inline float4 set4(float v) { return vdupq_n_f32(v); }
+static inline float4 add4(float4 a, float4 b) { return vaddq_f32(a, b); }
+static inline float4 sub4(float4 a, float4 b) { return vsubq_f32(a, b); }
+static inline float4 mul4(float4 a, float4 b) { return vmulq_f32(a, b); }
+static inline float4 div4(float4 a, float4 b) { return vdivq_f32(a, b); }
+static inline float4 sqrt4(float4 a) { return vsqrtq_f32(a); }
+static inline float4 neg4(float4 a) { return vnegq_f32(a); }
+static inline float4 notEqual4(float4 a, float4 b) { return vreinterpretq_f32_u32(vmvnq_u32(vceqq_f32(a, b))); }
+static inline float4 notLess4(float4 a, float4 b) { return vreinterpretq_f32_u32(vmvnq_u32(vcltq_f32(a, b))); }
+static inline float4 greater4(float4 a, float4 b) { return vreinterpretq_f32_u32(vcgtq_f32(a, b)); }
+static inline float4 and4(float4 a, float4 b) { return vreinterpretq_f32_u32(vandq_u32(vreinterpretq_u32_f32(a), vreinterpretq_u32_f32(b))); }
+static inline float4 or4(float4 a, float4 b) { return vreinterpretq_f32_u32(vorrq_u32(vreinterpretq_u32_f32(a), vreinterpretq_u32_f32(b))); }
+static inline float4 select4(float4 mask, float4 a, float4 b) { return vbslq_f32(vreinterpretq_u32_f32(mask), a, b); }
+
+#else
+#define CC_PARTICLE_SIMD 0
+#endif
+
+// values[i] -= delta
+static void subtractParticleValues(float* values, float delta, int start, int end, bool simd)
+{
+    int i = start;
+#if CC_PARTICLE_SIMD
+    if (simd)
+    {
+        const float4 d = set4(delta);
+        for (; i + 4 <= end; i += 4)
+        {
+            store4(values + i, sub4(load4(values + i), d));
+        }
+    }
+#endif
+    for (; i < end; ++i)
+    {
+        values[i] -= delta;
+    }
+}
+
+// values[i] += deltas[i] * dt, clamped to 0 if clampToZero
+static void addParticleDeltas(float* values, const float* deltas, float dt, int start, int end, bool clampToZero, bool simd)
+{
+    int i = start;
+#if CC_PARTICLE_SIMD
+    if (simd)
+    {
+        const float4 t = set4(dt);
+        const float4 zero = set4(0.0f);
+        for (; i + 4 <= end; i += 4)
+        {
+            float4 v = add4(load4(values + i), mul4(load4(deltas + i), t));
+            if (clampToZero)
+                v = select4(greater4(v, zero), v, zero);
+            store4(values + i, v);
+        }
+    }
+#endif
+    for (; i < end; ++i)
+    {
+        values[i] += deltas[i] * dt;
+        if (clampToZero)
+            values[i] = MAX(0, values[i]);
+    }
+}
+
+// gravity mode: radial and tangential accelerations plus gravity change the direction, which moves the particle
+static void updateGravityModeParticles(ParticleData& data, int start, int end, float dt, const Vec2& gravity, int yCoordFlipped, bool simd)
+{
+    int i = start;
+#if CC_PARTICLE_SIMD
+    if (simd)
+    {
+        const float4 t = set4(dt);
+        const float4 gx = set4(gravity.x);
+        const float4 gy = set4(gravity.y);
+        const float4 flip = set4((float)yCoordFlipped);
+        const float4 zero = set4(0.0f);
+        const float4 one = set4(1.0f);
+        const float4 tolerance = set4(MATH_TOLERANCE);
+        for (; i + 4 <= end; i += 4)
+        {
+            float4 x = load4(data.posx + i);
+            float4 y = load4(data.posy + i);
+
+            // normalize_point() leaves the radial at zero for the origin, the normalized and the too short positions
+            float4 n = add4(mul4(x, x), mul4(y, y));
+            float4 mask = and4(or4(notEqual4(x, zero), notEqual4(y, zero)), notEqual4(n, one));
+            n = sqrt4(n);
+            mask = and4(mask, notLess4(n, tolerance));
+            n = div4(one, n);
+            float4 radialX = and4(mask, mul4(x, n));
+            float4 radialY = and4(mask, mul4(y, n));
+
+            float4 tangentialAccel = load4(data.modeA.tangentialAccel + i);
+            float4 tangentialX = mul4(radialY, neg4(tangentialAccel));
+            float4 tangentialY = mul4(radialX, tangentialAccel);
+
+            float4 radialAccel = load4(data.modeA.radialAccel + i);
+            radialX = mul4(radialX, radialAccel);
+            radialY = mul4(radialY, radialAccel);
+
+            float4 dirX = add4(load4(data.modeA.dirX + i), mul4(add4(add4(radialX, tangentialX), gx), t));
+            float4 dirY = add4(load4(data.modeA.dirY + i), mul4(add4(add4(radialY, tangentialY), gy), t));
+            store4(data.modeA.dirX + i, dirX);
+            store4(data.modeA.dirY + i, dirY);
+
+            store4(data.posx + i, add4(x, mul4(mul4(dirX, t), flip)));
+            store4(data.posy + i, add4(y, mul4(mul4(dirY, t), flip)));
+        }
+    }
+#endif
+    for (; i < end; ++i)
+    {
+        particle_point tmp, radial = {0.0f, 0.0f}, tangential;
+        
+        // radial acceleration
+        if (data.posx[i] || data.posy[i])
+        {
+            normalize_point(data.posx[i], data.posy[i], &radial);
+        }
+        tangential = radial;
+        radial.x *= data.modeA.radialAccel[i];
+        radial.y *= data.modeA.radialAccel[i];
+        
+        // tangential acceleration
+        std::swap(tangential.x, tangential.y);
+        tangential.x *= - data.modeA.tangentialAccel[i];
+        tangential.y *= data.modeA.tangentialAccel[i];
+        
+        // (gravity + radial + tangential) * dt
+        tmp.x = radial.x + tangential.x + gravity.x;
+        tmp.y = radial.y + tangential.y + gravity.y;
+        tmp.x *= dt;
+        tmp.y *= dt;
+        
+        data.modeA.dirX[i] += tmp.x;
+        data.modeA.dirY[i] += tmp.y;
+        
+        // this is cocos2d-x v3.0
+        tmp.x = data.modeA.dirX[i] * dt * yCoordFlipped;
+        tmp.y = data.modeA.dirY[i] * dt * yCoordFlipped;
+        data.posx[i] += tmp.x;
+        data.posy[i] += tmp.y;
+    }
+}
+
+// radius mode: the particles turn around the emitter
+static void updateRadiusModeParticles(ParticleData& data, int start, int end, float dt, int yCoordFlipped, bool simd)
+{
+    //Why use so many for-loop separately instead of putting them together?
+    //When the processor needs to read from or write to a location in memory,
+    //it first checks whether a copy of that data is in the cache.
+    //And every property's memory of the particle system is continuous,
+    //for the purpose of improving cache hit rate, we should process only one property in one for-loop AFAP.
+    //It was proved to be effective especially for low-end machine. 
+    addParticleDeltas(data.modeB.angle, data.modeB.degreesPerSecond, dt, start, end, false, simd);
+    addParticleDeltas(data.modeB.radius, data.modeB.deltaRadius, dt, start, end, false, simd);
+    
+    for (int i = start; i < end; ++i)
+    {
+        data.posx[i] = - cosf(data.modeB.angle[i]) * data.modeB.radius[i];
+    }
+    for (int i = start; i < end; ++i)
+    {
+        data.posy[i] = - sinf(data.modeB.angle[i]) * data.modeB.radius[i] * yCoordFlipped;
+    }
 }
 
 ParticleData::ParticleData()
@@ -224,6 +457,9 @@ ParticleSystem::ParticleSystem()
 , _yCoordFlipped(1)
 , _positionType(PositionType::FREE)
 , _paused(false)
+, _parallelUpdateEnabled(false)
+, _randomSeed(rand())
+, _randomCounter(0)
 {
     modeA.gravity.setZero();
     modeA.speed = 0;
@@ -607,94 +843,9 @@ ParticleSystem::~ParticleSystem()
 
 void ParticleSystem::addParticles(int count)
 {
-    if (_paused)
+    if (_paused || count <= 0)
         return;
-    uint32_t RANDSEED = rand();
 
-    int start = _particleCount;
-    _particleCount += count;
-    
-    //life
-    for (int i = start; i < _particleCount ; ++i)
-    {
-        float theLife = _life + _lifeVar * RANDOM_M11(&RANDSEED);
-        _particleData.timeToLive[i] = MAX(0, theLife);
-    }
-    
-    //position
-    for (int i = start; i < _particleCount; ++i)
-    {
-        _particleData.posx[i] = _sourcePosition.x + _posVar.x * RANDOM_M11(&RANDSEED);
-    }
-    
-    for (int i = start; i < _particleCount; ++i)
-    {
-        _particleData.posy[i] = _sourcePosition.y + _posVar.y * RANDOM_M11(&RANDSEED);
-    }
-    
-    //color
-#define SET_COLOR(c, b, v)\
-for (int i = start; i < _particleCount; ++i)\
-{\
-c[i] = clampf( b + v * RANDOM_M11(&RANDSEED) , 0 , 1 );\
-}
-    
-    SET_COLOR(_particleData.colorR, _startColor.r, _startColorVar.r);
-    SET_COLOR(_particleData.colorG, _startColor.g, _startColorVar.g);
-    SET_COLOR(_particleData.colorB, _startColor.b, _startColorVar.b);
-    SET_COLOR(_particleData.colorA, _startColor.a, _startColorVar.a);
-    
-    SET_COLOR(_particleData.deltaColorR, _endColor.r, _endColorVar.r);
-    SET_COLOR(_particleData.deltaColorG, _endColor.g, _endColorVar.g);
-    SET_COLOR(_particleData.deltaColorB, _endColor.b, _endColorVar.b);
-    SET_COLOR(_particleData.deltaColorA, _endColor.a, _endColorVar.a);
-    
-#define SET_DELTA_COLOR(c, dc)\
-for (int i = start; i < _particleCount; ++i)\
-{\
-dc[i] = (dc[i] - c[i]) / _particleData.timeToLive[i];\
-}
-    
-    SET_DELTA_COLOR(_particleData.colorR, _particleData.deltaColorR);
-    SET_DELTA_COLOR(_particleData.colorG, _particleData.deltaColorG);
-    SET_DELTA_COLOR(_particleData.colorB, _particleData.deltaColorB);
-    SET_DELTA_COLOR(_particleData.colorA, _particleData.deltaColorA);
-    
-    //size
-    for (int i = start; i < _particleCount; ++i)
-    {
-        _particleData.size[i] = _startSize + _startSizeVar * RANDOM_M11(&RANDSEED);
-        _particleData.size[i] = MAX(0, _particleData.size[i]);
-    }
-    
-    if (_endSize != START_SIZE_EQUAL_TO_END_SIZE)
-    {
-        for (int i = start; i < _particleCount; ++i)
-        {
-            float endSize = _endSize + _endSizeVar * RANDOM_M11(&RANDSEED);
-            endSize = MAX(0, endSize);
-            _particleData.deltaSize[i] = (endSize - _particleData.size[i]) / _particleData.timeToLive[i];
-        }
-    }
-    else
-    {
-        for (int i = start; i < _particleCount; ++i)
-        {
-            _particleData.deltaSize[i] = 0.0f;
-        }
-    }
-    
-    // rotation
-    for (int i = start; i < _particleCount; ++i)
-    {
-        _particleData.rotation[i] = _startSpin + _startSpinVar * RANDOM_M11(&RANDSEED);
-    }
-    for (int i = start; i < _particleCount; ++i)
-    {
-        float endA = _endSpin + _endSpinVar * RANDOM_M11(&RANDSEED);
-        _particleData.deltaRotation[i] = (endA - _particleData.rotation[i]) / _particleData.timeToLive[i];
-    }
-    
     // position
     Vec2 pos;
     if (_positionType == PositionType::FREE)
@@ -705,98 +856,187 @@ dc[i] = (dc[i] - c[i]) / _particleData.timeToLive[i];\
     {
         pos = _position;
     }
-    for (int i = start; i < _particleCount; ++i)
-    {
-        _particleData.startPosX[i] = pos.x;
-    }
-    for (int i = start; i < _particleCount; ++i)
-    {
-        _particleData.startPosY[i] = pos.y;
-    }
-    
-    // Mode Gravity: A
-    if (_emitterMode == Mode::GRAVITY)
+
+    const int start = _particleCount;
+    const uint32_t counter = _randomCounter;
+    forEachParticleRange(count, [this, start, counter, &pos](int rangeStart, int rangeEnd) {
+        emitParticles(start + rangeStart, start + rangeEnd, counter + rangeStart, pos);
+    });
+
+    _particleCount += count;
+    _randomCounter += count;
+}
+
+void ParticleSystem::emitParticles(int start, int end, unsigned int counter, const Vec2& position)
+{
+    const uint32_t seed = _randomSeed;
+
+    for (int chunk = start; chunk < end; chunk += EMISSION_CHUNK_SIZE, counter += EMISSION_CHUNK_SIZE)
     {
-        
-        // radial accel
-        for (int i = start; i < _particleCount; ++i)
+        const int n = MIN(EMISSION_CHUNK_SIZE, end - chunk);
+
+        //life
+        float* timeToLive = _particleData.timeToLive + chunk;
+        generateRandomValues(timeToLive, n, _life, _lifeVar, seed, RANDOM_LIFE, counter);
+        for (int i = 0; i < n; ++i)
         {
-            _particleData.modeA.radialAccel[i] = modeA.radialAccel + modeA.radialAccelVar * RANDOM_M11(&RANDSEED);
+            timeToLive[i] = MAX(0, timeToLive[i]);
         }
-        
-        // tangential accel
-        for (int i = start; i < _particleCount; ++i)
+
+        //position
+        generateRandomValues(_particleData.posx + chunk, n, _sourcePosition.x, _posVar.x, seed, RANDOM_POS_X, counter);
+        generateRandomValues(_particleData.posy + chunk, n, _sourcePosition.y, _posVar.y, seed, RANDOM_POS_Y, counter);
+        for (int i = 0; i < n; ++i)
         {
-            _particleData.modeA.tangentialAccel[i] = modeA.tangentialAccel + modeA.tangentialAccelVar * RANDOM_M11(&RANDSEED);
+            _particleData.startPosX[chunk + i] = position.x;
+            _particleData.startPosY[chunk + i] = position.y;
         }
-        
-        // rotation is dir
-        if( modeA.rotationIsDir )
+
+        //color
+        float* colors[] = {
+            _particleData.colorR + chunk, _particleData.colorG + chunk, _particleData.colorB + chunk, _particleData.colorA + chunk,
+        };
+        float* deltaColors[] = {
+            _particleData.deltaColorR + chunk, _particleData.deltaColorG + chunk, _particleData.deltaColorB + chunk, _particleData.deltaColorA + chunk,
+        };
+        const float startColor[] = {_startColor.r, _startColor.g, _startColor.b, _startColor.a};
+        const float startColorVar[] = {_startColorVar.r, _startColorVar.g, _startColorVar.b, _startColorVar.a};
+        const float endColor[] = {_endColor.r, _endColor.g, _endColor.b, _endColor.a};
+        const float endColorVar[] = {_endColorVar.r, _endColorVar.g, _endColorVar.b, _endColorVar.a};
+        for (int c = 0; c < 4; ++c)
         {
-            for (int i = start; i < _particleCount; ++i)
+            float* color = colors[c];
+            float* deltaColor = deltaColors[c];
+            generateRandomValues(color, n, startColor[c], startColorVar[c], seed, RANDOM_START_R + c, counter);
+            generateRandomValues(deltaColor, n, endColor[c], endColorVar[c], seed, RANDOM_END_R + c, counter);
+            for (int i = 0; i < n; ++i)
             {
-                float a = CC_DEGREES_TO_RADIANS( _angle + _angleVar * RANDOM_M11(&RANDSEED) );
-                Vec2 v(cosf( a ), sinf( a ));
-                float s = modeA.speed + modeA.speedVar * RANDOM_M11(&RANDSEED);
-                Vec2 dir = v * s;
-                _particleData.modeA.dirX[i] = dir.x;//v * s ;
-                _particleData.modeA.dirY[i] = dir.y;
-                _particleData.rotation[i] = -CC_RADIANS_TO_DEGREES(dir.getAngle());
+                color[i] = clampf(color[i], 0, 1);
+                deltaColor[i] = (clampf(deltaColor[i], 0, 1) - color[i]) / timeToLive[i];
             }
         }
-        else
+
+        //size
+        float* size = _particleData.size + chunk;
+        float* deltaSize = _particleData.deltaSize + chunk;
+        generateRandomValues(size, n, _startSize, _startSizeVar, seed, RANDOM_START_SIZE, counter);
+        for (int i = 0; i < n; ++i)
+        {
+            size[i] = MAX(0, size[i]);
+        }
+        if (_endSize != START_SIZE_EQUAL_TO_END_SIZE)
         {
-            for (int i = start; i < _particleCount; ++i)
+            generateRandomValues(deltaSize, n, _endSize, _endSizeVar, seed, RANDOM_END_SIZE, counter);
+            for (int i = 0; i < n; ++i)
             {
-                float a = CC_DEGREES_TO_RADIANS( _angle + _angleVar * RANDOM_M11(&RANDSEED) );
-                Vec2 v(cosf( a ), sinf( a ));
-                float s = modeA.speed + modeA.speedVar * RANDOM_M11(&RANDSEED);
-                Vec2 dir = v * s;
-                _particleData.modeA.dirX[i] = dir.x;//v * s ;
-                _particleData.modeA.dirY[i] = dir.y;
+                deltaSize[i] = (MAX(0, deltaSize[i]) - size[i]) / timeToLive[i];
             }
         }
-        
-    }
-    
-    // Mode Radius: B
-    else
-    {
-        //Need to check by Jacky
-        // Set the default diameter of the particle from the source position
-        for (int i = start; i < _particleCount; ++i)
+        else
         {
-            _particleData.modeB.radius[i] = modeB.startRadius + modeB.startRadiusVar * RANDOM_M11(&RANDSEED);
+            std::fill(deltaSize, deltaSize + n, 0.0f);
         }
 
-        for (int i = start; i < _particleCount; ++i)
+        // rotation
+        float* rotation = _particleData.rotation + chunk;
+        float* deltaRotation = _particleData.deltaRotation + chunk;
+        generateRandomValues(rotation, n, _startSpin, _startSpinVar, seed, RANDOM_START_SPIN, counter);
+        generateRandomValues(deltaRotation, n, _endSpin, _endSpinVar, seed, RANDOM_END_SPIN, counter);
+        for (int i = 0; i < n; ++i)
         {
-            _particleData.modeB.angle[i] = CC_DEGREES_TO_RADIANS( _angle + _angleVar * RANDOM_M11(&RANDSEED));
+            deltaRotation[i] = (deltaRotation[i] - rotation[i]) / timeToLive[i];
         }
-        
-        for (int i = start; i < _particleCount; ++i)
-        {
-            _particleData.modeB.degreesPerSecond[i] = CC_DEGREES_TO_RADIANS(modeB.rotatePerSecond + modeB.rotatePerSecondVar * RANDOM_M11(&RANDSEED));
-        }
-        
-        if(modeB.endRadius == START_RADIUS_EQUAL_TO_END_RADIUS)
+
+        // Mode Gravity: A
+        if (_emitterMode == Mode::GRAVITY)
         {
-            for (int i = start; i < _particleCount; ++i)
+            generateRandomValues(_particleData.modeA.radialAccel + chunk, n, modeA.radialAccel, modeA.radialAccelVar, seed, RANDOM_RADIAL_ACCEL, counter);
+            generateRandomValues(_particleData.modeA.tangentialAccel + chunk, n, modeA.tangentialAccel, modeA.tangentialAccelVar, seed, RANDOM_TANGENTIAL_ACCEL, counter);
+
+            // the angle and the speed are generated in the direction arrays
+            float* dirX = _particleData.modeA.dirX + chunk;
+            float* dirY = _particleData.modeA.dirY + chunk;
+            generateRandomValues(dirX, n, _angle, _angleVar, seed, RANDOM_ANGLE, counter);
+            generateRandomValues(dirY, n, modeA.speed, modeA.speedVar, seed, RANDOM_SPEED, counter);
+            for (int i = 0; i < n; ++i)
             {
-                _particleData.modeB.deltaRadius[i] = 0.0f;
+                float a = CC_DEGREES_TO_RADIANS(dirX[i]);
+                float s = dirY[i];
+                dirX[i] = cosf(a) * s;
+                dirY[i] = sinf(a) * s;
+            }
+
+            // rotation is dir
+            if (modeA.rotationIsDir)
+            {
+                for (int i = 0; i < n; ++i)
+                {
+                    rotation[i] = -CC_RADIANS_TO_DEGREES(atan2f(dirY[i], dirX[i]));
+                }
             }
         }
+
+        // Mode Radius: B
         else
         {
-            for (int i = start; i < _particleCount; ++i)
+            // Set the default diameter of the particle from the source position
+            float* radius = _particleData.modeB.radius + chunk;
+            generateRandomValues(radius, n, modeB.startRadius, modeB.startRadiusVar, seed, RANDOM_START_RADIUS, counter);
+
+            float* angle = _particleData.modeB.angle + chunk;
+            float* degreesPerSecond = _particleData.modeB.degreesPerSecond + chunk;
+            generateRandomValues(angle, n, _angle, _angleVar, seed, RANDOM_ANGLE, counter);
+            generateRandomValues(degreesPerSecond, n, modeB.rotatePerSecond, modeB.rotatePerSecondVar, seed, RANDOM_ROTATE_PER_SECOND, counter);
+            for (int i = 0; i < n; ++i)
+            {
+                angle[i] = CC_DEGREES_TO_RADIANS(angle[i]);
+                degreesPerSecond[i] = CC_DEGREES_TO_RADIANS(degreesPerSecond[i]);
+            }
+
+            float* deltaRadius = _particleData.modeB.deltaRadius + chunk;
+            if (modeB.endRadius == START_RADIUS_EQUAL_TO_END_RADIUS)
+            {
+                std::fill(deltaRadius, deltaRadius + n, 0.0f);
+            }
+            else
             {
-                float endRadius = modeB.endRadius + modeB.endRadiusVar * RANDOM_M11(&RANDSEED);
-                _particleData.modeB.deltaRadius[i] = (endRadius - _particleData.modeB.radius[i]) / _particleData.timeToLive[i];
+                generateRandomValues(deltaRadius, n, modeB.endRadius, modeB.endRadiusVar, seed, RANDOM_END_RADIUS, counter);
+                for (int i = 0; i < n; ++i)
+                {
+                    deltaRadius[i] = (deltaRadius[i] - radius[i]) / timeToLive[i];
+                }
             }
         }
     }
 }
 
+void ParticleSystem::prewarm(float duration, float interval)
+{
+    CCASSERT(interval > 0, "The interval of the prewarm should be positive");
+    if (duration <= 0)
+        return;
+
+    const int steps = (int)ceilf(duration / interval);
+    const float dt = duration / steps;
+    for (int i = 0; i < steps; ++i)
+    {
+        stepParticles(dt);
+    }
+
+    updateParticleQuads();
+    _transformSystemDirty = false;
+    if (_visible && ! _batchNode)
+    {
+        postStep();
+    }
+}
+
+void ParticleSystem::setRandomSeed(unsigned int seed)
+{
+    _randomSeed = seed;
+    _randomCounter = 0;
+}
+
 void ParticleSystem::onEnter()
 {
 #if CC_ENABLE_SCRIPT_BINDING
@@ -854,6 +1094,27 @@ void ParticleSystem::update(float dt)
 {
     CC_PROFILER_START_CATEGORY(kProfilerCategoryParticles , "CCParticleSystem - update");
 
+    if (stepParticles(dt) && _isAutoRemoveOnFinish)
+    {
+        this->unscheduleUpdate();
+        _parent->removeChild(this, true);
+        return;
+    }
+
+    updateParticleQuads();
+    _transformSystemDirty = false;
+
+    // only update gl buffer when visible
+    if (_visible && ! _batchNode)
+    {
+        postStep();
+    }
+
+    CC_PROFILER_STOP_CATEGORY(kProfilerCategoryParticles , "CCParticleSystem - update");
+}
+
+bool ParticleSystem::stepParticles(float dt)
+{
     if (_isActive && _emissionRate)
     {
         float rate = 1.0f / _emissionRate;
@@ -877,152 +1138,139 @@ void ParticleSystem::update(float dt)
             this->stopSystem();
         }
     }
-    
+
+    subtractParticleValues(_particleData.timeToLive, dt, 0, _particleCount, s_simdUpdateEnabled);
+
+    const int previousCount = _particleCount;
+    removeDeadParticles();
+
+    forEachParticleRange(_particleCount, [this, dt](int start, int end) {
+        updateParticles(start, end, dt);
+    });
+
+    return previousCount > 0 && _particleCount == 0;
+}
+
+void ParticleSystem::removeDeadParticles()
+{
+    // the living particles are gathered in place, array by array, from the first dead one
+    int first = 0;
+    while (first < _particleCount && !(_particleData.timeToLive[first] <= 0.0f))
     {
-        for (int i = 0; i < _particleCount; ++i)
-        {
-            _particleData.timeToLive[i] -= dt;
-        }
-        
-        for (int i = 0; i < _particleCount; ++i)
-        {
-            if (_particleData.timeToLive[i] <= 0.0f)
-            {
-                int j = _particleCount - 1;
-                while (j > 0 && _particleData.timeToLive[j] <= 0)
-                {
-                    _particleCount--;
-                    j--;
-                }
-                _particleData.copyParticle(i, _particleCount - 1);
-                if (_batchNode)
-                {
-                    //disable the switched particle
-                    int currentIndex = _particleData.atlasIndex[i];
-                    _batchNode->disableParticle(_atlasIndex + currentIndex);
-                    //switch indexes
-                    _particleData.atlasIndex[_particleCount - 1] = currentIndex;
-                }
-                --_particleCount;
-                if( _particleCount == 0 && _isAutoRemoveOnFinish )
-                {
-                    this->unscheduleUpdate();
-                    _parent->removeChild(this, true);
-                    return;
-                }
-            }
-        }
-        
-        if (_emitterMode == Mode::GRAVITY)
-        {
-            for (int i = 0 ; i < _particleCount; ++i)
-            {
-                particle_point tmp, radial = {0.0f, 0.0f}, tangential;
-                
-                // radial acceleration
-                if (_particleData.posx[i] || _particleData.posy[i])
-                {
-                    normalize_point(_particleData.posx[i], _particleData.posy[i], &radial);
-                }
-                tangential = radial;
-                radial.x *= _particleData.modeA.radialAccel[i];
-                radial.y *= _particleData.modeA.radialAccel[i];
-                
-                // tangential acceleration
-                std::swap(tangential.x, tangential.y);
-                tangential.x *= - _particleData.modeA.tangentialAccel[i];
-                tangential.y *= _particleData.modeA.tangentialAccel[i];
-                
-                // (gravity + radial + tangential) * dt
-                tmp.x = radial.x + tangential.x + modeA.gravity.x;
-                tmp.y = radial.y + tangential.y + modeA.gravity.y;
-                tmp.x *= dt;
-                tmp.y *= dt;
-                
-                _particleData.modeA.dirX[i] += tmp.x;
-                _particleData.modeA.dirY[i] += tmp.y;
-                
-                // this is cocos2d-x v3.0
-                // if (_configName.length()>0 && _yCoordFlipped != -1)
-                
-                // this is cocos2d-x v3.0
-                tmp.x = _particleData.modeA.dirX[i] * dt * _yCoordFlipped;
-                tmp.y = _particleData.modeA.dirY[i] * dt * _yCoordFlipped;
-                _particleData.posx[i] += tmp.x;
-                _particleData.posy[i] += tmp.y;
-            }
-        }
-        else
-        {
-            //Why use so many for-loop separately instead of putting them together?
-            //When the processor needs to read from or write to a location in memory,
-            //it first checks whether a copy of that data is in the cache.
-            //And every property's memory of the particle system is continuous,
-            //for the purpose of improving cache hit rate, we should process only one property in one for-loop AFAP.
-            //It was proved to be effective especially for low-end machine. 
-            for (int i = 0; i < _particleCount; ++i)
-            {
-                _particleData.modeB.angle[i] += _particleData.modeB.degreesPerSecond[i] * dt;
-            }
-            
-            for (int i = 0; i < _particleCount; ++i)
-            {
-                _particleData.modeB.radius[i] += _particleData.modeB.deltaRadius[i] * dt;
-            }
-            
-            for (int i = 0; i < _particleCount; ++i)
-            {
-                _particleData.posx[i] = - cosf(_particleData.modeB.angle[i]) * _particleData.modeB.radius[i];
-            }
-            for (int i = 0; i < _particleCount; ++i)
-            {
-                _particleData.posy[i] = - sinf(_particleData.modeB.angle[i]) * _particleData.modeB.radius[i] * _yCoordFlipped;
-            }
-        }
-        
-        //color r,g,b,a
-        for (int i = 0 ; i < _particleCount; ++i)
-        {
-            _particleData.colorR[i] += _particleData.deltaColorR[i] * dt;
-        }
-        
-        for (int i = 0 ; i < _particleCount; ++i)
-        {
-            _particleData.colorG[i] += _particleData.deltaColorG[i] * dt;
-        }
-        
-        for (int i = 0 ; i < _particleCount; ++i)
-        {
-            _particleData.colorB[i] += _particleData.deltaColorB[i] * dt;
-        }
-        
-        for (int i = 0 ; i < _particleCount; ++i)
-        {
-            _particleData.colorA[i] += _particleData.deltaColorA[i] * dt;
-        }
-        //size
-        for (int i = 0 ; i < _particleCount; ++i)
+        ++first;
+    }
+    if (first == _particleCount)
+    {
+        return;
+    }
+
+    static thread_local std::vector<int> livingIndices;
+    static thread_local std::vector<int> deadIndices;
+    livingIndices.resize(_particleCount);
+    deadIndices.resize(_particleCount);
+
+    int livingCount = 0;
+    int deadCount = 0;
+    for (int i = first; i < _particleCount; ++i)
+    {
+        const int living = !(_particleData.timeToLive[i] <= 0.0f);
+        livingIndices[livingCount] = i;
+        deadIndices[deadCount] = i;
+        livingCount += living;
+        deadCount += 1 - living;
+    }
+
+    auto gather = [&](float* values) {
+        for (int j = 0; j < livingCount; ++j)
         {
-            _particleData.size[i] += (_particleData.deltaSize[i] * dt);
-            _particleData.size[i] = MAX(0, _particleData.size[i]);
+            values[first + j] = values[livingIndices[j]];
         }
-        //angle
-        for (int i = 0 ; i < _particleCount; ++i)
+    };
+
+    float* arrays[] = {
+        _particleData.posx, _particleData.posy, _particleData.startPosX, _particleData.startPosY,
+        _particleData.colorR, _particleData.colorG, _particleData.colorB, _particleData.colorA,
+        _particleData.deltaColorR, _particleData.deltaColorG, _particleData.deltaColorB, _particleData.deltaColorA,
+        _particleData.size, _particleData.deltaSize, _particleData.rotation, _particleData.deltaRotation,
+        _particleData.timeToLive,
+        _particleData.modeA.dirX, _particleData.modeA.dirY, _particleData.modeA.radialAccel, _particleData.modeA.tangentialAccel,
+        _particleData.modeB.angle, _particleData.modeB.degreesPerSecond, _particleData.modeB.radius, _particleData.modeB.deltaRadius,
+    };
+    for (auto values : arrays)
+    {
+        gather(values);
+    }
+
+    // the atlas indices of the dead particles go after the living ones, for the next particles
+    unsigned int* atlasIndex = _particleData.atlasIndex;
+    for (int j = 0; j < deadCount; ++j)
+    {
+        unsigned int index = atlasIndex[deadIndices[j]];
+        if (_batchNode)
         {
-            _particleData.rotation[i] += _particleData.deltaRotation[i] * dt;
+            //disable the dead particle
+            _batchNode->disableParticle(_atlasIndex + index);
         }
-        
-        updateParticleQuads();
-        _transformSystemDirty = false;
+        deadIndices[j] = index;
+    }
+    for (int j = 0; j < livingCount; ++j)
+    {
+        atlasIndex[first + j] = atlasIndex[livingIndices[j]];
+    }
+    for (int j = 0; j < deadCount; ++j)
+    {
+        atlasIndex[first + livingCount + j] = deadIndices[j];
     }
 
-    // only update gl buffer when visible
-    if (_visible && ! _batchNode)
+    _particleCount = first + livingCount;
+}
+
+void ParticleSystem::updateParticles(int start, int end, float dt)
+{
+    const bool simd = s_simdUpdateEnabled;
+
+    if (_emitterMode == Mode::GRAVITY)
     {
-        postStep();
+        updateGravityModeParticles(_particleData, start, end, dt, modeA.gravity, _yCoordFlipped, simd);
     }
+    else
+    {
+        updateRadiusModeParticles(_particleData, start, end, dt, _yCoordFlipped, simd);
+    }
+    
+    //color r,g,b,a
+    addParticleDeltas(_particleData.colorR, _particleData.deltaColorR, dt, start, end, false, simd);
+    addParticleDeltas(_particleData.colorG, _particleData.deltaColorG, dt, start, end, false, simd);
+    addParticleDeltas(_particleData.colorB, _particleData.deltaColorB, dt, start, end, false, simd);
+    addParticleDeltas(_particleData.colorA, _particleData.deltaColorA, dt, start, end, false, simd);
+    //size
+    addParticleDeltas(_particleData.size, _particleData.deltaSize, dt, start, end, true, simd);
+    //angle
+    addParticleDeltas(_particleData.rotation, _particleData.deltaRotation, dt, start, end, false, simd);
+}
 
-    CC_PROFILER_STOP_CATEGORY(kProfilerCategoryParticles , "CCParticleSystem - update");
+void ParticleSystem::forEachParticleRange(int count, const std::function<void(int, int)>& func)
+{
+    if (!_parallelUpdateEnabled || count < PARALLEL_UPDATE_MIN_PARTICLES)
+    {
+        func(0, count);
+        return;
+    }
+
+    auto workerPool = WorkerPool::getInstance();
+    // multiples of 16 particles, so the ranges don't share the cache lines of the arrays
+    int rangeSize = (count / workerPool->getConcurrency() + 15) & ~15;
+    rangeSize = std::max(rangeSize, PARALLEL_UPDATE_MIN_PARTICLES / 2);
+    const int rangeCount = (count + rangeSize - 1) / rangeSize;
+    if (rangeCount <= 1)
+    {
+        func(0, count);
+        return;
+    }
+
+    workerPool->parallelFor(rangeCount, [&](int range) {
+        func(range * rangeSize, std::min(count, (range + 1) * rangeSize));
+    });
 }
 
 void ParticleSystem::updateWithNoTime(void)
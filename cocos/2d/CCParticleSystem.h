@@ -252,6 +252,31 @@ public:
     static ParticleSystem* createWithTotalParticles(int numberOfParticles);
     
     void addParticles(int count);
+
+    /** Simulates the system for a duration, as if it had been running, without rendering it.
+     * It is meant to be called at load time so that an effect starts in its steady state.
+     *
+     * @param duration The simulated time, in seconds.
+     * @param interval The time step of the simulation, in seconds.
+     * @since v3.16
+     */
+    void prewarm(float duration, float interval = 1.0f / 30);
+
+    /** Sets the seed of the random values of the emitted particles.
+     * The particles are generated from the seed and their emission number, so two systems with the same
+     * settings and seed emit the same particles. It also restarts the emission numbers.
+     *
+     * @param seed The seed. By default it is taken from rand() when the system is created.
+     * @since v3.16
+     */
+    void setRandomSeed(unsigned int seed);
+
+    /** Gets the seed of the random values of the emitted particles.
+     *
+     * @return The seed.
+     * @since v3.16
+     */
+    unsigned int getRandomSeed() const { return _randomSeed; }
     
     void stopSystem();
     /** Kill all living particles.
@@ -287,6 +312,40 @@ public:
      */
     virtual void setAutoRemoveOnFinish(bool var);
 
+    /** Sets whether the update of the particles is split over the WorkerPool.
+     * Only the systems with at least PARALLEL_UPDATE_MIN_PARTICLES particles are split.
+     * The particles are computed the same way, so the result doesn't depend on it.
+     *
+     * @param enabled Whether the particles are updated in parallel. Default is false.
+     * @since v3.16
+     */
+    void setParallelUpdateEnabled(bool enabled) { _parallelUpdateEnabled = enabled; }
+
+    /** Whether the update of the particles is split over the WorkerPool.
+     *
+     * @return True if the particles are updated in parallel.
+     * @since v3.16
+     */
+    bool isParallelUpdateEnabled() const { return _parallelUpdateEnabled; }
+
+    /** Sets whether the particles of all the systems are updated with SIMD instructions, when the platform has them.
+     * The SIMD and the scalar updates compute the same values, it is mainly useful to check it.
+     *
+     * @param enabled Whether SIMD instructions are used. Default is true.
+     * @since v3.16
+     */
+    static void setSimdUpdateEnabled(bool enabled) { s_simdUpdateEnabled = enabled; }
+
+    /** Whether the particles of all the systems are updated with SIMD instructions, when the platform has them.
+     *
+     * @return True if SIMD instructions are used.
+     * @since v3.16
+     */
+    static bool isSimdUpdateEnabled() { return s_simdUpdateEnabled; }
+
+    /** Minimum number of particles of a system updated in parallel. */
+    static const int PARALLEL_UPDATE_MIN_PARTICLES = 1024;
+
     // mode A
     /** Gets the gravity.
      *
@@ -816,6 +875,27 @@ CC_CONSTRUCTOR_ACCESS:
 protected:
     virtual void updateBlendFunc();
 
+    /** Emits particles, updates the living ones and removes the dead ones, without updating the quads.
+     *
+     * @return True if the last particles died during this step.
+     */
+    bool stepParticles(float dt);
+
+    /** Generates the particles in [start, end), counter being the emission number of the particle at start. */
+    void emitParticles(int start, int end, unsigned int counter, const Vec2& position);
+
+    /** Removes the dead particles, keeping the order of the living ones. */
+    void removeDeadParticles();
+
+    /** Moves the particles in [start, end) and updates their color, size and rotation. */
+    void updateParticles(int start, int end, float dt);
+
+    /** Calls func(start, end) on ranges covering [0, count), concurrently if the parallel update is enabled.
+     * The ranges start on multiples of 4 particles.
+     * It's virtual so that subclasses can see how the particles are split.
+     */
+    virtual void forEachParticleRange(int count, const std::function<void(int, int)>& func);
+
     /** whether or not the particles are using blend additive.
      If enabled, the following blending function will be used.
      @code
@@ -971,6 +1051,16 @@ protected:
     /** is the emitter paused */
     bool _paused;
 
+    /** whether the update is split over the WorkerPool */
+    bool _parallelUpdateEnabled;
+
+    static bool s_simdUpdateEnabled;
+
+    /** seed of the random values of the particles */
+    unsigned int _randomSeed;
+    /** emission number of the next particle */
+    unsigned int _randomCounter;
+
 private:
     CC_DISALLOW_COPY_AND_ASSIGN(ParticleSystem);
 };
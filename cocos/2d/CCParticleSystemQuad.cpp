@@ -328,21 +328,38 @@ void ParticleSystemQuad::updateParticleQuads()
         startQuad = &(_quads[0]);
     }
     
+    // computed once, it may update the cached transforms
+    Mat4 worldToNodeTM;
+    if (_positionType == PositionType::FREE)
+    {
+        worldToNodeTM = getWorldToNodeTransform();
+    }
+
+    // the quads are independent, large systems may build them concurrently
+    forEachParticleRange(_particleCount, [&](int start, int end) {
+        updateParticleQuads(startQuad, currentPosition, pos, worldToNodeTM, start, end);
+    });
+}
+
+void ParticleSystemQuad::updateParticleQuads(V3F_C4B_T2F_Quad* startQuad, const Vec2& currentPosition, const Vec2& pos,
+                                             const Mat4& worldToNodeTM, int start, int end)
+{
+    const int count = end - start;
+
     if( _positionType == PositionType::FREE )
     {
         Vec3 p1(currentPosition.x, currentPosition.y, 0);
-        Mat4 worldToNodeTM = getWorldToNodeTransform();
         worldToNodeTM.transformPoint(&p1);
         Vec3 p2;
         Vec2 newPos;
-        float* startX = _particleData.startPosX;
-        float* startY = _particleData.startPosY;
-        float* x = _particleData.posx;
-        float* y = _particleData.posy;
-        float* s = _particleData.size;
-        float* r = _particleData.rotation;
-        V3F_C4B_T2F_Quad* quadStart = startQuad;
-        for (int i = 0 ; i < _particleCount; ++i, ++startX, ++startY, ++x, ++y, ++quadStart, ++s, ++r)
+        float* startX = _particleData.startPosX + start;
+        float* startY = _particleData.startPosY + start;
+        float* x = _particleData.posx + start;
+        float* y = _particleData.posy + start;
+        float* s = _particleData.size + start;
+        float* r = _particleData.rotation + start;
+        V3F_C4B_T2F_Quad* quadStart = startQuad + start;
+        for (int i = 0 ; i < count; ++i, ++startX, ++startY, ++x, ++y, ++quadStart, ++s, ++r)
         {
             p2.set(*startX, *startY, 0);
             worldToNodeTM.transformPoint(&p2);
@@ -356,14 +373,14 @@ void ParticleSystemQuad::updateParticleQuads()
     else if( _positionType == PositionType::RELATIVE )
     {
         Vec2 newPos;
-        float* startX = _particleData.startPosX;
-        float* startY = _particleData.startPosY;
-        float* x = _particleData.posx;
-        float* y = _particleData.posy;
-        float* s = _particleData.size;
-        float* r = _particleData.rotation;
-        V3F_C4B_T2F_Quad* quadStart = startQuad;
-        for (int i = 0 ; i < _particleCount; ++i, ++startX, ++startY, ++x, ++y, ++quadStart, ++s, ++r)
+        float* startX = _particleData.startPosX + start;
+        float* startY = _particleData.startPosY + start;
+        float* x = _particleData.posx + start;
+        float* y = _particleData.posy + start;
+        float* s = _particleData.size + start;
+        float* r = _particleData.rotation + start;
+        V3F_C4B_T2F_Quad* quadStart = startQuad + start;
+        for (int i = 0 ; i < count; ++i, ++startX, ++startY, ++x, ++y, ++quadStart, ++s, ++r)
         {
             newPos.set(*x, *y);
             newPos.x = *x - (currentPosition.x - *startX);
@@ -375,14 +392,14 @@ void ParticleSystemQuad::updateParticleQuads()
     else
     {
         Vec2 newPos;
-        float* startX = _particleData.startPosX;
-        float* startY = _particleData.startPosY;
-        float* x = _particleData.posx;
-        float* y = _particleData.posy;
-        float* s = _particleData.size;
-        float* r = _particleData.rotation;
-        V3F_C4B_T2F_Quad* quadStart = startQuad;
-        for (int i = 0 ; i < _particleCount; ++i, ++startX, ++startY, ++x, ++y, ++quadStart, ++s, ++r)
+        float* startX = _particleData.startPosX + start;
+        float* startY = _particleData.startPosY + start;
+        float* x = _particleData.posx + start;
+        float* y = _particleData.posy + start;
+        float* s = _particleData.size + start;
+        float* r = _particleData.rotation + start;
+        V3F_C4B_T2F_Quad* quadStart = startQuad + start;
+        for (int i = 0 ; i < count; ++i, ++startX, ++startY, ++x, ++y, ++quadStart, ++s, ++r)
         {
             newPos.set(*x + pos.x, *y + pos.y);
             updatePosWithParticle(quadStart, newPos, *s, *r);
@@ -392,13 +409,13 @@ void ParticleSystemQuad::updateParticleQuads()
     //set color
     if(_opacityModifyRGB)
     {
-        V3F_C4B_T2F_Quad* quad = startQuad;
-        float* r = _particleData.colorR;
-        float* g = _particleData.colorG;
-        float* b = _particleData.colorB;
-        float* a = _particleData.colorA;
+        V3F_C4B_T2F_Quad* quad = startQuad + start;
+        float* r = _particleData.colorR + start;
+        float* g = _particleData.colorG + start;
+        float* b = _particleData.colorB + start;
+        float* a = _particleData.colorA + start;
         
-        for (int i = 0; i < _particleCount; ++i,++quad,++r,++g,++b,++a)
+        for (int i = 0; i < count; ++i,++quad,++r,++g,++b,++a)
         {
             GLubyte colorR = *r * *a * 255;
             GLubyte colorG = *g * *a * 255;
@@ -412,13 +429,13 @@ void ParticleSystemQuad::updateParticleQuads()
     }
     else
     {
-        V3F_C4B_T2F_Quad* quad = startQuad;
-        float* r = _particleData.colorR;
-        float* g = _particleData.colorG;
-        float* b = _particleData.colorB;
-        float* a = _particleData.colorA;
+        V3F_C4B_T2F_Quad* quad = startQuad + start;
+        float* r = _particleData.colorR + start;
+        float* g = _particleData.colorG + start;
+        float* b = _particleData.colorB + start;
+        float* a = _particleData.colorA + start;
         
-        for (int i = 0; i < _particleCount; ++i,++quad,++r,++g,++b,++a)
+        for (int i = 0; i < count; ++i,++quad,++r,++g,++b,++a)
         {
             GLubyte colorR = *r * 255;
             GLubyte colorG = *g * 255;
@@ -174,6 +174,10 @@ protected:
     /** Updates texture coords */
     void updateTexCoords();
 
+    /** Updates the vertices and colors of the quads of the particles in [start, end). */
+    void updateParticleQuads(V3F_C4B_T2F_Quad* startQuad, const Vec2& currentPosition, const Vec2& pos,
+                             const Mat4& worldToNodeTM, int start, int end);
+
     void setupVBOandVAO();
     void setupVBO();
     bool allocMemory();
@@ -90,6 +90,14 @@ public:
      * @return a Node object whose tag equals to the input parameter.
      */
     virtual Node * getProtectedChildByTag(int tag);
+
+    /**
+     * Gets the protected children.
+     *
+     * @return The protected children, in the order they are drawn once sortAllProtectedChildren is called.
+     * @since v3.16
+     */
+    const Vector<Node*>& getProtectedChildren() const { return _protectedChildren; }
     
     ////// REMOVES //////
     
@@ -1215,7 +1215,7 @@ void Sprite::sortAllChildren()
 {
     if (_reorderChildDirty)
     {
-        sortNodes(_children);
+        sortChildrenIncrementally();
 
         if (_renderMode == RenderMode::QUAD_BATCHNODE)
         {
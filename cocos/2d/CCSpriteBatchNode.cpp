@@ -282,7 +282,7 @@ void SpriteBatchNode::sortAllChildren()
 {
     if (_reorderChildDirty)
     {
-        sortNodes(_children);
+        sortChildrenIncrementally();
 
         //sorted now check all children
         if (!_children.empty())
@@ -49,6 +49,172 @@ NS_CC_BEGIN
 
 static SpriteFrameCache *_sharedSpriteFrameCache = nullptr;
 
+// Binary sprite sheet (.ccsf), written by tools/spritesheet/plist2ccsf.py.
+// Little endian and 4 bytes aligned, the structures are read in place from the mapped file:
+//   header | frames | aliases | polygons | strings
+// The strings are NUL terminated and referenced by their offset in the strings.
+// The polygon of a frame has int32 vertices[2 * vertexCount], int32 verticesUV[2 * vertexCount]
+// and uint16 triangles[indexCount], padded to 4 bytes.
+static const char BINARY_SPRITE_SHEET_MAGIC[4] = {'C', 'C', 'S', 'F'};
+static const uint32_t BINARY_SPRITE_SHEET_VERSION = 1;
+static const uint32_t BINARY_SPRITE_SHEET_NO_STRING = 0xffffffff;
+
+struct BinarySpriteSheetHeader
+{
+    char magic[4];
+    uint32_t version;
+    uint32_t frameCount;
+    uint32_t aliasCount;
+    float textureWidth;
+    float textureHeight;
+    uint32_t textureFileName;
+    uint32_t pixelFormat;
+    uint32_t polygonsOffset;
+    uint32_t polygonsSize;
+    uint32_t stringsOffset;
+    uint32_t stringsSize;
+};
+
+struct BinarySpriteFrame
+{
+    enum Flags : uint32_t
+    {
+        ROTATED = 1,
+        ANCHOR = 2,
+        POLYGON = 4,
+    };
+
+    uint32_t name;
+    uint32_t nameLength;
+    float rect[4];
+    float offset[2];
+    float sourceSize[2];
+    float anchor[2];
+    uint32_t flags;
+    uint32_t vertexCount;
+    uint32_t indexCount;
+    uint32_t polygon;
+};
+
+struct BinarySpriteFrameAlias
+{
+    uint32_t name;
+    uint32_t nameLength;
+    uint32_t frame;
+};
+
+static_assert(sizeof(BinarySpriteSheetHeader) == 48, "the binary sprite sheet header should be packed");
+static_assert(sizeof(BinarySpriteFrame) == 64, "the binary sprite frame should be packed");
+static_assert(sizeof(BinarySpriteFrameAlias) == 12, "the binary sprite frame alias should be packed");
+
+static bool isBinarySpriteSheet(const std::string& file)
+{
+    return FileUtils::getInstance()->getFileExtension(file) == ".ccsf";
+}
+
+// Returns the header of the binary sprite sheet, or nullptr if the data isn't a valid one.
+static const BinarySpriteSheetHeader* getBinarySpriteSheetHeader(const FileView& data)
+{
+    const uint64_t size = data.getSize();
+    if (size < sizeof(BinarySpriteSheetHeader) || (reinterpret_cast<uintptr_t>(data.getBytes()) & 3) != 0)
+        return nullptr;
+
+    auto header = reinterpret_cast<const BinarySpriteSheetHeader*>(data.getBytes());
+    if (memcmp(header->magic, BINARY_SPRITE_SHEET_MAGIC, sizeof(header->magic)) != 0 || header->version != BINARY_SPRITE_SHEET_VERSION)
+        return nullptr;
+
+    const uint64_t tablesEnd = sizeof(BinarySpriteSheetHeader)
+        + (uint64_t)header->frameCount * sizeof(BinarySpriteFrame)
+        + (uint64_t)header->aliasCount * sizeof(BinarySpriteFrameAlias);
+    if (tablesEnd > header->polygonsOffset
+        || (uint64_t)header->polygonsOffset + header->polygonsSize > size
+        || (header->polygonsOffset & 3) != 0
+        || (uint64_t)header->stringsOffset + header->stringsSize > size
+        || header->stringsSize == 0
+        || data.getBytes()[header->stringsOffset + header->stringsSize - 1] != 0)
+        return nullptr;
+
+    // check the references of the frames and aliases, so that they can be used without checks
+    auto strings = data.getBytes() + header->stringsOffset;
+    auto isValidString = [header, strings](uint32_t offset, uint32_t length) {
+        return (uint64_t)offset + length < header->stringsSize && strings[offset + length] == 0;
+    };
+    auto frames = reinterpret_cast<const BinarySpriteFrame*>(header + 1);
+    for (uint32_t i = 0; i < header->frameCount; ++i)
+    {
+        const BinarySpriteFrame& frame = frames[i];
+        const uint64_t polygonSize = (uint64_t)frame.vertexCount * 4 * sizeof(int32_t) + (uint64_t)frame.indexCount * sizeof(uint16_t);
+        if (!isValidString(frame.name, frame.nameLength)
+            || (frame.polygon & 3) != 0
+            || ((frame.flags & BinarySpriteFrame::POLYGON) && (uint64_t)frame.polygon + polygonSize > header->polygonsSize))
+            return nullptr;
+    }
+    auto aliases = reinterpret_cast<const BinarySpriteFrameAlias*>(frames + header->frameCount);
+    for (uint32_t i = 0; i < header->aliasCount; ++i)
+    {
+        if (!isValidString(aliases[i].name, aliases[i].nameLength) || aliases[i].frame >= header->frameCount)
+            return nullptr;
+    }
+    if ((header->textureFileName != BINARY_SPRITE_SHEET_NO_STRING && header->textureFileName >= header->stringsSize)
+        || (header->pixelFormat != BINARY_SPRITE_SHEET_NO_STRING && header->pixelFormat >= header->stringsSize))
+        return nullptr;
+    return header;
+}
+
+static const char* getBinarySpriteSheetString(const FileView& data, uint32_t offset)
+{
+    auto header = reinterpret_cast<const BinarySpriteSheetHeader*>(data.getBytes());
+    return reinterpret_cast<const char*>(data.getBytes()) + header->stringsOffset + offset;
+}
+
+// The texture named by a binary sprite sheet, relative to it, or the sheet path with the .png extension.
+static std::string getBinarySpriteSheetTexturePath(const FileView& data, const std::string& fullPath)
+{
+    auto header = reinterpret_cast<const BinarySpriteSheetHeader*>(data.getBytes());
+    if (header->textureFileName != BINARY_SPRITE_SHEET_NO_STRING)
+    {
+        return FileUtils::getInstance()->fullPathFromRelativeFile(getBinarySpriteSheetString(data, header->textureFileName), fullPath);
+    }
+    std::string texturePath = fullPath.substr(0, fullPath.find_last_of('.')) + ".png";
+    CCLOG("cocos2d: SpriteFrameCache: Trying to use file %s as texture", texturePath.c_str());
+    return texturePath;
+}
+
+// Loads the texture of a sprite sheet with the pixel format the sheet asks for.
+static Texture2D* loadSpriteSheetTexture(const std::string& texturePath, const std::string& pixelFormatName)
+{
+    static std::unordered_map<std::string, Texture2D::PixelFormat> pixelFormats = {
+        {"RGBA8888", Texture2D::PixelFormat::RGBA8888},
+        {"RGBA4444", Texture2D::PixelFormat::RGBA4444},
+        {"RGB5A1", Texture2D::PixelFormat::RGB5A1},
+        {"RGBA5551", Texture2D::PixelFormat::RGB5A1},
+        {"RGB565", Texture2D::PixelFormat::RGB565},
+        {"A8", Texture2D::PixelFormat::A8},
+        {"ALPHA", Texture2D::PixelFormat::A8},
+        {"I8", Texture2D::PixelFormat::I8},
+        {"AI88", Texture2D::PixelFormat::AI88},
+        {"ALPHA_INTENSITY", Texture2D::PixelFormat::AI88},
+        //{"BGRA8888", Texture2D::PixelFormat::BGRA8888}, no Image conversion RGBA -> BGRA
+        {"RGB888", Texture2D::PixelFormat::RGB888}
+    };
+
+    Texture2D *texture = nullptr;
+    auto pixelFormatIt = pixelFormats.find(pixelFormatName);
+    if (pixelFormatIt != pixelFormats.end())
+    {
+        const Texture2D::PixelFormat pixelFormat = (*pixelFormatIt).second;
+        const Texture2D::PixelFormat currentPixelFormat = Texture2D::getDefaultAlphaPixelFormat();
+        Texture2D::setDefaultAlphaPixelFormat(pixelFormat);
+        texture = Director::getInstance()->getTextureCache()->addImage(texturePath);
+        Texture2D::setDefaultAlphaPixelFormat(currentPixelFormat);
+    }
+    else
+    {
+        texture = Director::getInstance()->getTextureCache()->addImage(texturePath);
+    }
+    return texture;
+}
+
 SpriteFrameCache* SpriteFrameCache::getInstance()
 {
     if (! _sharedSpriteFrameCache)
@@ -106,8 +272,21 @@ void SpriteFrameCache::initializePolygonInfo(const Size &textureSize,
                                              const std::vector<int> &triangleIndices,
                                              PolygonInfo &info)
 {
-    size_t vertexCount = vertices.size();
-    size_t indexCount = triangleIndices.size();
+    std::vector<unsigned short> indices(triangleIndices.begin(), triangleIndices.end());
+    initializePolygonInfo(textureSize, spriteSize, vertices.data(), verticesUV.data(), vertices.size(),
+                          indices.data(), indices.size(), info);
+}
+
+void SpriteFrameCache::initializePolygonInfo(const Size &textureSize,
+                                             const Size &spriteSize,
+                                             const int *vertices,
+                                             const int *verticesUV,
+                                             size_t vertexValueCount,
+                                             const unsigned short *triangleIndices,
+                                             size_t indexCount,
+                                             PolygonInfo &info)
+{
+    size_t vertexCount = vertexValueCount;
     
     float scaleFactor = CC_CONTENT_SCALE_FACTOR();
 
@@ -123,10 +302,7 @@ void SpriteFrameCache::initializePolygonInfo(const Size &textureSize,
     }
 
     unsigned short *indexData = new unsigned short[indexCount];
-    for (size_t i = 0; i < indexCount; i++)
-    {
-        indexData[i] = static_cast<unsigned short>(triangleIndices[i]);
-    }
+    memcpy(indexData, triangleIndices, indexCount * sizeof(unsigned short));
 
     info.triangles.vertCount = static_cast<int>(vertexCount);
     info.triangles.verts = vertexData;
@@ -308,35 +484,7 @@ void SpriteFrameCache::addSpriteFramesWithDictionary(ValueMap& dict, const std::
         }
     }
     
-    Texture2D *texture = nullptr;
-    static std::unordered_map<std::string, Texture2D::PixelFormat> pixelFormats = {
-        {"RGBA8888", Texture2D::PixelFormat::RGBA8888},
-        {"RGBA4444", Texture2D::PixelFormat::RGBA4444},
-        {"RGB5A1", Texture2D::PixelFormat::RGB5A1},
-        {"RGBA5551", Texture2D::PixelFormat::RGB5A1},
-        {"RGB565", Texture2D::PixelFormat::RGB565},
-        {"A8", Texture2D::PixelFormat::A8},
-        {"ALPHA", Texture2D::PixelFormat::A8},
-        {"I8", Texture2D::PixelFormat::I8},
-        {"AI88", Texture2D::PixelFormat::AI88},
-        {"ALPHA_INTENSITY", Texture2D::PixelFormat::AI88},
-        //{"BGRA8888", Texture2D::PixelFormat::BGRA8888}, no Image conversion RGBA -> BGRA
-        {"RGB888", Texture2D::PixelFormat::RGB888}
-    };
-
-    auto pixelFormatIt = pixelFormats.find(pixelFormatName);
-    if (pixelFormatIt != pixelFormats.end())
-    {
-        const Texture2D::PixelFormat pixelFormat = (*pixelFormatIt).second;
-        const Texture2D::PixelFormat currentPixelFormat = Texture2D::getDefaultAlphaPixelFormat();
-        Texture2D::setDefaultAlphaPixelFormat(pixelFormat);
-        texture = Director::getInstance()->getTextureCache()->addImage(texturePath);
-        Texture2D::setDefaultAlphaPixelFormat(currentPixelFormat);
-    }
-    else
-    {
-        texture = Director::getInstance()->getTextureCache()->addImage(texturePath);
-    }
+    Texture2D *texture = loadSpriteSheetTexture(texturePath, pixelFormatName);
     
     if (texture)
     {
@@ -348,6 +496,146 @@ void SpriteFrameCache::addSpriteFramesWithDictionary(ValueMap& dict, const std::
     }
 }
 
+void SpriteFrameCache::addSpriteFramesWithBinaryData(const FileView& data, Texture2D *texture, bool replaceExisting)
+{
+    auto header = getBinarySpriteSheetHeader(data);
+    if (!header)
+    {
+        CCLOG("cocos2d: SpriteFrameCache: invalid binary sprite sheet");
+        return;
+    }
+
+    auto frames = reinterpret_cast<const BinarySpriteFrame*>(header + 1);
+    auto aliases = reinterpret_cast<const BinarySpriteFrameAlias*>(frames + header->frameCount);
+    const unsigned char* polygons = data.getBytes() + header->polygonsOffset;
+    const char* strings = getBinarySpriteSheetString(data, 0);
+    const Size textureSize(header->textureWidth, header->textureHeight);
+
+    // the aliases of the frames which already exist are skipped, like in the plist files
+    std::vector<bool> addedFrames(header->aliasCount ? header->frameCount : 0);
+
+    auto textureFileName = Director::getInstance()->getTextureCache()->getTextureFilePath(texture);
+    Image* image = nullptr;
+    NinePatchImageParser parser;
+    std::string spriteFrameName;
+    for (uint32_t i = 0; i < header->frameCount; ++i)
+    {
+        const BinarySpriteFrame& frame = frames[i];
+        spriteFrameName.assign(strings + frame.name, frame.nameLength);
+        if (replaceExisting)
+        {
+            _spriteFrames.erase(spriteFrameName);
+        }
+        else if (_spriteFrames.at(spriteFrameName))
+        {
+            continue;
+        }
+
+        const Size sourceSize(frame.sourceSize[0], frame.sourceSize[1]);
+        SpriteFrame* spriteFrame = SpriteFrame::createWithTexture(texture,
+                                                                  Rect(frame.rect[0], frame.rect[1], frame.rect[2], frame.rect[3]),
+                                                                  (frame.flags & BinarySpriteFrame::ROTATED) != 0,
+                                                                  Vec2(frame.offset[0], frame.offset[1]),
+                                                                  sourceSize);
+
+        if (frame.flags & BinarySpriteFrame::POLYGON)
+        {
+            auto vertices = reinterpret_cast<const int*>(polygons + frame.polygon);
+            auto verticesUV = vertices + 2 * frame.vertexCount;
+            auto indices = reinterpret_cast<const unsigned short*>(verticesUV + 2 * frame.vertexCount);
+
+            PolygonInfo info;
+            initializePolygonInfo(textureSize, sourceSize, vertices, verticesUV, 2 * frame.vertexCount, indices, frame.indexCount, info);
+            spriteFrame->setPolygonInfo(info);
+        }
+        if (frame.flags & BinarySpriteFrame::ANCHOR)
+        {
+            spriteFrame->setAnchorPoint(Vec2(frame.anchor[0], frame.anchor[1]));
+        }
+
+        if (NinePatchImageParser::isNinePatchImage(spriteFrameName))
+        {
+            if (image == nullptr) {
+                image = new (std::nothrow) Image();
+                image->initWithImageFile(textureFileName);
+            }
+            parser.setSpriteFrameInfo(image, spriteFrame->getRectInPixels(), spriteFrame->isRotated());
+            texture->addSpriteFrameCapInset(spriteFrame, parser.parseCapInset());
+        }
+        // add sprite frame
+        _spriteFrames.insert(spriteFrameName, spriteFrame);
+        if (!addedFrames.empty())
+        {
+            addedFrames[i] = true;
+        }
+    }
+    CC_SAFE_DELETE(image);
+
+    for (uint32_t i = 0; i < header->aliasCount; ++i)
+    {
+        const BinarySpriteFrameAlias& alias = aliases[i];
+        if (!addedFrames[alias.frame])
+        {
+            continue;
+        }
+
+        std::string oneAlias(strings + alias.name, alias.nameLength);
+        if (_spriteFramesAliases.find(oneAlias) != _spriteFramesAliases.end())
+        {
+            CCLOGWARN("cocos2d: WARNING: an alias with name %s already exists", oneAlias.c_str());
+        }
+        const BinarySpriteFrame& frame = frames[alias.frame];
+        _spriteFramesAliases[oneAlias] = Value(std::string(strings + frame.name, frame.nameLength));
+    }
+}
+
+void SpriteFrameCache::removeSpriteFramesFromBinaryData(const FileView& data)
+{
+    auto header = getBinarySpriteSheetHeader(data);
+    if (!header)
+    {
+        CCLOG("cocos2d: SpriteFrameCache: invalid binary sprite sheet");
+        return;
+    }
+
+    auto frames = reinterpret_cast<const BinarySpriteFrame*>(header + 1);
+    const char* strings = getBinarySpriteSheetString(data, 0);
+    std::vector<std::string> keysToRemove;
+    for (uint32_t i = 0; i < header->frameCount; ++i)
+    {
+        std::string name(strings + frames[i].name, frames[i].nameLength);
+        if (_spriteFrames.at(name))
+        {
+            keysToRemove.push_back(std::move(name));
+        }
+    }
+
+    _spriteFrames.erase(keysToRemove);
+}
+
+void SpriteFrameCache::addSpriteFramesWithBinaryFile(const std::string& fullPath, Texture2D *texture, const std::string& texturePath)
+{
+    FileView data = FileUtils::getInstance()->getFileView(fullPath);
+    auto header = getBinarySpriteSheetHeader(data);
+    if (!header)
+    {
+        CCLOG("cocos2d: SpriteFrameCache: %s isn't a valid binary sprite sheet", fullPath.c_str());
+        return;
+    }
+
+    if (!texture)
+    {
+        const char* pixelFormatName = header->pixelFormat != BINARY_SPRITE_SHEET_NO_STRING ? getBinarySpriteSheetString(data, header->pixelFormat) : "";
+        texture = loadSpriteSheetTexture(texturePath.empty() ? getBinarySpriteSheetTexturePath(data, fullPath) : texturePath, pixelFormatName);
+        if (!texture)
+        {
+            CCLOG("cocos2d: SpriteFrameCache: Couldn't load texture");
+            return;
+        }
+    }
+    addSpriteFramesWithBinaryData(data, texture, false);
+}
+
 void SpriteFrameCache::addSpriteFramesWithFile(const std::string& plist, Texture2D *texture)
 {
     if (_loadedFileNames->find(plist) != _loadedFileNames->end())
@@ -356,9 +644,15 @@ void SpriteFrameCache::addSpriteFramesWithFile(const std::string& plist, Texture
     }
     
     std::string fullPath = FileUtils::getInstance()->fullPathForFilename(plist);
-    ValueMap dict = FileUtils::getInstance()->getValueMapFromFile(fullPath);
-
-    addSpriteFramesWithDictionary(dict, texture);
+    if (isBinarySpriteSheet(plist))
+    {
+        addSpriteFramesWithBinaryFile(fullPath, texture, "");
+    }
+    else
+    {
+        ValueMap dict = FileUtils::getInstance()->getValueMapFromFile(fullPath);
+        addSpriteFramesWithDictionary(dict, texture);
+    }
     _loadedFileNames->insert(plist);
 }
 
@@ -377,8 +671,15 @@ void SpriteFrameCache::addSpriteFramesWithFile(const std::string& plist, const s
     }
     
     const std::string fullPath = FileUtils::getInstance()->fullPathForFilename(plist);
-    ValueMap dict = FileUtils::getInstance()->getValueMapFromFile(fullPath);
-    addSpriteFramesWithDictionary(dict, textureFileName);
+    if (isBinarySpriteSheet(plist))
+    {
+        addSpriteFramesWithBinaryFile(fullPath, nullptr, textureFileName);
+    }
+    else
+    {
+        ValueMap dict = FileUtils::getInstance()->getValueMapFromFile(fullPath);
+        addSpriteFramesWithDictionary(dict, textureFileName);
+    }
     _loadedFileNames->insert(plist);
 }
 
@@ -396,6 +697,13 @@ void SpriteFrameCache::addSpriteFramesWithFile(const std::string& plist)
 
     if (_loadedFileNames->find(plist) == _loadedFileNames->end())
     {
+        if (isBinarySpriteSheet(plist))
+        {
+            addSpriteFramesWithBinaryFile(fullPath, nullptr, "");
+            _loadedFileNames->insert(plist);
+            return;
+        }
+
         ValueMap dict = FileUtils::getInstance()->getValueMapFromFile(fullPath);
 
         string texturePath("");
@@ -510,13 +818,26 @@ void SpriteFrameCache::removeSpriteFrameByName(const std::string& name)
 void SpriteFrameCache::removeSpriteFramesFromFile(const std::string& plist)
 {
     std::string fullPath = FileUtils::getInstance()->fullPathForFilename(plist);
-    ValueMap dict = FileUtils::getInstance()->getValueMapFromFile(fullPath);
-    if (dict.empty())
+    if (isBinarySpriteSheet(plist))
     {
-        CCLOG("cocos2d:SpriteFrameCache:removeSpriteFramesFromFile: create dict by %s fail.",plist.c_str());
-        return;
+        FileView data = FileUtils::getInstance()->getFileView(fullPath);
+        if (data.isNull())
+        {
+            CCLOG("cocos2d:SpriteFrameCache:removeSpriteFramesFromFile: read %s fail.",plist.c_str());
+            return;
+        }
+        removeSpriteFramesFromBinaryData(data);
+    }
+    else
+    {
+        ValueMap dict = FileUtils::getInstance()->getValueMapFromFile(fullPath);
+        if (dict.empty())
+        {
+            CCLOG("cocos2d:SpriteFrameCache:removeSpriteFramesFromFile: create dict by %s fail.",plist.c_str());
+            return;
+        }
+        removeSpriteFramesFromDictionary(dict);
     }
-    removeSpriteFramesFromDictionary(dict);
 
     // remove it from the cache
     set<string>::iterator ret = _loadedFileNames->find(plist);
@@ -725,6 +1046,32 @@ bool SpriteFrameCache::reloadTexture(const std::string& plist)
     }
 
     std::string fullPath = FileUtils::getInstance()->fullPathForFilename(plist);
+    if (isBinarySpriteSheet(plist))
+    {
+        FileView data = FileUtils::getInstance()->getFileView(fullPath);
+        if (!getBinarySpriteSheetHeader(data))
+        {
+            CCLOG("cocos2d: SpriteFrameCache: %s isn't a valid binary sprite sheet", plist.c_str());
+            return true;
+        }
+
+        std::string texturePath = getBinarySpriteSheetTexturePath(data, fullPath);
+        Texture2D *texture = nullptr;
+        if (Director::getInstance()->getTextureCache()->reloadTexture(texturePath))
+            texture = Director::getInstance()->getTextureCache()->getTextureForKey(texturePath);
+
+        if (texture)
+        {
+            addSpriteFramesWithBinaryData(data, texture, true);
+            _loadedFileNames->insert(plist);
+        }
+        else
+        {
+            CCLOG("cocos2d: SpriteFrameCache: Couldn't load texture");
+        }
+        return true;
+    }
+
     ValueMap dict = FileUtils::getInstance()->getValueMapFromFile(fullPath);
 
     string texturePath("");
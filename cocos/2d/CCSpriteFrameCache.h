@@ -36,6 +36,7 @@ THE SOFTWARE.
 #include "base/CCRef.h"
 #include "base/CCValue.h"
 #include "base/CCMap.h"
+#include "platform/CCFileView.h"
 
 NS_CC_BEGIN
 
@@ -80,6 +81,9 @@ class PolygonInfo;
  Use one of the following tools to create the .plist file and sprite sheet:
  - [TexturePacker](https://www.codeandweb.com/texturepacker/cocos2d)
  - [Zwoptex](https://zwopple.com/zwoptex/)
+
+ The .plist file can be converted to the binary .ccsf format with tools/spritesheet/plist2ccsf.py.
+ A .ccsf file is loaded by the same methods, without parsing XML and strings, which is much faster.
  
  @since v0.9
  @js cc.spriteFrameCache
@@ -267,8 +271,33 @@ protected:
                                const std::vector<int> &triangleIndices,
                                PolygonInfo &polygonInfo);
 
+    /** Configures PolygonInfo class with the passed sizes + triangles.
+     * vertexValueCount is the number of values in vertices and verticesUV, 2 per vertex.
+     */
+    void initializePolygonInfo(const Size &textureSize,
+                               const Size &spriteSize,
+                               const int *vertices,
+                               const int *verticesUV,
+                               size_t vertexValueCount,
+                               const unsigned short *triangleIndices,
+                               size_t indexCount,
+                               PolygonInfo &polygonInfo);
+
     void reloadSpriteFramesWithDictionary(ValueMap& dictionary, Texture2D *texture);
 
+    /** Adds the Sprite Frames of a binary sprite sheet.
+     * The existing frames with the same names are kept, unless replaceExisting is true.
+     */
+    void addSpriteFramesWithBinaryData(const FileView& data, Texture2D *texture, bool replaceExisting);
+
+    /** Removes the Sprite Frames of a binary sprite sheet. */
+    void removeSpriteFramesFromBinaryData(const FileView& data);
+
+    /** Adds multiple Sprite Frames from a binary sprite sheet file.
+     * When texture is null, the texture at texturePath is loaded, or the one named by the file if texturePath is empty.
+     */
+    void addSpriteFramesWithBinaryFile(const std::string& fullPath, Texture2D *texture, const std::string& texturePath);
+
     Map<std::string, SpriteFrame*> _spriteFrames;
     ValueMap _spriteFramesAliases;
     std::set<std::string>*  _loadedFileNames;
@@ -1080,7 +1080,7 @@ bool Bundle3D::loadBinary(const std::string& path)
     
     // get file data
     _binaryBuffer.clear();
-    _binaryBuffer = FileUtils::getInstance()->getDataFromFile(path);
+    _binaryBuffer = FileUtils::getInstance()->getFileView(path);
     if (_binaryBuffer.isNull())
     {
         clear();
@@ -1089,6 +1089,7 @@ bool Bundle3D::loadBinary(const std::string& path)
     }
     
     // Initialise bundle reader
+    // the reader only copies out of the buffer, so it can be a read-only mapping
     _binaryReader.init( (char*)_binaryBuffer.getBytes(),  _binaryBuffer.getSize() );
     
     // Read identifier info
@@ -26,6 +26,7 @@
 #define __CCBUNDLE3D_H__
 
 #include "base/CCData.h"
+#include "platform/CCFileView.h"
 #include "3d/CCBundle3DData.h"
 #include "3d/CCBundleReader.h"
 #include "json/document-wrapper.h"
@@ -181,7 +182,7 @@ protected:
     rapidjson::Document _jsonReader;
 
     // for binary reading
-    Data _binaryBuffer;
+    FileView _binaryBuffer;
     BundleReader _binaryReader;
     unsigned int _referenceCount;
     Reference* _references;
@@ -90,6 +90,7 @@ cocos2d.cpp \
 3d/CCFrustum.cpp \
 3d/CCPlane.cpp \
 platform/CCFileUtils.cpp \
+platform/CCFileView.cpp \
 platform/CCGLView.cpp \
 platform/CCImage.cpp \
 platform/CCSAXParser.cpp \
@@ -107,6 +108,7 @@ math/Vec4.cpp \
 base/CCNinePatchImageParser.cpp \
 base/CCStencilStateManager.cpp \
 base/CCAsyncTaskPool.cpp \
+base/CCWorkerPool.cpp \
 base/CCAutoreleasePool.cpp \
 base/CCConfiguration.cpp \
 base/CCConsole.cpp \
@@ -132,6 +134,7 @@ base/CCEventListenerMouse.cpp \
 base/CCEventListenerTouch.cpp \
 base/CCEventMouse.cpp \
 base/CCEventTouch.cpp \
+base/CCFunctionQueue.cpp \
 base/CCIMEDispatcher.cpp \
 base/CCNS.cpp \
 base/CCProfiling.cpp \
@@ -180,6 +183,7 @@ renderer/CCTechnique.cpp \
 renderer/CCTexture2D.cpp \
 renderer/CCTextureAtlas.cpp \
 renderer/CCTextureCache.cpp \
+renderer/CCTextureDiskCache.cpp \
 renderer/CCTextureCube.cpp \
 renderer/CCTrianglesCommand.cpp \
 renderer/CCVertexAttribBinding.cpp \
@@ -52,6 +52,7 @@ Configuration::Configuration()
 , _supportsOESDepth24(false)
 , _supportsOESPackedDepthStencil(false)
 , _supportsOESMapBuffer(false)
+, _supportsMapBufferRange(false)
 , _maxSamplesAllowed(0)
 , _maxTextureUnits(0)
 , _glExtensions(nullptr)
@@ -160,6 +161,9 @@ void Configuration::gatherGPUInfo()
     _supportsOESMapBuffer = checkForGLExtension("GL_OES_mapbuffer");
     _valueDict["gl.supports_OES_map_buffer"] = Value(_supportsOESMapBuffer);
 
+    _supportsMapBufferRange = checkForGLExtension("GL_ARB_map_buffer_range") && checkForGLExtension("GL_ARB_sync");
+    _valueDict["gl.supports_map_buffer_range"] = Value(_supportsMapBufferRange);
+
     _supportsOESDepth24 = checkForGLExtension("GL_OES_depth24");
     _valueDict["gl.supports_OES_depth24"] = Value(_supportsOESDepth24);
 
@@ -294,6 +298,17 @@ bool Configuration::supportsMapBuffer() const
 #endif
 }
 
+bool Configuration::supportsMapBufferRange() const
+{
+    // glMapBufferRange() and glFenceSync() are only declared by the desktop GL headers,
+    // OpenGL ES 2.0 exposes them as vendor extensions.
+#if defined(GL_MAP_UNSYNCHRONIZED_BIT) && defined(GL_SYNC_GPU_COMMANDS_COMPLETE)
+    return _supportsMapBufferRange;
+#else
+    return false;
+#endif
+}
+
 bool Configuration::supportsOESDepth24() const
 {
     return _supportsOESDepth24;
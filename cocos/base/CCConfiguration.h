@@ -170,6 +170,16 @@ public:
      */
     bool supportsMapBuffer() const;
 
+    /** Whether or not unsynchronized glMapBufferRange() and fence objects are supported.
+     *
+     * On Desktop it checks for the extensions `GL_ARB_map_buffer_range` and `GL_ARB_sync`.
+     * On Mobile it returns `false`.
+     *
+     * @return Whether or not `glMapBufferRange()` and `glFenceSync()` are supported.
+     * @since v3.16
+     */
+    bool supportsMapBufferRange() const;
+
     
     /** Max support directional light in shader, for Sprite3D.
      *
@@ -258,6 +268,7 @@ protected:
     bool            _supportsDiscardFramebuffer;
     bool            _supportsShareableVAO;
     bool            _supportsOESMapBuffer;
+    bool            _supportsMapBufferRange;
     bool            _supportsOESDepth24;
     bool            _supportsOESPackedDepthStencil;
     
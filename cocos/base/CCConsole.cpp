@@ -401,6 +401,7 @@ Console::Console()
     createCommandProjection();
     createCommandResolution();
     createCommandSceneGraph();
+    createCommandScheduler();
     createCommandTexture();
     createCommandTouch();
     createCommandUpload();
@@ -979,6 +980,16 @@ void Console::createCommandSceneGraph()
     addCommand({"scenegraph", "Print the scene graph", CC_CALLBACK_2(Console::commandSceneGraph, this)});
 }
 
+void Console::createCommandScheduler()
+{
+    addCommand({"scheduler", "Print the timer wheel and the performed functions statistics of the Scheduler. Args: [-h | help | wheel | functions | ]",
+        CC_CALLBACK_2(Console::commandScheduler, this)});
+    addSubCommand("scheduler", {"wheel", "Print the timer wheel statistics.",
+        CC_CALLBACK_2(Console::commandSchedulerSubCommandWheel, this)});
+    addSubCommand("scheduler", {"functions", "Print the statistics of the functions performed in the cocos thread.",
+        CC_CALLBACK_2(Console::commandSchedulerSubCommandFunctions, this)});
+}
+
 void Console::createCommandTexture()
 {
     addCommand({"texture", "Flush or print the TextureCache info. Args: [-h | help | flush | ] ",
@@ -1202,6 +1213,34 @@ void Console::commandSceneGraph(int fd, const std::string& /*args*/)
     sched->performFunctionInCocosThread( std::bind(&Console::printSceneGraphBoot, this, fd) );
 }
 
+void Console::commandScheduler(int fd, const std::string& /*args*/)
+{
+    Scheduler *sched = Director::getInstance()->getScheduler();
+    sched->performFunctionInCocosThread( [=](){
+        auto scheduler = Director::getInstance()->getScheduler();
+        Console::Utility::mydprintf(fd, "%s%s", scheduler->getTimerWheelInfo().c_str(), scheduler->getFunctionsToPerformInfo().c_str());
+        Console::Utility::sendPrompt(fd);
+    });
+}
+
+void Console::commandSchedulerSubCommandWheel(int fd, const std::string& /*args*/)
+{
+    Scheduler *sched = Director::getInstance()->getScheduler();
+    sched->performFunctionInCocosThread( [=](){
+        Console::Utility::mydprintf(fd, "%s", Director::getInstance()->getScheduler()->getTimerWheelInfo().c_str());
+        Console::Utility::sendPrompt(fd);
+    });
+}
+
+void Console::commandSchedulerSubCommandFunctions(int fd, const std::string& /*args*/)
+{
+    Scheduler *sched = Director::getInstance()->getScheduler();
+    sched->performFunctionInCocosThread( [=](){
+        Console::Utility::mydprintf(fd, "%s", Director::getInstance()->getScheduler()->getFunctionsToPerformInfo().c_str());
+        Console::Utility::sendPrompt(fd);
+    });
+}
+
 void Console::commandTextures(int fd, const std::string& /*args*/)
 {
     Scheduler *sched = Director::getInstance()->getScheduler();
@@ -207,6 +207,7 @@ protected:
     void createCommandProjection();
     void createCommandResolution();
     void createCommandSceneGraph();
+    void createCommandScheduler();
     void createCommandTexture();
     void createCommandTouch();
     void createCommandUpload();
@@ -234,6 +235,9 @@ protected:
     void commandResolution(int fd, const std::string& args);
     void commandResolutionSubCommandEmpty(int fd, const std::string& args);
     void commandSceneGraph(int fd, const std::string& args);
+    void commandScheduler(int fd, const std::string& args);
+    void commandSchedulerSubCommandWheel(int fd, const std::string& args);
+    void commandSchedulerSubCommandFunctions(int fd, const std::string& args);
     void commandTextures(int fd, const std::string& args);
     void commandTexturesSubCommandFlush(int fd, const std::string& args);
     void commandTouchSubCommandTap(int fd, const std::string& args);
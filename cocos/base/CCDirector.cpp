@@ -159,17 +159,18 @@ bool Director::init(void)
     _scheduler->scheduleUpdate(_actionManager, Scheduler::PRIORITY_SYSTEM, false);
 
     _eventDispatcher = new (std::nothrow) EventDispatcher();
-    _eventAfterDraw = new (std::nothrow) EventCustom(EVENT_AFTER_DRAW);
+    // the director's events are dispatched every frame, look their listeners up by interned ID
+    _eventAfterDraw = new (std::nothrow) EventCustom(EventListener::internListenerID(EVENT_AFTER_DRAW));
     _eventAfterDraw->setUserData(this);
-    _eventAfterVisit = new (std::nothrow) EventCustom(EVENT_AFTER_VISIT);
+    _eventAfterVisit = new (std::nothrow) EventCustom(EventListener::internListenerID(EVENT_AFTER_VISIT));
     _eventAfterVisit->setUserData(this);
-    _eventBeforeUpdate = new (std::nothrow) EventCustom(EVENT_BEFORE_UPDATE);
+    _eventBeforeUpdate = new (std::nothrow) EventCustom(EventListener::internListenerID(EVENT_BEFORE_UPDATE));
     _eventBeforeUpdate->setUserData(this);
-    _eventAfterUpdate = new (std::nothrow) EventCustom(EVENT_AFTER_UPDATE);
+    _eventAfterUpdate = new (std::nothrow) EventCustom(EventListener::internListenerID(EVENT_AFTER_UPDATE));
     _eventAfterUpdate->setUserData(this);
-    _eventProjectionChanged = new (std::nothrow) EventCustom(EVENT_PROJECTION_CHANGED);
+    _eventProjectionChanged = new (std::nothrow) EventCustom(EventListener::internListenerID(EVENT_PROJECTION_CHANGED));
     _eventProjectionChanged->setUserData(this);
-    _eventResetDirector = new (std::nothrow) EventCustom(EVENT_RESET);
+    _eventResetDirector = new (std::nothrow) EventCustom(EventListener::internListenerID(EVENT_RESET));
     //init TextureCache
     initTextureCache();
     initMatrixStack();
@@ -484,6 +485,10 @@ size_t Director::getProjectionMatrixStackSize()
 
 void Director::popMatrix(MATRIX_STACK_TYPE type)
 {
+    // the matrix stacks are not used by threads visiting the scene in parallel
+    if (Renderer::isRecordingCommands())
+        return;
+
     if(MATRIX_STACK_TYPE::MATRIX_STACK_MODELVIEW == type)
     {
         _modelViewMatrixStack.pop();
@@ -509,6 +514,9 @@ void Director::popProjectionMatrix(size_t index)
 
 void Director::loadIdentityMatrix(MATRIX_STACK_TYPE type)
 {
+    if (Renderer::isRecordingCommands())
+        return;
+
     if(MATRIX_STACK_TYPE::MATRIX_STACK_MODELVIEW == type)
     {
         _modelViewMatrixStack.top() = Mat4::IDENTITY;
@@ -534,6 +542,9 @@ void Director::loadProjectionIdentityMatrix(size_t index)
 
 void Director::loadMatrix(MATRIX_STACK_TYPE type, const Mat4& mat)
 {
+    if (Renderer::isRecordingCommands())
+        return;
+
     if(MATRIX_STACK_TYPE::MATRIX_STACK_MODELVIEW == type)
     {
         _modelViewMatrixStack.top() = mat;
@@ -559,6 +570,9 @@ void Director::loadProjectionMatrix(const Mat4& mat, size_t index)
 
 void Director::multiplyMatrix(MATRIX_STACK_TYPE type, const Mat4& mat)
 {
+    if (Renderer::isRecordingCommands())
+        return;
+
     if(MATRIX_STACK_TYPE::MATRIX_STACK_MODELVIEW == type)
     {
         _modelViewMatrixStack.top() *= mat;
@@ -584,6 +598,9 @@ void Director::multiplyProjectionMatrix(const Mat4& mat, size_t index)
 
 void Director::pushMatrix(MATRIX_STACK_TYPE type)
 {
+    if (Renderer::isRecordingCommands())
+        return;
+
     if(type == MATRIX_STACK_TYPE::MATRIX_STACK_MODELVIEW)
     {
         _modelViewMatrixStack.push(_modelViewMatrixStack.top());
@@ -24,6 +24,7 @@
 
 #include "base/CCEventCustom.h"
 #include "base/CCEvent.h"
+#include "base/ccMacros.h"
 
 NS_CC_BEGIN
 
@@ -31,7 +32,16 @@ EventCustom::EventCustom(const std::string& eventName)
 : Event(Type::CUSTOM)
 , _userData(nullptr)
 , _eventName(eventName)
+, _eventID(EventListener::INVALID_INTERNED_ID)
 {
 }
 
+EventCustom::EventCustom(EventListener::InternedID eventID)
+: Event(Type::CUSTOM)
+, _userData(nullptr)
+, _eventID(eventID)
+{
+    CCASSERT(eventID != EventListener::INVALID_INTERNED_ID, "Invalid event ID!");
+}
+
 NS_CC_END
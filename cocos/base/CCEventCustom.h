@@ -27,6 +27,7 @@
 
 #include <string>
 #include "base/CCEvent.h"
+#include "base/CCEventListener.h"
 
 /**
  * @addtogroup base
@@ -47,6 +48,14 @@ public:
      * @js ctor
      */
     EventCustom(const std::string& eventName);
+
+    /** Constructor with an interned event name, it doesn't copy the name.
+     *
+     * @param eventID The interned name of the custom event, see EventListener::internListenerID().
+     * @js NA
+     * @since v3.16
+     */
+    explicit EventCustom(EventListener::InternedID eventID);
     
     /** Sets user data.
      *
@@ -64,10 +73,21 @@ public:
      *
      * @return The name of the event.
      */
-    const std::string& getEventName() const { return _eventName; }
+    const std::string& getEventName() const
+    {
+        return _eventID == EventListener::INVALID_INTERNED_ID ? _eventName : EventListener::getInternedListenerID(_eventID);
+    }
+
+    /** Gets the interned event name.
+     *
+     * @return The interned name of the event, or EventListener::INVALID_INTERNED_ID if the event was created with a string.
+     * @since v3.16
+     */
+    EventListener::InternedID getEventID() const { return _eventID; }
 protected:
     void* _userData;       ///< User data
     std::string _eventName;
+    EventListener::InternedID _eventID;
 };
 
 NS_CC_END
@@ -35,12 +35,24 @@
 #include "base/CCEventListenerController.h"
 #endif
 #include "2d/CCScene.h"
+#include "2d/CCProtectedNode.h"
 #include "base/CCDirector.h"
 #include "base/CCEventType.h"
 #include "2d/CCCamera.h"
+#include "math/CCAffineTransform.h"
 
 #define DUMP_LISTENER_ITEM_PRIORITY_INFO 0
 
+// nodes covering more grid cells than this are tested for every touch instead
+#define MAX_TOUCH_GRID_CELLS_PER_NODE 256
+
+// The groups in which a node draws its children and itself, see ProtectedNode::visit
+#define DRAW_GROUP_NEGATIVE_CHILDREN 0
+#define DRAW_GROUP_NEGATIVE_PROTECTED_CHILDREN 1
+#define DRAW_GROUP_SELF 2
+#define DRAW_GROUP_PROTECTED_CHILDREN 3
+#define DRAW_GROUP_CHILDREN 4
+
 namespace
 {
 
@@ -66,28 +78,54 @@ private:
 
 NS_CC_BEGIN
 
-static EventListener::ListenerID __getListenerID(Event* event)
+// the IDs of the touch listeners are interned once
+static EventListener::InternedID __getTouchOneByOneListenerID()
+{
+    static const EventListener::InternedID listenerID = EventListener::internListenerID(EventListenerTouchOneByOne::LISTENER_ID);
+    return listenerID;
+}
+
+static EventListener::InternedID __getTouchAllAtOnceListenerID()
+{
+    static const EventListener::InternedID listenerID = EventListener::internListenerID(EventListenerTouchAllAtOnce::LISTENER_ID);
+    return listenerID;
+}
+
+static EventListener::InternedID __getListenerID(Event* event)
 {
-    EventListener::ListenerID ret;
+    static const EventListener::InternedID accelerationListenerID = EventListener::internListenerID(EventListenerAcceleration::LISTENER_ID);
+    static const EventListener::InternedID keyboardListenerID = EventListener::internListenerID(EventListenerKeyboard::LISTENER_ID);
+    static const EventListener::InternedID mouseListenerID = EventListener::internListenerID(EventListenerMouse::LISTENER_ID);
+    static const EventListener::InternedID focusListenerID = EventListener::internListenerID(EventListenerFocus::LISTENER_ID);
+#if (CC_TARGET_PLATFORM == CC_PLATFORM_ANDROID || CC_TARGET_PLATFORM == CC_PLATFORM_IOS || CC_TARGET_PLATFORM == CC_PLATFORM_MAC)
+    static const EventListener::InternedID controllerListenerID = EventListener::internListenerID(EventListenerController::LISTENER_ID);
+#endif
+
+    EventListener::InternedID ret = EventListener::INVALID_INTERNED_ID;
     switch (event->getType())
     {
         case Event::Type::ACCELERATION:
-            ret = EventListenerAcceleration::LISTENER_ID;
+            ret = accelerationListenerID;
             break;
         case Event::Type::CUSTOM:
             {
                 auto customEvent = static_cast<EventCustom*>(event);
-                ret = customEvent->getEventName();
+                ret = customEvent->getEventID();
+                // Events created with a name are looked up by it, a name that was never interned has no listeners
+                if (ret == EventListener::INVALID_INTERNED_ID)
+                {
+                    ret = EventListener::findInternedListenerID(customEvent->getEventName());
+                }
             }
             break;
         case Event::Type::KEYBOARD:
-            ret = EventListenerKeyboard::LISTENER_ID;
+            ret = keyboardListenerID;
             break;
         case Event::Type::MOUSE:
-            ret = EventListenerMouse::LISTENER_ID;
+            ret = mouseListenerID;
             break;
         case Event::Type::FOCUS:
-            ret = EventListenerFocus::LISTENER_ID;
+            ret = focusListenerID;
             break;
         case Event::Type::TOUCH:
             // Touch listener is very special, it contains two kinds of listeners, EventListenerTouchOneByOne and EventListenerTouchAllAtOnce.
@@ -96,7 +134,7 @@ static EventListener::ListenerID __getListenerID(Event* event)
             break;
 #if (CC_TARGET_PLATFORM == CC_PLATFORM_ANDROID || CC_TARGET_PLATFORM == CC_PLATFORM_IOS || CC_TARGET_PLATFORM == CC_PLATFORM_MAC)
         case Event::Type::GAME_CONTROLLER:
-            ret = EventListenerController::LISTENER_ID;
+            ret = controllerListenerID;
             break;
 #endif
         default:
@@ -199,18 +237,21 @@ void EventDispatcher::EventListenerVector::clear()
 
 
 EventDispatcher::EventDispatcher()
-: _inDispatch(0)
+: _nodePriorityScene(nullptr)
+, _inDispatch(0)
 , _isEnabled(false)
-, _nodePriorityIndex(0)
+, _touchGridCellSize(128.0f)
+, _touchGridDirty(false)
+, _touchHitSerial(0)
 {
     _toAddedListeners.reserve(50);
     _toRemovedListeners.reserve(50);
     
     // fixed #4129: Mark the following listener IDs for internal use.
     // Therefore, internal listeners would not be cleaned when removeAllEventListeners is invoked.
-    _internalCustomListenerIDs.insert(EVENT_COME_TO_FOREGROUND);
-    _internalCustomListenerIDs.insert(EVENT_COME_TO_BACKGROUND);
-    _internalCustomListenerIDs.insert(EVENT_RENDERER_RECREATED);
+    _internalCustomListenerIDs.insert(EventListener::internListenerID(EVENT_COME_TO_FOREGROUND));
+    _internalCustomListenerIDs.insert(EventListener::internListenerID(EVENT_COME_TO_BACKGROUND));
+    _internalCustomListenerIDs.insert(EventListener::internListenerID(EVENT_RENDERER_RECREATED));
 }
 
 EventDispatcher::~EventDispatcher()
@@ -221,75 +262,6 @@ EventDispatcher::~EventDispatcher()
     removeAllEventListeners();
 }
 
-void EventDispatcher::visitTarget(Node* node, bool isRootNode)
-{
-    node->sortAllChildren();
-    
-    int i = 0;
-    auto& children = node->getChildren();
-    
-    auto childrenCount = children.size();
-    
-    if(childrenCount > 0)
-    {
-        Node* child = nullptr;
-        // visit children zOrder < 0
-        for( ; i < childrenCount; i++ )
-        {
-            child = children.at(i);
-            
-            if ( child && child->getLocalZOrder() < 0 )
-                visitTarget(child, false);
-            else
-                break;
-        }
-        
-        if (_nodeListenersMap.find(node) != _nodeListenersMap.end())
-        {
-            _globalZOrderNodeMap[node->getGlobalZOrder()].push_back(node);
-        }
-        
-        for( ; i < childrenCount; i++ )
-        {
-            child = children.at(i);
-            if (child)
-                visitTarget(child, false);
-        }
-    }
-    else
-    {
-        if (_nodeListenersMap.find(node) != _nodeListenersMap.end())
-        {
-            _globalZOrderNodeMap[node->getGlobalZOrder()].push_back(node);
-        }
-    }
-    
-    if (isRootNode)
-    {
-        std::vector<float> globalZOrders;
-        globalZOrders.reserve(_globalZOrderNodeMap.size());
-        
-        for (const auto& e : _globalZOrderNodeMap)
-        {
-            globalZOrders.push_back(e.first);
-        }
-        
-        std::stable_sort(globalZOrders.begin(), globalZOrders.end(), [](const float a, const float b){
-            return a < b;
-        });
-        
-        for (const auto& globalZ : globalZOrders)
-        {
-            for (const auto& n : _globalZOrderNodeMap[globalZ])
-            {
-                _nodePriorityMap[n] = ++_nodePriorityIndex;
-            }
-        }
-        
-        _globalZOrderNodeMap.clear();
-    }
-}
-
 void EventDispatcher::pauseEventListenersForTarget(Node* target, bool recursive/* = false */)
 {
     auto listenerIter = _nodeListenersMap.find(target);
@@ -417,6 +389,12 @@ void EventDispatcher::associateNodeAndEventListener(Node* node, EventListener* l
     }
     
     listeners->push_back(listener);
+
+    if (listener->_type == EventListener::Type::TOUCH_ONE_BY_ONE
+        && static_cast<EventListenerTouchOneByOne*>(listener)->_touchBoundsCulling)
+    {
+        addTouchBounds(node);
+    }
 }
 
 void EventDispatcher::dissociateNodeAndEventListener(Node* node, EventListener* listener)
@@ -430,14 +408,237 @@ void EventDispatcher::dissociateNodeAndEventListener(Node* node, EventListener*
         if (iter != listeners->end())
         {
             listeners->erase(iter);
+
+            if (listener->_type == EventListener::Type::TOUCH_ONE_BY_ONE
+                && static_cast<EventListenerTouchOneByOne*>(listener)->_touchBoundsCulling)
+            {
+                removeTouchBounds(node);
+            }
         }
         
         if (listeners->empty())
         {
             _nodeListenersMap.erase(found);
             delete listeners;
+            // the node isn't set dirty while it has no listeners, its priority is computed again if it gets one
+            _nodePriorityMap.erase(node);
+        }
+    }
+}
+
+static int getTouchGridCell(float coordinate, float cellSize)
+{
+    // clamp so that huge or far away bounds can't overflow the cell coordinates
+    float cell = std::floor(coordinate / cellSize);
+    return static_cast<int>(clampf(cell, -(1 << 24), 1 << 24));
+}
+
+static int64_t getTouchGridKey(int cellX, int cellY)
+{
+    return (static_cast<int64_t>(cellX) << 32) | static_cast<uint32_t>(cellY);
+}
+
+void EventDispatcher::addTouchBounds(Node* node)
+{
+    auto found = _touchBoundsMap.find(node);
+    if (found != _touchBoundsMap.end())
+    {
+        ++found->second.listenerCount;
+        return;
+    }
+
+    TouchBounds bounds;
+    bounds.minCellX = bounds.minCellY = bounds.maxCellX = bounds.maxCellY = 0;
+    bounds.listenerCount = 1;
+    bounds.inGrid = false;
+    bounds.dirty = false;
+    updateTouchBounds(node, bounds);
+
+    std::lock_guard<std::mutex> lock(_dirtyTouchBoundsMutex);
+    _touchBoundsMap.emplace(node, bounds);
+    node->_touchBoundsIndexed = true;
+}
+
+void EventDispatcher::removeTouchBounds(Node* node)
+{
+    auto found = _touchBoundsMap.find(node);
+    if (found == _touchBoundsMap.end() || --found->second.listenerCount > 0)
+        return;
+
+    removeTouchBoundsFromGrid(node, found->second);
+
+    std::lock_guard<std::mutex> lock(_dirtyTouchBoundsMutex);
+    _touchBoundsMap.erase(found);
+    node->_touchBoundsIndexed = false;
+}
+
+void EventDispatcher::setTouchBoundsDirtyForNode(Node* node)
+{
+    std::lock_guard<std::mutex> lock(_dirtyTouchBoundsMutex);
+    auto found = _touchBoundsMap.find(node);
+    if (found != _touchBoundsMap.end() && !found->second.dirty)
+    {
+        found->second.dirty = true;
+        _dirtyTouchBoundsNodes.push_back(node);
+    }
+}
+
+void EventDispatcher::updateTouchBounds(Node* node, TouchBounds& bounds)
+{
+    removeTouchBoundsFromGrid(node, bounds);
+    bounds.rect = RectApplyTransform(Rect(Vec2::ZERO, node->getContentSize()), node->getNodeToWorldTransform());
+    insertTouchBoundsInGrid(node, bounds);
+}
+
+void EventDispatcher::insertTouchBoundsInGrid(Node* node, TouchBounds& bounds)
+{
+    bounds.minCellX = getTouchGridCell(bounds.rect.getMinX(), _touchGridCellSize);
+    bounds.minCellY = getTouchGridCell(bounds.rect.getMinY(), _touchGridCellSize);
+    bounds.maxCellX = getTouchGridCell(bounds.rect.getMaxX(), _touchGridCellSize);
+    bounds.maxCellY = getTouchGridCell(bounds.rect.getMaxY(), _touchGridCellSize);
+    bounds.inGrid = true;
+
+    int64_t cellCount = static_cast<int64_t>(bounds.maxCellX - bounds.minCellX + 1) * (bounds.maxCellY - bounds.minCellY + 1);
+    if (cellCount > MAX_TOUCH_GRID_CELLS_PER_NODE)
+    {
+        _touchGridOversizedNodes.push_back(node);
+        return;
+    }
+
+    for (int y = bounds.minCellY; y <= bounds.maxCellY; ++y)
+    {
+        for (int x = bounds.minCellX; x <= bounds.maxCellX; ++x)
+        {
+            _touchGrid[getTouchGridKey(x, y)].push_back(node);
+        }
+    }
+}
+
+void EventDispatcher::removeTouchBoundsFromGrid(Node* node, TouchBounds& bounds)
+{
+    if (!bounds.inGrid)
+        return;
+
+    bounds.inGrid = false;
+
+    int64_t cellCount = static_cast<int64_t>(bounds.maxCellX - bounds.minCellX + 1) * (bounds.maxCellY - bounds.minCellY + 1);
+    if (cellCount > MAX_TOUCH_GRID_CELLS_PER_NODE)
+    {
+        auto iter = std::find(_touchGridOversizedNodes.begin(), _touchGridOversizedNodes.end(), node);
+        if (iter != _touchGridOversizedNodes.end())
+        {
+            *iter = _touchGridOversizedNodes.back();
+            _touchGridOversizedNodes.pop_back();
+        }
+        return;
+    }
+
+    for (int y = bounds.minCellY; y <= bounds.maxCellY; ++y)
+    {
+        for (int x = bounds.minCellX; x <= bounds.maxCellX; ++x)
+        {
+            auto cell = _touchGrid.find(getTouchGridKey(x, y));
+            if (cell == _touchGrid.end())
+                continue;
+
+            auto& nodes = cell->second;
+            auto iter = std::find(nodes.begin(), nodes.end(), node);
+            if (iter != nodes.end())
+            {
+                *iter = nodes.back();
+                nodes.pop_back();
+            }
+            if (nodes.empty())
+            {
+                _touchGrid.erase(cell);
+            }
+        }
+    }
+}
+
+void EventDispatcher::updateTouchGrid()
+{
+    if (_touchGridDirty)
+    {
+        // the cell size changed, lay out all the bounds again
+        _touchGrid.clear();
+        _touchGridOversizedNodes.clear();
+        for (auto& e : _touchBoundsMap)
+        {
+            e.second.inGrid = false;
+            insertTouchBoundsInGrid(e.first, e.second);
+        }
+        _touchGridDirty = false;
+    }
+
+    std::vector<Node*> dirtyNodes;
+    {
+        std::lock_guard<std::mutex> lock(_dirtyTouchBoundsMutex);
+        dirtyNodes.swap(_dirtyTouchBoundsNodes);
+    }
+
+    for (auto node : dirtyNodes)
+    {
+        // the node may have lost its listeners since it was marked dirty
+        auto found = _touchBoundsMap.find(node);
+        if (found == _touchBoundsMap.end() || !found->second.dirty)
+            continue;
+
+        found->second.dirty = false;
+        updateTouchBounds(node, found->second);
+    }
+}
+
+unsigned int EventDispatcher::hitTestTouchGrid(const Vec2& location)
+{
+    // serial 0 is never used, it's the serial of the listeners that were never hit
+    if (++_touchHitSerial == 0)
+        ++_touchHitSerial;
+
+    auto hitNode = [this, &location](Node* node) {
+        auto bounds = _touchBoundsMap.find(node);
+        if (bounds == _touchBoundsMap.end() || !bounds->second.rect.containsPoint(location))
+            return;
+
+        auto listeners = _nodeListenersMap.find(node);
+        if (listeners == _nodeListenersMap.end())
+            return;
+
+        for (auto& l : *listeners->second)
+        {
+            if (l->_type == EventListener::Type::TOUCH_ONE_BY_ONE)
+            {
+                static_cast<EventListenerTouchOneByOne*>(l)->_touchHitSerial = _touchHitSerial;
+            }
+        }
+    };
+
+    auto cell = _touchGrid.find(getTouchGridKey(getTouchGridCell(location.x, _touchGridCellSize),
+                                                getTouchGridCell(location.y, _touchGridCellSize)));
+    if (cell != _touchGrid.end())
+    {
+        for (auto node : cell->second)
+        {
+            hitNode(node);
         }
     }
+
+    for (auto node : _touchGridOversizedNodes)
+    {
+        hitNode(node);
+    }
+
+    return _touchHitSerial;
+}
+
+void EventDispatcher::setTouchGridCellSize(float cellSize)
+{
+    CCASSERT(cellSize > 0, "The cell size of the touch grid must be positive.");
+    if (cellSize != _touchGridCellSize)
+    {
+        _touchGridCellSize = cellSize;
+        _touchGridDirty = true;
+    }
 }
 
 void EventDispatcher::addEventListener(EventListener* listener)
@@ -462,18 +663,17 @@ void EventDispatcher::addEventListener(EventListener* listener)
 
 void EventDispatcher::forceAddEventListener(EventListener* listener)
 {
-    EventListenerVector* listeners = nullptr;
-    EventListener::ListenerID listenerID = listener->getListenerID();
-    auto itr = _listenerMap.find(listenerID);
-    if (itr == _listenerMap.end())
+    EventListener::InternedID listenerID = listener->getListenerInternedID();
+    if (listenerID >= static_cast<EventListener::InternedID>(_listenerVectors.size()))
     {
-        
-        listeners = new (std::nothrow) EventListenerVector();
-        _listenerMap.emplace(listenerID, listeners);
+        _listenerVectors.resize(listenerID + 1, nullptr);
     }
-    else
+    
+    EventListenerVector* listeners = _listenerVectors[listenerID];
+    if (listeners == nullptr)
     {
-        listeners = itr->second;
+        listeners = new (std::nothrow) EventListenerVector();
+        _listenerVectors[listenerID] = listeners;
     }
     
     listeners->push_back(listener);
@@ -518,10 +718,8 @@ void EventDispatcher::addEventListenerWithSceneGraphPriority(EventListener* list
 void EventDispatcher::debugCheckNodeHasNoEventListenersOnDestruction(Node* node)
 {
     // Check the listeners map
-    for (const auto & keyValuePair : _listenerMap)
+    for (const EventListenerVector * eventListenerVector : _listenerVectors)
     {
-        const EventListenerVector * eventListenerVector = keyValuePair.second;
-        
         if (eventListenerVector)
         {
             if (eventListenerVector->getSceneGraphPriorityListeners())
@@ -644,9 +842,11 @@ void EventDispatcher::removeEventListener(EventListener* listener)
         }
     };
     
-    for (auto iter = _listenerMap.begin(); iter != _listenerMap.end();)
+    // a listener can only be in the vector of its own listener ID
+    EventListener::InternedID listenerID = listener->getListenerInternedID();
+    auto listeners = getListeners(listenerID);
+    if (listeners)
     {
-        auto listeners = iter->second;
         auto fixedPriorityListeners = listeners->getFixedPriorityListeners();
         auto sceneGraphPriorityListeners = listeners->getSceneGraphPriorityListeners();
 
@@ -654,14 +854,14 @@ void EventDispatcher::removeEventListener(EventListener* listener)
         if (isFound)
         {
             // fixed #4160: Dirty flag need to be updated after listeners were removed.
-            setDirty(listener->getListenerID(), DirtyFlag::SCENE_GRAPH_PRIORITY);
+            setDirty(listenerID, DirtyFlag::SCENE_GRAPH_PRIORITY);
         }
         else
         {
             removeListenerInVector(fixedPriorityListeners);
             if (isFound)
             {
-                setDirty(listener->getListenerID(), DirtyFlag::FIXED_PRIORITY);
+                setDirty(listenerID, DirtyFlag::FIXED_PRIORITY);
             }
         }
         
@@ -677,20 +877,12 @@ void EventDispatcher::removeEventListener(EventListener* listener)
                  "Listener should be in no lists after this is done if we're not currently in dispatch mode.");
 #endif
 
-        if (iter->second->empty())
-        {
-            _priorityDirtyFlagMap.erase(listener->getListenerID());
-            auto list = iter->second;
-            iter = _listenerMap.erase(iter);
-            CC_SAFE_DELETE(list);
-        }
-        else
+        if (listeners->empty())
         {
-            ++iter;
+            _priorityDirtyFlags[listenerID] = DirtyFlag::NONE;
+            _listenerVectors[listenerID] = nullptr;
+            CC_SAFE_DELETE(listeners);
         }
-        
-        if (isFound)
-            break;
     }
 
     if (isFound)
@@ -717,9 +909,10 @@ void EventDispatcher::setPriority(EventListener* listener, int fixedPriority)
     if (listener == nullptr)
         return;
     
-    for (auto& iter : _listenerMap)
+    auto listeners = getListeners(listener->getListenerInternedID());
+    if (listeners)
     {
-        auto fixedPriorityListeners = iter.second->getFixedPriorityListeners();
+        auto fixedPriorityListeners = listeners->getFixedPriorityListeners();
         if (fixedPriorityListeners)
         {
             auto found = std::find(fixedPriorityListeners->begin(), fixedPriorityListeners->end(), listener);
@@ -730,7 +923,7 @@ void EventDispatcher::setPriority(EventListener* listener, int fixedPriority)
                 if (listener->getFixedPriority() != fixedPriority)
                 {
                     listener->setFixedPriority(fixedPriority);
-                    setDirty(listener->getListenerID(), DirtyFlag::FIXED_PRIORITY);
+                    setDirty(listener->getListenerInternedID(), DirtyFlag::FIXED_PRIORITY);
                 }
                 return;
             }
@@ -921,11 +1114,9 @@ void EventDispatcher::dispatchEvent(Event* event)
     if (event->getType() == Event::Type::MOUSE) {
         pfnDispatchEventToListeners = &EventDispatcher::dispatchTouchEventToListeners;
     }
-    auto iter = _listenerMap.find(listenerID);
-    if (iter != _listenerMap.end())
+    auto listeners = getListeners(listenerID);
+    if (listeners)
     {
-        auto listeners = iter->second;
-        
         auto onEvent = [&event](EventListener* listener) -> bool{
             event->setCurrentTarget(listener->getAssociatedNode());
             listener->_onEvent(event);
@@ -940,23 +1131,59 @@ void EventDispatcher::dispatchEvent(Event* event)
 
 void EventDispatcher::dispatchCustomEvent(const std::string &eventName, void *optionalUserData)
 {
+    // Names with listeners are interned, which avoids copying the name into the event
+    auto eventID = EventListener::findInternedListenerID(eventName);
+    if (eventID != EventListener::INVALID_INTERNED_ID)
+    {
+        dispatchCustomEvent(eventID, optionalUserData);
+        return;
+    }
+    
     EventCustom ev(eventName);
     ev.setUserData(optionalUserData);
     dispatchEvent(&ev);
 }
 
+void EventDispatcher::dispatchCustomEvent(EventListener::InternedID eventID, void *optionalUserData)
+{
+    EventCustom ev(eventID);
+    ev.setUserData(optionalUserData);
+    dispatchEvent(&ev);
+}
+
 bool EventDispatcher::hasEventListener(const EventListener::ListenerID& listenerID) const
 {
-    return getListeners(listenerID) != nullptr;
+    // vectors of listener IDs stay allocated once they were used
+    auto listeners = getListeners(EventListener::findInternedListenerID(listenerID));
+    return listeners != nullptr && !listeners->empty();
+}
+
+// the location of a touch on the z = 0 plane of the world, as seen by the camera
+static Vec2 getTouchLocationInWorld(const Camera* camera, const Vec2& location)
+{
+    Vec3 nearPoint = camera->unprojectGL(Vec3(location.x, location.y, 0.0f));
+    Vec3 farPoint = camera->unprojectGL(Vec3(location.x, location.y, 1.0f));
+    float dz = farPoint.z - nearPoint.z;
+    if (dz == 0.0f)
+        return Vec2(nearPoint.x, nearPoint.y);
+
+    float t = -nearPoint.z / dz;
+    return Vec2(nearPoint.x + (farPoint.x - nearPoint.x) * t, nearPoint.y + (farPoint.y - nearPoint.y) * t);
 }
 
 void EventDispatcher::dispatchTouchEvent(EventTouch* event)
 {
-    sortEventListeners(EventListenerTouchOneByOne::LISTENER_ID);
-    sortEventListeners(EventListenerTouchAllAtOnce::LISTENER_ID);
+    sortEventListeners(__getTouchOneByOneListenerID());
+    sortEventListeners(__getTouchAllAtOnceListenerID());
+    
+    auto oneByOneListeners = getListeners(__getTouchOneByOneListenerID());
+    auto allAtOnceListeners = getListeners(__getTouchAllAtOnceListenerID());
     
-    auto oneByOneListeners = getListeners(EventListenerTouchOneByOne::LISTENER_ID);
-    auto allAtOnceListeners = getListeners(EventListenerTouchAllAtOnce::LISTENER_ID);
+    // Empty vectors are kept for reuse, treat them as no listeners
+    if (oneByOneListeners && oneByOneListeners->empty())
+        oneByOneListeners = nullptr;
+    if (allAtOnceListeners && allAtOnceListeners->empty())
+        allAtOnceListeners = nullptr;
     
     // If there aren't any touch listeners, return directly.
     if (nullptr == oneByOneListeners && nullptr == allAtOnceListeners)
@@ -975,9 +1202,23 @@ void EventDispatcher::dispatchTouchEvent(EventTouch* event)
     {
         auto mutableTouchesIter = mutableTouches.begin();
         
+        // listeners culled by bounds are tested against the grid, in the world seen by the default camera
+        auto scene = Director::getInstance()->getRunningScene();
+        Camera* defaultCamera = nullptr;
+        if (scene && !_touchBoundsMap.empty() && event->getEventCode() == EventTouch::EventCode::BEGAN)
+        {
+            defaultCamera = scene->getDefaultCamera();
+            updateTouchGrid();
+        }
+        
         for (auto& touches : originalTouches)
         {
             bool isSwallowed = false;
+            unsigned int hitSerial = 0;
+            if (defaultCamera)
+            {
+                hitSerial = hitTestTouchGrid(getTouchLocationInWorld(defaultCamera, touches->getLocation()));
+            }
 
             auto onTouchEvent = [&](EventListener* l) -> bool { // Return true to break
                 EventListenerTouchOneByOne* listener = static_cast<EventListenerTouchOneByOne*>(l);
@@ -985,6 +1226,11 @@ void EventDispatcher::dispatchTouchEvent(EventTouch* event)
                 // Skip if the listener was removed.
                 if (!listener->_isRegistered)
                     return false;
+                
+                // Skip if the touch began outside of the bounds of the listener's node.
+                if (hitSerial != 0 && listener->_touchBoundsCulling && listener->_touchHitSerial != hitSerial
+                    && listener->_node && Camera::getVisitingCamera() == defaultCamera)
+                    return false;
              
                 event->setCurrentTarget(listener->_node);
                 
@@ -1150,13 +1396,12 @@ void EventDispatcher::updateListeners(Event* event)
     if (_inDispatch > 1)
         return;
 
-    auto onUpdateListeners = [this](const EventListener::ListenerID& listenerID)
+    auto onUpdateListeners = [this](EventListener::InternedID listenerID)
     {
-        auto listenersIter = _listenerMap.find(listenerID);
-        if (listenersIter == _listenerMap.end())
+        auto listeners = getListeners(listenerID);
+        if (listeners == nullptr)
             return;
 
-        auto listeners = listenersIter->second;
         
         auto fixedPriorityListeners = listeners->getFixedPriorityListeners();
         auto sceneGraphPriorityListeners = listeners->getSceneGraphPriorityListeners();
@@ -1216,8 +1461,8 @@ void EventDispatcher::updateListeners(Event* event)
 
     if (event->getType() == Event::Type::TOUCH)
     {
-        onUpdateListeners(EventListenerTouchOneByOne::LISTENER_ID);
-        onUpdateListeners(EventListenerTouchAllAtOnce::LISTENER_ID);
+        onUpdateListeners(__getTouchOneByOneListenerID());
+        onUpdateListeners(__getTouchAllAtOnceListenerID());
     }
     else
     {
@@ -1226,19 +1471,7 @@ void EventDispatcher::updateListeners(Event* event)
     
     CCASSERT(_inDispatch == 1, "_inDispatch should be 1 here.");
     
-    for (auto iter = _listenerMap.begin(); iter != _listenerMap.end();)
-    {
-        if (iter->second->empty())
-        {
-            _priorityDirtyFlagMap.erase(iter->first);
-            delete iter->second;
-            iter = _listenerMap.erase(iter);
-        }
-        else
-        {
-            ++iter;
-        }
-    }
+    // Empty listener vectors are kept, they are indexed by listener ID and reused when listeners are added again
     
     if (!_toAddedListeners.empty())
     {
@@ -1264,9 +1497,12 @@ void EventDispatcher::updateDirtyFlagForSceneGraph()
             auto iter = _nodeListenersMap.find(node);
             if (iter != _nodeListenersMap.end())
             {
+                // the priority is computed again when the listeners are sorted
+                _nodePriorityMap.erase(node);
+                
                 for (auto& l : *iter->second)
                 {
-                    setDirty(l->getListenerID(), DirtyFlag::SCENE_GRAPH_PRIORITY);
+                    setDirty(l->getListenerInternedID(), DirtyFlag::SCENE_GRAPH_PRIORITY);
                 }
             }
         }
@@ -1275,20 +1511,19 @@ void EventDispatcher::updateDirtyFlagForSceneGraph()
     }
 }
 
-void EventDispatcher::sortEventListeners(const EventListener::ListenerID& listenerID)
+void EventDispatcher::sortEventListeners(EventListener::InternedID listenerID)
 {
     DirtyFlag dirtyFlag = DirtyFlag::NONE;
     
-    auto dirtyIter = _priorityDirtyFlagMap.find(listenerID);
-    if (dirtyIter != _priorityDirtyFlagMap.end())
+    if (listenerID >= 0 && listenerID < static_cast<EventListener::InternedID>(_priorityDirtyFlags.size()))
     {
-        dirtyFlag = dirtyIter->second;
+        dirtyFlag = _priorityDirtyFlags[listenerID];
     }
     
     if (dirtyFlag != DirtyFlag::NONE)
     {
         // Clear the dirty flag first, if `rootNode` is nullptr, then set its dirty flag of scene graph priority
-        dirtyIter->second = DirtyFlag::NONE;
+        _priorityDirtyFlags[listenerID] = DirtyFlag::NONE;
 
         if ((int)dirtyFlag & (int)DirtyFlag::FIXED_PRIORITY)
         {
@@ -1304,13 +1539,51 @@ void EventDispatcher::sortEventListeners(const EventListener::ListenerID& listen
             }
             else
             {
-                dirtyIter->second = DirtyFlag::SCENE_GRAPH_PRIORITY;
+                _priorityDirtyFlags[listenerID] = DirtyFlag::SCENE_GRAPH_PRIORITY;
             }
         }
     }
 }
 
-void EventDispatcher::sortEventListenersOfSceneGraphPriority(const EventListener::ListenerID& listenerID, Node* rootNode)
+void EventDispatcher::updateNodePriority(Node* node, Node* rootNode, NodePriority& priority)
+{
+    // A node is drawn between its children with a negative local Z order and the others, and a ProtectedNode
+    // draws its protected children after its children with the same sign of local Z order,
+    // so each level of the path is the draw group of the node followed by its sort key among its siblings
+    auto& path = priority.path;
+    path.clear();
+    path.push_back(DRAW_GROUP_SELF);
+    
+    Node* n = node;
+    for (Node* parent = n->getParent(); parent; n = parent, parent = n->getParent())
+    {
+        auto protectedParent = dynamic_cast<ProtectedNode*>(parent);
+        bool isProtected = protectedParent && protectedParent->getProtectedChildren().contains(n);
+        bool isNegative = n->getLocalZOrder() < 0;
+        path.push_back(n->_localZOrderAndArrival);
+        if (isProtected)
+            path.push_back(isNegative ? DRAW_GROUP_NEGATIVE_PROTECTED_CHILDREN : DRAW_GROUP_PROTECTED_CHILDREN);
+        else
+            path.push_back(isNegative ? DRAW_GROUP_NEGATIVE_CHILDREN : DRAW_GROUP_CHILDREN);
+    }
+    std::reverse(path.begin(), path.end());
+    
+    priority.inScene = (n == rootNode);
+    priority.globalZOrder = node->getGlobalZOrder();
+}
+
+bool EventDispatcher::isDrawnBefore(const NodePriority& p1, const NodePriority& p2)
+{
+    if (p1.inScene != p2.inScene)
+        return !p1.inScene;
+    
+    if (p1.globalZOrder != p2.globalZOrder)
+        return p1.globalZOrder < p2.globalZOrder;
+    
+    return std::lexicographical_compare(p1.path.begin(), p1.path.end(), p2.path.begin(), p2.path.end());
+}
+
+void EventDispatcher::sortEventListenersOfSceneGraphPriority(EventListener::InternedID listenerID, Node* rootNode)
 {
     auto listeners = getListeners(listenerID);
     
@@ -1321,27 +1594,50 @@ void EventDispatcher::sortEventListenersOfSceneGraphPriority(const EventListener
     if (sceneGraphListeners == nullptr)
         return;
 
-    // Reset priority index
-    _nodePriorityIndex = 0;
-    _nodePriorityMap.clear();
-
-    visitTarget(rootNode, true);
+    // Priorities are only valid in the scene they were computed in
+    if (rootNode != _nodePriorityScene)
+    {
+        _nodePriorityMap.clear();
+        _nodePriorityScene = rootNode;
+    }
+    
+    // Only nodes that were added or set dirty since the last sort need their priority computed,
+    // which walks up their parents instead of the whole scene graph
+    std::vector<std::pair<const NodePriority*, EventListener*>> sortedListeners;
+    sortedListeners.reserve(sceneGraphListeners->size());
+    for (auto& l : *sceneGraphListeners)
+    {
+        auto node = l->getAssociatedNode();
+        auto found = _nodePriorityMap.find(node);
+        if (found == _nodePriorityMap.end())
+        {
+            found = _nodePriorityMap.emplace(node, NodePriority()).first;
+            updateNodePriority(node, rootNode, found->second);
+        }
+        sortedListeners.emplace_back(&found->second, l);
+    }
     
     // After sort: priority < 0, > 0
-    std::stable_sort(sceneGraphListeners->begin(), sceneGraphListeners->end(), [this](const EventListener* l1, const EventListener* l2) {
-        return _nodePriorityMap[l1->getAssociatedNode()] > _nodePriorityMap[l2->getAssociatedNode()];
+    std::stable_sort(sortedListeners.begin(), sortedListeners.end(), [](const std::pair<const NodePriority*, EventListener*>& l1, const std::pair<const NodePriority*, EventListener*>& l2) {
+        return isDrawnBefore(*l2.first, *l1.first);
     });
     
+    for (size_t i = 0, size = sortedListeners.size(); i < size; ++i)
+    {
+        (*sceneGraphListeners)[i] = sortedListeners[i].second;
+    }
+    
 #if DUMP_LISTENER_ITEM_PRIORITY_INFO
     log("-----------------------------------");
     for (auto& l : *sceneGraphListeners)
     {
-        log("listener priority: node ([%s]%p), priority (%d)", typeid(*l->_node).name(), l->_node, _nodePriorityMap[l->_node]);
+        auto& priority = _nodePriorityMap[l->_node];
+        log("listener priority: node ([%s]%p), global Z (%f), depth (%d)", typeid(*l->_node).name(), l->_node, priority.globalZOrder, (int)priority.path.size());
     }
 #endif
 }
 
-void EventDispatcher::sortEventListenersOfFixedPriority(const EventListener::ListenerID& listenerID)
+void EventDispatcher::sortEventListenersOfFixedPriority(EventListener::InternedID listenerID)
 {
     auto listeners = getListeners(listenerID);
 
@@ -1378,23 +1674,21 @@ void EventDispatcher::sortEventListenersOfFixedPriority(const EventListener::Lis
     
 }
 
-EventDispatcher::EventListenerVector* EventDispatcher::getListeners(const EventListener::ListenerID& listenerID) const
+EventDispatcher::EventListenerVector* EventDispatcher::getListeners(EventListener::InternedID listenerID) const
 {
-    auto iter = _listenerMap.find(listenerID);
-    if (iter != _listenerMap.end())
+    if (listenerID >= 0 && listenerID < static_cast<EventListener::InternedID>(_listenerVectors.size()))
     {
-        return iter->second;
+        return _listenerVectors[listenerID];
     }
     
     return nullptr;
 }
 
-void EventDispatcher::removeEventListenersForListenerID(const EventListener::ListenerID& listenerID)
+void EventDispatcher::removeEventListenersForListenerID(EventListener::InternedID listenerID)
 {
-    auto listenerItemIter = _listenerMap.find(listenerID);
-    if (listenerItemIter != _listenerMap.end())
+    auto listeners = getListeners(listenerID);
+    if (listeners)
     {
-        auto listeners = listenerItemIter->second;
         auto fixedPriorityListeners = listeners->getFixedPriorityListeners();
         auto sceneGraphPriorityListeners = listeners->getSceneGraphPriorityListeners();
         
@@ -1429,19 +1723,22 @@ void EventDispatcher::removeEventListenersForListenerID(const EventListener::Lis
         
         // Remove the dirty flag according the 'listenerID'.
         // No need to check whether the dispatcher is dispatching event.
-        _priorityDirtyFlagMap.erase(listenerID);
+        if (listenerID < static_cast<EventListener::InternedID>(_priorityDirtyFlags.size()))
+        {
+            _priorityDirtyFlags[listenerID] = DirtyFlag::NONE;
+        }
         
         if (!_inDispatch)
         {
             listeners->clear();
             delete listeners;
-            _listenerMap.erase(listenerItemIter);
+            _listenerVectors[listenerID] = nullptr;
         }
     }
     
     for (auto iter = _toAddedListeners.begin(); iter != _toAddedListeners.end();)
     {
-        if ((*iter)->getListenerID() == listenerID)
+        if ((*iter)->getListenerInternedID() == listenerID)
         {
             (*iter)->setRegistered(false);
             releaseListener(*iter);
@@ -1458,23 +1755,23 @@ void EventDispatcher::removeEventListenersForType(EventListener::Type listenerTy
 {
     if (listenerType == EventListener::Type::TOUCH_ONE_BY_ONE)
     {
-        removeEventListenersForListenerID(EventListenerTouchOneByOne::LISTENER_ID);
+        removeEventListenersForListenerID(__getTouchOneByOneListenerID());
     }
     else if (listenerType == EventListener::Type::TOUCH_ALL_AT_ONCE)
     {
-        removeEventListenersForListenerID(EventListenerTouchAllAtOnce::LISTENER_ID);
+        removeEventListenersForListenerID(__getTouchAllAtOnceListenerID());
     }
     else if (listenerType == EventListener::Type::MOUSE)
     {
-        removeEventListenersForListenerID(EventListenerMouse::LISTENER_ID);
+        removeEventListenersForListenerID(EventListener::internListenerID(EventListenerMouse::LISTENER_ID));
     }
     else if (listenerType == EventListener::Type::ACCELERATION)
     {
-        removeEventListenersForListenerID(EventListenerAcceleration::LISTENER_ID);
+        removeEventListenersForListenerID(EventListener::internListenerID(EventListenerAcceleration::LISTENER_ID));
     }
     else if (listenerType == EventListener::Type::KEYBOARD)
     {
-        removeEventListenersForListenerID(EventListenerKeyboard::LISTENER_ID);
+        removeEventListenersForListenerID(EventListener::internListenerID(EventListenerKeyboard::LISTENER_ID));
     }
     else
     {
@@ -1484,36 +1781,18 @@ void EventDispatcher::removeEventListenersForType(EventListener::Type listenerTy
 
 void EventDispatcher::removeCustomEventListeners(const std::string& customEventName)
 {
-    removeEventListenersForListenerID(customEventName);
+    removeEventListenersForListenerID(EventListener::findInternedListenerID(customEventName));
 }
 
 void EventDispatcher::removeAllEventListeners()
 {
-    bool cleanMap = true;
-    std::vector<EventListener::ListenerID> types;
-    types.reserve(_listenerMap.size());
-    
-    for (const auto& e : _listenerMap)
+    for (EventListener::InternedID listenerID = 0, size = static_cast<EventListener::InternedID>(_listenerVectors.size()); listenerID < size; ++listenerID)
     {
-        if (_internalCustomListenerIDs.find(e.first) != _internalCustomListenerIDs.end())
+        if (_listenerVectors[listenerID] && _internalCustomListenerIDs.find(listenerID) == _internalCustomListenerIDs.end())
         {
-            cleanMap = false;
-        }
-        else
-        {
-            types.push_back(e.first);
+            removeEventListenersForListenerID(listenerID);
         }
     }
-
-    for (const auto& type : types)
-    {
-        removeEventListenersForListenerID(type);
-    }
-    
-    if (!_inDispatch && cleanMap)
-    {
-        _listenerMap.clear();
-    }
 }
 
 void EventDispatcher::setEnabled(bool isEnabled)
@@ -1531,6 +1810,7 @@ void EventDispatcher::setDirtyForNode(Node* node)
     // Mark the node dirty only when there is an eventlistener associated with it. 
     if (_nodeListenersMap.find(node) != _nodeListenersMap.end())
     {
+        std::lock_guard<std::mutex> lock(_dirtyNodesMutex);
         _dirtyNodes.insert(node);
     }
 
@@ -1540,35 +1820,41 @@ void EventDispatcher::setDirtyForNode(Node* node)
     {
         setDirtyForNode(child);
     }
-}
 
-void EventDispatcher::setDirty(const EventListener::ListenerID& listenerID, DirtyFlag flag)
-{    
-    auto iter = _priorityDirtyFlagMap.find(listenerID);
-    if (iter == _priorityDirtyFlagMap.end())
+    // and for its protected children, they are drawn with the children
+    auto protectedNode = dynamic_cast<ProtectedNode*>(node);
+    if (protectedNode)
     {
-        _priorityDirtyFlagMap.emplace(listenerID, flag);
+        for (const auto& child : protectedNode->getProtectedChildren())
+        {
+            setDirtyForNode(child);
+        }
     }
-    else
+}
+
+void EventDispatcher::setDirty(EventListener::InternedID listenerID, DirtyFlag flag)
+{    
+    if (listenerID >= static_cast<EventListener::InternedID>(_priorityDirtyFlags.size()))
     {
-        int ret = (int)flag | (int)iter->second;
-        iter->second = (DirtyFlag) ret;
+        _priorityDirtyFlags.resize(listenerID + 1, DirtyFlag::NONE);
     }
+    
+    int ret = (int)flag | (int)_priorityDirtyFlags[listenerID];
+    _priorityDirtyFlags[listenerID] = (DirtyFlag) ret;
 }
 
 void EventDispatcher::cleanToRemovedListeners()
 {
     for (auto& l : _toRemovedListeners)
     {
-        auto listenersIter = _listenerMap.find(l->getListenerID());
-        if (listenersIter == _listenerMap.end())
+        auto listeners = getListeners(l->getListenerInternedID());
+        if (listeners == nullptr)
         {
             releaseListener(l);
             continue;
         }
 
         bool find = false;
-        auto listeners = listenersIter->second;
         auto fixedPriorityListeners = listeners->getFixedPriorityListeners();
         auto sceneGraphPriorityListeners = listeners->getSceneGraphPriorityListeners();
 
@@ -30,11 +30,13 @@
 #include <unordered_map>
 #include <vector>
 #include <set>
+#include <mutex>
 
 #include "platform/CCPlatformMacros.h"
 #include "base/CCEventListener.h"
 #include "base/CCEvent.h"
 #include "platform/CCStdC.h"
+#include "math/CCGeometry.h"
 
 /**
  * @addtogroup base
@@ -171,12 +173,23 @@ public:
     void dispatchEvent(Event* event);
 
     /** Dispatches a Custom Event with a event name an optional user data.
+     *  The name is hashed and looked up under a lock on every call, events dispatched often should be
+     *  dispatched by their interned ID instead, see EventListener::internListenerID().
      *
      * @param eventName The name of the event which needs to be dispatched.
      * @param optionalUserData The optional user data, it's a void*, the default value is nullptr.
      */
     void dispatchCustomEvent(const std::string &eventName, void *optionalUserData = nullptr);
 
+    /** Dispatches a Custom Event with an interned event name and an optional user data.
+     *  The event is created on the stack and neither the name nor the listeners are looked up by string.
+     *
+     * @param eventID The interned name of the event, see EventListener::internListenerID().
+     * @param optionalUserData The optional user data, it's a void*, the default value is nullptr.
+     * @since v3.16
+     */
+    void dispatchCustomEvent(EventListener::InternedID eventID, void *optionalUserData = nullptr);
+
     /** Query whether the specified event listener id has been added.
      *
      * @param listenerID The listenerID of the event listener id.
@@ -187,6 +200,23 @@ public:
 
     /////////////////////////////////////////////
     
+    /** Sets the size of the grid cells that index the bounds of touch listeners.
+     *  @see EventListenerTouchOneByOne::setTouchBoundsCullingEnabled
+     *
+     * @param cellSize The width and height of a cell in points, 128 by default.
+     * @since v3.16
+     */
+    void setTouchGridCellSize(float cellSize);
+
+    /** Gets the size of the grid cells that index the bounds of touch listeners.
+     *
+     * @return The width and height of a cell in points.
+     * @since v3.16
+     */
+    float getTouchGridCellSize() const { return _touchGridCellSize; }
+
+    /////////////////////////////////////////////
+    
     /** Constructor of EventDispatcher.
      */
     EventDispatcher();
@@ -209,6 +239,9 @@ protected:
     
     /** Sets the dirty flag for a node. */
     void setDirtyForNode(Node* node);
+
+    /** Marks the bounds of a node indexed for touches as dirty, it's called when the node's transform or content size changes. */
+    void setTouchBoundsDirtyForNode(Node* node);
     
     /**
      *  The vector to store event listeners with scene graph based priority and fixed priority.
@@ -249,22 +282,22 @@ protected:
     void forceAddEventListener(EventListener* listener);
     
     /** Gets event the listener list for the event listener type. */
-    EventListenerVector* getListeners(const EventListener::ListenerID& listenerID) const;
+    EventListenerVector* getListeners(EventListener::InternedID listenerID) const;
     
     /** Update dirty flag */
     void updateDirtyFlagForSceneGraph();
     
     /** Removes all listeners with the same event listener ID */
-    void removeEventListenersForListenerID(const EventListener::ListenerID& listenerID);
+    void removeEventListenersForListenerID(EventListener::InternedID listenerID);
     
     /** Sort event listener */
-    void sortEventListeners(const EventListener::ListenerID& listenerID);
+    void sortEventListeners(EventListener::InternedID listenerID);
     
     /** Sorts the listeners of specified type by scene graph priority */
-    void sortEventListenersOfSceneGraphPriority(const EventListener::ListenerID& listenerID, Node* rootNode);
+    void sortEventListenersOfSceneGraphPriority(EventListener::InternedID listenerID, Node* rootNode);
     
     /** Sorts the listeners of specified type by fixed priority */
-    void sortEventListenersOfFixedPriority(const EventListener::ListenerID& listenerID);
+    void sortEventListenersOfFixedPriority(EventListener::InternedID listenerID);
     
     /** Updates all listeners
      *  1) Removes all listener items that have been marked as 'removed' when dispatching event.
@@ -306,28 +339,68 @@ protected:
     };
     
     /** Sets the dirty flag for a specified listener ID */
-    void setDirty(const EventListener::ListenerID& listenerID, DirtyFlag flag);
+    void setDirty(EventListener::InternedID listenerID, DirtyFlag flag);
+    
+    /** The draw order of a node: its global Z order, then the draw groups and sort keys of the node and its ancestors from the scene down */
+    struct NodePriority
+    {
+        bool inScene;
+        float globalZOrder;
+        std::vector<int64_t> path;
+    };
     
-    /** Walks though scene graph to get the draw order for each node, it's called before sorting event listener with scene graph priority */
-    void visitTarget(Node* node, bool isRootNode);
+    /** Computes the draw order of a node from its path to the root, it's called before sorting event listener with scene graph priority */
+    void updateNodePriority(Node* node, Node* rootNode, NodePriority& priority);
+    
+    /** Whether visiting the scene graph draws the first node before the second one, nodes out of the scene come first */
+    static bool isDrawnBefore(const NodePriority& p1, const NodePriority& p2);
 
     /** Remove all listeners in _toRemoveListeners list and cleanup */
     void cleanToRemovedListeners();
 
-    /** Listeners map */
-    std::unordered_map<EventListener::ListenerID, EventListenerVector*> _listenerMap;
+    /** The world bounding box of a node whose touch listeners are culled by bounds, and the grid cells it covers */
+    struct TouchBounds
+    {
+        Rect rect;
+        int minCellX, minCellY, maxCellX, maxCellY;
+        int listenerCount;
+        bool inGrid;
+        bool dirty;
+    };
+
+    /** Starts indexing the bounds of the node of a listener culled by bounds */
+    void addTouchBounds(Node* node);
+
+    /** Stops indexing the bounds of the node of a listener culled by bounds */
+    void removeTouchBounds(Node* node);
+
+    /** Recomputes the bounds of a node and moves it to the cells it covers now */
+    void updateTouchBounds(Node* node, TouchBounds& bounds);
+
+    /** Adds or removes a node from the grid cells of its bounds */
+    void insertTouchBoundsInGrid(Node* node, TouchBounds& bounds);
+    void removeTouchBoundsFromGrid(Node* node, TouchBounds& bounds);
+
+    /** Refreshes dirty bounds and rebuilds the grid, it's called before dispatching a touch began event */
+    void updateTouchGrid();
+
+    /** Stamps the listeners whose node contains the location with a new hit serial and returns it */
+    unsigned int hitTestTouchGrid(const Vec2& location);
+
+    /** Listeners indexed by interned listener ID, nullptr for IDs without listeners */
+    std::vector<EventListenerVector*> _listenerVectors;
     
-    /** The map of dirty flag */
-    std::unordered_map<EventListener::ListenerID, DirtyFlag> _priorityDirtyFlagMap;
+    /** Dirty flags indexed by interned listener ID */
+    std::vector<DirtyFlag> _priorityDirtyFlags;
     
     /** The map of node and event listeners */
     std::unordered_map<Node*, std::vector<EventListener*>*> _nodeListenersMap;
     
-    /** The map of node and its event priority */
-    std::unordered_map<Node*, int> _nodePriorityMap;
+    /** The map of node and its event priority, entries of dirty nodes are erased and computed again when sorting */
+    std::unordered_map<Node*, NodePriority> _nodePriorityMap;
     
-    /** key: Global Z Order, value: Sorted Nodes */
-    std::unordered_map<float, std::vector<Node*>> _globalZOrderNodeMap;
+    /** The scene the priorities of _nodePriorityMap were computed in */
+    Node* _nodePriorityScene;
     
     /** The listeners to be added after dispatching event */
     std::vector<EventListener*> _toAddedListeners;
@@ -337,6 +410,8 @@ protected:
 
     /** The nodes were associated with scene graph based priority listeners */
     std::set<Node*> _dirtyNodes;
+    // nodes may be set dirty by threads visiting the scene in parallel
+    std::mutex _dirtyNodesMutex;
     
     /** Whether the dispatcher is dispatching event */
     int _inDispatch;
@@ -344,9 +419,25 @@ protected:
     /** Whether to enable dispatching event */
     bool _isEnabled;
     
-    int _nodePriorityIndex;
-    
-    std::set<std::string> _internalCustomListenerIDs;
+    std::set<EventListener::InternedID> _internalCustomListenerIDs;
+
+    /** The bounds of the nodes whose touch listeners are culled by bounds */
+    std::unordered_map<Node*, TouchBounds> _touchBoundsMap;
+
+    /** key: the cell coordinates packed in 64 bits, value: the nodes whose bounds overlap the cell */
+    std::unordered_map<int64_t, std::vector<Node*>> _touchGrid;
+
+    /** Nodes whose bounds cover too many cells to be put in the grid, they are always tested */
+    std::vector<Node*> _touchGridOversizedNodes;
+
+    /** Nodes whose bounds changed since the last touch */
+    std::vector<Node*> _dirtyTouchBoundsNodes;
+    // nodes may be set dirty by threads visiting the scene in parallel
+    std::mutex _dirtyTouchBoundsMutex;
+
+    float _touchGridCellSize;
+    bool _touchGridDirty;
+    unsigned int _touchHitSerial;
 };
 
 
@@ -25,9 +25,63 @@
 #include "base/CCEventListener.h"
 #include "base/CCConsole.h"
 
+#include <deque>
+#include <mutex>
+#include <unordered_map>
+
 NS_CC_BEGIN
 
+namespace
+{
+    // listener IDs are interned once and never released, so the references to them stay valid
+    struct InternedListenerIDs
+    {
+        std::mutex mutex;
+        std::unordered_map<EventListener::ListenerID, EventListener::InternedID> internedIDs;
+        std::deque<EventListener::ListenerID> listenerIDs;
+    };
+
+    InternedListenerIDs& getInternedListenerIDs()
+    {
+        static InternedListenerIDs s_internedListenerIDs;
+        return s_internedListenerIDs;
+    }
+}
+
+const EventListener::InternedID EventListener::INVALID_INTERNED_ID;
+
+EventListener::InternedID EventListener::internListenerID(const ListenerID& listenerID)
+{
+    auto& interned = getInternedListenerIDs();
+    std::lock_guard<std::mutex> lock(interned.mutex);
+    auto found = interned.internedIDs.find(listenerID);
+    if (found != interned.internedIDs.end())
+        return found->second;
+
+    InternedID internedID = static_cast<InternedID>(interned.listenerIDs.size());
+    interned.listenerIDs.push_back(listenerID);
+    interned.internedIDs.emplace(listenerID, internedID);
+    return internedID;
+}
+
+EventListener::InternedID EventListener::findInternedListenerID(const ListenerID& listenerID)
+{
+    auto& interned = getInternedListenerIDs();
+    std::lock_guard<std::mutex> lock(interned.mutex);
+    auto found = interned.internedIDs.find(listenerID);
+    return found != interned.internedIDs.end() ? found->second : INVALID_INTERNED_ID;
+}
+
+const EventListener::ListenerID& EventListener::getInternedListenerID(InternedID internedID)
+{
+    auto& interned = getInternedListenerIDs();
+    std::lock_guard<std::mutex> lock(interned.mutex);
+    CCASSERT(internedID >= 0 && internedID < static_cast<InternedID>(interned.listenerIDs.size()), "Invalid interned listener ID!");
+    return interned.listenerIDs[internedID];
+}
+
 EventListener::EventListener()
+: _listenerInternedID(INVALID_INTERNED_ID)
 {}
     
 EventListener::~EventListener() 
@@ -40,6 +94,7 @@ bool EventListener::init(Type t, const ListenerID& listenerID, const std::functi
     _onEvent = callback;
     _type = t;
     _listenerID = listenerID;
+    _listenerInternedID = internListenerID(listenerID);
     _isRegistered = false;
     _paused = true;
     _isEnabled = true;
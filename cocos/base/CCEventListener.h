@@ -66,6 +66,41 @@ public:
 
     typedef std::string ListenerID;
 
+    /** An integer standing for a ListenerID, listeners are looked up by it when dispatching.
+     * @since v3.16
+     */
+    typedef int InternedID;
+
+    /** The interned ID of no listener ID. @since v3.16 */
+    static const InternedID INVALID_INTERNED_ID = -1;
+
+    /** Gets the interned ID of a listener ID, interning it on first use.
+     *  Resolve the name of a custom event once and keep its ID to dispatch it without looking up strings.
+     *  Interned names are never released. Listeners intern their listener ID too, so custom events should use
+     *  a fixed set of names rather than names built at runtime.
+     *
+     * @param listenerID The listener ID, the name of the event for custom events.
+     * @return The interned ID, it stays the same for the lifetime of the program.
+     * @since v3.16
+     */
+    static InternedID internListenerID(const ListenerID& listenerID);
+
+    /** Gets the interned ID of a listener ID if it was already interned.
+     *
+     * @param listenerID The listener ID, the name of the event for custom events.
+     * @return The interned ID, or INVALID_INTERNED_ID if the listener ID was never interned.
+     * @since v3.16
+     */
+    static InternedID findInternedListenerID(const ListenerID& listenerID);
+
+    /** Gets the listener ID of an interned ID.
+     *
+     * @param internedID An interned ID returned by internListenerID().
+     * @return The listener ID.
+     * @since v3.16
+     */
+    static const ListenerID& getInternedListenerID(InternedID internedID);
+
 CC_CONSTRUCTOR_ACCESS:
     /**
      * Constructor
@@ -141,6 +176,9 @@ protected:
      */
     const ListenerID& getListenerID() const { return _listenerID; }
 
+    /** Gets the interned ID of the listener ID of this listener */
+    InternedID getListenerInternedID() const { return _listenerInternedID; }
+
     /** Sets the fixed priority for this listener
      *  @note This method is only used for `fixed priority listeners`, it needs to access a non-zero value.
      *  0 is reserved for scene graph priority listeners
@@ -167,6 +205,7 @@ protected:
 
     Type _type;                             /// Event listener type
     ListenerID _listenerID;                 /// Event listener ID
+    InternedID _listenerInternedID;         /// Interned event listener ID
     bool _isRegistered;                     /// Whether the listener has been added to dispatcher.
 
     int   _fixedPriority;   // The higher the number, the higher the priority, 0 is for scene graph base priority.
@@ -39,6 +39,8 @@ EventListenerTouchOneByOne::EventListenerTouchOneByOne()
 , onTouchEnded(nullptr)
 , onTouchCancelled(nullptr)
 , _needSwallow(false)
+, _touchBoundsCulling(false)
+, _touchHitSerial(0)
 {
 }
 
@@ -67,6 +69,12 @@ bool EventListenerTouchOneByOne::isSwallowTouches()
     return _needSwallow;
 }
 
+void EventListenerTouchOneByOne::setTouchBoundsCullingEnabled(bool enabled)
+{
+    CCASSERT(!isRegistered(), "Bounds culling must be set before the listener is added to the dispatcher.");
+    _touchBoundsCulling = enabled;
+}
+
 EventListenerTouchOneByOne* EventListenerTouchOneByOne::create()
 {
     auto ret = new (std::nothrow) EventListenerTouchOneByOne();
@@ -108,6 +116,7 @@ EventListenerTouchOneByOne* EventListenerTouchOneByOne::clone()
         
         ret->_claimedTouches = _claimedTouches;
         ret->_needSwallow = _needSwallow;
+        ret->_touchBoundsCulling = _touchBoundsCulling;
     }
     else
     {
@@ -68,6 +68,26 @@ public:
      */
     bool isSwallowTouches();
     
+    /** Whether the listener only handles touches that begin inside the bounding box of its node.
+     *
+     * When enabled, the dispatcher indexes the node's world bounding box in a grid and does not
+     * call 'onTouchBegan' for touches outside of it, so large UIs only pay for the listeners that
+     * can actually be hit. Only set it for listeners that never claim touches outside of their node,
+     * and for nodes drawn flat on the z = 0 plane; the bounds follow the node as of the last frame it was visited.
+     * It has no effect on listeners with fixed priority or for cameras other than the scene's default camera.
+     * @note Must be called before the listener is added to the dispatcher.
+     *
+     * @param enabled True if touches outside the node's bounding box should be skipped.
+     * @since v3.16
+     */
+    void setTouchBoundsCullingEnabled(bool enabled);
+    /** Whether touches outside the bounding box of the node are skipped.
+     *
+     * @return True if touches outside the node's bounding box are skipped.
+     * @since v3.16
+     */
+    bool isTouchBoundsCullingEnabled() const { return _touchBoundsCulling; }
+    
     /// Overrides
     virtual EventListenerTouchOneByOne* clone() override;
     virtual bool checkAvailable() override;
@@ -90,6 +110,8 @@ CC_CONSTRUCTOR_ACCESS:
 private:
     std::vector<Touch*> _claimedTouches;
     bool _needSwallow;
+    bool _touchBoundsCulling;
+    unsigned int _touchHitSerial;       // serial of the last touch that hit the node's bounds
     
     friend class EventDispatcher;
 };
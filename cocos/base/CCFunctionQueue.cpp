@@ -0,0 +1,247 @@
+/****************************************************************************
+Copyright (c) 2017 Chukong Technologies Inc.
+
+http://www.cocos2d-x.org
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+****************************************************************************/
+
+#include "base/CCFunctionQueue.h"
+
+#include <algorithm>
+#include <functional>
+
+NS_CC_BEGIN
+
+// Scheduler::performFunctionInCocosThread() queues std::function objects, they must not allocate
+static_assert(sizeof(std::function<void()>) <= FunctionQueue::INLINE_STORAGE_SIZE, "std::function doesn't fit in the queue nodes");
+
+namespace
+{
+    // recycled nodes above this count are deleted
+    const size_t MAX_FREE_NODE_COUNT = 1024;
+}
+
+struct FunctionQueue::NodeCache
+{
+    Node* nodes = nullptr;
+
+    ~NodeCache()
+    {
+        while (nodes)
+        {
+            Node* next = nodes->next.load(std::memory_order_relaxed);
+            delete nodes;
+            nodes = next;
+        }
+    }
+};
+
+FunctionQueue::FunctionQueue()
+: _tail(&_stub)
+, _pushSequence(0)
+, _discardSequence(0)
+, _poppedCount(0)
+, _freeNodes(nullptr)
+, _freeNodeCount(0)
+, _lastPerformedCount(0)
+, _lastRemainingCount(0)
+, _lastMaxLatency(0)
+, _lastAverageLatency(0)
+, _maxDepth(0)
+, _totalPerformedCount(0)
+{
+    _stub.next.store(nullptr, std::memory_order_relaxed);
+    _head.store(&_stub, std::memory_order_relaxed);
+}
+
+FunctionQueue::~FunctionQueue()
+{
+    while (Node* node = dequeue())
+    {
+        node->destroy(node);
+        delete node;
+    }
+
+    Node* node = _freeNodes.exchange(nullptr, std::memory_order_acquire);
+    while (node)
+    {
+        Node* next = node->next.load(std::memory_order_relaxed);
+        delete node;
+        node = next;
+    }
+}
+
+FunctionQueue::Node* FunctionQueue::allocateNode()
+{
+    // The producers take the whole free list, so it never has to be popped concurrently (ABA problem).
+    // The nodes are not bound to a queue, the cache of the thread can serve any of them.
+    static thread_local NodeCache cache;
+
+    if (cache.nodes == nullptr)
+    {
+        cache.nodes = _freeNodes.exchange(nullptr, std::memory_order_acquire);
+        if (cache.nodes)
+            _freeNodeCount.store(0, std::memory_order_relaxed);
+    }
+
+    Node* node = cache.nodes;
+    if (node)
+    {
+        cache.nodes = node->next.load(std::memory_order_relaxed);
+        return node;
+    }
+    return new (std::nothrow) Node();
+}
+
+void FunctionQueue::recycleNode(Node* node)
+{
+    if (_freeNodeCount.load(std::memory_order_relaxed) >= MAX_FREE_NODE_COUNT)
+    {
+        delete node;
+        return;
+    }
+    _freeNodeCount.fetch_add(1, std::memory_order_relaxed);
+
+    Node* head = _freeNodes.load(std::memory_order_relaxed);
+    do
+    {
+        node->next.store(head, std::memory_order_relaxed);
+    } while (!_freeNodes.compare_exchange_weak(head, node, std::memory_order_release, std::memory_order_relaxed));
+}
+
+void FunctionQueue::enqueue(Node* node)
+{
+    node->next.store(nullptr, std::memory_order_relaxed);
+    Node* prev = _head.exchange(node, std::memory_order_acq_rel);
+    // the queue is not linked until this store, dequeue() returns nullptr meanwhile
+    prev->next.store(node, std::memory_order_release);
+}
+
+FunctionQueue::Node* FunctionQueue::dequeue()
+{
+    Node* tail = _tail;
+    Node* next = tail->next.load(std::memory_order_acquire);
+    if (tail == &_stub)
+    {
+        if (next == nullptr)
+            return nullptr;
+        _tail = next;
+        tail = next;
+        next = next->next.load(std::memory_order_acquire);
+    }
+
+    if (next)
+    {
+        _tail = next;
+        return tail;
+    }
+
+    // tail is the last node, unless a push is in progress
+    if (tail != _head.load(std::memory_order_acquire))
+        return nullptr;
+
+    // put the stub back to keep a node in the queue once tail is popped
+    enqueue(&_stub);
+    next = tail->next.load(std::memory_order_acquire);
+    if (next)
+    {
+        _tail = next;
+        return tail;
+    }
+    return nullptr;
+}
+
+size_t FunctionQueue::perform(float timeBudget)
+{
+    // the functions pushed by the performed ones are left to the next call
+    const uint64_t lastSequence = _pushSequence.load(std::memory_order_acquire);
+    const uint64_t discardSequence = _discardSequence.load(std::memory_order_acquire);
+    const auto start = Clock::now();
+
+    size_t performedCount = 0;
+    double totalLatency = 0;
+    double maxLatency = 0;
+    _maxDepth = std::max(_maxDepth, getSize());
+
+    while (Node* node = dequeue())
+    {
+        _poppedCount.fetch_add(1, std::memory_order_relaxed);
+        const uint64_t sequence = node->sequence;
+
+        if (sequence > discardSequence)
+        {
+            auto now = Clock::now();
+            double latency = std::chrono::duration<double>(now - node->pushTime).count();
+            totalLatency += latency;
+            maxLatency = std::max(maxLatency, latency);
+            ++performedCount;
+
+            node->invoke(node);
+        }
+        node->destroy(node);
+        recycleNode(node);
+
+        if (sequence >= lastSequence)
+            break;
+        if (timeBudget > 0 && std::chrono::duration<float>(Clock::now() - start).count() >= timeBudget)
+            break;
+    }
+
+    _lastPerformedCount = performedCount;
+    _lastRemainingCount = getSize();
+    _lastMaxLatency = maxLatency;
+    _lastAverageLatency = performedCount > 0 ? totalLatency / performedCount : 0;
+    _totalPerformedCount += performedCount;
+
+    return performedCount;
+}
+
+void FunctionQueue::discardAll()
+{
+    uint64_t sequence = _pushSequence.load(std::memory_order_acquire);
+    uint64_t discardSequence = _discardSequence.load(std::memory_order_relaxed);
+    while (discardSequence < sequence
+           && !_discardSequence.compare_exchange_weak(discardSequence, sequence, std::memory_order_release, std::memory_order_relaxed))
+    {
+    }
+}
+
+size_t FunctionQueue::getSize() const
+{
+    uint64_t pushed = _pushSequence.load(std::memory_order_acquire);
+    uint64_t popped = _poppedCount.load(std::memory_order_relaxed);
+    return pushed > popped ? (size_t)(pushed - popped) : 0;
+}
+
+std::string FunctionQueue::getInfo() const
+{
+    char buffer[512];
+    snprintf(buffer, sizeof(buffer) - 1,
+             "functions to perform: %lu (max: %lu)\n"
+             "last frame: %lu performed, %lu left, latency %.3f ms avg, %.3f ms max\n"
+             "total: %llu performed\n",
+             (unsigned long)getSize(), (unsigned long)_maxDepth,
+             (unsigned long)_lastPerformedCount, (unsigned long)_lastRemainingCount,
+             _lastAverageLatency * 1000, _lastMaxLatency * 1000,
+             (unsigned long long)_totalPerformedCount);
+    return buffer;
+}
+
+NS_CC_END
@@ -0,0 +1,167 @@
+/****************************************************************************
+Copyright (c) 2017 Chukong Technologies Inc.
+
+http://www.cocos2d-x.org
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+****************************************************************************/
+
+#ifndef __CCFUNCTION_QUEUE_H__
+#define __CCFUNCTION_QUEUE_H__
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <string>
+#include <type_traits>
+#include <utility>
+
+#include "platform/CCPlatformMacros.h"
+
+/**
+ * @addtogroup base
+ * @{
+ */
+NS_CC_BEGIN
+
+/**
+ * @class FunctionQueue
+ * @brief A lock-free multiple producers, single consumer queue of functions.
+ *
+ * Any thread can push functions, they are performed by the consumer thread in push order.
+ * The functions whose size is at most INLINE_STORAGE_SIZE are stored in the queue nodes,
+ * which are recycled, so pushing them doesn't allocate memory once the queue is warmed up.
+ * @since v3.16
+ * @js NA
+ */
+class CC_DLL FunctionQueue
+{
+public:
+    /** Size of the functions stored without allocating memory, std::function and lambdas capturing a few values fit.
+     It is sized for the largest std::function, 64 bytes with MSVC on x64, 32 with libstdc++ and libc++ on 64 bits.
+     */
+    static const size_t INLINE_STORAGE_SIZE = 64;
+
+    FunctionQueue();
+    ~FunctionQueue();
+
+    /** Pushes a function to be performed by the consumer thread.
+     This function is thread safe.
+     */
+    template <typename Function>
+    void push(Function&& function);
+
+    /** Performs the functions pushed before the call, in push order. Must be called by the consumer thread.
+     @param timeBudget If greater than 0, stops performing functions once this time in seconds is spent,
+            the remaining ones are performed by the next call.
+     @return The number of performed functions.
+     */
+    size_t perform(float timeBudget = 0);
+
+    /** Removes the functions pushed before the call, they will not be performed.
+     This function is thread safe.
+     */
+    void discardAll();
+
+    /** Returns the number of functions pushed but not performed or discarded yet. */
+    size_t getSize() const;
+
+    /** Returns the statistics of the queue: depth, performed functions and their latency. */
+    std::string getInfo() const;
+
+private:
+    typedef std::chrono::steady_clock Clock;
+
+    struct Node
+    {
+        std::atomic<Node*> next;
+        uint64_t sequence;
+        Clock::time_point pushTime;
+        void (*invoke)(Node* node);
+        void (*destroy)(Node* node);
+        alignas(std::max_align_t) unsigned char storage[INLINE_STORAGE_SIZE];
+    };
+
+    /** Stores the function in the node, or a pointer to a copy on the heap when it doesn't fit. */
+    template <typename Type, bool Inline = (sizeof(Type) <= INLINE_STORAGE_SIZE && alignof(Type) <= alignof(std::max_align_t))>
+    struct Storage
+    {
+        template <typename Function>
+        static void construct(Node* node, Function&& function) { new (node->storage) Type(std::forward<Function>(function)); }
+        static void invoke(Node* node) { (*reinterpret_cast<Type*>(node->storage))(); }
+        static void destroy(Node* node) { reinterpret_cast<Type*>(node->storage)->~Type(); }
+    };
+
+    template <typename Type>
+    struct Storage<Type, false>
+    {
+        template <typename Function>
+        static void construct(Node* node, Function&& function) { *reinterpret_cast<Type**>(node->storage) = new Type(std::forward<Function>(function)); }
+        static void invoke(Node* node) { (**reinterpret_cast<Type**>(node->storage))(); }
+        static void destroy(Node* node) { delete *reinterpret_cast<Type**>(node->storage); }
+    };
+
+    /** Nodes taken from the free list by a producer thread. */
+    struct NodeCache;
+
+    Node* allocateNode();
+    void recycleNode(Node* node);
+    void enqueue(Node* node);
+    Node* dequeue();
+
+    std::atomic<Node*> _head;                  // last pushed node, the producers exchange it
+    Node* _tail;                               // next node to pop, only used by the consumer
+    Node _stub;
+    std::atomic<uint64_t> _pushSequence;       // sequence of the last pushed function
+    std::atomic<uint64_t> _discardSequence;    // functions up to this sequence are discarded
+    std::atomic<uint64_t> _poppedCount;
+
+    std::atomic<Node*> _freeNodes;             // pushed by the consumer, taken all at once by the producers
+    std::atomic<size_t> _freeNodeCount;
+
+    // statistics, only written by the consumer
+    size_t _lastPerformedCount;
+    size_t _lastRemainingCount;
+    double _lastMaxLatency;
+    double _lastAverageLatency;
+    size_t _maxDepth;
+    uint64_t _totalPerformedCount;
+};
+
+template <typename Function>
+void FunctionQueue::push(Function&& function)
+{
+    typedef typename std::decay<Function>::type Type;
+
+    Node* node = allocateNode();
+    Storage<Type>::construct(node, std::forward<Function>(function));
+    node->invoke = &Storage<Type>::invoke;
+    node->destroy = &Storage<Type>::destroy;
+    node->pushTime = Clock::now();
+    node->sequence = _pushSequence.fetch_add(1, std::memory_order_acq_rel) + 1;
+    enqueue(node);
+}
+
+NS_CC_END
+// end of base group
+/** @} */
+
+#endif // __CCFUNCTION_QUEUE_H__
@@ -26,9 +26,12 @@ THE SOFTWARE.
 ****************************************************************************/
 
 #include "base/CCScheduler.h"
+
+#include <algorithm>
+#include <iterator>
+
 #include "base/ccMacros.h"
 #include "base/CCDirector.h"
-#include "base/utlist.h"
 #include "base/ccCArray.h"
 #include "base/CCScriptSupport.h"
 
@@ -36,32 +39,12 @@ NS_CC_BEGIN
 
 // data structures
 
-// A list double-linked list used for "updates with priority"
-typedef struct _listEntry
-{
-    struct _listEntry   *prev, *next;
-    ccSchedulerFunc     callback;
-    void                *target;
-    int                 priority;
-    bool                paused;
-    bool                markedForDeletion; // selector will no longer be called and entry will be removed at end of the next tick
-} tListEntry;
-
-typedef struct _hashUpdateEntry
-{
-    tListEntry          **list;        // Which list does it belong to ?
-    tListEntry          *entry;        // entry in the list
-    void                *target;
-    ccSchedulerFunc     callback;
-    UT_hash_handle      hh;
-} tHashUpdateEntry;
-
 // Hash Element used for "selectors with interval"
 typedef struct _hashSelectorEntry
 {
     ccArray             *timers;
     void                *target;
-    int                 timerIndex;
+    double              pausedTime;   // Scheduler time when the target was paused
     Timer               *currentTimer;
     bool                paused;
     UT_hash_handle      hh;
@@ -79,6 +62,11 @@ Timer::Timer()
 , _delay(0.0f)
 , _interval(0.0f)
 , _aborted(false)
+, _schedulerEntry(nullptr)
+, _wheelTime(0.0)
+, _wheelDeadline(0.0)
+, _wheelList(nullptr)
+, _wheelIndex(0)
 {
 
 }
@@ -145,6 +133,19 @@ void Timer::update(float dt)
     }
 }
 
+float Timer::getTimeToNextTrigger() const
+{
+    // the first update only starts counting
+    if (_elapsed == -1)
+        return 0;
+    if (_useDelay)
+        return _delay - _elapsed;
+    // if _interval == 0, triggers once every frame
+    if (_interval > 0)
+        return _interval - _elapsed;
+    return 0;
+}
+
 // TimerTargetSelector
 
 TimerTargetSelector::TimerTargetSelector()
@@ -246,20 +247,17 @@ const int Scheduler::PRIORITY_NON_SYSTEM_MIN = PRIORITY_SYSTEM + 1;
 
 Scheduler::Scheduler(void)
 : _timeScale(1.0f)
-, _updatesNegList(nullptr)
-, _updates0List(nullptr)
-, _updatesPosList(nullptr)
-, _hashForUpdates(nullptr)
+, _updateSlotsDirty(false)
+, _time(0.0)
+, _timerWheel(1.0 / 256)
 , _hashForTimers(nullptr)
 , _currentTarget(nullptr)
 , _currentTargetSalvaged(false)
-, _updateHashLocked(false)
 #if CC_ENABLE_SCRIPT_BINDING
 , _scriptHandlerEntries(20)
 #endif
+, _functionsToPerformTimeBudget(0)
 {
-    // I don't expect to have more than 30 functions to all per frame
-    _functionsToPerform.reserve(30);
 }
 
 Scheduler::~Scheduler(void)
@@ -296,6 +294,7 @@ void Scheduler::schedule(const ccSchedulerFunc& callback, void *target, float in
 
         // Is this the 1st element ? Then set the pause level to all the selectors of this target
         element->paused = paused;
+        element->pausedTime = _time;
     }
     else
     {
@@ -316,6 +315,12 @@ void Scheduler::schedule(const ccSchedulerFunc& callback, void *target, float in
             {
                 CCLOG("CCScheduler#scheduleSelector. Selector already scheduled. Updating interval from: %.4f to %.4f", timer->getInterval(), interval);
                 timer->setInterval(interval);
+                // a timer re-scheduled from its own callback is put back in the wheel by update()
+                if (timer != element->currentTimer)
+                {
+                    _timerWheel.remove(timer);
+                    addTimerToWheel(timer);
+                }
                 return;
             }        
         }
@@ -325,6 +330,10 @@ void Scheduler::schedule(const ccSchedulerFunc& callback, void *target, float in
     TimerTargetCallback *timer = new (std::nothrow) TimerTargetCallback();
     timer->initWithCallback(this, callback, target, key, interval, repeat, delay);
     ccArrayAppendObject(element->timers, timer);
+    timer->_schedulerEntry = element;
+    // resumeTimers() adds the whole pause to the timers of a paused target, a new one only counts from the pause
+    timer->_wheelTime = element->paused ? element->pausedTime : _time;
+    addTimerToWheel(timer);
     timer->release();
 }
 
@@ -356,14 +365,9 @@ void Scheduler::unschedule(const std::string &key, void *target)
                     timer->setAborted();
                 }
 
+                _timerWheel.remove(timer);
                 ccArrayRemoveObjectAtIndex(element->timers, i, true);
 
-                // update timerIndex in case we are in tick:, looping over the actions
-                if (element->timerIndex >= i)
-                {
-                    element->timerIndex--;
-                }
-
                 if (element->timers->num == 0)
                 {
                     if (_currentTarget == element)
@@ -382,91 +386,369 @@ void Scheduler::unschedule(const std::string &key, void *target)
     }
 }
 
-void Scheduler::priorityIn(tListEntry **list, const ccSchedulerFunc& callback, void *target, int priority, bool paused)
+// implementation of Scheduler::TimerWheel
+
+Scheduler::TimerWheel::TimerWheel(double resolution)
+: _resolution(resolution)
+, _time(0.0)
+, _tick(0)
+, _timerCount(0)
+, _lastDueCount(0)
+, _lastCascadedCount(0)
+, _totalDueCount(0)
 {
-    tListEntry *listElement = new (std::nothrow) tListEntry();
+}
 
-    listElement->callback = callback;
-    listElement->target = target;
-    listElement->priority = priority;
-    listElement->paused = paused;
-    listElement->next = listElement->prev = nullptr;
-    listElement->markedForDeletion = false;
+void Scheduler::TimerWheel::insert(Timer *timer, std::vector<Timer*>& list)
+{
+    timer->_wheelList = &list;
+    timer->_wheelIndex = list.size();
+    list.push_back(timer);
+    if (&list != &_dueTimers)
+        ++_timerCount;
+}
 
-    // empty list ?
-    if (! *list)
+void Scheduler::TimerWheel::take(Timer *timer)
+{
+    auto& list = *timer->_wheelList;
+    if (&list == &_dueTimers)
     {
-        DL_APPEND(*list, listElement);
+        // the due timers are being iterated, keep the others in place
+        list[timer->_wheelIndex] = nullptr;
     }
     else
     {
-        bool added = false;
+        Timer *last = list.back();
+        list[timer->_wheelIndex] = last;
+        last->_wheelIndex = timer->_wheelIndex;
+        list.pop_back();
+        --_timerCount;
+    }
+    timer->_wheelList = nullptr;
+}
 
-        for (tListEntry *element = *list; element; element = element->next)
+void Scheduler::TimerWheel::add(Timer *timer, double deadline)
+{
+    CCASSERT(timer->_wheelList == nullptr, "The timer is already in the wheel");
+    timer->_wheelDeadline = deadline;
+
+    uint64_t tick = deadline > _time ? (uint64_t)(deadline / _resolution) : 0;
+    // the deadline is reached or falls in a tick already processed, check it on the next advance
+    if (tick <= _tick)
+        insert(timer, _nextAdvance);
+    else
+        insertAtTick(timer, tick);
+}
+
+void Scheduler::TimerWheel::insertAtTick(Timer *timer, uint64_t tick)
+{
+    const uint64_t maxDelta = (1ULL << (LEVEL_BITS * LEVEL_COUNT)) - 1;
+    uint64_t delta = tick - _tick;
+    if (delta > maxDelta)
+    {
+        // put it as far as possible, it is cascaded again until its deadline is in range
+        delta = maxDelta;
+        tick = _tick + maxDelta;
+    }
+
+    int level = 0;
+    while (level < LEVEL_COUNT - 1 && delta >= (1ULL << (LEVEL_BITS * (level + 1))))
+        ++level;
+
+    insert(timer, _slots[level][(tick >> (LEVEL_BITS * level)) & (LEVEL_SIZE - 1)]);
+}
+
+void Scheduler::TimerWheel::remove(Timer *timer)
+{
+    if (timer->_wheelList != nullptr)
+        take(timer);
+}
+
+void Scheduler::TimerWheel::cascade(int level)
+{
+    if (level >= LEVEL_COUNT)
+        return;
+
+    uint64_t index = (_tick >> (LEVEL_BITS * level)) & (LEVEL_SIZE - 1);
+    // the upper level wrapped too, its slot goes down first
+    if (index == 0)
+        cascade(level + 1);
+
+    std::vector<Timer*> timers;
+    timers.swap(_slots[level][index]);
+    for (auto timer : timers)
+    {
+        timer->_wheelList = nullptr;
+        --_timerCount;
+        insertAtTick(timer, std::max((uint64_t)(timer->_wheelDeadline / _resolution), _tick));
+    }
+    _lastCascadedCount += timers.size();
+}
+
+void Scheduler::TimerWheel::advance(double time)
+{
+    _time = time;
+    _lastDueCount = 0;
+    _lastCascadedCount = 0;
+    _dueTimers.clear();
+
+    auto processList = [this](std::vector<Timer*>& list) {
+        std::vector<Timer*> timers;
+        timers.swap(list);
+        for (auto timer : timers)
         {
-            if (priority < element->priority)
-            {
-                if (element == *list)
-                {
-                    DL_PREPEND(*list, listElement);
-                }
-                else
-                {
-                    listElement->next = element;
-                    listElement->prev = element->prev;
+            timer->_wheelList = nullptr;
+            --_timerCount;
+            if (timer->_wheelDeadline <= _time)
+                insert(timer, _dueTimers);
+            else
+                add(timer, timer->_wheelDeadline);
+        }
+    };
 
-                    element->prev->next = listElement;
-                    element->prev = listElement;
-                }
+    processList(_nextAdvance);
 
-                added = true;
-                break;
-            }
+    const uint64_t lastTick = (uint64_t)(time / _resolution);
+    if (_timerCount == _nextAdvance.size())
+    {
+        // the slots are empty, no need to walk through them
+        _tick = std::max(_tick, lastTick + 1);
+    }
+    while (_tick <= lastTick)
+    {
+        if ((_tick & (LEVEL_SIZE - 1)) == 0)
+            cascade(1);
+
+        processList(_slots[0][_tick & (LEVEL_SIZE - 1)]);
+        ++_tick;
+    }
+
+    _lastDueCount = _dueTimers.size();
+    _totalDueCount += _lastDueCount;
+}
+
+std::string Scheduler::TimerWheel::getInfo() const
+{
+    size_t levelCounts[LEVEL_COUNT] = {0};
+    for (int level = 0; level < LEVEL_COUNT; ++level)
+    {
+        for (const auto& slot : _slots[level])
+            levelCounts[level] += slot.size();
+    }
+
+    char buffer[512];
+    snprintf(buffer, sizeof(buffer) - 1,
+             "timers: %lu (levels: %lu %lu %lu %lu, next frame: %lu)\n"
+             "resolution: %.2f ms, tick: %llu\n"
+             "last frame: %lu due, %lu cascaded\n"
+             "total: %llu due\n",
+             (unsigned long)_timerCount,
+             (unsigned long)levelCounts[0], (unsigned long)levelCounts[1], (unsigned long)levelCounts[2], (unsigned long)levelCounts[3],
+             (unsigned long)_nextAdvance.size(),
+             _resolution * 1000, (unsigned long long)_tick,
+             (unsigned long)_lastDueCount, (unsigned long)_lastCascadedCount,
+             (unsigned long long)_totalDueCount);
+    return buffer;
+}
+
+// implementation of Scheduler, timers
+
+void Scheduler::addTimerToWheel(Timer *timer)
+{
+    _timerWheel.add(timer, timer->_wheelTime + timer->getTimeToNextTrigger());
+}
+
+void Scheduler::pauseTimers(tHashTimerEntry *element)
+{
+    if (element->paused)
+        return;
+
+    element->paused = true;
+    element->pausedTime = _time;
+}
+
+void Scheduler::resumeTimers(tHashTimerEntry *element)
+{
+    if (!element->paused)
+        return;
+
+    element->paused = false;
+    // the time spent paused doesn't count
+    double pausedDuration = _time - element->pausedTime;
+    for (int i = 0; i < element->timers->num; ++i)
+    {
+        Timer *timer = (Timer*)element->timers->arr[i];
+        timer->_wheelTime += pausedDuration;
+        // the timers that came due while paused were left out of the wheel, the others are updated
+        // on their old deadline, which is earlier, and put back at the right time then
+        if (timer->_wheelList == nullptr && timer != element->currentTimer)
+            addTimerToWheel(timer);
+    }
+}
+
+std::string Scheduler::getTimerWheelInfo() const
+{
+    return _timerWheel.getInfo();
+}
+
+// implementation of Scheduler::UpdateSlotMap
+
+const int Scheduler::UpdateSlotMap::INVALID_INDEX = INT_MIN;
+
+Scheduler::UpdateSlotMap::UpdateSlotMap()
+: _count(0)
+{
+}
+
+size_t Scheduler::UpdateSlotMap::bucketOf(void *target) const
+{
+    // targets are aligned pointers, mix all their bits into the low ones
+    uint64_t key = (uint64_t)reinterpret_cast<uintptr_t>(target);
+    key ^= key >> 33;
+    key *= 0xff51afd7ed558ccdULL;
+    key ^= key >> 33;
+    return (size_t)key & (_buckets.size() - 1);
+}
+
+int Scheduler::UpdateSlotMap::find(void *target) const
+{
+    if (_buckets.empty())
+        return INVALID_INDEX;
+
+    const size_t mask = _buckets.size() - 1;
+    for (size_t i = bucketOf(target); ; i = (i + 1) & mask)
+    {
+        const Bucket& bucket = _buckets[i];
+        if (bucket.target == target)
+            return bucket.index;
+        if (bucket.target == nullptr)
+            return INVALID_INDEX;
+    }
+}
+
+void Scheduler::UpdateSlotMap::set(void *target, int index)
+{
+    // keep the load factor under 1/2, so probing sequences stay short
+    if ((_count + 1) * 2 > _buckets.size())
+        rehash(std::max(_buckets.size() * 2, (size_t)64));
+
+    const size_t mask = _buckets.size() - 1;
+    for (size_t i = bucketOf(target); ; i = (i + 1) & mask)
+    {
+        Bucket& bucket = _buckets[i];
+        if (bucket.target == target)
+        {
+            bucket.index = index;
+            return;
         }
+        if (bucket.target == nullptr)
+        {
+            bucket.target = target;
+            bucket.index = index;
+            ++_count;
+            return;
+        }
+    }
+}
+
+void Scheduler::UpdateSlotMap::erase(void *target)
+{
+    if (_buckets.empty())
+        return;
 
-        // Not added? priority has the higher value. Append it.
-        if (! added)
+    const size_t mask = _buckets.size() - 1;
+    size_t hole = bucketOf(target);
+    while (_buckets[hole].target != target)
+    {
+        if (_buckets[hole].target == nullptr)
+            return;
+        hole = (hole + 1) & mask;
+    }
+
+    // shift back the following buckets of the probing sequence instead of leaving a tombstone
+    for (size_t i = (hole + 1) & mask; _buckets[i].target != nullptr; i = (i + 1) & mask)
+    {
+        const size_t home = bucketOf(_buckets[i].target);
+        const bool reachable = hole <= i ? (hole < home && home <= i) : (hole < home || home <= i);
+        if (!reachable)
         {
-            DL_APPEND(*list, listElement);
+            _buckets[hole] = _buckets[i];
+            hole = i;
         }
     }
+    _buckets[hole].target = nullptr;
+    --_count;
+}
+
+void Scheduler::UpdateSlotMap::clear()
+{
+    _buckets.clear();
+    _count = 0;
+}
+
+void Scheduler::UpdateSlotMap::rehash(size_t bucketCount)
+{
+    std::vector<Bucket> buckets(bucketCount, Bucket{nullptr, 0});
+    _buckets.swap(buckets);
+    _count = 0;
+    for (const auto& bucket : buckets)
+    {
+        if (bucket.target != nullptr)
+            set(bucket.target, bucket.index);
+    }
+}
+
+// implementation of Scheduler, update slots
 
-    // update hash entry for quick access
-    tHashUpdateEntry *hashElement = (tHashUpdateEntry *)calloc(sizeof(*hashElement), 1);
-    hashElement->target = target;
-    hashElement->list = list;
-    hashElement->entry = listElement;
-    HASH_ADD_PTR(_hashForUpdates, target, hashElement);
+Scheduler::UpdateSlot* Scheduler::findUpdateSlot(void *target)
+{
+    int index = _updateSlotMap.find(target);
+    if (index == UpdateSlotMap::INVALID_INDEX)
+        return nullptr;
+    return index >= 0 ? &_updateSlots[index] : &_pendingUpdateSlots[-1 - index];
 }
 
-void Scheduler::appendIn(_listEntry **list, const ccSchedulerFunc& callback, void *target, bool paused)
+void Scheduler::flushUpdateSlots()
 {
-    tListEntry *listElement = new (std::nothrow) tListEntry();
+    if (!_updateSlotsDirty)
+        return;
+    _updateSlotsDirty = false;
 
-    listElement->callback = callback;
-    listElement->target = target;
-    listElement->paused = paused;
-    listElement->priority = 0;
-    listElement->markedForDeletion = false;
+    auto isMarked = [](const UpdateSlot& slot) { return slot.markedForDeletion; };
+    auto comparePriority = [](const UpdateSlot& slot1, const UpdateSlot& slot2) { return slot1.priority < slot2.priority; };
 
-    DL_APPEND(*list, listElement);
+    // the slots before the first removal or insertion keep their index
+    auto firstMarked = std::find_if(_updateSlots.begin(), _updateSlots.end(), isMarked);
+    size_t firstMoved = firstMarked - _updateSlots.begin();
+    _updateSlots.erase(std::remove_if(firstMarked, _updateSlots.end(), isMarked), _updateSlots.end());
+
+    _pendingUpdateSlots.erase(std::remove_if(_pendingUpdateSlots.begin(), _pendingUpdateSlots.end(), isMarked), _pendingUpdateSlots.end());
+    if (!_pendingUpdateSlots.empty())
+    {
+        // with the same priority, slots are called in order of scheduling
+        std::stable_sort(_pendingUpdateSlots.begin(), _pendingUpdateSlots.end(), comparePriority);
+        size_t insertion = std::upper_bound(_updateSlots.begin(), _updateSlots.end(), _pendingUpdateSlots.front(), comparePriority) - _updateSlots.begin();
+        size_t middle = _updateSlots.size();
+        firstMoved = std::min(firstMoved, insertion);
+
+        std::move(_pendingUpdateSlots.begin(), _pendingUpdateSlots.end(), std::back_inserter(_updateSlots));
+        std::inplace_merge(_updateSlots.begin() + insertion, _updateSlots.begin() + middle, _updateSlots.end(), comparePriority);
+        _pendingUpdateSlots.clear();
+    }
 
-    // update hash entry for quicker access
-    tHashUpdateEntry *hashElement = (tHashUpdateEntry *)calloc(sizeof(*hashElement), 1);
-    hashElement->target = target;
-    hashElement->list = list;
-    hashElement->entry = listElement;
-    HASH_ADD_PTR(_hashForUpdates, target, hashElement);
+    for (size_t i = firstMoved, count = _updateSlots.size(); i < count; ++i)
+    {
+        _updateSlotMap.set(_updateSlots[i].target, (int)i);
+    }
 }
 
 void Scheduler::schedulePerFrame(const ccSchedulerFunc& callback, void *target, int priority, bool paused)
 {
-    tHashUpdateEntry *hashElement = nullptr;
-    HASH_FIND_PTR(_hashForUpdates, &target, hashElement);
-    if (hashElement)
+    UpdateSlot *slot = findUpdateSlot(target);
+    if (slot)
     {
         // change priority: should unschedule it first
-        if (hashElement->entry->priority != priority)
+        if (slot->priority != priority)
         {
             unscheduleUpdate(target);
         }
@@ -478,21 +760,11 @@ void Scheduler::schedulePerFrame(const ccSchedulerFunc& callback, void *target,
         }
     }
 
-    // most of the updates are going to be 0, that's way there
-    // is an special list for updates with priority 0
-    if (priority == 0)
-    {
-        appendIn(&_updates0List, callback, target, paused);
-    }
-    else if (priority < 0)
-    {
-        priorityIn(&_updatesNegList, callback, target, priority, paused);
-    }
-    else
-    {
-        // priority > 0
-        priorityIn(&_updatesPosList, callback, target, priority, paused);
-    }
+    // the slot is merged with the others on the next update, so the slots being called never move
+    UpdateSlot newSlot = { callback, target, priority, paused, false };
+    _pendingUpdateSlots.push_back(std::move(newSlot));
+    _updateSlotMap.set(target, -(int)_pendingUpdateSlots.size());
+    _updateSlotsDirty = true;
 }
 
 bool Scheduler::isScheduled(const std::string& key, void *target)
@@ -530,29 +802,6 @@ bool Scheduler::isScheduled(const std::string& key, void *target)
     return false;  // should never get here
 }
 
-void Scheduler::removeUpdateFromHash(struct _listEntry *entry)
-{
-    tHashUpdateEntry *element = nullptr;
-
-    HASH_FIND_PTR(_hashForUpdates, &entry->target, element);
-    if (element)
-    {
-        // list entry
-        DL_DELETE(*element->list, element->entry);
-        if (!_updateHashLocked)
-            CC_SAFE_DELETE(element->entry);
-        else
-        {
-            element->entry->markedForDeletion = true;
-            _updateDeleteVector.push_back(element->entry);
-        }
-
-        // hash entry
-        HASH_DEL(_hashForUpdates, element);
-        free(element);
-    }
-}
-
 void Scheduler::unscheduleUpdate(void *target)
 {
     if (target == nullptr)
@@ -560,10 +809,14 @@ void Scheduler::unscheduleUpdate(void *target)
         return;
     }
 
-    tHashUpdateEntry *element = nullptr;
-    HASH_FIND_PTR(_hashForUpdates, &target, element);
-    if (element)
-        this->removeUpdateFromHash(element->entry);
+    UpdateSlot *slot = findUpdateSlot(target);
+    if (slot)
+    {
+        // the slot may be the one being called, it is removed on the next flush
+        slot->markedForDeletion = true;
+        _updateSlotMap.erase(target);
+        _updateSlotsDirty = true;
+    }
 }
 
 void Scheduler::unscheduleAll(void)
@@ -586,31 +839,19 @@ void Scheduler::unscheduleAllWithMinPriority(int minPriority)
     }
 
     // Updates selectors
-    tListEntry *entry, *tmp;
-    if(minPriority < 0)
+    for (auto& slot : _updateSlots)
     {
-        DL_FOREACH_SAFE(_updatesNegList, entry, tmp)
+        if (!slot.markedForDeletion && slot.priority >= minPriority)
         {
-            if(entry->priority >= minPriority)
-            {
-                unscheduleUpdate(entry->target);
-            }
+            unscheduleUpdate(slot.target);
         }
     }
 
-    if(minPriority <= 0)
+    for (auto& slot : _pendingUpdateSlots)
     {
-        DL_FOREACH_SAFE(_updates0List, entry, tmp)
+        if (!slot.markedForDeletion && slot.priority >= minPriority)
         {
-            unscheduleUpdate(entry->target);
-        }
-    }
-
-    DL_FOREACH_SAFE(_updatesPosList, entry, tmp)
-    {
-        if(entry->priority >= minPriority)
-        {
-            unscheduleUpdate(entry->target);
+            unscheduleUpdate(slot.target);
         }
     }
 #if CC_ENABLE_SCRIPT_BINDING
@@ -638,6 +879,10 @@ void Scheduler::unscheduleAllForTarget(void *target)
             element->currentTimer->retain();
             element->currentTimer->setAborted();
         }
+        for (int i = 0; i < element->timers->num; ++i)
+        {
+            _timerWheel.remove((Timer*)element->timers->arr[i]);
+        }
         ccArrayRemoveAllObjects(element->timers);
 
         if (_currentTarget == element)
@@ -686,16 +931,14 @@ void Scheduler::resumeTarget(void *target)
     HASH_FIND_PTR(_hashForTimers, &target, element);
     if (element)
     {
-        element->paused = false;
+        resumeTimers(element);
     }
 
     // update selector
-    tHashUpdateEntry *elementUpdate = nullptr;
-    HASH_FIND_PTR(_hashForUpdates, &target, elementUpdate);
-    if (elementUpdate)
+    UpdateSlot *slot = findUpdateSlot(target);
+    if (slot)
     {
-        CCASSERT(elementUpdate->entry != nullptr, "elementUpdate's entry can't be nullptr!");
-        elementUpdate->entry->paused = false;
+        slot->paused = false;
     }
 }
 
@@ -708,16 +951,14 @@ void Scheduler::pauseTarget(void *target)
     HASH_FIND_PTR(_hashForTimers, &target, element);
     if (element)
     {
-        element->paused = true;
+        pauseTimers(element);
     }
 
     // update selector
-    tHashUpdateEntry *elementUpdate = nullptr;
-    HASH_FIND_PTR(_hashForUpdates, &target, elementUpdate);
-    if (elementUpdate)
+    UpdateSlot *slot = findUpdateSlot(target);
+    if (slot)
     {
-        CCASSERT(elementUpdate->entry != nullptr, "elementUpdate's entry can't be nullptr!");
-        elementUpdate->entry->paused = true;
+        slot->paused = true;
     }
 }
 
@@ -734,11 +975,10 @@ bool Scheduler::isTargetPaused(void *target)
     }
     
     // We should check update selectors if target does not have custom selectors
-	tHashUpdateEntry *elementUpdate = nullptr;
-	HASH_FIND_PTR(_hashForUpdates, &target, elementUpdate);
-	if ( elementUpdate )
+    UpdateSlot *slot = findUpdateSlot(target);
+    if ( slot )
     {
-		return elementUpdate->entry->paused;
+        return slot->paused;
     }
     
     return false;  // should never get here
@@ -757,39 +997,26 @@ std::set<void*> Scheduler::pauseAllTargetsWithMinPriority(int minPriority)
     for(tHashTimerEntry *element = _hashForTimers; element != nullptr;
         element = (tHashTimerEntry*)element->hh.next)
     {
-        element->paused = true;
+        pauseTimers(element);
         idsWithSelectors.insert(element->target);
     }
 
     // Updates selectors
-    tListEntry *entry, *tmp;
-    if(minPriority < 0)
+    for (auto& slot : _updateSlots)
     {
-        DL_FOREACH_SAFE( _updatesNegList, entry, tmp ) 
+        if (!slot.markedForDeletion && slot.priority >= minPriority)
         {
-            if(entry->priority >= minPriority)
-            {
-                entry->paused = true;
-                idsWithSelectors.insert(entry->target);
-            }
+            slot.paused = true;
+            idsWithSelectors.insert(slot.target);
         }
     }
 
-    if(minPriority <= 0)
+    for (auto& slot : _pendingUpdateSlots)
     {
-        DL_FOREACH_SAFE( _updates0List, entry, tmp )
+        if (!slot.markedForDeletion && slot.priority >= minPriority)
         {
-            entry->paused = true;
-            idsWithSelectors.insert(entry->target);
-        }
-    }
-
-    DL_FOREACH_SAFE( _updatesPosList, entry, tmp ) 
-    {
-        if(entry->priority >= minPriority) 
-        {
-            entry->paused = true;
-            idsWithSelectors.insert(entry->target);
+            slot.paused = true;
+            idsWithSelectors.insert(slot.target);
         }
     }
 
@@ -805,24 +1032,22 @@ void Scheduler::resumeTargets(const std::set<void*>& targetsToResume)
 
 void Scheduler::performFunctionInCocosThread(const std::function<void ()> &function)
 {
-    _performMutex.lock();
-
-    _functionsToPerform.push_back(function);
-
-    _performMutex.unlock();
+    _functionsToPerform.push(function);
 }
 
 void Scheduler::removeAllFunctionsToBePerformedInCocosThread()
 {
-    std::unique_lock<std::mutex> lock(_performMutex);
-    _functionsToPerform.clear();
+    _functionsToPerform.discardAll();
+}
+
+std::string Scheduler::getFunctionsToPerformInfo() const
+{
+    return _functionsToPerform.getInfo();
 }
 
 // main loop
 void Scheduler::update(float dt)
 {
-    _updateHashLocked = true;
-
     if (_timeScale != 1.0f)
     {
         dt *= _timeScale;
@@ -832,84 +1057,75 @@ void Scheduler::update(float dt)
     // Selector callbacks
     //
 
-    // Iterate over all the Updates' selectors
-    tListEntry *entry, *tmp;
+    // Iterate over all the Updates' selectors, in priority order
+    flushUpdateSlots();
 
-    // updates with priority < 0
-    DL_FOREACH_SAFE(_updatesNegList, entry, tmp)
+    // callbacks only mark slots or add pending ones, _updateSlots is not resized until the next flush
+    for (size_t i = 0, count = _updateSlots.size(); i < count; ++i)
     {
-        if ((! entry->paused) && (! entry->markedForDeletion))
+        UpdateSlot& slot = _updateSlots[i];
+        if ((! slot.paused) && (! slot.markedForDeletion))
         {
-            entry->callback(dt);
+            slot.callback(dt);
         }
     }
 
-    // updates with priority == 0
-    DL_FOREACH_SAFE(_updates0List, entry, tmp)
+    // Iterate over the custom selectors whose deadline is reached
+    _time += dt;
+    _timerWheel.advance(_time);
+
+    // The due timers may be unscheduled by the ones called before them, they are set to nullptr then
+    auto& dueTimers = _timerWheel.getDueTimers();
+    for (size_t i = 0; i < dueTimers.size(); ++i)
     {
-        if ((! entry->paused) && (! entry->markedForDeletion))
+        Timer *timer = dueTimers[i];
+        if (timer == nullptr)
         {
-            entry->callback(dt);
+            continue;
         }
-    }
+        _timerWheel.remove(timer);
 
-    // updates with priority > 0
-    DL_FOREACH_SAFE(_updatesPosList, entry, tmp)
-    {
-        if ((! entry->paused) && (! entry->markedForDeletion))
+        tHashTimerEntry *elt = timer->_schedulerEntry;
+        // paused timers are added back to the wheel by resumeTimers()
+        if (elt->paused)
         {
-            entry->callback(dt);
+            continue;
         }
-    }
 
-    // Iterate over all the custom selectors
-    for (tHashTimerEntry *elt = _hashForTimers; elt != nullptr; )
-    {
         _currentTarget = elt;
         _currentTargetSalvaged = false;
+        elt->currentTimer = timer;
 
-        if (! _currentTarget->paused)
-        {
-            // The 'timers' array may change while inside this loop
-            for (elt->timerIndex = 0; elt->timerIndex < elt->timers->num; ++(elt->timerIndex))
-            {
-                elt->currentTimer = (Timer*)(elt->timers->arr[elt->timerIndex]);
-                CCASSERT
-                  ( !elt->currentTimer->isAborted(),
-                    "An aborted timer should not be updated" );
-
-                elt->currentTimer->update(dt);
-
-                if (elt->currentTimer->isAborted())
-                {
-                    // The currentTimer told the remove itself. To prevent the timer from
-                    // accidentally deallocating itself before finishing its step, we retained
-                    // it. Now that step is done, it's safe to release it.
-                    elt->currentTimer->release();
-                }
+        // feed the time elapsed since its last update, which may span several frames
+        float elapsed = (float)(_time - timer->_wheelTime);
+        timer->_wheelTime = _time;
+        timer->update(elapsed);
 
-                elt->currentTimer = nullptr;
-            }
+        if (timer->isAborted())
+        {
+            // The currentTimer told the remove itself. To prevent the timer from
+            // accidentally deallocating itself before finishing its step, we retained
+            // it. Now that step is done, it's safe to release it.
+            timer->release();
+        }
+        else
+        {
+            addTimerToWheel(timer);
         }
 
-        // elt, at this moment, is still valid
-        // so it is safe to ask this here (issue #490)
-        elt = (tHashTimerEntry *)elt->hh.next;
+        elt->currentTimer = nullptr;
 
         // only delete currentTarget if no actions were scheduled during the cycle (issue #481)
-        if (_currentTargetSalvaged && _currentTarget->timers->num == 0)
+        if (_currentTargetSalvaged && elt->timers->num == 0)
         {
-            removeHashElement(_currentTarget);
+            removeHashElement(elt);
         }
     }
+    dueTimers.clear();
  
     // delete all updates that are removed in update
-    for (auto &e : _updateDeleteVector)
-        delete e;
+    flushUpdateSlots();
 
-    _updateDeleteVector.clear();
-
-    _updateHashLocked = false;
     _currentTarget = nullptr;
 
 #if CC_ENABLE_SCRIPT_BINDING
@@ -938,19 +1154,8 @@ void Scheduler::update(float dt)
     // Functions allocated from another thread
     //
 
-    // Testing size is faster than locking / unlocking.
-    // And almost never there will be functions scheduled to be called.
-    if( !_functionsToPerform.empty() ) {
-        _performMutex.lock();
-        // fixed #4123: Save the callback functions, they must be invoked after '_performMutex.unlock()', otherwise if new functions are added in callback, it will cause thread deadlock.
-        auto temp = _functionsToPerform;
-        _functionsToPerform.clear();
-        _performMutex.unlock();
-        for( const auto &function : temp ) {
-            function();
-        }
-        
-    }
+    // The functions added by the performed ones are performed on the next frame
+    _functionsToPerform.perform(_functionsToPerformTimeBudget);
 }
 
 void Scheduler::schedule(SEL_SCHEDULE selector, Ref *target, float interval, unsigned int repeat, float delay, bool paused)
@@ -969,6 +1174,7 @@ void Scheduler::schedule(SEL_SCHEDULE selector, Ref *target, float interval, uns
         
         // Is this the 1st element ? Then set the pause level to all the selectors of this target
         element->paused = paused;
+        element->pausedTime = _time;
     }
     else
     {
@@ -989,6 +1195,12 @@ void Scheduler::schedule(SEL_SCHEDULE selector, Ref *target, float interval, uns
             {
                 CCLOG("CCScheduler#scheduleSelector. Selector already scheduled. Updating interval from: %.4f to %.4f", timer->getInterval(), interval);
                 timer->setInterval(interval);
+                // a timer re-scheduled from its own callback is put back in the wheel by update()
+                if (timer != element->currentTimer)
+                {
+                    _timerWheel.remove(timer);
+                    addTimerToWheel(timer);
+                }
                 return;
             }
         }
@@ -998,6 +1210,10 @@ void Scheduler::schedule(SEL_SCHEDULE selector, Ref *target, float interval, uns
     TimerTargetSelector *timer = new (std::nothrow) TimerTargetSelector();
     timer->initWithSelector(this, selector, target, interval, repeat, delay);
     ccArrayAppendObject(element->timers, timer);
+    timer->_schedulerEntry = element;
+    // resumeTimers() adds the whole pause to the timers of a paused target, a new one only counts from the pause
+    timer->_wheelTime = element->paused ? element->pausedTime : _time;
+    addTimerToWheel(timer);
     timer->release();
 }
 
@@ -1066,14 +1282,9 @@ void Scheduler::unschedule(SEL_SCHEDULE selector, Ref *target)
                     timer->setAborted();
                 }
                 
+                _timerWheel.remove(timer);
                 ccArrayRemoveObjectAtIndex(element->timers, i, true);
                 
-                // update timerIndex in case we are in tick:, looping over the actions
-                if (element->timerIndex >= i)
-                {
-                    element->timerIndex--;
-                }
-                
                 if (element->timers->num == 0)
                 {
                     if (_currentTarget == element)
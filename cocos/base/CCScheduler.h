@@ -31,7 +31,10 @@ THE SOFTWARE.
 #include <functional>
 #include <mutex>
 #include <set>
+#include <string>
+#include <vector>
 
+#include "base/CCFunctionQueue.h"
 #include "base/CCRef.h"
 #include "base/CCVector.h"
 #include "base/uthash.h"
@@ -39,6 +42,7 @@ THE SOFTWARE.
 NS_CC_BEGIN
 
 class Scheduler;
+struct _hashSelectorEntry;
 
 typedef std::function<void(float)> ccSchedulerFunc;
 
@@ -65,7 +69,11 @@ public:
     /** triggers the timer */
     void update(float dt);
     
+    /** Returns the time left before the timer triggers, or 0 if it must be updated on the next frame. */
+    float getTimeToNextTrigger() const;
+    
 protected:
+    friend class Scheduler;
     
     Scheduler* _scheduler; // weak ref
     float _elapsed;
@@ -76,6 +84,13 @@ protected:
     float _delay;
     float _interval;
     bool _aborted;
+    
+    // used by the Scheduler's timer wheel
+    struct _hashSelectorEntry* _schedulerEntry; // entry of the target in the Scheduler
+    double _wheelTime;                 // Scheduler time of the last update
+    double _wheelDeadline;             // Scheduler time when the timer has to be updated
+    std::vector<Timer*>* _wheelList;   // the list of the wheel holding the timer, nullptr if none
+    size_t _wheelIndex;                // index of the timer in _wheelList
 };
 
 
@@ -144,10 +159,6 @@ private:
  * @{
  */
 
-struct _listEntry;
-struct _hashSelectorEntry;
-struct _hashUpdateEntry;
-
 #if CC_ENABLE_SCRIPT_BINDING
 class SchedulerScriptHandlerEntry;
 #endif
@@ -432,6 +443,20 @@ public:
      @js NA
      */
     void performFunctionInCocosThread( const std::function<void()> &function);
+
+    /** Calls a function object on the cocos2d thread, without wrapping it in a std::function.
+     The function objects up to FunctionQueue::INLINE_STORAGE_SIZE bytes are queued without allocating memory.
+     This function is thread safe.
+     @param function The function object to be run in cocos2d thread.
+     @since v3.16
+     @js NA
+     @lua NA
+     */
+    template <typename Function>
+    void performFunctionInCocosThread(Function&& function)
+    {
+        _functionsToPerform.push(std::forward<Function>(function));
+    }
     
     /**
      * Remove all pending functions queued to be performed with Scheduler::performFunctionInCocosThread
@@ -441,6 +466,45 @@ public:
      * @js NA
      */
     void removeAllFunctionsToBePerformedInCocosThread();
+
+    /**
+     * Sets the time the functions queued with Scheduler::performFunctionInCocosThread can spend each frame.
+     * Once it is spent, the remaining functions are performed on the next frames.
+     * @param budget The time in seconds. 0, the default, performs all the queued functions every frame.
+     * @since v3.16
+     * @js NA
+     */
+    void setFunctionsToPerformTimeBudget(float budget) { _functionsToPerformTimeBudget = budget; }
+
+    /**
+     * Gets the time the functions queued with Scheduler::performFunctionInCocosThread can spend each frame.
+     * @since v3.16
+     * @js NA
+     */
+    float getFunctionsToPerformTimeBudget() const { return _functionsToPerformTimeBudget; }
+
+    /**
+     * Returns the number of functions queued with Scheduler::performFunctionInCocosThread not performed yet.
+     * This function is thread safe
+     * @since v3.16
+     * @js NA
+     */
+    size_t getFunctionsToPerformCount() const { return _functionsToPerform.getSize(); }
+
+    /**
+     * Returns the statistics of the functions queued with Scheduler::performFunctionInCocosThread:
+     * queue depth, functions performed last frame and their latency.
+     * @since v3.16
+     * @js NA
+     */
+    std::string getFunctionsToPerformInfo() const;
+    
+    /**
+     * Returns the statistics of the timer wheel of the scheduled selectors and callbacks.
+     * @since v3.16
+     * @js NA
+     */
+    std::string getTimerWheelInfo() const;
     
     /////////////////////////////////////
     
@@ -512,39 +576,121 @@ protected:
     void schedulePerFrame(const ccSchedulerFunc& callback, void *target, int priority, bool paused);
     
     void removeHashElement(struct _hashSelectorEntry *element);
-    void removeUpdateFromHash(struct _listEntry *entry);
+
+    // timers specific
+
+    /** Hierarchical timing wheel holding the timers of the selectors and callbacks until their deadline.
+     Each level has LEVEL_SIZE slots, a slot of level n spans LEVEL_SIZE^n ticks of 'resolution' seconds.
+     */
+    class TimerWheel
+    {
+    public:
+        static const int LEVEL_BITS = 8;
+        static const int LEVEL_SIZE = 1 << LEVEL_BITS;
+        static const int LEVEL_COUNT = 4;
+
+        explicit TimerWheel(double resolution);
+        /** Adds a timer that has to be updated once the time reaches 'deadline'. */
+        void add(Timer *timer, double deadline);
+        /** Removes a timer, it may be one of the due timers. */
+        void remove(Timer *timer);
+        /** Moves the timers whose deadline is reached to the due timers. Removed due timers are set to nullptr. */
+        void advance(double time);
+        std::vector<Timer*>& getDueTimers() { return _dueTimers; }
+        std::string getInfo() const;
+
+    private:
+        void insert(Timer *timer, std::vector<Timer*>& list);
+        void take(Timer *timer);
+        void insertAtTick(Timer *timer, uint64_t tick);
+        void cascade(int level);
+
+        double _resolution;
+        double _time;                                      // time of the last advance
+        uint64_t _tick;                                    // next tick to process
+        std::vector<Timer*> _slots[LEVEL_COUNT][LEVEL_SIZE];
+        std::vector<Timer*> _nextAdvance;                  // checked on the next advance, whatever the time
+        std::vector<Timer*> _dueTimers;
+        size_t _timerCount;                                // timers in the slots and in _nextAdvance
+
+        // statistics
+        size_t _lastDueCount;
+        size_t _lastCascadedCount;
+        uint64_t _totalDueCount;
+    };
+
+    /** Adds the timer to the wheel, at the time it has to be updated next. */
+    void addTimerToWheel(Timer *timer);
+    void pauseTimers(struct _hashSelectorEntry *element);
+    void resumeTimers(struct _hashSelectorEntry *element);
 
     // update specific
 
-    void priorityIn(struct _listEntry **list, const ccSchedulerFunc& callback, void *target, int priority, bool paused);
-    void appendIn(struct _listEntry **list, const ccSchedulerFunc& callback, void *target, bool paused);
+    /** An 'update' callback of a target. */
+    struct UpdateSlot
+    {
+        ccSchedulerFunc callback;
+        void *target;
+        int priority;
+        bool paused;
+        bool markedForDeletion; // callback will no longer be called and slot will be removed at the next flush
+    };
 
+    /** Open addressing hash map from a target to the index of its update slot.
+     Indexes >= 0 are in _updateSlots, index -1 - i is _pendingUpdateSlots[i].
+     */
+    class UpdateSlotMap
+    {
+    public:
+        UpdateSlotMap();
+        /** Returns the index of the slot of the target, or INVALID_INDEX. */
+        int find(void *target) const;
+        void set(void *target, int index);
+        void erase(void *target);
+        void clear();
+
+        static const int INVALID_INDEX;
+    private:
+        struct Bucket
+        {
+            void *target;
+            int index;
+        };
+        size_t bucketOf(void *target) const;
+        void rehash(size_t bucketCount);
+
+        std::vector<Bucket> _buckets;
+        size_t _count;
+    };
+
+    UpdateSlot* findUpdateSlot(void *target);
+    /** Removes the slots marked for deletion and merges the pending slots, in priority order. */
+    void flushUpdateSlots();
 
     float _timeScale;
 
     //
     // "updates with priority" stuff
     //
-    struct _listEntry *_updatesNegList;        // list of priority < 0
-    struct _listEntry *_updates0List;            // list priority == 0
-    struct _listEntry *_updatesPosList;        // list priority > 0
-    struct _hashUpdateEntry *_hashForUpdates; // hash used to fetch quickly the list entries for pause,delete,etc
-    std::vector<struct _listEntry *> _updateDeleteVector; // the vector holds list entries that needs to be deleted after update
+    std::vector<UpdateSlot> _updateSlots;        // sorted by priority, then by order of scheduling
+    std::vector<UpdateSlot> _pendingUpdateSlots; // scheduled since the last flush, they are first called on the next update
+    UpdateSlotMap _updateSlotMap;                // used to fetch quickly the slots for pause,delete,etc
+    bool _updateSlotsDirty;                      // there are pending slots or slots marked for deletion
 
     // Used for "selectors with interval"
+    double _time;                                // sum of the scaled elapsed times, in seconds
+    TimerWheel _timerWheel;
     struct _hashSelectorEntry *_hashForTimers;
     struct _hashSelectorEntry *_currentTarget;
     bool _currentTargetSalvaged;
-    // If true unschedule will not remove anything from a hash. Elements will only be marked for deletion.
-    bool _updateHashLocked;
     
 #if CC_ENABLE_SCRIPT_BINDING
     Vector<SchedulerScriptHandlerEntry*> _scriptHandlerEntries;
 #endif
     
     // Used for "perform Function"
-    std::vector<std::function<void()>> _functionsToPerform;
-    std::mutex _performMutex;
+    FunctionQueue _functionsToPerform;
+    float _functionsToPerformTimeBudget;
 };
 
 // end of base group
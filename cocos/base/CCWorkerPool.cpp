@@ -0,0 +1,160 @@
+/****************************************************************************
+Copyright (c) 2017 Chukong Technologies Inc.
+
+http://www.cocos2d-x.org
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+****************************************************************************/
+
+#include "base/CCWorkerPool.h"
+#include <algorithm>
+#include <atomic>
+#include <memory>
+
+NS_CC_BEGIN
+
+WorkerPool* WorkerPool::s_workerPool = nullptr;
+
+WorkerPool* WorkerPool::getInstance()
+{
+    if (s_workerPool == nullptr)
+    {
+        s_workerPool = new (std::nothrow) WorkerPool();
+    }
+    return s_workerPool;
+}
+
+void WorkerPool::destroyInstance()
+{
+    delete s_workerPool;
+    s_workerPool = nullptr;
+}
+
+WorkerPool::WorkerPool()
+: _stop(false)
+{
+    // the thread calling parallelFor() works too, leave a core for it
+    int count = std::max((int)std::thread::hardware_concurrency() - 1, 1);
+    for (int i = 0; i < count; ++i)
+    {
+        _threads.emplace_back(&WorkerPool::workerLoop, this);
+    }
+}
+
+WorkerPool::~WorkerPool()
+{
+    {
+        std::unique_lock<std::mutex> lock(_queueMutex);
+        _stop = true;
+    }
+    _condition.notify_all();
+    for (auto& thread : _threads)
+    {
+        thread.join();
+    }
+}
+
+void WorkerPool::workerLoop()
+{
+    for (;;)
+    {
+        std::function<void()> task;
+        {
+            std::unique_lock<std::mutex> lock(_queueMutex);
+            _condition.wait(lock, [this]{ return _stop || !_tasks.empty(); });
+            if (_stop && _tasks.empty())
+                return;
+            task = std::move(_tasks.front());
+            _tasks.pop();
+        }
+
+        task();
+    }
+}
+
+void WorkerPool::enqueue(const std::function<void()>& task)
+{
+    {
+        std::unique_lock<std::mutex> lock(_queueMutex);
+
+        // don't allow enqueueing after stopping the pool
+        if (_stop)
+        {
+            CC_ASSERT(0 && "already stop");
+            return;
+        }
+        _tasks.push(task);
+    }
+    _condition.notify_one();
+}
+
+void WorkerPool::parallelFor(int count, const std::function<void(int)>& func)
+{
+    if (count <= 0)
+        return;
+
+    if (count == 1 || _threads.empty())
+    {
+        for (int i = 0; i < count; ++i)
+            func(i);
+        return;
+    }
+
+    // shared with the helpers, which may only start after the work is done and this call returned
+    struct Job
+    {
+        std::atomic<int> next;
+        std::atomic<int> done;
+        int count;
+        const std::function<void(int)>* func;
+        std::mutex mutex;
+        std::condition_variable finished;
+    };
+    auto job = std::make_shared<Job>();
+    job->next = 0;
+    job->done = 0;
+    job->count = count;
+    job->func = &func;
+
+    auto work = [](Job* job) {
+        int index;
+        while ((index = job->next.fetch_add(1)) < job->count)
+        {
+            (*job->func)(index);
+            if (job->done.fetch_add(1) + 1 == job->count)
+            {
+                std::lock_guard<std::mutex> lock(job->mutex);
+                job->finished.notify_all();
+            }
+        }
+    };
+
+    int helpers = std::min(count - 1, (int)_threads.size());
+    for (int i = 0; i < helpers; ++i)
+    {
+        enqueue([job, work]() { work(job.get()); });
+    }
+
+    work(job.get());
+
+    std::unique_lock<std::mutex> lock(job->mutex);
+    job->finished.wait(lock, [&job]{ return job->done == job->count; });
+}
+
+NS_CC_END
@@ -0,0 +1,103 @@
+/****************************************************************************
+Copyright (c) 2017 Chukong Technologies Inc.
+
+http://www.cocos2d-x.org
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+****************************************************************************/
+
+#ifndef __CCWORKER_POOL_H_
+#define __CCWORKER_POOL_H_
+
+#include "platform/CCPlatformMacros.h"
+#include <vector>
+#include <queue>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+
+/**
+* @addtogroup base
+* @{
+*/
+NS_CC_BEGIN
+
+/**
+ * @class WorkerPool
+ * @brief Spreads CPU work over a pool of threads, one per spare core.
+ *
+ * Unlike AsyncTaskPool, parallelFor() returns once the work is done, with the calling thread
+ * helping, so it can be used to split per-frame work such as scene traversal or particle updates.
+ * @js NA
+ */
+class CC_DLL WorkerPool
+{
+public:
+    /**
+     * Returns the shared instance of the worker pool.
+     */
+    static WorkerPool* getInstance();
+
+    /**
+     * Destroys the worker pool, waiting for the running tasks.
+     */
+    static void destroyInstance();
+
+    /**
+     * Returns the number of threads running the work of parallelFor(), the calling thread included.
+     */
+    int getConcurrency() const { return (int)_threads.size() + 1; }
+
+    /**
+     * Calls func(index) for every index in [0, count), spread over the worker threads and the calling thread.
+     * Returns when all the calls are done. It may be called from a worker thread.
+     *
+     * @param count number of indices.
+     * @param func function called once per index, possibly concurrently.
+     */
+    void parallelFor(int count, const std::function<void(int)>& func);
+
+    /**
+     * Enqueues a task that runs on a worker thread. Nothing waits for it.
+     *
+     * @param task the function to run.
+     */
+    void enqueue(const std::function<void()>& task);
+
+CC_CONSTRUCTOR_ACCESS:
+    WorkerPool();
+    ~WorkerPool();
+
+protected:
+    void workerLoop();
+
+    std::vector<std::thread> _threads;
+    std::queue<std::function<void()>> _tasks;
+    std::mutex _queueMutex;
+    std::condition_variable _condition;
+    bool _stop;
+
+    static WorkerPool* s_workerPool;
+};
+
+NS_CC_END
+// end group
+/// @}
+#endif //__CCWORKER_POOL_H_
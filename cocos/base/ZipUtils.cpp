@@ -23,13 +23,6 @@
  THE SOFTWARE.
  ****************************************************************************/
 
-// FIXME: hack, must be included before ziputils
-#ifdef MINIZIP_FROM_SYSTEM
-#include <minizip/unzip.h>
-#else // from our embedded sources
-#include "unzip.h"
-#endif
-
 #include "base/ZipUtils.h"
 
 #include <zlib.h>
@@ -38,24 +31,30 @@
 
 #include "base/CCData.h"
 #include "base/ccMacros.h"
+#include "base/CCWorkerPool.h"
 #include "platform/CCFileUtils.h"
-#include <map>
-
-// FIXME: Other platforms should use upstream minizip like mingw-w64  
-#ifdef MINIZIP_FROM_SYSTEM
-#define unzGoToFirstFile64(A,B,C,D) unzGoToFirstFile2(A,B,C,D, NULL, 0, NULL, 0)
-#define unzGoToNextFile64(A,B,C,D) unzGoToNextFile2(A,B,C,D, NULL, 0, NULL, 0)
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <climits>
+#include <limits>
+#include <mutex>
+
+#if (CC_TARGET_PLATFORM != CC_PLATFORM_WIN32) && (CC_TARGET_PLATFORM != CC_PLATFORM_WINRT)
+#include <fcntl.h>
+#include <unistd.h>
 #endif
 
 NS_CC_BEGIN
 
 unsigned int ZipUtils::s_uEncryptedPvrKeyParts[4] = {0,0,0,0};
 unsigned int ZipUtils::s_uEncryptionKey[1024];
-bool ZipUtils::s_bEncryptionKeyIsValid = false;
+std::atomic<bool> ZipUtils::s_bEncryptionKeyIsValid(false);
+static std::mutex s_encryptionKeyMutex;
 
 // --------------------- ZipUtils ---------------------
 
-inline void ZipUtils::decodeEncodedPvr(unsigned int *data, ssize_t len)
+inline void ZipUtils::decodeEncodedPvr(unsigned int *data, ssize_t len, ssize_t first)
 {
     const int enclen = 1024;
     const int securelen = 512;
@@ -68,59 +67,58 @@ inline void ZipUtils::decodeEncodedPvr(unsigned int *data, ssize_t len)
     CCASSERT(s_uEncryptedPvrKeyParts[2] != 0, "Cocos2D: CCZ file is encrypted but key part 2 is not set. Did you call ZipUtils::setPvrEncryptionKeyPart(...)?");
     CCASSERT(s_uEncryptedPvrKeyParts[3] != 0, "Cocos2D: CCZ file is encrypted but key part 3 is not set. Did you call ZipUtils::setPvrEncryptionKeyPart(...)?");
     
-    // create long key
-    if(!s_bEncryptionKeyIsValid)
+    // create long key, once: the threads loading images decode concurrently
+    if(!s_bEncryptionKeyIsValid.load(std::memory_order_acquire))
     {
-        unsigned int y, p, e;
-        unsigned int rounds = 6;
-        unsigned int sum = 0;
-        unsigned int z = s_uEncryptionKey[enclen-1];
-        
-        do
+        std::lock_guard<std::mutex> lock(s_encryptionKeyMutex);
+        if (!s_bEncryptionKeyIsValid.load(std::memory_order_relaxed))
         {
+            unsigned int y, p, e;
+            unsigned int rounds = 6;
+            unsigned int sum = 0;
+            unsigned int z = s_uEncryptionKey[enclen-1];
+        
+            do
+            {
 #define DELTA 0x9e3779b9
 #define MX (((z>>5^y<<2) + (y>>3^z<<4)) ^ ((sum^y) + (s_uEncryptedPvrKeyParts[(p&3)^e] ^ z)))
             
-            sum += DELTA;
-            e = (sum >> 2) & 3;
+                sum += DELTA;
+                e = (sum >> 2) & 3;
             
-            for (p = 0; p < enclen - 1; p++)
-            {
-                y = s_uEncryptionKey[p + 1];
-                z = s_uEncryptionKey[p] += MX;
-            }
+                for (p = 0; p < enclen - 1; p++)
+                {
+                    y = s_uEncryptionKey[p + 1];
+                    z = s_uEncryptionKey[p] += MX;
+                }
             
-            y = s_uEncryptionKey[0];
-            z = s_uEncryptionKey[enclen - 1] += MX;
+                y = s_uEncryptionKey[0];
+                z = s_uEncryptionKey[enclen - 1] += MX;
             
-        } while (--rounds);
+            } while (--rounds);
         
-        s_bEncryptionKeyIsValid = true;
+            s_bEncryptionKeyIsValid.store(true, std::memory_order_release);
+        }
     }
     
-    int b = 0;
-    int i = 0;
+    // data holds the words [first, first + len) of the encrypted area
+    ssize_t i = first;
+    ssize_t end = first + len;
     
     // encrypt first part completely
-    for(; i < len && i < securelen; i++)
+    for(; i < end && i < securelen; i++)
     {
-        data[i] ^= s_uEncryptionKey[b++];
-        
-        if(b >= enclen)
-        {
-            b = 0;
-        }
+        data[i - first] ^= s_uEncryptionKey[i];
     }
     
-    // encrypt second section partially
-    for(; i < len; i += distance)
+    // encrypt second section partially, every distance words from the end of the first part
+    if (i < end && (i - securelen) % distance != 0)
     {
-        data[i] ^= s_uEncryptionKey[b++];
-        
-        if(b >= enclen)
-        {
-            b = 0;
-        }
+        i += distance - (i - securelen) % distance;
+    }
+    for(; i < end; i += distance)
+    {
+        data[i - first] ^= s_uEncryptionKey[(securelen + (i - securelen) / distance) % enclen];
     }
 }
 
@@ -243,6 +241,19 @@ ssize_t ZipUtils::inflateMemoryWithHint(unsigned char *in, ssize_t inLength, uns
 
 ssize_t ZipUtils::inflateMemory(unsigned char *in, ssize_t inLength, unsigned char **out)
 {
+    // a gzip stream ends with its inflated size modulo 2^32, so the buffer is allocated once
+    // unless there are several members or it's bigger
+    if (isGZipBuffer(in, inLength) && inLength >= 18)
+    {
+        const unsigned char* size = in + inLength - 4;
+        ssize_t hint = (ssize_t)((unsigned int)size[0] | ((unsigned int)size[1] << 8) | ((unsigned int)size[2] << 16) | ((unsigned int)size[3] << 24));
+        // deflate can't compress more than 1032:1, a bigger size is a corrupted trailer
+        if (hint > 0 && hint / 1032 <= inLength)
+        {
+            return inflateMemoryWithHint(in, inLength, out, hint);
+        }
+    }
+
     // 256k for hint
     return inflateMemoryWithHint(in, inLength, out, 256 * 1024);
 }
@@ -368,73 +379,194 @@ bool ZipUtils::isGZipBuffer(const unsigned char *buffer, ssize_t len)
 }
 
 
-int ZipUtils::inflateCCZBuffer(const unsigned char *buffer, ssize_t bufferLen, unsigned char **out)
+// the header of an encrypted ccz file is followed by the encrypted area, which starts with the len field of the header
+static const ssize_t CCZ_ENCRYPTED_AREA_OFFSET = 12;
+
+ssize_t ZipUtils::getCCZUncompressedLength(const unsigned char *buffer, ssize_t bufferLen)
 {
-    struct CCZHeader *header = (struct CCZHeader*) buffer;
+    if (!isCCZBuffer(buffer, bufferLen))
+    {
+        CCLOG("cocos2d: Invalid CCZ file");
+        return -1;
+    }
 
-    // verify header
-    if( header->sig[0] == 'C' && header->sig[1] == 'C' && header->sig[2] == 'Z' && header->sig[3] == '!' )
+    const struct CCZHeader *header = (const struct CCZHeader*) buffer;
+    unsigned int version = CC_SWAP_INT16_BIG_TO_HOST( header->version );
+    unsigned int compression = CC_SWAP_INT16_BIG_TO_HOST( header->compression_type );
+    unsigned int len = header->len;
+
+    if( header->sig[3] == '!' )
     {
-        // verify header version
-        unsigned int version = CC_SWAP_INT16_BIG_TO_HOST( header->version );
+        // verify header version and compression format
         if( version > 2 )
         {
             CCLOG("cocos2d: Unsupported CCZ header format");
             return -1;
         }
-
-        // verify compression format
-        if( CC_SWAP_INT16_BIG_TO_HOST(header->compression_type) != CCZ_COMPRESSION_ZLIB )
+        if( compression != CCZ_COMPRESSION_ZLIB && compression != CCZ_COMPRESSION_ZLIB_CHUNKED )
         {
             CCLOG("cocos2d: CCZ Unsupported compression method");
             return -1;
         }
     }
-    else if( header->sig[0] == 'C' && header->sig[1] == 'C' && header->sig[2] == 'Z' && header->sig[3] == 'p' )
+    else
     {
         // encrypted ccz file
-        header = (struct CCZHeader*) buffer;
-
-        // verify header version
-        unsigned int version = CC_SWAP_INT16_BIG_TO_HOST( header->version );
         if( version > 0 )
         {
             CCLOG("cocos2d: Unsupported CCZ header format");
             return -1;
         }
-
-        // verify compression format
-        if( CC_SWAP_INT16_BIG_TO_HOST(header->compression_type) != CCZ_COMPRESSION_ZLIB )
+        if( compression != CCZ_COMPRESSION_ZLIB )
         {
             CCLOG("cocos2d: CCZ Unsupported compression method");
             return -1;
         }
 
-        // decrypt
-        unsigned int* ints = (unsigned int*)(buffer+12);
-        ssize_t enclen = (bufferLen-12)/4;
+        // the length is the first encrypted word
+        decodeEncodedPvr(&len, 1, 0);
+    }
+
+    return CC_SWAP_INT32_BIG_TO_HOST( len );
+}
+
+bool ZipUtils::inflateCCZBuffer(const unsigned char *buffer, ssize_t bufferLen, unsigned char *out, ssize_t outLength)
+{
+    ssize_t len = getCCZUncompressedLength(buffer, bufferLen);
+    if (len < 0 || !out || outLength < len)
+    {
+        return false;
+    }
+
+    const struct CCZHeader *header = (const struct CCZHeader*) buffer;
+    const bool encrypted = header->sig[3] == 'p';
+    const unsigned char* source = buffer + sizeof(*header);
+    const ssize_t sourceLen = bufferLen - sizeof(*header);
+
+    if (CC_SWAP_INT16_BIG_TO_HOST(header->compression_type) == CCZ_COMPRESSION_ZLIB_CHUNKED)
+    {
+        // the chunks are independent zlib streams, written one after the other
+        if (static_cast<size_t>(sourceLen) < sizeof(CCZChunkTable))
+        {
+            CCLOG("cocos2d: CCZ: Invalid chunk table");
+            return false;
+        }
+        const CCZChunkTable* table = (const CCZChunkTable*) source;
+        const ssize_t chunkSize = CC_SWAP_INT32_BIG_TO_HOST(table->chunkSize);
+        const ssize_t chunkCount = CC_SWAP_INT32_BIG_TO_HOST(table->chunkCount);
+        if (chunkSize <= 0 || chunkCount != (len + chunkSize - 1) / chunkSize
+            || (ssize_t)(sizeof(CCZChunkTable) + chunkCount * sizeof(unsigned int)) > sourceLen)
+        {
+            CCLOG("cocos2d: CCZ: Invalid chunk table");
+            return false;
+        }
+
+        const unsigned int* compressedSizes = (const unsigned int*)(source + sizeof(CCZChunkTable));
+        std::vector<ssize_t> offsets(chunkCount + 1);
+        offsets[0] = sizeof(CCZChunkTable) + chunkCount * sizeof(unsigned int);
+        for (ssize_t i = 0; i < chunkCount; ++i)
+        {
+            offsets[i + 1] = offsets[i] + CC_SWAP_INT32_BIG_TO_HOST(compressedSizes[i]);
+        }
+        if (offsets[chunkCount] > sourceLen)
+        {
+            CCLOG("cocos2d: CCZ: Invalid chunk table");
+            return false;
+        }
 
-        decodeEncodedPvr(ints, enclen);
+        std::atomic<bool> failed(false);
+        WorkerPool::getInstance()->parallelFor((int)chunkCount, [&](int i) {
+            uLongf destLen = (uLongf)std::min(chunkSize, len - i * chunkSize);
+            const uLongf expectedLen = destLen;
+            int ret = uncompress(out + i * chunkSize, &destLen, (const Bytef*)source + offsets[i], (uLong)(offsets[i + 1] - offsets[i]));
+            if (ret != Z_OK || destLen != expectedLen)
+                failed = true;
+        });
+        if (failed)
+        {
+            CCLOG("cocos2d: CCZ: Failed to uncompress data");
+            return false;
+        }
+        return true;
+    }
 
 #if COCOS2D_DEBUG > 0
+    if (encrypted)
+    {
         // verify checksum in debug mode
-        unsigned int calculated = checksumPvr(ints, enclen);
+        unsigned int words[128];
+        ssize_t count = std::min<ssize_t>(128, (bufferLen - CCZ_ENCRYPTED_AREA_OFFSET) / 4);
+        memcpy(words, buffer + CCZ_ENCRYPTED_AREA_OFFSET, count * 4);
+        decodeEncodedPvr(words, count, 0);
+        unsigned int calculated = checksumPvr(words, count);
         unsigned int required = CC_SWAP_INT32_BIG_TO_HOST( header->reserved );
 
         if(calculated != required)
         {
             CCLOG("cocos2d: Can't decrypt image file. Is the decryption key valid?");
-            return -1;
+            return false;
         }
+    }
 #endif
+
+    z_stream stream;
+    memset(&stream, 0, sizeof(stream));
+    if (inflateInit(&stream) != Z_OK)
+    {
+        CCLOG("cocos2d: CCZ: Failed to uncompress data");
+        return false;
+    }
+    stream.next_out = out;
+    stream.avail_out = static_cast<uInt>(len);
+
+    int ret = Z_OK;
+    if (!encrypted)
+    {
+        stream.next_in = const_cast<Bytef*>(source);
+        stream.avail_in = static_cast<uInt>(sourceLen);
+        ret = inflate(&stream, Z_FINISH);
     }
     else
     {
-        CCLOG("cocos2d: Invalid CCZ file");
-        return -1;
+        // the encrypted words are decrypted in a small buffer on their way to zlib, rather than in place,
+        // since the buffer may be a read only view of the file
+        const ssize_t encryptedWords = (bufferLen - CCZ_ENCRYPTED_AREA_OFFSET) / 4;
+        unsigned int words[4096];
+        ssize_t offset = 0;
+        while (ret == Z_OK && offset < sourceLen)
+        {
+            ssize_t count = std::min<ssize_t>(sizeof(words), sourceLen - offset);
+            memcpy(words, source + offset, count);
+
+            // the source starts with the second encrypted word, and a trailing partial word isn't encrypted
+            ssize_t firstWord = 1 + offset / 4;
+            ssize_t wordCount = std::min<ssize_t>(count / 4, encryptedWords - firstWord);
+            if (wordCount > 0)
+                decodeEncodedPvr(words, wordCount, firstWord);
+
+            stream.next_in = (Bytef*)words;
+            stream.avail_in = static_cast<uInt>(count);
+            ret = inflate(&stream, Z_NO_FLUSH);
+            offset += count;
+        }
     }
+    inflateEnd(&stream);
 
-    unsigned int len = CC_SWAP_INT32_BIG_TO_HOST( header->len );
+    if (ret != Z_STREAM_END || stream.total_out != (uLong)len)
+    {
+        CCLOG("cocos2d: CCZ: Failed to uncompress data");
+        return false;
+    }
+    return true;
+}
+
+int ZipUtils::inflateCCZBuffer(const unsigned char *buffer, ssize_t bufferLen, unsigned char **out)
+{
+    ssize_t len = getCCZUncompressedLength(buffer, bufferLen);
+    if (len < 0)
+    {
+        return -1;
+    }
 
     *out = (unsigned char*)malloc( len );
     if(! *out )
@@ -443,19 +575,14 @@ int ZipUtils::inflateCCZBuffer(const unsigned char *buffer, ssize_t bufferLen, u
         return -1;
     }
 
-    unsigned long destlen = len;
-    size_t source = (size_t) buffer + sizeof(*header);
-    int ret = uncompress(*out, &destlen, (Bytef*)source, bufferLen - sizeof(*header) );
-
-    if( ret != Z_OK )
+    if (!inflateCCZBuffer(buffer, bufferLen, *out, len))
     {
-        CCLOG("cocos2d: CCZ: Failed to uncompress data");
         free( *out );
         *out = nullptr;
         return -1;
     }
 
-    return len;
+    return (int)len;
 }
 
 int ZipUtils::inflateCCZFile(const char *path, unsigned char **out)
@@ -481,6 +608,7 @@ void ZipUtils::setPvrEncryptionKeyPart(int index, unsigned int value)
     
     if(s_uEncryptedPvrKeyParts[index] != value)
     {
+        std::lock_guard<std::mutex> lock(s_encryptionKeyMutex);
         s_uEncryptedPvrKeyParts[index] = value;
         s_bEncryptionKeyIsValid = false;
     }
@@ -495,27 +623,318 @@ void ZipUtils::setPvrEncryptionKey(unsigned int keyPart1, unsigned int keyPart2,
 }
 
 // --------------------- ZipFile ---------------------
-// from unzip.cpp
-#define UNZ_MAXFILENAMEINZIP 256
-
 static const std::string emptyFilename("");
 
+// signatures and sizes of the zip records, see the APPNOTE of PKWARE
+static const uint32_t ZIP_LOCAL_HEADER_SIGNATURE = 0x04034b50;
+static const uint32_t ZIP_CENTRAL_HEADER_SIGNATURE = 0x02014b50;
+static const uint32_t ZIP_END_OF_CENTRAL_DIRECTORY_SIGNATURE = 0x06054b50;
+static const uint32_t ZIP64_END_OF_CENTRAL_DIRECTORY_SIGNATURE = 0x06064b50;
+static const uint32_t ZIP64_END_OF_CENTRAL_DIRECTORY_LOCATOR_SIGNATURE = 0x07064b50;
+static const uint64_t ZIP_LOCAL_HEADER_SIZE = 30;
+static const uint64_t ZIP_CENTRAL_HEADER_SIZE = 46;
+static const uint64_t ZIP_END_OF_CENTRAL_DIRECTORY_SIZE = 22;
+static const uint64_t ZIP64_END_OF_CENTRAL_DIRECTORY_SIZE = 56;
+static const uint64_t ZIP64_END_OF_CENTRAL_DIRECTORY_LOCATOR_SIZE = 20;
+static const uint16_t ZIP64_EXTRA_FIELD_ID = 0x0001;
+static const uint16_t ZIP_METHOD_STORED = 0;
+static const uint16_t ZIP_METHOD_DEFLATED = 8;
+static const uint16_t ZIP_FLAG_ENCRYPTED = 0x0001;
+
+static inline uint16_t readZipUint16(const unsigned char* p)
+{
+    return (uint16_t)(p[0] | (p[1] << 8));
+}
+
+static inline uint32_t readZipUint32(const unsigned char* p)
+{
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+static inline uint64_t readZipUint64(const unsigned char* p)
+{
+    return (uint64_t)readZipUint32(p) | ((uint64_t)readZipUint32(p + 4) << 32);
+}
+
 struct ZipEntryInfo
 {
-    unz_file_pos pos;
-    uLong uncompressed_size;
+    std::string name;
+    uint64_t localHeaderOffset;
+    uint64_t compressedSize;
+    uint64_t uncompressedSize;
+    uint16_t method;
+    uint16_t flags;
 };
 
 class ZipFilePrivate
 {
 public:
-    unzFile zipFile;
-    
-    // std::unordered_map is faster if available on the platform
-    typedef std::unordered_map<std::string, struct ZipEntryInfo> FileListContainer;
-    FileListContainer fileList;
+    ZipFilePrivate()
+    : bytes(nullptr)
+    , size(0)
+    , filterBegin(0)
+    , filterEnd(0)
+    , iterator(0)
+    , timingEnabled(false)
+    {
+    }
+
+    bool parseCentralDirectory();
+    const ZipEntryInfo* findEntry(const std::string& fileName) const;
+    // a range of the archive, pointing in the mapping or read from the file into storage, nullptr if it can't be read
+    const unsigned char* getArchiveRange(uint64_t offset, uint64_t length, std::vector<unsigned char>& storage) const;
+    // the stored or deflated data of an entry, nullptr if its local header is invalid
+    const unsigned char* getEntryData(const ZipEntryInfo& entry, std::vector<unsigned char>& storage) const;
+    bool readEntry(const ZipEntryInfo& entry, unsigned char* out) const;
+    void addReadTiming(const ZipEntryInfo& entry, const std::chrono::steady_clock::time_point& start) const;
+
+    // the path of the archive, empty when it is read from a buffer
+    std::string zipFilePath;
+    // the mapped archive, null if it can't be mapped and is read from the file
+    FileView archive;
+    const unsigned char* bytes;
+    uint64_t size;
+
+    // every entry of the central directory, in the order of the archive
+    std::vector<ZipEntryInfo> entries;
+    // the indices of the entries sorted by name, the entries with the same name stay in the order of the archive
+    std::vector<size_t> sortedEntries;
+    // the range of sortedEntries accepted by the filter
+    size_t filterBegin;
+    size_t filterEnd;
+    // the entry of getFirstFilename() / getNextFilename()
+    size_t iterator;
+
+    std::atomic<bool> timingEnabled;
+    mutable std::mutex timingMutex;
+    mutable std::vector<ZipFile::ReadTiming> timings;
 };
 
+bool ZipFilePrivate::parseCentralDirectory()
+{
+    entries.clear();
+    sortedEntries.clear();
+    if (size < ZIP_END_OF_CENTRAL_DIRECTORY_SIZE)
+        return false;
+
+    // the end of central directory record is followed by a comment of up to 64KB
+    const uint64_t tailSize = std::min(size, ZIP_END_OF_CENTRAL_DIRECTORY_SIZE + 0xffff);
+    std::vector<unsigned char> tailStorage;
+    const unsigned char* tail = getArchiveRange(size - tailSize, tailSize, tailStorage);
+    if (!tail)
+        return false;
+
+    uint64_t eocdInTail = tailSize - ZIP_END_OF_CENTRAL_DIRECTORY_SIZE;
+    while (readZipUint32(tail + eocdInTail) != ZIP_END_OF_CENTRAL_DIRECTORY_SIGNATURE)
+    {
+        if (eocdInTail == 0)
+            return false;
+        --eocdInTail;
+    }
+    const unsigned char* eocdRecord = tail + eocdInTail;
+    const uint64_t eocd = size - tailSize + eocdInTail;
+
+    uint64_t entryCount = readZipUint16(eocdRecord + 10);
+    uint64_t directorySize = readZipUint32(eocdRecord + 12);
+    uint64_t directoryOffset = readZipUint32(eocdRecord + 16);
+
+    // zip64 archives keep the real values in another record, found through the locator before the end record
+    if ((entryCount == 0xffff || directorySize == 0xffffffff || directoryOffset == 0xffffffff)
+        && eocd >= ZIP64_END_OF_CENTRAL_DIRECTORY_LOCATOR_SIZE)
+    {
+        std::vector<unsigned char> locatorStorage;
+        const unsigned char* locator = getArchiveRange(eocd - ZIP64_END_OF_CENTRAL_DIRECTORY_LOCATOR_SIZE, ZIP64_END_OF_CENTRAL_DIRECTORY_LOCATOR_SIZE, locatorStorage);
+        if (locator && readZipUint32(locator) == ZIP64_END_OF_CENTRAL_DIRECTORY_LOCATOR_SIGNATURE)
+        {
+            std::vector<unsigned char> eocd64Storage;
+            const unsigned char* eocd64Record = getArchiveRange(readZipUint64(locator + 8), ZIP64_END_OF_CENTRAL_DIRECTORY_SIZE, eocd64Storage);
+            if (!eocd64Record || readZipUint32(eocd64Record) != ZIP64_END_OF_CENTRAL_DIRECTORY_SIGNATURE)
+                return false;
+            entryCount = readZipUint64(eocd64Record + 32);
+            directorySize = readZipUint64(eocd64Record + 40);
+            directoryOffset = readZipUint64(eocd64Record + 48);
+        }
+    }
+
+    if (directoryOffset > size || directorySize > size - directoryOffset
+        || entryCount > directorySize / ZIP_CENTRAL_HEADER_SIZE)
+        return false;
+
+    std::vector<unsigned char> directoryStorage;
+    const unsigned char* p = getArchiveRange(directoryOffset, directorySize, directoryStorage);
+    if (!p)
+        return false;
+
+    entries.reserve((size_t)entryCount);
+    const unsigned char* end = p + directorySize;
+    for (uint64_t i = 0; i < entryCount; ++i)
+    {
+        if ((uint64_t)(end - p) < ZIP_CENTRAL_HEADER_SIZE || readZipUint32(p) != ZIP_CENTRAL_HEADER_SIGNATURE)
+            return false;
+
+        const uint16_t nameLength = readZipUint16(p + 28);
+        const uint16_t extraLength = readZipUint16(p + 30);
+        const uint16_t commentLength = readZipUint16(p + 32);
+        if ((uint64_t)(end - p) < ZIP_CENTRAL_HEADER_SIZE + nameLength + extraLength + commentLength)
+            return false;
+
+        ZipEntryInfo entry;
+        entry.flags = readZipUint16(p + 8);
+        entry.method = readZipUint16(p + 10);
+        entry.compressedSize = readZipUint32(p + 20);
+        entry.uncompressedSize = readZipUint32(p + 24);
+        entry.localHeaderOffset = readZipUint32(p + 42);
+        entry.name.assign((const char*)p + ZIP_CENTRAL_HEADER_SIZE, nameLength);
+
+        // the zip64 extra field holds, in this order, the values which don't fit in 32 bits
+        const unsigned char* extra = p + ZIP_CENTRAL_HEADER_SIZE + nameLength;
+        const unsigned char* extraEnd = extra + extraLength;
+        while (extraEnd - extra >= 4)
+        {
+            const uint16_t fieldId = readZipUint16(extra);
+            const uint16_t fieldSize = readZipUint16(extra + 2);
+            const unsigned char* field = extra + 4;
+            if (extraEnd - field < fieldSize)
+                break;
+            if (fieldId == ZIP64_EXTRA_FIELD_ID)
+            {
+                const unsigned char* fieldEnd = field + fieldSize;
+                if (entry.uncompressedSize == 0xffffffff && fieldEnd - field >= 8)
+                {
+                    entry.uncompressedSize = readZipUint64(field);
+                    field += 8;
+                }
+                if (entry.compressedSize == 0xffffffff && fieldEnd - field >= 8)
+                {
+                    entry.compressedSize = readZipUint64(field);
+                    field += 8;
+                }
+                if (entry.localHeaderOffset == 0xffffffff && fieldEnd - field >= 8)
+                {
+                    entry.localHeaderOffset = readZipUint64(field);
+                }
+                break;
+            }
+            extra = field + fieldSize;
+        }
+
+        entries.push_back(std::move(entry));
+        p += ZIP_CENTRAL_HEADER_SIZE + nameLength + extraLength + commentLength;
+    }
+
+    sortedEntries.resize(entries.size());
+    for (size_t i = 0; i < sortedEntries.size(); ++i)
+    {
+        sortedEntries[i] = i;
+    }
+    std::stable_sort(sortedEntries.begin(), sortedEntries.end(), [this](size_t entry1, size_t entry2) {
+        return entries[entry1].name < entries[entry2].name;
+    });
+    return true;
+}
+
+const ZipEntryInfo* ZipFilePrivate::findEntry(const std::string& fileName) const
+{
+    // an archive may have several entries with the same name, the last one is used like when the archive is extracted
+    auto begin = sortedEntries.begin() + filterBegin;
+    auto end = sortedEntries.begin() + filterEnd;
+    auto it = std::upper_bound(begin, end, fileName, [this](const std::string& name, size_t entry) {
+        return name < entries[entry].name;
+    });
+    if (it == begin || entries[*(it - 1)].name != fileName)
+        return nullptr;
+    return &entries[*(it - 1)];
+}
+
+const unsigned char* ZipFilePrivate::getArchiveRange(uint64_t offset, uint64_t length, std::vector<unsigned char>& storage) const
+{
+    if (offset > size || length > size - offset)
+        return nullptr;
+    if (bytes)
+        return bytes + offset;
+    if (zipFilePath.empty() || offset > SIZE_MAX || length > SIZE_MAX)
+        return nullptr;
+
+    // the archive couldn't be mapped, each range is read from the file on its own
+    if (FileUtils::getInstance()->getFileRange(zipFilePath, (size_t)offset, (size_t)length, &storage) != FileUtils::Status::OK)
+        return nullptr;
+
+    static const unsigned char emptyRange = 0;
+    return storage.empty() ? &emptyRange : storage.data();
+}
+
+const unsigned char* ZipFilePrivate::getEntryData(const ZipEntryInfo& entry, std::vector<unsigned char>& storage) const
+{
+    // the local header repeats the name, and may have a different extra field than the central directory
+    const unsigned char* header = getArchiveRange(entry.localHeaderOffset, ZIP_LOCAL_HEADER_SIZE, storage);
+    if (!header || readZipUint32(header) != ZIP_LOCAL_HEADER_SIGNATURE)
+        return nullptr;
+
+    const uint64_t dataOffset = entry.localHeaderOffset + ZIP_LOCAL_HEADER_SIZE + readZipUint16(header + 26) + readZipUint16(header + 28);
+    return getArchiveRange(dataOffset, entry.compressedSize, storage);
+}
+
+bool ZipFilePrivate::readEntry(const ZipEntryInfo& entry, unsigned char* out) const
+{
+    std::vector<unsigned char> storage;
+    const unsigned char* data = getEntryData(entry, storage);
+    if (!data || (entry.flags & ZIP_FLAG_ENCRYPTED))
+        return false;
+
+    if (entry.method == ZIP_METHOD_STORED)
+    {
+        if (entry.compressedSize != entry.uncompressedSize)
+            return false;
+        memcpy(out, data, (size_t)entry.uncompressedSize);
+        return true;
+    }
+
+    if (entry.method != ZIP_METHOD_DEFLATED || entry.compressedSize > UINT_MAX || entry.uncompressedSize > UINT_MAX)
+        return false;
+
+    // each thread keeps its own raw inflate stream, which is reset for every file
+    struct InflateStream
+    {
+        z_stream stream;
+        bool initialized;
+
+        InflateStream() : initialized(false) { memset(&stream, 0, sizeof(stream)); }
+        ~InflateStream() { if (initialized) inflateEnd(&stream); }
+    };
+    static thread_local InflateStream inflater;
+
+    z_stream& stream = inflater.stream;
+    if (!inflater.initialized)
+    {
+        if (inflateInit2(&stream, -MAX_WBITS) != Z_OK)
+            return false;
+        inflater.initialized = true;
+    }
+    else if (inflateReset(&stream) != Z_OK)
+    {
+        return false;
+    }
+
+    stream.next_in = const_cast<Bytef*>(data);
+    stream.avail_in = (uInt)entry.compressedSize;
+    stream.next_out = out;
+    stream.avail_out = (uInt)entry.uncompressedSize;
+    int err = inflate(&stream, Z_FINISH);
+    return err == Z_STREAM_END && stream.total_out == entry.uncompressedSize;
+}
+
+void ZipFilePrivate::addReadTiming(const ZipEntryInfo& entry, const std::chrono::steady_clock::time_point& start) const
+{
+    ZipFile::ReadTiming timing;
+    timing.fileName = entry.name;
+    timing.size = (ssize_t)entry.uncompressedSize;
+    timing.compressed = entry.method != ZIP_METHOD_STORED;
+    timing.milliseconds = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+    std::lock_guard<std::mutex> lock(timingMutex);
+    timings.push_back(std::move(timing));
+}
+
 ZipFile *ZipFile::createWithBuffer(const void* buffer, uLong size)
 {
     ZipFile *zip = new (std::nothrow) ZipFile();
@@ -530,23 +949,36 @@ ZipFile *ZipFile::createWithBuffer(const void* buffer, uLong size)
 ZipFile::ZipFile()
 : _data(new ZipFilePrivate)
 {
-    _data->zipFile = nullptr;
 }
 
 ZipFile::ZipFile(const std::string &zipFile, const std::string &filter)
 : _data(new ZipFilePrivate)
 {
-    _data->zipFile = unzOpen(FileUtils::getInstance()->getSuitableFOpen(zipFile).c_str());
-    setFilter(filter);
-}
+    _data->zipFilePath = zipFile;
+    if (_data->archive.initWithMappedFile(zipFile))
+    {
+        _data->bytes = _data->archive.getBytes();
+        _data->size = (uint64_t)_data->archive.getSize();
+    }
+    else
+    {
+        // the archive isn't loaded whole, the central directory and the files are read from it when needed
+        long fileSize = FileUtils::getInstance()->getFileSize(zipFile);
+        _data->size = fileSize > 0 ? (uint64_t)fileSize : 0;
+    }
 
-ZipFile::~ZipFile()
-{
-    if (_data && _data->zipFile)
+    if (_data->parseCentralDirectory())
     {
-        unzClose(_data->zipFile);
+        setFilter(filter);
     }
+    else
+    {
+        CCLOG("cocos2d: ZipFile: invalid zip file %s", zipFile.c_str());
+    }
+}
 
+ZipFile::~ZipFile()
+{
     CC_SAFE_DELETE(_data);
 }
 
@@ -556,43 +988,23 @@ bool ZipFile::setFilter(const std::string &filter)
     do
     {
         CC_BREAK_IF(!_data);
-        CC_BREAK_IF(!_data->zipFile);
-        
-        // clear existing file list
-        _data->fileList.clear();
-        
-        // UNZ_MAXFILENAMEINZIP + 1 - it is done so in unzLocateFile
-        char szCurrentFileName[UNZ_MAXFILENAMEINZIP + 1];
-        unz_file_info64 fileInfo;
-        
-        // go through all files and store position information about the required files
-        int err = unzGoToFirstFile64(_data->zipFile, &fileInfo,
-                                     szCurrentFileName, sizeof(szCurrentFileName) - 1);
-        while (err == UNZ_OK)
-        {
-            unz_file_pos posInfo;
-            int posErr = unzGetFilePos(_data->zipFile, &posInfo);
-            if (posErr == UNZ_OK)
-            {
-                std::string currentFileName = szCurrentFileName;
-                // cache info about filtered files only (like 'assets/')
-                if (filter.empty()
-                    || currentFileName.substr(0, filter.length()) == filter)
-                {
-                    ZipEntryInfo entry;
-                    entry.pos = posInfo;
-                    entry.uncompressed_size = (uLong)fileInfo.uncompressed_size;
-                    _data->fileList[currentFileName] = entry;
-                }
-            }
-            // next file - also get the information about it
-            err = unzGoToNextFile64(_data->zipFile, &fileInfo,
-                                    szCurrentFileName, sizeof(szCurrentFileName) - 1);
-        }
+        CC_BREAK_IF(_data->entries.empty());
+
+        // the names starting with the filter are next to each other in the sorted entries
+        const auto& entries = _data->entries;
+        auto& sortedEntries = _data->sortedEntries;
+        auto begin = std::lower_bound(sortedEntries.begin(), sortedEntries.end(), filter, [&entries](size_t entry, const std::string& name) {
+            return entries[entry].name < name;
+        });
+        auto end = std::partition_point(begin, sortedEntries.end(), [&entries, &filter](size_t entry) {
+            return entries[entry].name.compare(0, filter.length(), filter) == 0;
+        });
+        _data->filterBegin = begin - sortedEntries.begin();
+        _data->filterEnd = end - sortedEntries.begin();
         ret = true;
-        
+
     } while(false);
-    
+
     return ret;
 }
 
@@ -603,7 +1015,7 @@ bool ZipFile::fileExists(const std::string &fileName) const
     {
         CC_BREAK_IF(!_data);
         
-        ret = _data->fileList.find(fileName) != _data->fileList.end();
+        ret = _data->findEntry(fileName) != nullptr;
     } while(false);
     
     return ret;
@@ -617,31 +1029,33 @@ unsigned char *ZipFile::getFileData(const std::string &fileName, ssize_t *size)
 
     do
     {
-        CC_BREAK_IF(!_data->zipFile);
         CC_BREAK_IF(fileName.empty());
-        
-        ZipFilePrivate::FileListContainer::const_iterator it = _data->fileList.find(fileName);
-        CC_BREAK_IF(it ==  _data->fileList.end());
-        
-        ZipEntryInfo fileInfo = it->second;
-        
-        int nRet = unzGoToFilePos(_data->zipFile, &fileInfo.pos);
-        CC_BREAK_IF(UNZ_OK != nRet);
-        
-        nRet = unzOpenCurrentFile(_data->zipFile);
-        CC_BREAK_IF(UNZ_OK != nRet);
-        
-        buffer = (unsigned char*)malloc(fileInfo.uncompressed_size);
-        int CC_UNUSED nSize = unzReadCurrentFile(_data->zipFile, buffer, static_cast<unsigned int>(fileInfo.uncompressed_size));
-        CCASSERT(nSize == 0 || nSize == (int)fileInfo.uncompressed_size, "the file size is wrong");
-        
+
+        const ZipEntryInfo* entry = _data->findEntry(fileName);
+        CC_BREAK_IF(!entry);
+        CC_BREAK_IF(entry->uncompressedSize > (uint64_t)std::numeric_limits<ssize_t>::max());
+
+        auto start = std::chrono::steady_clock::now();
+        buffer = (unsigned char*)malloc((size_t)entry->uncompressedSize);
+        CC_BREAK_IF(!buffer);
+        if (!_data->readEntry(*entry, buffer))
+        {
+            CCLOG("cocos2d: ZipFile: failed to read %s", fileName.c_str());
+            free(buffer);
+            buffer = nullptr;
+            break;
+        }
+
         if (size)
         {
-            *size = fileInfo.uncompressed_size;
+            *size = (ssize_t)entry->uncompressedSize;
+        }
+        if (_data->timingEnabled)
+        {
+            _data->addReadTiming(*entry, start);
         }
-        unzCloseCurrentFile(_data->zipFile);
     } while (0);
-    
+
     return buffer;
 }
 
@@ -650,67 +1064,116 @@ bool ZipFile::getFileData(const std::string &fileName, ResizableBuffer* buffer)
     bool res = false;
     do
     {
-        CC_BREAK_IF(!_data->zipFile);
         CC_BREAK_IF(fileName.empty());
-        
-        ZipFilePrivate::FileListContainer::const_iterator it = _data->fileList.find(fileName);
-        CC_BREAK_IF(it ==  _data->fileList.end());
-        
-        ZipEntryInfo fileInfo = it->second;
-        
-        int nRet = unzGoToFilePos(_data->zipFile, &fileInfo.pos);
-        CC_BREAK_IF(UNZ_OK != nRet);
-        
-        nRet = unzOpenCurrentFile(_data->zipFile);
-        CC_BREAK_IF(UNZ_OK != nRet);
-        
-        buffer->resize(fileInfo.uncompressed_size);
-        int CC_UNUSED nSize = unzReadCurrentFile(_data->zipFile, buffer->buffer(), static_cast<unsigned int>(fileInfo.uncompressed_size));
-        CCASSERT(nSize == 0 || nSize == (int)fileInfo.uncompressed_size, "the file size is wrong");
-        unzCloseCurrentFile(_data->zipFile);
+
+        const ZipEntryInfo* entry = _data->findEntry(fileName);
+        CC_BREAK_IF(!entry);
+        CC_BREAK_IF(entry->uncompressedSize > (uint64_t)std::numeric_limits<ssize_t>::max());
+
+        auto start = std::chrono::steady_clock::now();
+        buffer->resize((size_t)entry->uncompressedSize);
+        if (!_data->readEntry(*entry, static_cast<unsigned char*>(buffer->buffer())))
+        {
+            CCLOG("cocos2d: ZipFile: failed to read %s", fileName.c_str());
+            break;
+        }
+
+        if (_data->timingEnabled)
+        {
+            _data->addReadTiming(*entry, start);
+        }
         res = true;
     } while (0);
-    
+
     return res;
 }
 
-std::string ZipFile::getFirstFilename()
+FileView ZipFile::getFileView(const std::string &fileName) const
+{
+    FileView view;
+    do
+    {
+        CC_BREAK_IF(fileName.empty());
+
+        const ZipEntryInfo* entry = _data->findEntry(fileName);
+        CC_BREAK_IF(!entry);
+        CC_BREAK_IF(entry->uncompressedSize > (uint64_t)std::numeric_limits<ssize_t>::max());
+
+        auto start = std::chrono::steady_clock::now();
+
+#if (CC_TARGET_PLATFORM != CC_PLATFORM_WIN32) && (CC_TARGET_PLATFORM != CC_PLATFORM_WINRT)
+        // a stored file is mapped on its own from the archive on disk, so it isn't copied
+        if (entry->method == ZIP_METHOD_STORED && _data->archive.isMapped() && !(entry->flags & ZIP_FLAG_ENCRYPTED))
+        {
+            std::vector<unsigned char> storage;
+            const unsigned char* data = _data->getEntryData(*entry, storage);
+            CC_BREAK_IF(!data || entry->compressedSize != entry->uncompressedSize);
+
+            int fd = open(_data->zipFilePath.c_str(), O_RDONLY);
+            if (fd >= 0)
+            {
+                view.initWithMappedDescriptor(fd, data - _data->bytes, (ssize_t)entry->uncompressedSize);
+                close(fd);
+            }
+        }
+#endif
+
+        if (view.isNull())
+        {
+            Data data;
+            ResizableBufferAdapter<Data> buffer(&data);
+            buffer.resize((size_t)entry->uncompressedSize);
+            if (!_data->readEntry(*entry, static_cast<unsigned char*>(buffer.buffer())))
+            {
+                CCLOG("cocos2d: ZipFile: failed to read %s", fileName.c_str());
+                break;
+            }
+            view.initWithData(std::move(data));
+        }
+
+        if (_data->timingEnabled)
+        {
+            _data->addReadTiming(*entry, start);
+        }
+    } while (0);
+
+    return view;
+}
+
+void ZipFile::setReadTimingEnabled(bool enabled)
 {
-    if (unzGoToFirstFile(_data->zipFile) != UNZ_OK) return emptyFilename;
-    std::string path;
-    unz_file_info info;
-    getCurrentFileInfo(&path, &info);
-    return path;
+    std::lock_guard<std::mutex> lock(_data->timingMutex);
+    _data->timings.clear();
+    _data->timingEnabled = enabled;
 }
 
-std::string ZipFile::getNextFilename()
+std::vector<ZipFile::ReadTiming> ZipFile::getReadTimings() const
 {
-    if (unzGoToNextFile(_data->zipFile) != UNZ_OK) return emptyFilename;
-    std::string path;
-    unz_file_info info;
-    getCurrentFileInfo(&path, &info);
-    return path;
+    std::lock_guard<std::mutex> lock(_data->timingMutex);
+    return _data->timings;
 }
 
-int ZipFile::getCurrentFileInfo(std::string *filename, unz_file_info *info)
+std::string ZipFile::getFirstFilename()
 {
-    char path[FILENAME_MAX + 1];
-    int ret = unzGetCurrentFileInfo(_data->zipFile, info, path, sizeof(path), nullptr, 0, nullptr, 0);
-    if (ret != UNZ_OK) {
-        *filename = emptyFilename;
-    } else {
-        filename->assign(path);
-    }
-    return ret;
+    _data->iterator = 0;
+    if (_data->entries.empty()) return emptyFilename;
+    return _data->entries[0].name;
+}
+
+std::string ZipFile::getNextFilename()
+{
+    if (_data->iterator + 1 >= _data->entries.size()) return emptyFilename;
+    return _data->entries[++_data->iterator].name;
 }
 
 bool ZipFile::initWithBuffer(const void *buffer, uLong size)
 {
     if (!buffer || size == 0) return false;
-    
-    _data->zipFile = unzOpenBuffer(buffer, size);
-    if (!_data->zipFile) return false;
-    
+
+    _data->bytes = static_cast<const unsigned char*>(buffer);
+    _data->size = size;
+    if (!_data->parseCentralDirectory()) return false;
+
     setFilter(emptyFilename);
     return true;
 }
@@ -27,7 +27,9 @@ THE SOFTWARE.
 #define __SUPPORT_ZIPUTILS_H__
 /// @cond DO_NOT_SHOW
 
+#include <atomic>
 #include <string>
+#include <vector>
 #include "platform/CCPlatformConfig.h"
 #include "platform/CCPlatformMacros.h"
 #include "platform/CCPlatformDefine.h"
@@ -66,6 +68,18 @@ typedef struct unz_file_info_s unz_file_info;
         CCZ_COMPRESSION_BZIP2,              /** bzip2 format (not supported yet). */
         CCZ_COMPRESSION_GZIP,               /** gzip format (not supported yet). */
         CCZ_COMPRESSION_NONE,               /** plain (not supported yet). */
+        CCZ_COMPRESSION_ZLIB_CHUNKED,       /** zlib format, in chunks which are inflated in parallel. */
+    };
+
+    /** @struct CCZChunkTable
+     * Follows the header of a CCZ file compressed with CCZ_COMPRESSION_ZLIB_CHUNKED.
+     * It is followed by chunkCount big endian unsigned ints, the compressed sizes of the chunks,
+     * and then by the chunks: each one is a zlib stream of chunkSize bytes, except the last which may be shorter.
+     * Such files are made with tools/ccz/cczconvert.py.
+     */
+    struct CCZChunkTable {
+        unsigned int    chunkSize;          /** Size of the uncompressed chunks. */
+        unsigned int    chunkCount;         /** Number of chunks. */
     };
 
     class CC_DLL ZipUtils
@@ -137,6 +151,26 @@ typedef struct unz_file_info_s unz_file_info;
          */
         CC_DEPRECATED_ATTRIBUTE static int ccInflateCCZBuffer(const unsigned char *buffer, ssize_t len, unsigned char **out) { return inflateCCZBuffer(buffer, len, out); }
         static int inflateCCZBuffer(const unsigned char *buffer, ssize_t len, unsigned char **out);
+
+        /**
+         * Inflates a buffer with CCZ format into memory provided by the caller.
+         * The buffer isn't modified, encrypted ones are decrypted while they are inflated.
+         * The chunks of a CCZ_COMPRESSION_ZLIB_CHUNKED buffer are inflated in parallel.
+         *
+         * @param out The memory to inflate into, of getCCZUncompressedLength() bytes.
+         * @param outLength The size of out.
+         * @return True if the whole buffer has been inflated.
+         * @since v3.16
+         */
+        static bool inflateCCZBuffer(const unsigned char *buffer, ssize_t len, unsigned char *out, ssize_t outLength);
+
+        /**
+         * Gets the size of the inflated data of a buffer with CCZ format, from its header.
+         *
+         * @return The size of the inflated data, or -1 if the header isn't valid.
+         * @since v3.16
+         */
+        static ssize_t getCCZUncompressedLength(const unsigned char *buffer, ssize_t len);
         
         /** 
          * Test a file is a CCZ format file or not.
@@ -210,12 +244,13 @@ typedef struct unz_file_info_s unz_file_info;
 
     private:
         static int inflateMemoryWithHint(unsigned char *in, ssize_t inLength, unsigned char **out, ssize_t *outLength, ssize_t outLengthHint);
-        static inline void decodeEncodedPvr (unsigned int *data, ssize_t len);
+        static inline void decodeEncodedPvr (unsigned int *data, ssize_t len, ssize_t first = 0);
         static inline unsigned int checksumPvr(const unsigned int *data, ssize_t len);
 
         static unsigned int s_uEncryptedPvrKeyParts[4];
         static unsigned int s_uEncryptionKey[1024];
-        static bool s_bEncryptionKeyIsValid;
+        // the key is built on first use, possibly by several loading threads at once
+        static std::atomic<bool> s_bEncryptionKeyIsValid;
     };
 
     // forward declaration
@@ -228,6 +263,14 @@ typedef struct unz_file_info_s unz_file_info;
     * It will cache the file list of a particular zip file with positions inside an archive,
     * so it would be much faster to read some particular files or to check their existence.
     *
+    * The archive is memory mapped and its central directory is read once into a sorted index.
+    * When the archive can't be mapped, the files are read from it through FileUtils::getFileRange().
+    * getFirstFilename() and getNextFilename() list every file in the order of the archive, and when
+    * several files have the same name, the last one is read.
+    * Reading files, checking their existence and getting views of them don't change the ZipFile,
+    * so they can be done from several threads at the same time. setFilter() and the
+    * getFirstFilename() / getNextFilename() iteration must not run concurrently with them.
+    *
     * @since v2.0.5
     */
     class CC_DLL ZipFile
@@ -285,6 +328,42 @@ typedef struct unz_file_info_s unz_file_info;
         */
         bool getFileData(const std::string &fileName, ResizableBuffer* buffer);
 
+        /**
+        * Get a view of a file in the zip file.
+        * Files stored without compression are mapped from the archive when it is a file on disk,
+        * the others are inflated into the view.
+        *
+        * @param fileName File name
+        * @return The view of the file, null if the file can't be read.
+        *
+        * @since v3.16
+        */
+        FileView getFileView(const std::string &fileName) const;
+
+        /** The time spent to read a file of the zip file. */
+        struct ReadTiming
+        {
+            std::string fileName;
+            ssize_t size;
+            bool compressed;
+            float milliseconds;
+        };
+
+        /**
+        * Enable or disable the recording of the time spent in each read.
+        * Enabling it clears the timings recorded so far.
+        *
+        * @since v3.16
+        */
+        void setReadTimingEnabled(bool enabled);
+
+        /**
+        * Get the timings recorded since the recording was enabled, in the order the reads finished.
+        *
+        * @since v3.16
+        */
+        std::vector<ReadTiming> getReadTimings() const;
+
         std::string getFirstFilename();
         std::string getNextFilename();
         
@@ -295,7 +374,6 @@ typedef struct unz_file_info_s unz_file_info;
         ZipFile();
         
         bool initWithBuffer(const void *buffer, unsigned long size);
-        int getCurrentFileInfo(std::string *filename, unz_file_info *info);
         
         /** Internal data like zip file pointer / file list array and so on */
         ZipFilePrivate *_data;
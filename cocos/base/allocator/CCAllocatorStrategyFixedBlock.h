@@ -78,6 +78,7 @@ public:
     {
 #if CC_ENABLE_ALLOCATOR_DIAGNOSTICS
         _highestCount = 0;
+        _allocationCount = 0;
         AllocatorDiagnostics::instance()->trackAllocator(this);
         AllocatorBase::setTag(tag ? tag : typeid(AllocatorStrategyFixedBlock).name());
 #endif
@@ -164,6 +165,8 @@ public:
         return s.str();
     }
     size_t _highestCount;
+    // the number of blocks allocated since the creation of the allocator
+    size_t _allocationCount;
 #endif
     
 protected:
@@ -214,6 +217,7 @@ protected:
 #if CC_ENABLE_ALLOCATOR_DIAGNOSTICS
         if (_allocated > _highestCount)
             _highestCount = _allocated;
+        ++_allocationCount;
 #endif
         CC_ASSERT(block_size < AllocatorBase::kDefaultAlignment || 0 == ((intptr_t)block & (AllocatorBase::kDefaultAlignment - 1)));
         return block;
@@ -81,6 +81,27 @@ public:
     }
 };
 
+/**
+ * ObjectTraits of a pool only providing the memory of the objects.
+ *
+ * For the pools of the classes overriding their operators new and delete,
+ * the objects are already constructed by the new expression and destroyed by the delete expression.
+ *
+ * @param T Type of object.
+ * @param _alignment Alignment of object T.
+ */
+template <typename T, size_t _alignment = sizeof(uint32_t)>
+class MemoryObjectTraits : public ObjectTraits<T, _alignment>
+{
+public:
+    
+    void construct(T* /*address*/)
+    {}
+    
+    void destroy(T* /*address*/)
+    {}
+};
+
 /**
  * Fixed sized pool allocator strategy for objects of type T.
  *
@@ -107,6 +128,9 @@ public:
     
     AllocatorStrategyPool(const char* tag = nullptr, size_t poolSize = 100)
         : tParentStrategy(tag)
+#if CC_ENABLE_ALLOCATOR_DIAGNOSTICS
+        , _fallbackCount(0)
+#endif
     {
         poolSize = Configuration::getInstance()->getValue(tag, Value((int)poolSize)).asInt();
         tParentStrategy::_pageSize = poolSize;
@@ -128,6 +152,11 @@ public:
         else
         {
             object = (T*)ccAllocatorGlobal.allocate(size);
+#if CC_ENABLE_ALLOCATOR_DIAGNOSTICS
+            tParentStrategy::lock();
+            ++_fallbackCount;
+            tParentStrategy::unlock();
+#endif
         }
         O::construct(object);
         return object;
@@ -156,12 +185,22 @@ public:
     }
     
 #if CC_ENABLE_ALLOCATOR_DIAGNOSTICS
+    // reused counts the allocations of blocks freed before,
+    // the others are the first use of a block, at most the highest count.
+    // fallback counts the objects of another size allocated by the global allocator.
     std::string diagnostics() const
     {
+        const size_t allocations = tParentStrategy::_allocationCount;
+        const size_t reused = allocations - tParentStrategy::_highestCount;
         std::stringstream s;
-        s << AllocatorBase::tag() << " initial:" << tParentStrategy::_pageSize << " count:" << tParentStrategy::_allocated << " highest:" << tParentStrategy::_highestCount << "\n";
+        s << AllocatorBase::tag() << " initial:" << tParentStrategy::_pageSize << " count:" << tParentStrategy::_allocated << " highest:" << tParentStrategy::_highestCount
+          << " allocations:" << allocations << " reused:" << reused << " (" << (allocations ? reused * 100 / allocations : 0) << "%)"
+          << " fallback:" << _fallbackCount << "\n";
         return s.str();
-    }    
+    }
+    
+protected:
+    size_t _fallbackCount;
 #endif
 };
 
@@ -389,6 +389,17 @@ THE SOFTWARE.
 # define CC_ALLOCATOR_GLOBAL_NEW_DELETE cocos2d::allocator::AllocatorStrategyGlobalSmallBlock
 #endif
 
+/** @def CC_ENABLE_ACTION_POOL
+ * Turn on the pools of the common actions, MoveBy, Sequence, CallFunc and the like.
+ * The memory of a released action is kept in the pool of its type for the next one,
+ * instead of being freed to the heap. Requires CC_ENABLE_ALLOCATOR.
+ * The pools are listed by the "allocator" command of the Console with CC_ENABLE_ALLOCATOR_DIAGNOSTICS.
+ * @since v3.16
+ */
+#ifndef CC_ENABLE_ACTION_POOL
+# define CC_ENABLE_ACTION_POOL 0
+#endif
+
 #ifndef CC_FILEUTILS_APPLE_ENABLE_OBJC
 #define CC_FILEUTILS_APPLE_ENABLE_OBJC  1
 #endif
@@ -39,6 +39,7 @@ THE SOFTWARE.
 
 // base
 #include "base/CCAsyncTaskPool.h"
+#include "base/CCWorkerPool.h"
 #include "base/CCAutoreleasePool.h"
 #include "base/CCConfiguration.h"
 #include "base/CCConsole.h"
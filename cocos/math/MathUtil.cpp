@@ -20,6 +20,7 @@ This file was modified to fit the cocos2d-x project
 
 #include "math/MathUtil.h"
 #include "base/ccMacros.h"
+#include "base/ccTypes.h"
 
 #if (CC_TARGET_PLATFORM == CC_PLATFORM_ANDROID)
 #include <cpu-features.h>
@@ -275,4 +276,37 @@ void MathUtil::crossVec3(const float* v1, const float* v2, float* dst)
 #endif
 }
 
+void MathUtil::transformVertices(const float* m, const V3F_C4B_T2F* src, V3F_C4B_T2F* dst, size_t count)
+{
+#ifdef USE_NEON32
+    MathUtilNeon::transformVertices(m, src, dst, count);
+#elif defined (USE_NEON64)
+    MathUtilNeon64::transformVertices(m, src, dst, count);
+#elif defined (INCLUDE_NEON32)
+    if(isNeon32Enabled()) MathUtilNeon::transformVertices(m, src, dst, count);
+    else MathUtilC::transformVertices(m, src, dst, count);
+#elif defined (USE_SSE)
+    __m128 col[4] = { _mm_loadu_ps(m), _mm_loadu_ps(m + 4), _mm_loadu_ps(m + 8), _mm_loadu_ps(m + 12) };
+    transformVertices(col, src, dst, count);
+#else
+    MathUtilC::transformVertices(m, src, dst, count);
+#endif
+}
+
+void MathUtil::transformIndices(const unsigned short* src, unsigned short* dst, size_t count, unsigned short offset)
+{
+#ifdef USE_NEON32
+    MathUtilNeon::transformIndices(src, dst, count, offset);
+#elif defined (USE_NEON64)
+    MathUtilNeon64::transformIndices(src, dst, count, offset);
+#elif defined (INCLUDE_NEON32)
+    if(isNeon32Enabled()) MathUtilNeon::transformIndices(src, dst, count, offset);
+    else MathUtilC::transformIndices(src, dst, count, offset);
+#elif defined (USE_SSE) && defined (__SSE2__)
+    transformIndices(_mm_set1_epi16((short)offset), src, dst, count);
+#else
+    MathUtilC::transformIndices(src, dst, count, offset);
+#endif
+}
+
 NS_CC_MATH_END
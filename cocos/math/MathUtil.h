@@ -26,6 +26,10 @@
 #include <xmmintrin.h>
 #endif
 
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
 #include "math/CCMathBase.h"
 
 /**
@@ -35,6 +39,8 @@
 
 NS_CC_MATH_BEGIN
 
+struct V3F_C4B_T2F;
+
 /**
  * Defines a math utility class.
  *
@@ -87,6 +93,28 @@ public:
      * @return interpolated float value
      */
     static float lerp(float from, float to, float alpha);
+
+    /**
+     * Copies a V3F_C4B_T2F vertex stream, transforming every position by the given
+     * matrix (as a point, w = 1). Colors and texture coordinates are copied unchanged.
+     * The source and destination streams must not overlap.
+     *
+     * @param m the column-major 4x4 matrix to transform the positions with.
+     * @param src the vertices to transform.
+     * @param dst the vertices receiving the transformed copy.
+     * @param count the number of vertices.
+     */
+    static void transformVertices(const float* m, const V3F_C4B_T2F* src, V3F_C4B_T2F* dst, size_t count);
+
+    /**
+     * Copies an index stream, adding the given offset to every index.
+     *
+     * @param src the indices to copy.
+     * @param dst the indices receiving the rebased copy.
+     * @param count the number of indices.
+     * @param offset the value added to every index.
+     */
+    static void transformIndices(const unsigned short* src, unsigned short* dst, size_t count, unsigned short offset);
 private:
     //Indicates that if neon is enabled
     static bool isNeon32Enabled();
@@ -108,6 +136,11 @@ private:
     static void transposeMatrix(const __m128 m[4], __m128 dst[4]);
         
     static void transformVec4(const __m128 m[4], const __m128& v, __m128& dst);
+
+    static void transformVertices(const __m128 m[4], const V3F_C4B_T2F* src, V3F_C4B_T2F* dst, size_t count);
+#endif
+#ifdef __SSE2__
+    static void transformIndices(const __m128i& offset, const unsigned short* src, unsigned short* dst, size_t count);
 #endif
     static void addMatrix(const float* m, float scalar, float* dst);
 
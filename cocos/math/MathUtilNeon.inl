@@ -17,6 +17,9 @@
 
  This file was modified to fit the cocos2d-x project
  */
+
+#include <arm_neon.h>
+
 NS_CC_MATH_BEGIN
 
 class MathUtilNeon
@@ -41,6 +44,10 @@ public:
     inline static void transformVec4(const float* m, const float* v, float* dst);
     
     inline static void crossVec3(const float* v1, const float* v2, float* dst);
+
+    inline static void transformVertices(const float* m, const V3F_C4B_T2F* src, V3F_C4B_T2F* dst, size_t count);
+
+    inline static void transformIndices(const unsigned short* src, unsigned short* dst, size_t count, unsigned short offset);
 };
 
 inline void MathUtilNeon::addMatrix(const float* m, float scalar, float* dst)
@@ -268,4 +275,38 @@ inline void MathUtilNeon::crossVec3(const float* v1, const float* v2, float* dst
                  );
 }
 
+inline void MathUtilNeon::transformVertices(const float* m, const V3F_C4B_T2F* src, V3F_C4B_T2F* dst, size_t count)
+{
+    float32x4_t c0 = vld1q_f32(m);
+    float32x4_t c1 = vld1q_f32(m + 4);
+    float32x4_t c2 = vld1q_f32(m + 8);
+    float32x4_t c3 = vld1q_f32(m + 12);
+
+    for (size_t i = 0; i < count; ++i)
+    {
+        const float* v = &src[i].vertices.x;
+        float32x4_t p = vmlaq_n_f32(vmlaq_n_f32(vmlaq_n_f32(c3, c0, v[0]), c1, v[1]), c2, v[2]);
+
+        float* d = &dst[i].vertices.x;
+        vst1_f32(d, vget_low_f32(p));           // V[x, y]
+        vst1q_lane_f32(d + 2, p, 2);            // V[z]
+        dst[i].colors = src[i].colors;
+        dst[i].texCoords = src[i].texCoords;
+    }
+}
+
+inline void MathUtilNeon::transformIndices(const unsigned short* src, unsigned short* dst, size_t count, unsigned short offset)
+{
+    uint16x8_t o = vdupq_n_u16(offset);
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8)
+    {
+        vst1q_u16(dst + i, vaddq_u16(vld1q_u16(src + i), o));
+    }
+    for (; i < count; ++i)
+    {
+        dst[i] = src[i] + offset;
+    }
+}
+
 NS_CC_MATH_END
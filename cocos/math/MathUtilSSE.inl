@@ -151,6 +151,46 @@ void MathUtil::transformVec4(const __m128 m[4], const __m128& v, __m128& dst)
                      );
 }
 
+void MathUtil::transformVertices(const __m128 m[4], const V3F_C4B_T2F* src, V3F_C4B_T2F* dst, size_t count)
+{
+    for (size_t i = 0; i < count; ++i)
+    {
+        // x, y, z and the color bits of the vertex, the last lane is only moved, never computed
+        __m128 v = _mm_loadu_ps(&src[i].vertices.x);
+        __m128 x = _mm_shuffle_ps(v, v, _MM_SHUFFLE(0, 0, 0, 0));
+        __m128 y = _mm_shuffle_ps(v, v, _MM_SHUFFLE(1, 1, 1, 1));
+        __m128 z = _mm_shuffle_ps(v, v, _MM_SHUFFLE(2, 2, 2, 2));
+
+        // same evaluation order as MathUtilC::transformVec4 so both paths give identical results
+        __m128 p = _mm_add_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(m[0], x), _mm_mul_ps(m[1], y)), _mm_mul_ps(m[2], z)), m[3]);
+
+        // [p.x, p.y, p.z, color]
+        __m128 t = _mm_shuffle_ps(p, v, _MM_SHUFFLE(3, 3, 2, 2));
+        _mm_storeu_ps(&dst[i].vertices.x, _mm_shuffle_ps(p, t, _MM_SHUFFLE(2, 0, 1, 0)));
+        dst[i].texCoords = src[i].texCoords;
+    }
+}
+
+#endif
+
+#ifdef __SSE2__
+
+void MathUtil::transformIndices(const __m128i& offset, const unsigned short* src, unsigned short* dst, size_t count)
+{
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8)
+    {
+        __m128i v = _mm_loadu_si128((const __m128i*)(src + i));
+        _mm_storeu_si128((__m128i*)(dst + i), _mm_add_epi16(v, offset));
+    }
+
+    unsigned short o = (unsigned short)_mm_extract_epi16(offset, 0);
+    for (; i < count; ++i)
+    {
+        dst[i] = src[i] + o;
+    }
+}
+
 #endif
 
 
@@ -26,6 +26,8 @@
 #include "platform/CCFileUtils.h"
 
 #include <stack>
+#include <algorithm>
+#include <climits>
 
 #include "base/CCData.h"
 #include "base/ccMacros.h"
@@ -550,7 +552,9 @@ void FileUtils::setDelegate(FileUtils *delegate)
 }
 
 FileUtils::FileUtils()
-: _writablePath("")
+: _pathIndexEnabled(true)
+, _directFileAccessEnabled(false)
+, _writablePath("")
 {
 }
 
@@ -617,7 +621,11 @@ bool FileUtils::init()
 
 void FileUtils::purgeCachedEntries()
 {
+    std::lock_guard<std::recursive_mutex> lock(_fullPathCacheMutex);
     _fullPathCache.clear();
+    _missingPathCache.clear();
+    _pathIndex.clear();
+    _pathIndexWritablePath.clear();
 }
 
 std::string FileUtils::getStringFromFile(const std::string& filename)
@@ -691,6 +699,89 @@ FileUtils::Status FileUtils::getContents(const std::string& filename, ResizableB
     return Status::OK;
 }
 
+FileUtils::Status FileUtils::getFileRange(const std::string& filename, size_t offset, size_t size, ResizableBuffer* buffer)
+{
+    if (filename.empty())
+        return Status::NotExists;
+
+    if (!_directFileAccessEnabled)
+    {
+        // getContents may not return the file as it is, take the part from what it returns
+        Data data;
+        Status status = getContents(filename, &data);
+        if (status != Status::OK)
+            return status;
+
+        size_t fileSize = (size_t)data.getSize();
+        size_t available = offset < fileSize ? std::min(size, fileSize - offset) : 0;
+        buffer->resize(available);
+        if (available > 0)
+            memcpy(buffer->buffer(), data.getBytes() + offset, available);
+        return available < size ? Status::ReadFailed : Status::OK;
+    }
+
+    auto fs = FileUtils::getInstance();
+
+    std::string fullPath = fs->fullPathForFilename(filename);
+    if (fullPath.empty())
+        return Status::NotExists;
+
+    FILE *fp = fopen(fs->getSuitableFOpen(fullPath).c_str(), "rb");
+    if (!fp)
+        return Status::OpenFailed;
+
+#if defined(_MSC_VER)
+    auto descriptor = _fileno(fp);
+#else
+    auto descriptor = fileno(fp);
+#endif
+    struct stat statBuf;
+    if (fstat(descriptor, &statBuf) == -1) {
+        fclose(fp);
+        return Status::ReadFailed;
+    }
+    size_t fileSize = statBuf.st_size;
+    if (offset > fileSize || offset > LONG_MAX) {
+        fclose(fp);
+        buffer->resize(0);
+        return Status::ReadFailed;
+    }
+
+    size_t available = std::min(size, fileSize - offset);
+    buffer->resize(available);
+    size_t readsize = 0;
+    if (fseek(fp, (long)offset, SEEK_SET) == 0)
+        readsize = fread(buffer->buffer(), 1, available, fp);
+    fclose(fp);
+
+    if (readsize < size) {
+        buffer->resize(readsize);
+        return Status::ReadFailed;
+    }
+
+    return Status::OK;
+}
+
+FileView FileUtils::getFileView(const std::string& filename)
+{
+    FileView view;
+    if (filename.empty())
+        return view;
+
+    std::string fullPath = fullPathForFilename(filename);
+    if (fullPath.empty())
+        return view;
+
+    if (!_directFileAccessEnabled || !view.initWithMappedFile(fullPath))
+    {
+        // not a regular file, or getContents may not return it as it is, copy it
+        Data data;
+        if (getContents(fullPath, &data) == Status::OK)
+            view.initWithData(std::move(data));
+    }
+    return view;
+}
+
 unsigned char* FileUtils::getFileData(const std::string& filename, const char* mode, ssize_t *size)
 {
     CCASSERT(!filename.empty() && size != nullptr && mode != nullptr, "Invalid parameters.");
@@ -816,6 +907,8 @@ std::string FileUtils::fullPathForFilename(const std::string &filename) const
         return filename;
     }
 
+    std::lock_guard<std::recursive_mutex> lock(_fullPathCacheMutex);
+
     // Already Cached ?
     auto cacheIter = _fullPathCache.find(filename);
     if(cacheIter != _fullPathCache.end())
@@ -823,15 +916,71 @@ std::string FileUtils::fullPathForFilename(const std::string &filename) const
         return cacheIter->second;
     }
 
+    // Already known to be missing ?
+    if (_missingPathCache.find(filename) != _missingPathCache.end())
+    {
+        return "";
+    }
+
     // Get the new file name.
     const std::string newFilename( getNewFilename(filename) );
 
+    // The index is looked up with the lower case name, so that it never misses a file on a case insensitive file system.
+    // Names with non ASCII characters or backslashes, and paths ending with '/', are left to the file system,
+    // which may normalize them.
+    std::string filePath;
+    std::string indexName;
+    bool useIndex = _pathIndexEnabled;
+    if (useIndex)
+    {
+        size_t pos = newFilename.find_last_of('/');
+        if (pos != std::string::npos)
+        {
+            filePath = newFilename.substr(0, pos+1);
+            indexName = newFilename.substr(pos+1);
+        }
+        else
+        {
+            indexName = newFilename;
+        }
+
+        if (indexName.empty())
+        {
+            useIndex = false;
+        }
+
+        for (auto& c : indexName)
+        {
+            if ((c & 0x80) || c == '\\')
+            {
+                useIndex = false;
+                break;
+            }
+            c = ::tolower(c);
+        }
+    }
+
+    // The miss is only remembered when every directory was answered by the index.
+    bool missingFromIndex = useIndex;
     std::string fullpath;
 
     for (const auto& searchIt : _searchPathArray)
     {
         for (const auto& resolutionIt : _searchResolutionsOrderArray)
         {
+            if (useIndex)
+            {
+                auto names = getPathIndexEntry(searchIt + filePath + resolutionIt);
+                if (names == nullptr)
+                {
+                    missingFromIndex = false;
+                }
+                else if (names->find(indexName) == names->end())
+                {
+                    continue;
+                }
+            }
+
             fullpath = this->getPathForFilename(newFilename, resolutionIt, searchIt);
 
             if (!fullpath.empty())
@@ -844,6 +993,11 @@ std::string FileUtils::fullPathForFilename(const std::string &filename) const
         }
     }
 
+    if (missingFromIndex)
+    {
+        _missingPathCache.insert(filename);
+    }
+
     if(isPopupNotify()){
         CCLOG("cocos2d: fullPathForFilename: No file found at %s. Possible missing file.", filename.c_str());
     }
@@ -852,6 +1006,93 @@ std::string FileUtils::fullPathForFilename(const std::string &filename) const
     return "";
 }
 
+const std::unordered_set<std::string>* FileUtils::getPathIndexEntry(const std::string& dirPath) const
+{
+    auto iter = _pathIndex.find(dirPath);
+    if (iter != _pathIndex.end())
+    {
+        return iter->second.get();
+    }
+
+    // Files are written to the writable path while the game runs, so it's always asked to the file system.
+    if (_pathIndexWritablePath.empty())
+    {
+        _pathIndexWritablePath = getWritablePath();
+    }
+
+    std::unique_ptr<std::unordered_set<std::string>> names;
+    std::vector<std::string> files;
+    if ((_pathIndexWritablePath.empty() || dirPath.compare(0, _pathIndexWritablePath.length(), _pathIndexWritablePath) != 0)
+        && listDirectoryInternal(dirPath, files))
+    {
+        names.reset(new std::unordered_set<std::string>());
+        names->reserve(files.size());
+        for (auto& name : files)
+        {
+            for (auto& c : name)
+            {
+                if (!(c & 0x80))
+                    c = ::tolower(c);
+            }
+            names->insert(std::move(name));
+        }
+    }
+
+    auto result = names.get();
+    _pathIndex.emplace(dirPath, std::move(names));
+    return result;
+}
+
+void FileUtils::setPathIndexEnabled(bool enabled)
+{
+    std::lock_guard<std::recursive_mutex> lock(_fullPathCacheMutex);
+    _pathIndexEnabled = enabled;
+    _missingPathCache.clear();
+}
+
+bool FileUtils::isPathIndexEnabled() const
+{
+    return _pathIndexEnabled;
+}
+
+void FileUtils::setDirectFileAccessEnabled(bool enabled)
+{
+    _directFileAccessEnabled = enabled;
+}
+
+bool FileUtils::isDirectFileAccessEnabled() const
+{
+    return _directFileAccessEnabled;
+}
+
+void FileUtils::prefetchPathIndex(std::function<void()> callback)
+{
+    std::vector<std::string> dirs;
+    {
+        std::lock_guard<std::recursive_mutex> lock(_fullPathCacheMutex);
+        for (const auto& searchIt : _searchPathArray)
+        {
+            for (const auto& resolutionIt : _searchResolutionsOrderArray)
+            {
+                dirs.push_back(searchIt + resolutionIt);
+            }
+        }
+    }
+
+    performOperationOffthread([dirs]() -> bool {
+        auto fileUtils = FileUtils::getInstance();
+        for (const auto& dir : dirs)
+        {
+            std::lock_guard<std::recursive_mutex> lock(fileUtils->_fullPathCacheMutex);
+            fileUtils->getPathIndexEntry(dir);
+        }
+        return true;
+    }, [callback](bool) {
+        if (callback)
+            callback();
+    });
+}
+
 std::string FileUtils::fullPathFromRelativeFile(const std::string &filename, const std::string &relativeFile)
 {
     return relativeFile.substr(0, relativeFile.rfind('/')+1) + getNewFilename(filename);
@@ -866,7 +1107,9 @@ void FileUtils::setSearchResolutionsOrder(const std::vector<std::string>& search
 
     bool existDefault = false;
 
+    std::lock_guard<std::recursive_mutex> lock(_fullPathCacheMutex);
     _fullPathCache.clear();
+    _missingPathCache.clear();
     _searchResolutionsOrderArray.clear();
     for(const auto& iter : searchResolutionsOrder)
     {
@@ -896,6 +1139,8 @@ void FileUtils::addSearchResolutionsOrder(const std::string &order,const bool fr
     if (!resOrder.empty() && resOrder[resOrder.length()-1] != '/')
         resOrder.append("/");
 
+    std::lock_guard<std::recursive_mutex> lock(_fullPathCacheMutex);
+    _missingPathCache.clear();
     if (front) {
         _searchResolutionsOrderArray.insert(_searchResolutionsOrderArray.begin(), resOrder);
     } else {
@@ -920,7 +1165,11 @@ const std::vector<std::string>& FileUtils::getOriginalSearchPaths() const
 
 void FileUtils::setWritablePath(const std::string& writablePath)
 {
+    std::lock_guard<std::recursive_mutex> lock(_fullPathCacheMutex);
     _writablePath = writablePath;
+    _missingPathCache.clear();
+    _pathIndex.clear();
+    _pathIndexWritablePath.clear();
 }
 
 const std::string& FileUtils::getDefaultResourceRootPath() const
@@ -930,6 +1179,7 @@ const std::string& FileUtils::getDefaultResourceRootPath() const
 
 void FileUtils::setDefaultResourceRootPath(const std::string& path)
 {
+    std::lock_guard<std::recursive_mutex> lock(_fullPathCacheMutex);
     if (_defaultResRootPath != path)
     {
         _fullPathCache.clear();
@@ -947,9 +1197,12 @@ void FileUtils::setDefaultResourceRootPath(const std::string& path)
 void FileUtils::setSearchPaths(const std::vector<std::string>& searchPaths)
 {
     bool existDefaultRootPath = false;
+
+    std::lock_guard<std::recursive_mutex> lock(_fullPathCacheMutex);
     _originalSearchPaths = searchPaths;
 
     _fullPathCache.clear();
+    _missingPathCache.clear();
     _searchPathArray.clear();
 
     for (const auto& path : _originalSearchPaths)
@@ -992,6 +1245,9 @@ void FileUtils::addSearchPath(const std::string &searchpath,const bool front)
         path += "/";
     }
 
+    std::lock_guard<std::recursive_mutex> lock(_fullPathCacheMutex);
+    _fullPathCache.clear();
+    _missingPathCache.clear();
     if (front) {
         _originalSearchPaths.insert(_originalSearchPaths.begin(), searchpath);
         _searchPathArray.insert(_searchPathArray.begin(), path);
@@ -1011,7 +1267,9 @@ void FileUtils::addSearchPath(const std::string &searchpath,const bool front)
 
 void FileUtils::setFilenameLookupDictionary(const ValueMap& filenameLookupDict)
 {
+    std::lock_guard<std::recursive_mutex> lock(_fullPathCacheMutex);
     _fullPathCache.clear();
+    _missingPathCache.clear();
     _filenameLookupDict = filenameLookupDict;
 }
 
@@ -1089,6 +1347,8 @@ bool FileUtils::isDirectoryExist(const std::string& dirPath) const
         return isDirectoryExistInternal(dirPath);
     }
 
+    std::lock_guard<std::recursive_mutex> lock(_fullPathCacheMutex);
+
     // Already Cached ?
     auto cacheIter = _fullPathCache.find(dirPath);
     if( cacheIter != _fullPathCache.end() )
@@ -1192,6 +1452,11 @@ bool FileUtils::isDirectoryExistInternal(const std::string& dirPath) const
     return false;
 }
 
+bool FileUtils::listDirectoryInternal(const std::string& /*dirPath*/, std::vector<std::string>& /*names*/) const
+{
+    return false;
+}
+
 bool FileUtils::createDirectory(const std::string& path)
 {
     CCASSERT(false, "FileUtils not support createDirectory");
@@ -1268,6 +1533,29 @@ bool FileUtils::isDirectoryExistInternal(const std::string& dirPath) const
     return false;
 }
 
+bool FileUtils::listDirectoryInternal(const std::string& dirPath, std::vector<std::string>& names) const
+{
+    // Relative paths are resolved differently on each platform, they are left to the subclasses.
+    if (!isAbsolutePath(dirPath))
+        return false;
+
+    DIR* dir = opendir(dirPath.c_str());
+    if (dir == nullptr)
+    {
+        // A directory that doesn't exist has no files.
+        return errno == ENOENT || errno == ENOTDIR;
+    }
+
+    struct dirent* entry;
+    while ((entry = readdir(dir)) != nullptr)
+    {
+        if (strcmp(entry->d_name, ".") != 0 && strcmp(entry->d_name, "..") != 0)
+            names.push_back(entry->d_name);
+    }
+    closedir(dir);
+    return true;
+}
+
 bool FileUtils::createDirectory(const std::string& path)
 {
     CCASSERT(!path.empty(), "Invalid path");
@@ -28,12 +28,16 @@
 #include <string>
 #include <vector>
 #include <unordered_map>
+#include <unordered_set>
 #include <type_traits>
+#include <memory>
+#include <mutex>
 
 #include "platform/CCPlatformMacros.h"
 #include "base/ccTypes.h"
 #include "base/CCValue.h"
 #include "base/CCData.h"
+#include "platform/CCFileView.h"
 #include "base/CCAsyncTaskPool.h"
 #include "base/CCScheduler.h"
 #include "base/CCDirector.h"
@@ -270,6 +274,41 @@ public:
     }
     virtual Status getContents(const std::string& filename, ResizableBuffer* buffer);
 
+    /**
+     *  Gets a part of the contents of a file, without reading the rest when direct file access is enabled.
+     *
+     *  @param[in]  filename The resource file name which contains the path.
+     *  @param[in]  offset The offset of the part in the file.
+     *  @param[in]  size The size of the part.
+     *  @param[out] buffer The buffer where the part is stored to, see getContents.
+     *  @return Returns the same values as getContents. Status::ReadFailed when the file ends before the end
+     *      of the part, the buffer is filled with the bytes before the end of the file.
+     *  @since v3.16
+     */
+    template <
+    typename T,
+    typename Enable = typename std::enable_if<
+    std::is_base_of< ResizableBuffer, ResizableBufferAdapter<T> >::value
+    >::type
+    >
+    Status getFileRange(const std::string& filename, size_t offset, size_t size, T* buffer) {
+        ResizableBufferAdapter<T> buf(buffer);
+        return getFileRange(filename, offset, size, &buf);
+    }
+    virtual Status getFileRange(const std::string& filename, size_t offset, size_t size, ResizableBuffer* buffer);
+
+    /**
+     *  Gets a read-only view of the contents of a file.
+     *  When direct file access is enabled, the file is memory mapped when it can be, so that it isn't copied
+     *  to the heap, and it is copied otherwise, for example when it is in a zip or compressed in the apk.
+     *  The view holds what getContents returns otherwise.
+     *
+     *  @param filename The resource file name which contains the path.
+     *  @return The view of the file, null if the file can't be read.
+     *  @since v3.16
+     */
+    virtual FileView getFileView(const std::string& filename);
+
     /**
      *  Gets resource file data
      *
@@ -842,6 +881,58 @@ public:
     /** Returns the full path cache. */
     const std::unordered_map<std::string, std::string>& getFullPathCache() const { return _fullPathCache; }
 
+    /**
+     *  Enables or disables the path index used by fullPathForFilename.
+     *
+     *  When enabled, every directory that a lookup has to probe is listed once and kept in memory,
+     *  so later lookups answer from the listing instead of asking the file system, and names that
+     *  aren't found in any search path are remembered as missing until the search paths change.
+     *  Directories under the writable path are never indexed. If files are added to the other search
+     *  paths while the game runs, call purgeCachedEntries() or disable the index.
+     *  It is enabled by default.
+     *
+     *  @param enabled True to resolve file names through the path index.
+     *  @since v3.16
+     */
+    void setPathIndexEnabled(bool enabled);
+
+    /**
+     *  Checks whether the path index is enabled.
+     *  @since v3.16
+     */
+    bool isPathIndexEnabled() const;
+
+    /**
+     *  Enables or disables the direct file access of getFileView and getFileRange.
+     *
+     *  When enabled, they map or read the files themselves, which is only right if getContents returns
+     *  the files as they are. When disabled, they read the whole file with getContents, so subclasses
+     *  decrypting the files or reading them from elsewhere are used by them too.
+     *  It is enabled for the FileUtils created by getInstance, and disabled for the other instances,
+     *  the delegates of setDelegate for instance.
+     *
+     *  @param enabled True to let getFileView and getFileRange read the files directly.
+     *  @since v3.16
+     */
+    void setDirectFileAccessEnabled(bool enabled);
+
+    /**
+     *  Checks whether the direct file access of getFileView and getFileRange is enabled.
+     *  @since v3.16
+     */
+    bool isDirectFileAccessEnabled() const;
+
+    /**
+     *  Lists the directories of the current search paths and resolution orders off the main cocos thread,
+     *  so that the first lookups don't pay for it.
+     *
+     *  @param callback The function to be called once the directories are indexed, on the main cocos thread.
+     *  @since v3.16
+     * @js NA
+     * @lua NA
+     */
+    void prefetchPathIndex(std::function<void()> callback);
+
     /**
      *  Gets the new filename from the filename lookup dictionary.
      *  It is possible to have a override names.
@@ -881,6 +972,30 @@ protected:
      */
     virtual bool isDirectoryExistInternal(const std::string& dirPath) const;
 
+    /**
+     *  Lists the names of the files in a directory without considering search paths and resolution orders.
+     *  It is used to build the path index of fullPathForFilename.
+     *
+     *  @note Names should be the ones isFileExistInternal would accept inside the directory. A directory
+     *        which doesn't exist is listed as empty.
+     *  @param dirPath The directory to list, it ends with '/' unless it is empty.
+     *  @param names The names of the files in the directory.
+     *  @return False if the directory can't be listed on this platform, in which case every file is looked up
+     *          with isFileExistInternal.
+     *  @since v3.16
+     */
+    virtual bool listDirectoryInternal(const std::string& dirPath, std::vector<std::string>& names) const;
+
+    /**
+     *  Gets the lower case names of the files in a directory from the path index, listing it the first time.
+     *  The caller must hold _fullPathCacheMutex.
+     *
+     *  @param dirPath The directory, as built by getPathForFilename.
+     *  @return The names, or nullptr if the directory isn't indexed and has to be asked to the file system.
+     *  @since v3.16
+     */
+    const std::unordered_set<std::string>* getPathIndexEntry(const std::string& dirPath) const;
+
     /**
      *  Gets full path for filename, resolution directory and search path.
      *
@@ -944,6 +1059,38 @@ protected:
      */
     mutable std::unordered_map<std::string, std::string> _fullPathCache;
 
+    /**
+     *  The file names which couldn't be found in any search path.
+     *  It is cleared when the search paths, the resolution orders or the filename lookup dictionary change.
+     */
+    mutable std::unordered_set<std::string> _missingPathCache;
+
+    /**
+     *  Lower case names of the files in each directory listed by the path index.
+     *  Directories that can't be listed are mapped to nullptr.
+     */
+    mutable std::unordered_map<std::string, std::unique_ptr<std::unordered_set<std::string>>> _pathIndex;
+
+    /**
+     *  The writable path as it was when the path index was built, its directories are never indexed.
+     */
+    mutable std::string _pathIndexWritablePath;
+
+    /**
+     *  Whether fullPathForFilename uses the path index.
+     */
+    bool _pathIndexEnabled;
+
+    /**
+     *  Whether getFileView and getFileRange may read the files without going through getContents.
+     */
+    bool _directFileAccessEnabled;
+
+    /**
+     *  Guards the search paths and the caches above, fullPathForFilename can be called from loading threads.
+     */
+    mutable std::recursive_mutex _fullPathCacheMutex;
+
     /**
      * Writable path.
      */
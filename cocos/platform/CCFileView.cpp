@@ -0,0 +1,188 @@
+/****************************************************************************
+Copyright (c) 2017 Chukong Technologies Inc.
+
+http://www.cocos2d-x.org
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+****************************************************************************/
+
+#include "platform/CCFileView.h"
+#include "platform/CCPlatformConfig.h"
+
+#if CC_TARGET_PLATFORM == CC_PLATFORM_WIN32
+#include "platform/win32/CCUtils-win32.h"
+#define CC_FILE_VIEW_WIN32_MAPPING 1
+#elif CC_TARGET_PLATFORM == CC_PLATFORM_WINRT
+// no mapping, the files are copied
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define CC_FILE_VIEW_POSIX_MAPPING 1
+#endif
+
+NS_CC_BEGIN
+
+FileView::FileView()
+: _bytes(nullptr)
+, _size(0)
+, _mapping(nullptr)
+, _mappingSize(0)
+{
+}
+
+FileView::FileView(FileView&& other)
+: _bytes(other._bytes)
+, _size(other._size)
+, _mapping(other._mapping)
+, _mappingSize(other._mappingSize)
+, _data(std::move(other._data))
+{
+    other._bytes = nullptr;
+    other._size = 0;
+    other._mapping = nullptr;
+    other._mappingSize = 0;
+}
+
+FileView::~FileView()
+{
+    clear();
+}
+
+FileView& FileView::operator= (FileView&& other)
+{
+    if (this != &other)
+    {
+        clear();
+        _bytes = other._bytes;
+        _size = other._size;
+        _mapping = other._mapping;
+        _mappingSize = other._mappingSize;
+        _data = std::move(other._data);
+        other._bytes = nullptr;
+        other._size = 0;
+        other._mapping = nullptr;
+        other._mappingSize = 0;
+    }
+    return *this;
+}
+
+bool FileView::initWithMappedFile(const std::string& fullPath)
+{
+    clear();
+
+#if defined(CC_FILE_VIEW_WIN32_MAPPING)
+    HANDLE file = ::CreateFileW(StringUtf8ToWideChar(fullPath).c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE)
+        return false;
+
+    LARGE_INTEGER size;
+    void* mapping = nullptr;
+    if (::GetFileSizeEx(file, &size) && size.QuadPart > 0 && (uint64_t)size.QuadPart <= SIZE_MAX)
+    {
+        HANDLE fileMapping = ::CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (fileMapping)
+        {
+            mapping = ::MapViewOfFile(fileMapping, FILE_MAP_READ, 0, 0, 0);
+            // the view keeps the mapping alive
+            ::CloseHandle(fileMapping);
+        }
+    }
+    ::CloseHandle(file);
+    if (!mapping)
+        return false;
+
+    _mapping = mapping;
+    _mappingSize = (size_t)size.QuadPart;
+    _bytes = static_cast<const unsigned char*>(mapping);
+    _size = (ssize_t)size.QuadPart;
+    return true;
+#elif defined(CC_FILE_VIEW_POSIX_MAPPING)
+    int fd = ::open(fullPath.c_str(), O_RDONLY);
+    if (fd < 0)
+        return false;
+
+    struct stat statBuf;
+    bool ret = ::fstat(fd, &statBuf) == 0 && S_ISREG(statBuf.st_mode)
+        && initWithMappedDescriptor(fd, 0, (ssize_t)statBuf.st_size);
+    ::close(fd);
+    return ret;
+#else
+    CC_UNUSED_PARAM(fullPath);
+    return false;
+#endif
+}
+
+bool FileView::initWithMappedDescriptor(int fd, int64_t offset, ssize_t size)
+{
+    clear();
+
+#if defined(CC_FILE_VIEW_POSIX_MAPPING)
+    // an empty file can't be mapped
+    if (fd < 0 || offset < 0 || size <= 0)
+        return false;
+
+    // the mapping starts at a page boundary
+    static const int64_t pageSize = ::sysconf(_SC_PAGESIZE);
+    const int64_t mappingOffset = offset - offset % pageSize;
+    const size_t mappingSize = (size_t)(offset - mappingOffset) + (size_t)size;
+    void* mapping = ::mmap(nullptr, mappingSize, PROT_READ, MAP_PRIVATE, fd, (off_t)mappingOffset);
+    if (mapping == MAP_FAILED)
+        return false;
+
+    _mapping = mapping;
+    _mappingSize = mappingSize;
+    _bytes = static_cast<const unsigned char*>(mapping) + (offset - mappingOffset);
+    _size = size;
+    return true;
+#else
+    CC_UNUSED_PARAM(fd);
+    CC_UNUSED_PARAM(offset);
+    CC_UNUSED_PARAM(size);
+    return false;
+#endif
+}
+
+void FileView::initWithData(Data&& data)
+{
+    clear();
+    _data = std::move(data);
+    _bytes = _data.getBytes();
+    _size = _data.getSize();
+}
+
+void FileView::clear()
+{
+    if (_mapping)
+    {
+#if defined(CC_FILE_VIEW_WIN32_MAPPING)
+        ::UnmapViewOfFile(_mapping);
+#elif defined(CC_FILE_VIEW_POSIX_MAPPING)
+        ::munmap(_mapping, _mappingSize);
+#endif
+        _mapping = nullptr;
+        _mappingSize = 0;
+    }
+    _data.clear();
+    _bytes = nullptr;
+    _size = 0;
+}
+
+NS_CC_END
@@ -0,0 +1,113 @@
+/****************************************************************************
+Copyright (c) 2017 Chukong Technologies Inc.
+
+http://www.cocos2d-x.org
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+****************************************************************************/
+
+#ifndef __CC_FILE_VIEW_H__
+#define __CC_FILE_VIEW_H__
+
+#include "platform/CCPlatformMacros.h"
+#include "base/CCData.h"
+#include <string>
+
+/**
+ * @addtogroup platform
+ * @{
+ */
+
+NS_CC_BEGIN
+
+/** @class FileView
+ * @brief Read-only contents of a file, memory mapped when possible.
+ *
+ * A mapped file isn't copied to the heap: its pages are read by the system when they are accessed,
+ * and can be dropped again under memory pressure. When the file can't be mapped, for example when
+ * it is in a zip or in the assets of an apk which are compressed, the view holds a copy of it instead.
+ * Get one with FileUtils::getFileView().
+ *
+ * The view can be moved but not copied. The bytes are valid until the view is destroyed or cleared.
+ * @js NA
+ * @lua NA
+ * @since v3.16
+ */
+class CC_DLL FileView
+{
+public:
+    FileView();
+    FileView(FileView&& other);
+    ~FileView();
+
+    FileView& operator= (FileView&& other);
+
+    /** Maps a whole file, read only.
+     *
+     * @param fullPath The full path of the file, in UTF-8.
+     * @return True if the file is mapped. The view is left empty otherwise.
+     */
+    bool initWithMappedFile(const std::string& fullPath);
+
+    /** Maps a part of an open file, read only. The descriptor can be closed afterwards.
+     *
+     * @param fd The descriptor of the file.
+     * @param offset The offset of the part in the file. It doesn't need to be aligned.
+     * @param size The size of the part.
+     * @return True if the part is mapped. The view is left empty otherwise.
+     */
+    bool initWithMappedDescriptor(int fd, int64_t offset, ssize_t size);
+
+    /** Uses a copy of the file instead of a mapping. */
+    void initWithData(Data&& data);
+
+    /** Gets the bytes of the file, nullptr if the view is empty. */
+    const unsigned char* getBytes() const { return _bytes; }
+
+    /** Gets the size of the file. */
+    ssize_t getSize() const { return _size; }
+
+    /** Whether the view is empty. */
+    bool isNull() const { return _bytes == nullptr || _size == 0; }
+
+    /** Whether the file is mapped rather than copied. */
+    bool isMapped() const { return _mapping != nullptr; }
+
+    /** Unmaps or releases the file. */
+    void clear();
+
+private:
+    FileView(const FileView&) = delete;
+    FileView& operator= (const FileView&) = delete;
+
+    const unsigned char* _bytes;
+    ssize_t _size;
+    // the mapped region, which starts at a page boundary before _bytes
+    void* _mapping;
+    size_t _mappingSize;
+    // the copy of the file when it isn't mapped
+    Data _data;
+};
+
+NS_CC_END
+
+// end of platform group
+/// @}
+
+#endif // __CC_FILE_VIEW_H__
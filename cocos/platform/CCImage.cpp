@@ -32,6 +32,12 @@ THE SOFTWARE.
 #include "base/CCData.h"
 #include "base/ccConfig.h" // CC_USE_JPEG, CC_USE_TIFF, CC_USE_WEBP
 
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#elif defined(__ARM_NEON__) || defined(__aarch64__) || defined(__arm64__)
+#include <arm_neon.h>
+#endif
+
 extern "C"
 {
     // To resolve link error when building 32bits with Xcode 6.
@@ -509,11 +515,12 @@ bool Image::initWithImageFile(const std::string& path)
     bool ret = false;
     _filePath = FileUtils::getInstance()->fullPathForFilename(path);
 
-    Data data = FileUtils::getInstance()->getDataFromFile(_filePath);
+    // the file is mapped when possible, the decoders copy what they keep
+    FileView view = FileUtils::getInstance()->getFileView(_filePath);
 
-    if (!data.isNull())
+    if (!view.isNull())
     {
-        ret = initWithImageData(data.getBytes(), data.getSize());
+        ret = initWithImageData(view.getBytes(), view.getSize());
     }
 
     return ret;
@@ -524,11 +531,12 @@ bool Image::initWithImageFileThreadSafe(const std::string& fullpath)
     bool ret = false;
     _filePath = fullpath;
 
-    Data data = FileUtils::getInstance()->getDataFromFile(fullpath);
+    // the file is mapped when possible, the decoders copy what they keep
+    FileView view = FileUtils::getInstance()->getFileView(fullpath);
 
-    if (!data.isNull())
+    if (!view.isNull())
     {
-        ret = initWithImageData(data.getBytes(), data.getSize());
+        ret = initWithImageData(view.getBytes(), view.getSize());
     }
 
     return ret;
@@ -2458,8 +2466,51 @@ void Image::premultipliedAlpha()
 #else
     CCASSERT(_renderFormat == Texture2D::PixelFormat::RGBA8888, "The pixel format should be RGBA8888!");
     
+    const int pixels = _width * _height;
+    int i = 0;
+#if defined(__SSE2__)
+    if (Texture2D::isSimdConversionEnabled())
+    {
+        // 4 pixels at a time, the channels widened to 16 bits are multiplied by their alpha + 1
+        const __m128i zero = _mm_setzero_si128();
+        const __m128i one = _mm_set1_epi16(1);
+        const __m128i alphaMask = _mm_set1_epi32((int)0xFF000000);
+        for (; i + 4 <= pixels; i += 4)
+        {
+            const __m128i v = _mm_loadu_si128((const __m128i*)(_data + i * 4));
+            __m128i lo = _mm_unpacklo_epi8(v, zero);
+            __m128i hi = _mm_unpackhi_epi8(v, zero);
+            const __m128i alphaLo = _mm_add_epi16(_mm_shufflehi_epi16(_mm_shufflelo_epi16(lo, _MM_SHUFFLE(3, 3, 3, 3)), _MM_SHUFFLE(3, 3, 3, 3)), one);
+            const __m128i alphaHi = _mm_add_epi16(_mm_shufflehi_epi16(_mm_shufflelo_epi16(hi, _MM_SHUFFLE(3, 3, 3, 3)), _MM_SHUFFLE(3, 3, 3, 3)), one);
+            lo = _mm_srli_epi16(_mm_mullo_epi16(lo, alphaLo), 8);
+            hi = _mm_srli_epi16(_mm_mullo_epi16(hi, alphaHi), 8);
+            const __m128i rgb = _mm_andnot_si128(alphaMask, _mm_packus_epi16(lo, hi));
+            _mm_storeu_si128((__m128i*)(_data + i * 4), _mm_or_si128(rgb, _mm_and_si128(v, alphaMask)));
+        }
+    }
+#elif defined(__ARM_NEON__) || defined(__aarch64__) || defined(__arm64__)
+    if (Texture2D::isSimdConversionEnabled())
+    {
+        // 16 pixels at a time, c * (a + 1) >> 8 computed as (c * a + c) >> 8
+        for (; i + 16 <= pixels; i += 16)
+        {
+            uint8x16x4_t v = vld4q_u8(_data + i * 4);
+            const uint8x8_t alphaLo = vget_low_u8(v.val[3]);
+            const uint8x8_t alphaHi = vget_high_u8(v.val[3]);
+            for (int c = 0; c < 3; ++c)
+            {
+                const uint8x8_t lo = vget_low_u8(v.val[c]);
+                const uint8x8_t hi = vget_high_u8(v.val[c]);
+                v.val[c] = vcombine_u8(vshrn_n_u16(vaddw_u8(vmull_u8(lo, alphaLo), lo), 8),
+                                       vshrn_n_u16(vaddw_u8(vmull_u8(hi, alphaHi), hi), 8));
+            }
+            vst4q_u8(_data + i * 4, v);
+        }
+    }
+#endif
+
     unsigned int* fourBytes = (unsigned int*)_data;
-    for(int i = 0; i < _width * _height; i++)
+    for(; i < pixels; i++)
     {
         unsigned char* p = _data + i * 4;
         fourBytes[i] = CC_RGB_PREMULTIPLY_ALPHA(p[0], p[1], p[2], p[3]);
@@ -106,6 +106,13 @@ public:
      *  @param enabled (default: true)
      */
     static void setPNGPremultipliedAlphaEnabled(bool enabled) { PNG_PREMULTIPLIED_ALPHA_ENABLED = enabled; }
+
+    /**
+     * Whether premultiplied alpha is enabled for PNG files.
+     *
+     * @since v3.16
+     */
+    static bool isPNGPremultipliedAlphaEnabled() { return PNG_PREMULTIPLIED_ALPHA_ENABLED; }
     
     /** treats (or not) PVR files as if they have alpha premultiplied.
      Since it is impossible to know at runtime if the PVR images have the alpha channel premultiplied, it is
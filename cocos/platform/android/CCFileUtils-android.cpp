@@ -35,6 +35,8 @@ THE SOFTWARE.
 #include "base/ZipUtils.h"
 #include <stdlib.h>
 #include <sys/stat.h>
+#include <unistd.h>
+#include <algorithm>
 
 #define  LOG_TAG    "CCFileUtils-android.cpp"
 #define  LOGD(...)  __android_log_print(ANDROID_LOG_DEBUG,LOG_TAG,__VA_ARGS__)
@@ -69,6 +71,11 @@ FileUtils* FileUtils::getInstance()
           s_sharedFileUtils = nullptr;
           CCLOG("ERROR: Could not init CCFileUtilsAndroid");
         }
+        else
+        {
+            // getContents returns the files as they are, they can be mapped
+            s_sharedFileUtils->setDirectFileAccessEnabled(true);
+        }
     }
     return s_sharedFileUtils;
 }
@@ -238,6 +245,45 @@ bool FileUtilsAndroid::isDirectoryExistInternal(const std::string& dirPath) cons
     return false;
 }
 
+bool FileUtilsAndroid::listDirectoryInternal(const std::string& dirPath, std::vector<std::string>& names) const
+{
+    if (!dirPath.empty() && dirPath[0] == '/')
+    {
+        return FileUtils::listDirectoryInternal(dirPath, names);
+    }
+
+    // Files in the obb are only looked up one by one, and the asset manager doesn't resolve "..".
+    if (obbfile || !FileUtilsAndroid::assetmanager || dirPath.find("..") != std::string::npos)
+    {
+        return false;
+    }
+
+    std::string relativePath = dirPath;
+    if (relativePath.find(ASSETS_FOLDER_NAME) == 0)
+    {
+        relativePath.erase(0, ASSETS_FOLDER_NAME_LENGTH);
+    }
+    if (!relativePath.empty() && relativePath[relativePath.length()-1] == '/')
+    {
+        relativePath.pop_back();
+    }
+
+    // Opening a directory that isn't in the apk gives an empty listing.
+    AAssetDir* dir = AAssetManager_openDir(FileUtilsAndroid::assetmanager, relativePath.c_str());
+    if (dir == nullptr)
+    {
+        return false;
+    }
+
+    const char* name;
+    while ((name = AAssetDir_getNextFileName(dir)) != nullptr)
+    {
+        names.push_back(name);
+    }
+    AAssetDir_close(dir);
+    return true;
+}
+
 bool FileUtilsAndroid::isAbsolutePath(const std::string& strPath) const
 {
     // On Android, there are two situations for full path.
@@ -277,17 +323,10 @@ long FileUtilsAndroid::getFileSize(const std::string& filepath)
     return size;
 }
 
-FileUtils::Status FileUtilsAndroid::getContents(const std::string& filename, ResizableBuffer* buffer)
+// the path of an asset in the apk or the obb file
+static string getAssetRelativePath(const string& fullPath)
 {
     static const std::string apkprefix("assets/");
-    if (filename.empty())
-        return FileUtils::Status::NotExists;
-
-    string fullPath = fullPathForFilename(filename);
-
-    if (fullPath[0] == '/')
-        return FileUtils::getContents(fullPath, buffer);
-
     string relativePath = string();
     size_t position = fullPath.find(apkprefix);
     if (0 == position) {
@@ -296,6 +335,20 @@ FileUtils::Status FileUtilsAndroid::getContents(const std::string& filename, Res
     } else {
         relativePath = fullPath;
     }
+    return relativePath;
+}
+
+FileUtils::Status FileUtilsAndroid::getContents(const std::string& filename, ResizableBuffer* buffer)
+{
+    if (filename.empty())
+        return FileUtils::Status::NotExists;
+
+    string fullPath = fullPathForFilename(filename);
+
+    if (fullPath[0] == '/')
+        return FileUtils::getContents(fullPath, buffer);
+
+    string relativePath = getAssetRelativePath(fullPath);
     
     if (obbfile)
     {
@@ -329,6 +382,110 @@ FileUtils::Status FileUtilsAndroid::getContents(const std::string& filename, Res
     return FileUtils::Status::OK;
 }
 
+FileUtils::Status FileUtilsAndroid::getFileRange(const std::string& filename, size_t offset, size_t size, ResizableBuffer* buffer)
+{
+    if (filename.empty())
+        return FileUtils::Status::NotExists;
+
+    string fullPath = fullPathForFilename(filename);
+    if (fullPath.empty())
+        return FileUtils::Status::NotExists;
+
+    // the base class takes the part from getContents when the files can't be read directly
+    if (fullPath[0] == '/' || !isDirectFileAccessEnabled())
+        return FileUtils::getFileRange(fullPath, offset, size, buffer);
+
+    string relativePath = getAssetRelativePath(fullPath);
+
+    if (obbfile && obbfile->fileExists(relativePath))
+    {
+        // the stored files of the obb are mapped, the others are inflated whole
+        FileView view = obbfile->getFileView(relativePath);
+        if (view.isNull())
+            return FileUtils::Status::ReadFailed;
+
+        size_t available = offset < (size_t)view.getSize() ? std::min(size, (size_t)view.getSize() - offset) : 0;
+        buffer->resize(available);
+        if (available > 0)
+            memcpy(buffer->buffer(), view.getBytes() + offset, available);
+        return available < size ? FileUtils::Status::ReadFailed : FileUtils::Status::OK;
+    }
+
+    if (nullptr == assetmanager) {
+        LOGD("... FileUtilsAndroid::assetmanager is nullptr");
+        return FileUtils::Status::NotInitialized;
+    }
+
+    AAsset* asset = AAssetManager_open(assetmanager, relativePath.data(), AASSET_MODE_RANDOM);
+    if (nullptr == asset) {
+        LOGD("asset is nullptr");
+        return FileUtils::Status::OpenFailed;
+    }
+
+    off64_t length = AAsset_getLength64(asset);
+    if ((off64_t)offset > length || AAsset_seek64(asset, (off64_t)offset, SEEK_SET) < 0) {
+        AAsset_close(asset);
+        buffer->resize(0);
+        return FileUtils::Status::ReadFailed;
+    }
+
+    size_t available = std::min(size, (size_t)(length - (off64_t)offset));
+    buffer->resize(available);
+    int readsize = available > 0 ? AAsset_read(asset, buffer->buffer(), available) : 0;
+    AAsset_close(asset);
+
+    if (readsize < 0 || (size_t)readsize < size) {
+        buffer->resize(readsize >= 0 ? readsize : 0);
+        return FileUtils::Status::ReadFailed;
+    }
+
+    return FileUtils::Status::OK;
+}
+
+FileView FileUtilsAndroid::getFileView(const std::string& filename)
+{
+    FileView view;
+    if (filename.empty())
+        return view;
+
+    string fullPath = fullPathForFilename(filename);
+    if (fullPath.empty())
+        return view;
+
+    if (fullPath[0] == '/' || !isDirectFileAccessEnabled())
+        return FileUtils::getFileView(fullPath);
+
+    // the assets stored without compression are mapped from the apk or the obb, the others are inflated
+    string relativePath = getAssetRelativePath(fullPath);
+    if (obbfile && obbfile->fileExists(relativePath))
+    {
+        return obbfile->getFileView(relativePath);
+    }
+    if (assetmanager)
+    {
+        AAsset* asset = AAssetManager_open(assetmanager, relativePath.data(), AASSET_MODE_UNKNOWN);
+        if (asset)
+        {
+            off64_t start = 0;
+            off64_t length = 0;
+            int fd = AAsset_openFileDescriptor64(asset, &start, &length);
+            if (fd >= 0)
+            {
+                view.initWithMappedDescriptor(fd, start, (ssize_t)length);
+                close(fd);
+            }
+            AAsset_close(asset);
+            if (!view.isNull())
+                return view;
+        }
+    }
+
+    Data data;
+    if (getContents(fullPath, &data) == FileUtils::Status::OK)
+        view.initWithData(std::move(data));
+    return view;
+}
+
 string FileUtilsAndroid::getWritablePath() const
 {
     // Fix for Nexus 10 (Android 4.2 multi-user environment)
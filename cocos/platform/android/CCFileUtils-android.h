@@ -67,6 +67,8 @@ public:
     virtual std::string getNewFilename(const std::string &filename) const override;
 
     virtual FileUtils::Status getContents(const std::string& filename, ResizableBuffer* buffer) override;
+    virtual FileUtils::Status getFileRange(const std::string& filename, size_t offset, size_t size, ResizableBuffer* buffer) override;
+    virtual FileView getFileView(const std::string& filename) override;
 
     virtual std::string getWritablePath() const override;
     virtual bool isAbsolutePath(const std::string& strPath) const override;
@@ -76,6 +78,7 @@ public:
 private:
     virtual bool isFileExistInternal(const std::string& strFilePath) const override;
     virtual bool isDirectoryExistInternal(const std::string& dirPath) const override;
+    virtual bool listDirectoryInternal(const std::string& dirPath, std::vector<std::string>& names) const override;
 
     static AAssetManager* assetmanager;
     static ZipFile* obbfile;
@@ -43,6 +43,11 @@ FileUtils* FileUtils::getInstance()
           s_sharedFileUtils = nullptr;
           CCLOG("ERROR: Could not init FileUtilsTizen");
         }
+        else
+        {
+            // getContents returns the files as they are, they can be mapped
+            s_sharedFileUtils->setDirectFileAccessEnabled(true);
+        }
     }
 
     return s_sharedFileUtils;
@@ -88,6 +88,11 @@ FileUtils* FileUtils::getInstance()
           s_sharedFileUtils = nullptr;
           CCLOG("ERROR: Could not init CCFileUtilsWin32");
         }
+        else
+        {
+            // getContents returns the files as they are, they can be mapped
+            s_sharedFileUtils->setDirectFileAccessEnabled(true);
+        }
     }
     return s_sharedFileUtils;
 }
@@ -114,6 +119,40 @@ bool FileUtilsWin32::isDirectoryExistInternal(const std::string& dirPath) const
     return false;
 }
 
+bool FileUtilsWin32::listDirectoryInternal(const std::string& dirPath, std::vector<std::string>& names) const
+{
+    std::string strPath = dirPath;
+    if (!isAbsolutePath(strPath))
+    { // Not absolute path, add the default root path at the beginning.
+        strPath.insert(0, _defaultResRootPath);
+    }
+    if (!strPath.empty() && strPath[strPath.length()-1] != '/' && strPath[strPath.length()-1] != '\\')
+    {
+        strPath += '/';
+    }
+    strPath += '*';
+
+    WIN32_FIND_DATAW wfd;
+    HANDLE search = FindFirstFileExW(StringUtf8ToWideChar(strPath).c_str(), FindExInfoBasic, &wfd, FindExSearchNameMatch, NULL, FIND_FIRST_EX_LARGE_FETCH);
+    if (search == INVALID_HANDLE_VALUE)
+    {
+        // A directory that doesn't exist has no files.
+        DWORD error = GetLastError();
+        return error == ERROR_FILE_NOT_FOUND || error == ERROR_PATH_NOT_FOUND;
+    }
+
+    // Directories are listed too, their paths are resolved like the paths of files.
+    do
+    {
+        if (wcscmp(wfd.cFileName, L".") != 0 && wcscmp(wfd.cFileName, L"..") != 0)
+        {
+            names.push_back(StringWideCharToUtf8(wfd.cFileName));
+        }
+    } while (FindNextFileW(search, &wfd));
+    FindClose(search);
+    return true;
+}
+
 std::string FileUtilsWin32::getSuitableFOpen(const std::string& filenameUtf8) const
 {
     return UTF8StringToMultiByte(filenameUtf8);
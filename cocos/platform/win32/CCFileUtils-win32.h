@@ -84,6 +84,14 @@ protected:
     */
     virtual bool isDirectoryExistInternal(const std::string& dirPath) const override;
 
+    /**
+    *  Lists the names of the files and sub directories in a directory, '.' and '..' are left out.
+    *  @param dirPath The directory to list
+    *  @param names The names of the files in the directory
+    *  @return Returns false if the directory can't be listed
+    */
+    virtual bool listDirectoryInternal(const std::string& dirPath, std::vector<std::string>& names) const override;
+
     /**
     *  Removes a file.
     *
@@ -28,6 +28,7 @@
 
 #include <vector>
 #include <unordered_map>
+#include <mutex>
 
 #include "base/CCRef.h"
 #include "renderer/CCRenderCommand.h"
@@ -53,6 +54,8 @@ protected:
     bool init();
     std::unordered_map<int, bool> _groupMapping;
     std::vector<int> _unusedIDs;
+    // group commands may be initialized by threads visiting the scene in parallel
+    std::mutex _mutex;
 };
 
 /**
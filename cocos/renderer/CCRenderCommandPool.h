@@ -27,6 +27,7 @@
 /// @cond DO_NOT_SHOW
 
 #include <list>
+#include <mutex>
 
 #include "platform/CCPlatformMacros.h"
 
@@ -56,6 +57,7 @@ public:
 
     T* generateCommand()
     {
+        std::lock_guard<std::mutex> lock(_mutex);
         T* result = nullptr;
         if(_freePool.empty())
         {
@@ -69,6 +71,7 @@ public:
     
     void pushBackCommand(T* ptr)
     {
+        std::lock_guard<std::mutex> lock(_mutex);
 //        if(_usedPool.find(ptr) == _usedPool.end())
 //        {
 //            CCLOG("push Back Wrong command!");
@@ -94,6 +97,8 @@ private:
     std::list<T*> _allocatedPoolBlocks;
     std::list<T*> _freePool;
     //std::set<T*> _usedPool;
+    // commands may be generated by threads visiting the scene in parallel
+    std::mutex _mutex;
 };
 
 NS_CC_END
@@ -25,6 +25,7 @@
 #include "renderer/CCRenderer.h"
 
 #include <algorithm>
+#include <string.h>
 
 #include "renderer/CCTrianglesCommand.h"
 #include "renderer/CCBatchCommand.h"
@@ -46,9 +47,17 @@
 #include "base/CCEventType.h"
 #include "2d/CCCamera.h"
 #include "2d/CCScene.h"
+#include "math/MathUtil.h"
 
 NS_CC_BEGIN
 
+// unsynchronized buffer mapping and fences, see Configuration::supportsMapBufferRange()
+#if defined(GL_MAP_UNSYNCHRONIZED_BIT) && defined(GL_SYNC_GPU_COMMANDS_COMPLETE)
+#define CC_RENDERER_MAP_BUFFER_RANGE 1
+#else
+#define CC_RENDERER_MAP_BUFFER_RANGE 0
+#endif
+
 // helper
 static bool compareRenderCommand(RenderCommand* a, RenderCommand* b)
 {
@@ -60,6 +69,21 @@ static bool compare3DCommand(RenderCommand* a, RenderCommand* b)
     return  a->getDepth() > b->getDepth();
 }
 
+// below this size std::stable_sort is faster than clearing and scanning the radix histograms
+static const size_t RADIX_SORT_THRESHOLD = 256;
+
+// maps a float to an unsigned key with the same ordering
+static inline uint32_t floatToRadixKey(float value)
+{
+    uint32_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    // -0.0f == 0.0f, they must get the same key to keep the sort stable
+    if (bits == 0x80000000u)
+        bits = 0;
+    // negative: flip all the bits to reverse their order, positive: set the sign bit to put them after the negatives
+    return (bits & 0x80000000u) ? ~bits : (bits | 0x80000000u);
+}
+
 // queue
 RenderQueue::RenderQueue()
 {
@@ -111,9 +135,75 @@ ssize_t RenderQueue::size() const
 void RenderQueue::sort()
 {
     // Don't sort _queue0, it already comes sorted
-    std::stable_sort(std::begin(_commands[QUEUE_GROUP::TRANSPARENT_3D]), std::end(_commands[QUEUE_GROUP::TRANSPARENT_3D]), compare3DCommand);
-    std::stable_sort(std::begin(_commands[QUEUE_GROUP::GLOBALZ_NEG]), std::end(_commands[QUEUE_GROUP::GLOBALZ_NEG]), compareRenderCommand);
-    std::stable_sort(std::begin(_commands[QUEUE_GROUP::GLOBALZ_POS]), std::end(_commands[QUEUE_GROUP::GLOBALZ_POS]), compareRenderCommand);
+    if (_commands[QUEUE_GROUP::TRANSPARENT_3D].size() < RADIX_SORT_THRESHOLD)
+        std::stable_sort(std::begin(_commands[QUEUE_GROUP::TRANSPARENT_3D]), std::end(_commands[QUEUE_GROUP::TRANSPARENT_3D]), compare3DCommand);
+    else
+        radixSort(_commands[QUEUE_GROUP::TRANSPARENT_3D], true);
+
+    if (_commands[QUEUE_GROUP::GLOBALZ_NEG].size() < RADIX_SORT_THRESHOLD)
+        std::stable_sort(std::begin(_commands[QUEUE_GROUP::GLOBALZ_NEG]), std::end(_commands[QUEUE_GROUP::GLOBALZ_NEG]), compareRenderCommand);
+    else
+        radixSort(_commands[QUEUE_GROUP::GLOBALZ_NEG], false);
+
+    if (_commands[QUEUE_GROUP::GLOBALZ_POS].size() < RADIX_SORT_THRESHOLD)
+        std::stable_sort(std::begin(_commands[QUEUE_GROUP::GLOBALZ_POS]), std::end(_commands[QUEUE_GROUP::GLOBALZ_POS]), compareRenderCommand);
+    else
+        radixSort(_commands[QUEUE_GROUP::GLOBALZ_POS], false);
+}
+
+void RenderQueue::radixSort(std::vector<RenderCommand*>& commands, bool byDepth)
+{
+    const size_t count = commands.size();
+    _sortBuffer.resize(count);
+    _sortScratch.resize(count);
+
+    // one histogram per byte of the key, all built in a single pass
+    uint32_t histograms[4][256];
+    memset(histograms, 0, sizeof(histograms));
+
+    for (size_t i = 0; i < count; ++i)
+    {
+        auto command = commands[i];
+        // depth sorts descending, inverting the key keeps equal depths in their original order
+        uint32_t key = byDepth ? ~floatToRadixKey(command->getDepth()) : floatToRadixKey(command->getGlobalOrder());
+        _sortBuffer[i].key = key;
+        _sortBuffer[i].command = command;
+        ++histograms[0][key & 0xFF];
+        ++histograms[1][(key >> 8) & 0xFF];
+        ++histograms[2][(key >> 16) & 0xFF];
+        ++histograms[3][key >> 24];
+    }
+
+    SortElement* src = _sortBuffer.data();
+    SortElement* dst = _sortScratch.data();
+    for (int pass = 0; pass < 4; ++pass)
+    {
+        const int shift = pass * 8;
+        uint32_t* histogram = histograms[pass];
+
+        // all the keys share this byte, the pass would not move anything
+        if (histogram[(src[0].key >> shift) & 0xFF] == count)
+            continue;
+
+        uint32_t offset = 0;
+        for (int i = 0; i < 256; ++i)
+        {
+            uint32_t bucketSize = histogram[i];
+            histogram[i] = offset;
+            offset += bucketSize;
+        }
+
+        for (size_t i = 0; i < count; ++i)
+        {
+            dst[histogram[(src[i].key >> shift) & 0xFF]++] = src[i];
+        }
+        std::swap(src, dst);
+    }
+
+    for (size_t i = 0; i < count; ++i)
+    {
+        commands[i] = src[i].command;
+    }
 }
 
 RenderCommand* RenderQueue::operator[](ssize_t index) const
@@ -149,6 +239,14 @@ void RenderQueue::realloc(size_t reserveSize)
     }
 }
 
+void RenderQueue::append(const RenderQueue& queue)
+{
+    for(int i = 0; i < QUEUE_COUNT; ++i)
+    {
+        _commands[i].insert(_commands[i].end(), queue._commands[i].begin(), queue._commands[i].end());
+    }
+}
+
 void RenderQueue::saveRenderState()
 {
     _isDepthEnabled = glIsEnabled(GL_DEPTH_TEST) != GL_FALSE;
@@ -193,6 +291,18 @@ void RenderQueue::restoreRenderState()
 //
 static const int DEFAULT_RENDER_QUEUE = 0;
 
+// recorder of the calling thread, see Renderer::beginRecordingCommands()
+static thread_local Renderer::CommandRecorder* s_commandRecorder = nullptr;
+
+void Renderer::CommandRecorder::clear()
+{
+    groupStack.clear();
+    for (auto& queue : queues)
+    {
+        queue.clear();
+    }
+}
+
 //
 // constructors, destructor, init
 //
@@ -200,7 +310,17 @@ Renderer::Renderer()
 :_lastBatchedMeshCommand(nullptr)
 ,_filledVertex(0)
 ,_filledIndex(0)
+,_streamingMode(VertexStreamingMode::ORPHAN)
+,_streamingBufferIndex(0)
+,_streamingFrame(0)
+,_streamingBuffersCreated(false)
+,_streamingVerts(nullptr)
+,_streamingIndices(nullptr)
+,_streamingMapped(false)
 ,_glViewAssigned(false)
+,_drawnBatches(0)
+,_drawnVertices(0)
+,_uploadedBytes(0)
 ,_isRendering(false)
 ,_isDepthTestFor2D(false)
 ,_triBatchesToDraw(nullptr)
@@ -231,6 +351,7 @@ Renderer::~Renderer()
     _groupCommandManager->release();
     
     glDeleteBuffers(2, _buffersVBO);
+    deleteStreamingBuffers();
 
     free(_triBatchesToDraw);
 
@@ -270,19 +391,15 @@ void Renderer::setupBuffer()
     {
         setupVBO();
     }
+
+    if (_streamingMode == VertexStreamingMode::RING_BUFFER)
+    {
+        setupStreamingBuffers();
+    }
 }
 
-void Renderer::setupVBOAndVAO()
+static void setupTrianglesVertexAttribs()
 {
-    //generate vbo and vao for trianglesCommand
-    glGenVertexArrays(1, &_buffersVAO);
-    GL::bindVAO(_buffersVAO);
-
-    glGenBuffers(2, &_buffersVBO[0]);
-
-    glBindBuffer(GL_ARRAY_BUFFER, _buffersVBO[0]);
-    glBufferData(GL_ARRAY_BUFFER, sizeof(_verts[0]) * VBO_SIZE, _verts, GL_DYNAMIC_DRAW);
-
     // vertices
     glEnableVertexAttribArray(GLProgram::VERTEX_ATTRIB_POSITION);
     glVertexAttribPointer(GLProgram::VERTEX_ATTRIB_POSITION, 3, GL_FLOAT, GL_FALSE, sizeof(V3F_C4B_T2F), (GLvoid*) offsetof( V3F_C4B_T2F, vertices));
@@ -294,6 +411,20 @@ void Renderer::setupVBOAndVAO()
     // tex coords
     glEnableVertexAttribArray(GLProgram::VERTEX_ATTRIB_TEX_COORD);
     glVertexAttribPointer(GLProgram::VERTEX_ATTRIB_TEX_COORD, 2, GL_FLOAT, GL_FALSE, sizeof(V3F_C4B_T2F), (GLvoid*) offsetof( V3F_C4B_T2F, texCoords));
+}
+
+void Renderer::setupVBOAndVAO()
+{
+    //generate vbo and vao for trianglesCommand
+    glGenVertexArrays(1, &_buffersVAO);
+    GL::bindVAO(_buffersVAO);
+
+    glGenBuffers(2, &_buffersVBO[0]);
+
+    glBindBuffer(GL_ARRAY_BUFFER, _buffersVBO[0]);
+    glBufferData(GL_ARRAY_BUFFER, sizeof(_verts[0]) * VBO_SIZE, _verts, GL_DYNAMIC_DRAW);
+
+    setupTrianglesVertexAttribs();
 
     glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, _buffersVBO[1]);
     glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(_indices[0]) * INDEX_VBO_SIZE, _indices, GL_STATIC_DRAW);
@@ -338,9 +469,87 @@ void Renderer::mapBuffers()
     CHECK_GL_ERROR_DEBUG();
 }
 
+void Renderer::setupStreamingBuffers()
+{
+    // the ring buffers keep their element buffer in a VAO
+    _streamingBuffersCreated = false;
+    if (!Configuration::getInstance()->supportsShareableVAO())
+        return;
+
+    for (auto& buffer : _streamingBuffers)
+    {
+        glGenVertexArrays(1, &buffer.vao);
+        GL::bindVAO(buffer.vao);
+
+        glGenBuffers(2, &buffer.vbo[0]);
+
+        glBindBuffer(GL_ARRAY_BUFFER, buffer.vbo[0]);
+        glBufferData(GL_ARRAY_BUFFER, sizeof(_verts[0]) * VBO_SIZE, nullptr, GL_STREAM_DRAW);
+
+        setupTrianglesVertexAttribs();
+
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, buffer.vbo[1]);
+        glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(_indices[0]) * INDEX_VBO_SIZE, nullptr, GL_STREAM_DRAW);
+
+        buffer.filledVertex = 0;
+        buffer.filledIndex = 0;
+        buffer.fence = nullptr;
+    }
+
+    // Must unbind the VAO before changing the element buffer.
+    GL::bindVAO(0);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+    _streamingBufferIndex = 0;
+    _streamingFrame = Director::getInstance()->getTotalFrames();
+    _streamingBuffersCreated = true;
+
+    CHECK_GL_ERROR_DEBUG();
+}
+
+void Renderer::deleteStreamingBuffers()
+{
+    if (!_streamingBuffersCreated)
+        return;
+
+    for (auto& buffer : _streamingBuffers)
+    {
+#if CC_RENDERER_MAP_BUFFER_RANGE
+        if (buffer.fence)
+            glDeleteSync((GLsync)buffer.fence);
+#endif
+        buffer.fence = nullptr;
+        glDeleteBuffers(2, buffer.vbo);
+        glDeleteVertexArrays(1, &buffer.vao);
+    }
+    GL::bindVAO(0);
+
+    _streamingBuffersCreated = false;
+}
+
+void Renderer::setVertexStreamingMode(VertexStreamingMode mode)
+{
+    CCASSERT(!_isRendering, "Cannot change the vertex streaming mode while rendering");
+
+    if (_streamingMode == mode)
+        return;
+
+    _streamingMode = mode;
+
+    // buffers are created once the GL context exists, see setupBuffer()
+    if (_glViewAssigned)
+    {
+        if (_streamingMode == VertexStreamingMode::RING_BUFFER)
+            setupStreamingBuffers();
+        else
+            deleteStreamingBuffers();
+    }
+}
+
 void Renderer::addCommand(RenderCommand* command)
 {
-    int renderQueue =_commandGroupStack.top();
+    int renderQueue = s_commandRecorder ? s_commandRecorder->groupStack.back() : _commandGroupStack.top();
     addCommand(command, renderQueue);
 }
 
@@ -350,19 +559,34 @@ void Renderer::addCommand(RenderCommand* command, int renderQueue)
     CCASSERT(renderQueue >=0, "Invalid render queue");
     CCASSERT(command->getType() != RenderCommand::Type::UNKNOWN_COMMAND, "Invalid Command Type");
 
+    if (s_commandRecorder)
+    {
+        auto& queues = s_commandRecorder->queues;
+        if (renderQueue >= (int)queues.size())
+            queues.resize(renderQueue + 1);
+        queues[renderQueue].push_back(command);
+        return;
+    }
+
     _renderGroups[renderQueue].push_back(command);
 }
 
 void Renderer::pushGroup(int renderQueueID)
 {
     CCASSERT(!_isRendering, "Cannot change render queue while rendering");
-    _commandGroupStack.push(renderQueueID);
+    if (s_commandRecorder)
+        s_commandRecorder->groupStack.push_back(renderQueueID);
+    else
+        _commandGroupStack.push(renderQueueID);
 }
 
 void Renderer::popGroup()
 {
     CCASSERT(!_isRendering, "Cannot change render queue while rendering");
-    _commandGroupStack.pop();
+    if (s_commandRecorder)
+        s_commandRecorder->groupStack.pop_back();
+    else
+        _commandGroupStack.pop();
 }
 
 int Renderer::createRenderQueue()
@@ -372,6 +596,44 @@ int Renderer::createRenderQueue()
     return (int)_renderGroups.size() - 1;
 }
 
+void Renderer::beginRecordingCommands(CommandRecorder* recorder)
+{
+    CCASSERT(!s_commandRecorder, "Already recording commands");
+    recorder->clear();
+    recorder->groupStack.push_back(_commandGroupStack.top());
+    s_commandRecorder = recorder;
+}
+
+void Renderer::endRecordingCommands()
+{
+    CCASSERT(s_commandRecorder && s_commandRecorder->groupStack.size() == 1, "Unbalanced pushGroup() / popGroup() while recording");
+    s_commandRecorder = nullptr;
+}
+
+void Renderer::mergeRecordedCommands(CommandRecorder* recorder)
+{
+    for (size_t i = 0, size = recorder->queues.size(); i < size; ++i)
+    {
+        if (recorder->queues[i].size() > 0)
+        {
+            _renderGroups[i].append(recorder->queues[i]);
+        }
+    }
+    recorder->clear();
+}
+
+bool Renderer::isRecordingCommands()
+{
+    return s_commandRecorder != nullptr;
+}
+
+Renderer::CommandRecorder* Renderer::getCommandRecorders(int count)
+{
+    if ((int)_commandRecorders.size() < count)
+        _commandRecorders.resize(count);
+    return _commandRecorders.data();
+}
+
 void Renderer::processRenderCommand(RenderCommand* command)
 {
     auto commandType = command->getType();
@@ -698,26 +960,126 @@ void Renderer::setDepthTest(bool enable)
     CHECK_GL_ERROR_DEBUG();
 }
 
-void Renderer::fillVerticesAndIndices(const TrianglesCommand* cmd)
+void Renderer::fillVerticesAndIndices(const TrianglesCommand* cmd, V3F_C4B_T2F* verts, GLushort* indices, unsigned int vertexBufferOffset)
 {
-    memcpy(&_verts[_filledVertex], cmd->getVertices(), sizeof(V3F_C4B_T2F) * cmd->getVertexCount());
-
     // fill vertex, and convert them to world coordinates
-    const Mat4& modelView = cmd->getModelView();
-    for(ssize_t i=0; i < cmd->getVertexCount(); ++i)
+    MathUtil::transformVertices(cmd->getModelView().m, cmd->getVertices(), &verts[_filledVertex], cmd->getVertexCount());
+
+    // fill index
+    MathUtil::transformIndices(cmd->getIndices(), &indices[_filledIndex], cmd->getIndexCount(), vertexBufferOffset + _filledVertex);
+
+    _filledVertex += cmd->getVertexCount();
+    _filledIndex += cmd->getIndexCount();
+}
+
+void Renderer::nextStreamingBuffer()
+{
+#if CC_RENDERER_MAP_BUFFER_RANGE
+    // fence the draws reading the buffer being left, so it is not written again before they complete
+    if (Configuration::getInstance()->supportsMapBufferRange())
     {
-        modelView.transformPoint(&(_verts[i + _filledVertex].vertices));
+        auto& current = _streamingBuffers[_streamingBufferIndex];
+        if (current.fence)
+            glDeleteSync((GLsync)current.fence);
+        current.fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
     }
+#endif
 
-    // fill index
-    const unsigned short* indices = cmd->getIndices();
-    for(ssize_t i=0; i< cmd->getIndexCount(); ++i)
+    _streamingBufferIndex = (_streamingBufferIndex + 1) % STREAMING_BUFFER_COUNT;
+    auto& next = _streamingBuffers[_streamingBufferIndex];
+
+#if CC_RENDERER_MAP_BUFFER_RANGE
+    // the buffer is mapped unsynchronized, so the GPU must be done with the frame that used it.
+    // STREAMING_BUFFER_COUNT frames later it usually is, and this doesn't block.
+    if (next.fence)
     {
-        _indices[_filledIndex + i] = _filledVertex + indices[i];
+        GLenum result;
+        do
+        {
+            result = glClientWaitSync((GLsync)next.fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000);
+        } while (result == GL_TIMEOUT_EXPIRED);
+
+        glDeleteSync((GLsync)next.fence);
+        next.fence = nullptr;
     }
+#endif
 
-    _filledVertex += cmd->getVertexCount();
-    _filledIndex += cmd->getIndexCount();
+    next.filledVertex = 0;
+    next.filledIndex = 0;
+}
+
+bool Renderer::beginStreaming(ssize_t vertexCount, ssize_t indexCount)
+{
+    if (_streamingMode != VertexStreamingMode::RING_BUFFER || !_streamingBuffersCreated)
+        return false;
+
+    // every frame starts in a new buffer, and so does a flush that doesn't fit in the current one
+    auto frame = Director::getInstance()->getTotalFrames();
+    auto buffer = &_streamingBuffers[_streamingBufferIndex];
+    if (frame != _streamingFrame
+        || buffer->filledVertex + vertexCount > VBO_SIZE
+        || buffer->filledIndex + indexCount > INDEX_VBO_SIZE)
+    {
+        nextStreamingBuffer();
+        _streamingFrame = frame;
+        buffer = &_streamingBuffers[_streamingBufferIndex];
+    }
+
+    GL::bindVAO(buffer->vao);
+    glBindBuffer(GL_ARRAY_BUFFER, buffer->vbo[0]);
+
+    _streamingVerts = _verts;
+    _streamingIndices = _indices;
+    _streamingMapped = false;
+
+#if CC_RENDERER_MAP_BUFFER_RANGE
+    if (Configuration::getInstance()->supportsMapBufferRange())
+    {
+        // nothing reads these ranges yet: write the vertices straight into the buffers
+        const GLbitfield access = GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_RANGE_BIT | GL_MAP_UNSYNCHRONIZED_BIT;
+        auto verts = glMapBufferRange(GL_ARRAY_BUFFER, sizeof(_verts[0]) * buffer->filledVertex, sizeof(_verts[0]) * vertexCount, access);
+        auto indices = glMapBufferRange(GL_ELEMENT_ARRAY_BUFFER, sizeof(_indices[0]) * buffer->filledIndex, sizeof(_indices[0]) * indexCount, access);
+        if (verts && indices)
+        {
+            _streamingVerts = (V3F_C4B_T2F*)verts;
+            _streamingIndices = (GLushort*)indices;
+            _streamingMapped = true;
+        }
+        else
+        {
+            if (verts)
+                glUnmapBuffer(GL_ARRAY_BUFFER);
+            if (indices)
+                glUnmapBuffer(GL_ELEMENT_ARRAY_BUFFER);
+        }
+    }
+#endif
+
+    return true;
+}
+
+void Renderer::endStreaming()
+{
+    auto& buffer = _streamingBuffers[_streamingBufferIndex];
+
+    if (_streamingMapped)
+    {
+        glUnmapBuffer(GL_ARRAY_BUFFER);
+        glUnmapBuffer(GL_ELEMENT_ARRAY_BUFFER);
+    }
+    else
+    {
+        glBufferSubData(GL_ARRAY_BUFFER, sizeof(_verts[0]) * buffer.filledVertex, sizeof(_verts[0]) * _filledVertex, _verts);
+        glBufferSubData(GL_ELEMENT_ARRAY_BUFFER, sizeof(_indices[0]) * buffer.filledIndex, sizeof(_indices[0]) * _filledIndex, _indices);
+    }
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+    buffer.filledVertex += _filledVertex;
+    buffer.filledIndex += _filledIndex;
+
+    _streamingVerts = nullptr;
+    _streamingIndices = nullptr;
+    _streamingMapped = false;
 }
 
 void Renderer::drawBatchedTriangles()
@@ -727,12 +1089,21 @@ void Renderer::drawBatchedTriangles()
 
     CCGL_DEBUG_INSERT_EVENT_MARKER("RENDERER_BATCH_TRIANGLES");
 
+    // with ring buffered streaming, the batch is appended after what the current buffer already holds.
+    // _filledVertex and _filledIndex count the queued vertices and indices, see processRenderCommand()
+    const bool streaming = beginStreaming(_filledVertex, _filledIndex);
+
     _filledVertex = 0;
     _filledIndex = 0;
 
     /************** 1: Setup up vertices/indices *************/
 
-    _triBatchesToDraw[0].offset = 0;
+    V3F_C4B_T2F* verts = streaming ? _streamingVerts : _verts;
+    GLushort* indices = streaming ? _streamingIndices : _indices;
+    const unsigned int vertexBufferOffset = streaming ? _streamingBuffers[_streamingBufferIndex].filledVertex : 0;
+    const GLsizei indexBufferOffset = streaming ? _streamingBuffers[_streamingBufferIndex].filledIndex : 0;
+
+    _triBatchesToDraw[0].offset = indexBufferOffset;
     _triBatchesToDraw[0].indicesToDraw = 0;
     _triBatchesToDraw[0].cmd = nullptr;
 
@@ -745,7 +1116,7 @@ void Renderer::drawBatchedTriangles()
         auto currentMaterialID = cmd->getMaterialID();
         const bool batchable = !cmd->isSkipBatching();
 
-        fillVerticesAndIndices(cmd);
+        fillVerticesAndIndices(cmd, verts, indices, vertexBufferOffset);
 
         // in the same batch ?
         if (batchable && (prevMaterialID == currentMaterialID || firstCommand))
@@ -783,7 +1154,12 @@ void Renderer::drawBatchedTriangles()
 
     /************** 2: Copy vertices/indices to GL objects *************/
     auto conf = Configuration::getInstance();
-    if (conf->supportsShareableVAO() && conf->supportsMapBuffer())
+    if (streaming)
+    {
+        // VAO of the ring buffer is bound by beginStreaming()
+        endStreaming();
+    }
+    else if (conf->supportsShareableVAO() && conf->supportsMapBuffer())
     {
         //Bind VAO
         GL::bindVAO(_buffersVAO);
@@ -843,8 +1219,10 @@ void Renderer::drawBatchedTriangles()
         _drawnVertices += _triBatchesToDraw[i].indicesToDraw;
     }
 
+    _uploadedBytes += sizeof(_verts[0]) * _filledVertex + sizeof(_indices[0]) * _filledIndex;
+
     /************** 4: Cleanup *************/
-    if (Configuration::getInstance()->supportsShareableVAO() && conf->supportsMapBuffer())
+    if (streaming || (conf->supportsShareableVAO() && conf->supportsMapBuffer()))
     {
         //Unbind VAO
         GL::bindVAO(0);
@@ -94,7 +94,10 @@ public:
     void push_back(RenderCommand* command);
     /**Return the number of render commands.*/
     ssize_t size() const;
-    /**Sort the render commands.*/
+    /**Sort the render commands.
+     The globalZ and transparent 3D queues are sorted with a stable radix sort on their float keys,
+     small queues fall back to std::stable_sort.
+     */
     void sort();
     /**Treat sorted commands as an array, access them one by one.*/
     RenderCommand* operator[](ssize_t index) const;
@@ -102,6 +105,8 @@ public:
     void clear();
     /**Realloc command queues and reserve with given size. Note: this clears any existing commands.*/
     void realloc(size_t reserveSize);
+    /**Append the commands of another render queue after the ones of this queue, keeping their order.*/
+    void append(const RenderQueue& queue);
     /**Get a sub group of the render queue.*/
     std::vector<RenderCommand*>& getSubQueue(QUEUE_GROUP group) { return _commands[group]; }
     /**Get the number of render commands contained in a subqueue.*/
@@ -113,8 +118,21 @@ public:
     void restoreRenderState();
     
 protected:
+    /**A command and its sort key, see radixSort().*/
+    struct SortElement
+    {
+        uint32_t key;
+        RenderCommand* command;
+    };
+
+    /**Stable LSD radix sort of the commands, by globalOrder ascending or by depth descending.*/
+    void radixSort(std::vector<RenderCommand*>& commands, bool byDepth);
+
     /**The commands in the render queue.*/
     std::vector<RenderCommand*> _commands[QUEUE_COUNT];
+    /**Scratch buffers of radixSort(), kept to avoid reallocating them every frame.*/
+    std::vector<SortElement> _sortBuffer;
+    std::vector<SortElement> _sortScratch;
     
     /**Cull state.*/
     bool _isCullEnabled;
@@ -148,6 +166,37 @@ public:
     static const int BATCH_TRIAGCOMMAND_RESERVED_SIZE = 64;
     /**Reserved for material id, which means that the command could not be batched.*/
     static const int MATERIAL_ID_DO_NOT_BATCH = 0;
+    /**The number of vertex/index buffers used by the ring buffered vertex streaming.*/
+    static const int STREAMING_BUFFER_COUNT = 3;
+
+    /** How the batched triangles are uploaded to the GPU.
+     @since v3.16
+     */
+    enum class VertexStreamingMode
+    {
+        /** The vertex buffer is orphaned and the vertices/indices are copied into it on every flush. */
+        ORPHAN,
+        /** Each frame appends into the next buffer of a ring of STREAMING_BUFFER_COUNT vertex/index buffers.
+         When unsynchronized glMapBufferRange() and fences are supported, the vertices are written directly
+         into the mapped buffers. Requires shareable VAOs, otherwise ORPHAN is used.
+         */
+        RING_BUFFER,
+    };
+
+
+    /** The commands added, and the groups pushed, by a thread visiting part of the scene graph concurrently.
+     See Node::setParallelVisitEnabled(). This will not be used outside.
+     */
+    struct CommandRecorder
+    {
+        /**Empty the recorded queues, keeping their memory.*/
+        void clear();
+
+        std::vector<int> groupStack;
+        /**Recorded commands, indexed by render queue ID.*/
+        std::vector<RenderQueue> queues;
+    };
+
     /**Constructor.*/
     Renderer();
     /**Destructor.*/
@@ -171,6 +220,28 @@ public:
     /** Creates a render queue and returns its Id */
     int createRenderQueue();
 
+    /** Until endRecordingCommands(), the commands and groups the calling thread adds go to recorder
+     instead of the render queues. The recording starts in the current group.
+     @since v3.16
+     */
+    void beginRecordingCommands(CommandRecorder* recorder);
+    /** Stops recording the commands of the calling thread.
+     @since v3.16
+     */
+    void endRecordingCommands();
+    /** Adds the commands recorded by recorder to the render queues, in order, and clears it.
+     @since v3.16
+     */
+    void mergeRecordedCommands(CommandRecorder* recorder);
+    /** Whether the calling thread is recording its commands.
+     @since v3.16
+     */
+    static bool isRecordingCommands();
+    /** Returns count recorders, reused from one parallel visit to the next. Not thread safe.
+     @since v3.16
+     */
+    CommandRecorder* getCommandRecorders(int count);
+
     /** Renders into the GLView all the queued `RenderCommand` objects */
     void render();
 
@@ -190,8 +261,20 @@ public:
     ssize_t getDrawnVertices() const { return _drawnVertices; }
     /* RenderCommands (except) TrianglesCommand should update this value */
     void addDrawnVertices(ssize_t number) { _drawnVertices += number; };
+    /* returns the number of vertex and index bytes uploaded by the batched triangles in the last frame */
+    ssize_t getUploadedBytes() const { return _uploadedBytes; }
     /* clear draw stats */
-    void clearDrawStats() { _drawnBatches = _drawnVertices = 0; }
+    void clearDrawStats() { _drawnBatches = _drawnVertices = _uploadedBytes = 0; }
+
+    /** Sets how the batched triangles are uploaded to the GPU. Default is VertexStreamingMode::ORPHAN.
+     Must not be called while rendering.
+     @since v3.16
+     */
+    void setVertexStreamingMode(VertexStreamingMode mode);
+    /** Returns how the batched triangles are uploaded to the GPU.
+     @since v3.16
+     */
+    VertexStreamingMode getVertexStreamingMode() const { return _streamingMode; }
 
     /**
      * Enable/Disable depth test
@@ -213,8 +296,15 @@ protected:
     void setupVBOAndVAO();
     void setupVBO();
     void mapBuffers();
+    void setupStreamingBuffers();
+    void deleteStreamingBuffers();
     void drawBatchedTriangles();
 
+    //Ring buffered streaming of the batched triangles
+    bool beginStreaming(ssize_t vertexCount, ssize_t indexCount);
+    void endStreaming();
+    void nextStreamingBuffer();
+
     //Draw the previews queued triangles and flush previous context
     void flush();
     
@@ -227,7 +317,7 @@ protected:
     void processRenderCommand(RenderCommand* command);
     void visitRenderQueue(RenderQueue& queue);
 
-    void fillVerticesAndIndices(const TrianglesCommand* cmd);
+    void fillVerticesAndIndices(const TrianglesCommand* cmd, V3F_C4B_T2F* verts, GLushort* indices, unsigned int vertexBufferOffset);
 
 
     /* clear color set outside be used in setGLDefaultValues() */
@@ -237,6 +327,8 @@ protected:
     
     std::vector<RenderQueue> _renderGroups;
 
+    std::vector<CommandRecorder> _commandRecorders;
+
     MeshCommand* _lastBatchedMeshCommand;
     std::vector<TrianglesCommand*> _queuedTriangleCommands;
 
@@ -260,11 +352,30 @@ protected:
     int _filledVertex;
     int _filledIndex;
 
+    // One buffer of the ring used by VertexStreamingMode::RING_BUFFER
+    struct StreamingBuffer {
+        GLuint vao;
+        GLuint vbo[2]; //0: vertex  1: indices
+        int filledVertex;
+        int filledIndex;
+        void* fence;    // GLsync of the last frame drawn from this buffer, when supported
+    };
+    VertexStreamingMode _streamingMode;
+    StreamingBuffer _streamingBuffers[STREAMING_BUFFER_COUNT];
+    int _streamingBufferIndex;
+    unsigned int _streamingFrame;
+    bool _streamingBuffersCreated;
+    // where the current flush writes: the mapped buffers, or _verts/_indices
+    V3F_C4B_T2F* _streamingVerts;
+    GLushort* _streamingIndices;
+    bool _streamingMapped;
+
     bool _glViewAssigned;
 
     // stats
     ssize_t _drawnBatches;
     ssize_t _drawnVertices;
+    ssize_t _uploadedBytes;
     //the flag for checking whether renderer is rendering
     bool _isRendering;
     
@@ -33,6 +33,12 @@ THE SOFTWARE.
 
 #include "renderer/CCTexture2D.h"
 
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#elif defined(__ARM_NEON__) || defined(__aarch64__) || defined(__arm64__)
+#include <arm_neon.h>
+#endif
+
 #include "platform/CCGL.h"
 #include "platform/CCImage.h"
 #include "base/ccUtils.h"
@@ -52,6 +58,10 @@ THE SOFTWARE.
     #include "renderer/CCTextureCache.h"
 #endif
 
+#if (CC_TARGET_PLATFORM == CC_PLATFORM_ANDROID) && defined(__arm__)
+#include <cpu-features.h>
+#endif
+
 NS_CC_BEGIN
 
 
@@ -120,13 +130,368 @@ const Texture2D::PixelFormatInfoMap Texture2D::_pixelFormatInfoTables(TexturePix
 // Default is: RGBA8888 (32-bit textures)
 static Texture2D::PixelFormat g_defaultAlphaPixelFormat = Texture2D::PixelFormat::DEFAULT;
 
+bool Texture2D::s_simdConversionEnabled = true;
+
+//////////////////////////////////////////////////////////////////////////
+// SIMD convertor kernels
+//
+// They convert blocks of 16 pixels and the scalar convertors finish the remaining pixels.
+// Whatever the formats, a block is held as 4 vectors of 4 RGBA8888 pixels, one pixel in each 32 bits lane,
+// and the results are the ones of the scalar convertors bit for bit.
+
+#if defined(__SSE2__)
+#define CC_PIXEL_CONVERT_SIMD 1
+
+typedef __m128i pixel4;
+
+static inline pixel4 and4(pixel4 v, unsigned int mask) { return _mm_and_si128(v, _mm_set1_epi32((int)mask)); }
+static inline pixel4 or4(pixel4 a, pixel4 b) { return _mm_or_si128(a, b); }
+template <int N> static inline pixel4 shl4(pixel4 v) { return _mm_slli_epi32(v, N); }
+template <int N> static inline pixel4 shr4(pixel4 v) { return _mm_srli_epi32(v, N); }
+
+struct PixelBlock
+{
+    pixel4 p[4];
+};
+
+// lanes IAIA -> IIIA
+static inline pixel4 expandAI88(pixel4 v)
+{
+    return or4(and4(v, 0xFFFF00FF), and4(shl4<8>(v), 0x0000FF00));
+}
+
+// 12 low bytes RGBRGBRGBRGB -> RGBA lanes, with an alpha of 0
+static inline pixel4 expandRGB888(__m128i v)
+{
+    const __m128i m0 = _mm_setr_epi32(0x00FFFFFF, 0, 0, 0);
+    const __m128i m1 = _mm_setr_epi32(0, 0x00FFFFFF, 0, 0);
+    const __m128i m2 = _mm_setr_epi32(0, 0, 0x00FFFFFF, 0);
+    const __m128i m3 = _mm_setr_epi32(0, 0, 0, 0x00FFFFFF);
+    return _mm_or_si128(_mm_or_si128(_mm_and_si128(v, m0), _mm_and_si128(_mm_slli_si128(v, 1), m1)),
+                        _mm_or_si128(_mm_and_si128(_mm_slli_si128(v, 2), m2), _mm_and_si128(_mm_slli_si128(v, 3), m3)));
+}
+
+// RGBA lanes -> 12 low bytes RGBRGBRGBRGB, the 4 high bytes are 0
+static inline __m128i compressRGB888(pixel4 v)
+{
+    const __m128i m0 = _mm_setr_epi32(0x00FFFFFF, 0, 0, 0);
+    const __m128i m1 = _mm_setr_epi32(0, 0x00FFFFFF, 0, 0);
+    const __m128i m2 = _mm_setr_epi32(0, 0, 0x00FFFFFF, 0);
+    const __m128i m3 = _mm_setr_epi32(0, 0, 0, 0x00FFFFFF);
+    return _mm_or_si128(_mm_or_si128(_mm_and_si128(v, m0), _mm_srli_si128(_mm_and_si128(v, m1), 1)),
+                        _mm_or_si128(_mm_srli_si128(_mm_and_si128(v, m2), 2), _mm_srli_si128(_mm_and_si128(v, m3), 3)));
+}
+
+static inline void loadI8(const unsigned char* data, PixelBlock& block)
+{
+    const __m128i alpha = _mm_set1_epi32((int)0xFF000000);
+    const __m128i v = _mm_loadu_si128((const __m128i*)data);
+    const __m128i lo = _mm_unpacklo_epi8(v, v);
+    const __m128i hi = _mm_unpackhi_epi8(v, v);
+    block.p[0] = _mm_or_si128(_mm_unpacklo_epi16(lo, lo), alpha);
+    block.p[1] = _mm_or_si128(_mm_unpackhi_epi16(lo, lo), alpha);
+    block.p[2] = _mm_or_si128(_mm_unpacklo_epi16(hi, hi), alpha);
+    block.p[3] = _mm_or_si128(_mm_unpackhi_epi16(hi, hi), alpha);
+}
+
+static inline void loadAI88(const unsigned char* data, PixelBlock& block)
+{
+    const __m128i v0 = _mm_loadu_si128((const __m128i*)data);
+    const __m128i v1 = _mm_loadu_si128((const __m128i*)(data + 16));
+    block.p[0] = expandAI88(_mm_unpacklo_epi16(v0, v0));
+    block.p[1] = expandAI88(_mm_unpackhi_epi16(v0, v0));
+    block.p[2] = expandAI88(_mm_unpacklo_epi16(v1, v1));
+    block.p[3] = expandAI88(_mm_unpackhi_epi16(v1, v1));
+}
+
+static inline void loadRGB888(const unsigned char* data, PixelBlock& block)
+{
+    const __m128i alpha = _mm_set1_epi32((int)0xFF000000);
+    const __m128i v0 = _mm_loadu_si128((const __m128i*)data);
+    const __m128i v1 = _mm_loadu_si128((const __m128i*)(data + 16));
+    const __m128i v2 = _mm_loadu_si128((const __m128i*)(data + 32));
+    block.p[0] = _mm_or_si128(expandRGB888(v0), alpha);
+    block.p[1] = _mm_or_si128(expandRGB888(_mm_or_si128(_mm_srli_si128(v0, 12), _mm_slli_si128(v1, 4))), alpha);
+    block.p[2] = _mm_or_si128(expandRGB888(_mm_or_si128(_mm_srli_si128(v1, 8), _mm_slli_si128(v2, 8))), alpha);
+    block.p[3] = _mm_or_si128(expandRGB888(_mm_srli_si128(v2, 4)), alpha);
+}
+
+static inline void loadRGBA8888(const unsigned char* data, PixelBlock& block)
+{
+    for (int i = 0; i < 4; ++i)
+        block.p[i] = _mm_loadu_si128((const __m128i*)(data + i * 16));
+}
+
+static inline void storeRGB888(const PixelBlock& block, unsigned char* outData)
+{
+    const __m128i v0 = compressRGB888(block.p[0]);
+    const __m128i v1 = compressRGB888(block.p[1]);
+    const __m128i v2 = compressRGB888(block.p[2]);
+    const __m128i v3 = compressRGB888(block.p[3]);
+    _mm_storeu_si128((__m128i*)outData, _mm_or_si128(v0, _mm_slli_si128(v1, 12)));
+    _mm_storeu_si128((__m128i*)(outData + 16), _mm_or_si128(_mm_srli_si128(v1, 4), _mm_slli_si128(v2, 8)));
+    _mm_storeu_si128((__m128i*)(outData + 32), _mm_or_si128(_mm_srli_si128(v2, 8), _mm_slli_si128(v3, 4)));
+}
+
+static inline void storeRGBA8888(const PixelBlock& block, unsigned char* outData)
+{
+    for (int i = 0; i < 4; ++i)
+        _mm_storeu_si128((__m128i*)(outData + i * 16), block.p[i]);
+}
+
+// lanes of at most 0xFF -> 16 bytes
+static inline void storeBytes(const pixel4 v[4], unsigned char* outData)
+{
+    _mm_storeu_si128((__m128i*)outData, _mm_packus_epi16(_mm_packs_epi32(v[0], v[1]), _mm_packs_epi32(v[2], v[3])));
+}
+
+// lanes of at most 0xFFFF -> 16 shorts, sign extended first since the pack saturates signed values
+static inline void storeShorts(const pixel4 v[4], unsigned char* outData)
+{
+    __m128i s[4];
+    for (int i = 0; i < 4; ++i)
+        s[i] = _mm_srai_epi32(_mm_slli_epi32(v[i], 16), 16);
+    _mm_storeu_si128((__m128i*)outData, _mm_packs_epi32(s[0], s[1]));
+    _mm_storeu_si128((__m128i*)(outData + 16), _mm_packs_epi32(s[2], s[3]));
+}
+
+// (R*299 + G*587 + B*114 + 500) / 1000, the alpha is replaced by 1 to add the 500 in the multiply-add.
+// x / 1000 == (x / 8) / 125 == ((x >> 3) * 33555) >> 22 for the x up to 255500
+static inline pixel4 intensity4(pixel4 v)
+{
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i weights = _mm_setr_epi16(299, 587, 114, 500, 299, 587, 114, 500);
+    v = _mm_or_si128(and4(v, 0x00FFFFFF), _mm_set1_epi32(0x01000000));
+    const __m128 lo = _mm_castsi128_ps(_mm_madd_epi16(_mm_unpacklo_epi8(v, zero), weights));
+    const __m128 hi = _mm_castsi128_ps(_mm_madd_epi16(_mm_unpackhi_epi8(v, zero), weights));
+    const __m128i x = _mm_add_epi32(_mm_castps_si128(_mm_shuffle_ps(lo, hi, _MM_SHUFFLE(2, 0, 2, 0))),
+                                    _mm_castps_si128(_mm_shuffle_ps(lo, hi, _MM_SHUFFLE(3, 1, 3, 1))));
+    return _mm_srli_epi32(_mm_mulhi_epu16(_mm_srli_epi32(x, 3), _mm_set1_epi32(33555)), 6);
+}
+
+#elif defined(__ARM_NEON__) || defined(__aarch64__) || defined(__arm64__)
+#define CC_PIXEL_CONVERT_SIMD 1
+
+typedef uint32x4_t pixel4;
+
+static inline pixel4 and4(pixel4 v, unsigned int mask) { return vandq_u32(v, vdupq_n_u32(mask)); }
+static inline pixel4 or4(pixel4 a, pixel4 b) { return vorrq_u32(a, b); }
+template <int N> static inline pixel4 shl4(pixel4 v) { return vshlq_n_u32(v, N); }
+template <int N> static inline pixel4 shr4(pixel4 v) { return vshrq_n_u32(v, N); }
+
+struct PixelBlock
+{
+    pixel4 p[4];
+};
+
+// lanes IAIA -> IIIA
+static inline pixel4 expandAI88(uint16x8_t v)
+{
+    const pixel4 p = vreinterpretq_u32_u16(v);
+    return or4(and4(p, 0xFFFF00FF), and4(shl4<8>(p), 0x0000FF00));
+}
+
+// 16 R, G, B and A -> RGBA lanes
+static inline void interleave(uint8x16_t r, uint8x16_t g, uint8x16_t b, uint8x16_t a, PixelBlock& block)
+{
+    const uint8x16x2_t rg = vzipq_u8(r, g);
+    const uint8x16x2_t ba = vzipq_u8(b, a);
+    const uint16x8x2_t lo = vzipq_u16(vreinterpretq_u16_u8(rg.val[0]), vreinterpretq_u16_u8(ba.val[0]));
+    const uint16x8x2_t hi = vzipq_u16(vreinterpretq_u16_u8(rg.val[1]), vreinterpretq_u16_u8(ba.val[1]));
+    block.p[0] = vreinterpretq_u32_u16(lo.val[0]);
+    block.p[1] = vreinterpretq_u32_u16(lo.val[1]);
+    block.p[2] = vreinterpretq_u32_u16(hi.val[0]);
+    block.p[3] = vreinterpretq_u32_u16(hi.val[1]);
+}
+
+static inline void loadI8(const unsigned char* data, PixelBlock& block)
+{
+    const uint8x16_t v = vld1q_u8(data);
+    interleave(v, v, v, vdupq_n_u8(0xFF), block);
+}
+
+static inline void loadAI88(const unsigned char* data, PixelBlock& block)
+{
+    const uint16x8_t v0 = vreinterpretq_u16_u8(vld1q_u8(data));
+    const uint16x8_t v1 = vreinterpretq_u16_u8(vld1q_u8(data + 16));
+    const uint16x8x2_t z0 = vzipq_u16(v0, v0);
+    const uint16x8x2_t z1 = vzipq_u16(v1, v1);
+    block.p[0] = expandAI88(z0.val[0]);
+    block.p[1] = expandAI88(z0.val[1]);
+    block.p[2] = expandAI88(z1.val[0]);
+    block.p[3] = expandAI88(z1.val[1]);
+}
+
+static inline void loadRGB888(const unsigned char* data, PixelBlock& block)
+{
+    const uint8x16x3_t rgb = vld3q_u8(data);
+    interleave(rgb.val[0], rgb.val[1], rgb.val[2], vdupq_n_u8(0xFF), block);
+}
+
+static inline void loadRGBA8888(const unsigned char* data, PixelBlock& block)
+{
+    for (int i = 0; i < 4; ++i)
+        block.p[i] = vreinterpretq_u32_u8(vld1q_u8(data + i * 16));
+}
+
+static inline void storeRGB888(const PixelBlock& block, unsigned char* outData)
+{
+    // even bytes are R and B, odd bytes G and A, twice to get the channels
+    const uint8x16x2_t p01 = vuzpq_u8(vreinterpretq_u8_u32(block.p[0]), vreinterpretq_u8_u32(block.p[1]));
+    const uint8x16x2_t p23 = vuzpq_u8(vreinterpretq_u8_u32(block.p[2]), vreinterpretq_u8_u32(block.p[3]));
+    const uint8x16x2_t rb = vuzpq_u8(p01.val[0], p23.val[0]);
+    const uint8x16x2_t ga = vuzpq_u8(p01.val[1], p23.val[1]);
+    uint8x16x3_t rgb;
+    rgb.val[0] = rb.val[0];
+    rgb.val[1] = ga.val[0];
+    rgb.val[2] = rb.val[1];
+    vst3q_u8(outData, rgb);
+}
+
+static inline void storeRGBA8888(const PixelBlock& block, unsigned char* outData)
+{
+    for (int i = 0; i < 4; ++i)
+        vst1q_u8(outData + i * 16, vreinterpretq_u8_u32(block.p[i]));
+}
+
+// lanes of at most 0xFF -> 16 bytes
+static inline void storeBytes(const pixel4 v[4], unsigned char* outData)
+{
+    const uint16x8_t lo = vcombine_u16(vmovn_u32(v[0]), vmovn_u32(v[1]));
+    const uint16x8_t hi = vcombine_u16(vmovn_u32(v[2]), vmovn_u32(v[3]));
+    vst1q_u8(outData, vcombine_u8(vmovn_u16(lo), vmovn_u16(hi)));
+}
+
+// lanes of at most 0xFFFF -> 16 shorts
+static inline void storeShorts(const pixel4 v[4], unsigned char* outData)
+{
+    vst1q_u8(outData, vreinterpretq_u8_u16(vcombine_u16(vmovn_u32(v[0]), vmovn_u32(v[1]))));
+    vst1q_u8(outData + 16, vreinterpretq_u8_u16(vcombine_u16(vmovn_u32(v[2]), vmovn_u32(v[3]))));
+}
+
+// (R*299 + G*587 + B*114 + 500) / 1000
+// x / 1000 == (x / 8) / 125 == ((x >> 3) * 33555) >> 22 for the x up to 255500
+static inline pixel4 intensity4(pixel4 v)
+{
+    pixel4 x = vmlaq_n_u32(vdupq_n_u32(500), and4(v, 0xFF), 299);
+    x = vmlaq_n_u32(x, and4(shr4<8>(v), 0xFF), 587);
+    x = vmlaq_n_u32(x, and4(shr4<16>(v), 0xFF), 114);
+    return shr4<22>(vmulq_n_u32(shr4<3>(x), 33555));
+}
+
+#else
+#define CC_PIXEL_CONVERT_SIMD 0
+#endif
+
+#if CC_PIXEL_CONVERT_SIMD
+
+static inline pixel4 encodeRGB565(pixel4 v)
+{
+    return or4(or4(shl4<8>(and4(v, 0xF8)), shr4<5>(and4(v, 0xFC00))), shr4<19>(and4(v, 0xF80000)));
+}
+
+static inline pixel4 encodeRGBA4444(pixel4 v)
+{
+    return or4(or4(shl4<8>(and4(v, 0xF0)), shr4<4>(and4(v, 0xF000))), or4(shr4<16>(and4(v, 0xF00000)), shr4<28>(v)));
+}
+
+static inline pixel4 encodeRGB5A1(pixel4 v)
+{
+    return or4(or4(shl4<8>(and4(v, 0xF8)), shr4<5>(and4(v, 0xF800))), or4(shr4<18>(and4(v, 0xF80000)), shr4<31>(v)));
+}
+
+static inline pixel4 encodeAI88(pixel4 v)
+{
+    return or4(intensity4(v), and4(shr4<16>(v), 0xFF00));
+}
+
+// the sources with an intensity already have R == G == B
+static inline pixel4 encodeGrayI8(pixel4 v)
+{
+    return and4(v, 0xFF);
+}
+
+static inline pixel4 encodeGrayAI88(pixel4 v)
+{
+    return or4(and4(v, 0xFF), and4(shr4<16>(v), 0xFF00));
+}
+
+static inline pixel4 encodeA8(pixel4 v)
+{
+    return shr4<24>(v);
+}
+
+template <pixel4 (*Encode)(pixel4)>
+static inline void storeEncodedBytes(const PixelBlock& block, unsigned char* outData)
+{
+    const pixel4 v[4] = { Encode(block.p[0]), Encode(block.p[1]), Encode(block.p[2]), Encode(block.p[3]) };
+    storeBytes(v, outData);
+}
+
+template <pixel4 (*Encode)(pixel4)>
+static inline void storeEncodedShorts(const PixelBlock& block, unsigned char* outData)
+{
+    const pixel4 v[4] = { Encode(block.p[0]), Encode(block.p[1]), Encode(block.p[2]), Encode(block.p[3]) };
+    storeShorts(v, outData);
+}
+
+static inline void storeRGB565(const PixelBlock& block, unsigned char* outData) { storeEncodedShorts<encodeRGB565>(block, outData); }
+static inline void storeRGBA4444(const PixelBlock& block, unsigned char* outData) { storeEncodedShorts<encodeRGBA4444>(block, outData); }
+static inline void storeRGB5A1(const PixelBlock& block, unsigned char* outData) { storeEncodedShorts<encodeRGB5A1>(block, outData); }
+static inline void storeAI88(const PixelBlock& block, unsigned char* outData) { storeEncodedShorts<encodeAI88>(block, outData); }
+static inline void storeGrayAI88(const PixelBlock& block, unsigned char* outData) { storeEncodedShorts<encodeGrayAI88>(block, outData); }
+static inline void storeI8(const PixelBlock& block, unsigned char* outData) { storeEncodedBytes<intensity4>(block, outData); }
+static inline void storeGrayI8(const PixelBlock& block, unsigned char* outData) { storeEncodedBytes<encodeGrayI8>(block, outData); }
+static inline void storeA8(const PixelBlock& block, unsigned char* outData) { storeEncodedBytes<encodeA8>(block, outData); }
+
+// converts the whole blocks of data, returns the number of bytes of data converted and moves outData past the converted pixels
+template <void (*Load)(const unsigned char*, PixelBlock&), void (*Store)(const PixelBlock&, unsigned char*), int SrcBytes, int DstBytes>
+static ssize_t convertPixelBlocks(const unsigned char* data, ssize_t dataLen, unsigned char*& outData)
+{
+    if (!Texture2D::isSimdConversionEnabled())
+        return 0;
+
+    const ssize_t length = dataLen / (16 * SrcBytes) * (16 * SrcBytes);
+    PixelBlock block;
+    for (ssize_t i = 0; i < length; i += 16 * SrcBytes)
+    {
+        Load(data + i, block);
+        Store(block, outData);
+        outData += 16 * DstBytes;
+    }
+    return length;
+}
+
+#define CC_CONVERT_PIXEL_BLOCKS(load, store, srcBytes, dstBytes, data, dataLen, outData) \
+    convertPixelBlocks<load, store, srcBytes, dstBytes>(data, dataLen, outData)
+
+#else
+
+#define CC_CONVERT_PIXEL_BLOCKS(load, store, srcBytes, dstBytes, data, dataLen, outData) ((ssize_t)0)
+
+#endif // CC_PIXEL_CONVERT_SIMD
+
+bool Texture2D::isSimdConversionEnabled()
+{
+#if CC_PIXEL_CONVERT_SIMD && (CC_TARGET_PLATFORM == CC_PLATFORM_ANDROID) && defined(__arm__)
+    // as MathUtil, NEON is optional on ARMv7
+    static const bool hasNeon = android_getCpuFamily() == ANDROID_CPU_FAMILY_ARM && (android_getCpuFeatures() & ANDROID_CPU_ARM_FEATURE_NEON) != 0;
+    return s_simdConversionEnabled && hasNeon;
+#elif CC_PIXEL_CONVERT_SIMD
+    return s_simdConversionEnabled;
+#else
+    return false;
+#endif
+}
+
 //////////////////////////////////////////////////////////////////////////
 //convertor function
 
 // IIIIIIII -> RRRRRRRRGGGGGGGGGBBBBBBBB
 void Texture2D::convertI8ToRGB888(const unsigned char* data, ssize_t dataLen, unsigned char* outData)
 {
-    for (ssize_t i=0; i < dataLen; ++i)
+    ssize_t i = CC_CONVERT_PIXEL_BLOCKS(loadI8, storeRGB888, 1, 3, data, dataLen, outData);
+    for (; i < dataLen; ++i)
     {
         *outData++ = data[i];     //R
         *outData++ = data[i];     //G
@@ -137,7 +502,8 @@ void Texture2D::convertI8ToRGB888(const unsigned char* data, ssize_t dataLen, un
 // IIIIIIIIAAAAAAAA -> RRRRRRRRGGGGGGGGBBBBBBBB
 void Texture2D::convertAI88ToRGB888(const unsigned char* data, ssize_t dataLen, unsigned char* outData)
 {
-    for (ssize_t i = 0, l = dataLen - 1; i < l; i += 2)
+    ssize_t i = CC_CONVERT_PIXEL_BLOCKS(loadAI88, storeRGB888, 2, 3, data, dataLen, outData);
+    for (ssize_t l = dataLen - 1; i < l; i += 2)
     {
         *outData++ = data[i];     //R
         *outData++ = data[i];     //G
@@ -148,7 +514,8 @@ void Texture2D::convertAI88ToRGB888(const unsigned char* data, ssize_t dataLen,
 // IIIIIIII -> RRRRRRRRGGGGGGGGGBBBBBBBBAAAAAAAA
 void Texture2D::convertI8ToRGBA8888(const unsigned char* data, ssize_t dataLen, unsigned char* outData)
 {
-    for (ssize_t i = 0; i < dataLen; ++i)
+    ssize_t i = CC_CONVERT_PIXEL_BLOCKS(loadI8, storeRGBA8888, 1, 4, data, dataLen, outData);
+    for (; i < dataLen; ++i)
     {
         *outData++ = data[i];     //R
         *outData++ = data[i];     //G
@@ -160,7 +527,8 @@ void Texture2D::convertI8ToRGBA8888(const unsigned char* data, ssize_t dataLen,
 // IIIIIIIIAAAAAAAA -> RRRRRRRRGGGGGGGGBBBBBBBBAAAAAAAA
 void Texture2D::convertAI88ToRGBA8888(const unsigned char* data, ssize_t dataLen, unsigned char* outData)
 {
-    for (ssize_t i = 0, l = dataLen - 1; i < l; i += 2)
+    ssize_t i = CC_CONVERT_PIXEL_BLOCKS(loadAI88, storeRGBA8888, 2, 4, data, dataLen, outData);
+    for (ssize_t l = dataLen - 1; i < l; i += 2)
     {
         *outData++ = data[i];     //R
         *outData++ = data[i];     //G
@@ -172,8 +540,9 @@ void Texture2D::convertAI88ToRGBA8888(const unsigned char* data, ssize_t dataLen
 // IIIIIIII -> RRRRRGGGGGGBBBBB
 void Texture2D::convertI8ToRGB565(const unsigned char* data, ssize_t dataLen, unsigned char* outData)
 {
+    ssize_t i = CC_CONVERT_PIXEL_BLOCKS(loadI8, storeRGB565, 1, 2, data, dataLen, outData);
     unsigned short* out16 = (unsigned short*)outData;
-    for (int i = 0; i < dataLen; ++i)
+    for (; i < dataLen; ++i)
     {
         *out16++ = (data[i] & 0x00F8) << 8    //R
             | (data[i] & 0x00FC) << 3         //G
@@ -184,8 +553,9 @@ void Texture2D::convertI8ToRGB565(const unsigned char* data, ssize_t dataLen, un
 // IIIIIIIIAAAAAAAA -> RRRRRGGGGGGBBBBB
 void Texture2D::convertAI88ToRGB565(const unsigned char* data, ssize_t dataLen, unsigned char* outData)
 {
+    ssize_t i = CC_CONVERT_PIXEL_BLOCKS(loadAI88, storeRGB565, 2, 2, data, dataLen, outData);
     unsigned short* out16 = (unsigned short*)outData;
-    for (ssize_t i = 0, l = dataLen - 1; i < l; i += 2)
+    for (ssize_t l = dataLen - 1; i < l; i += 2)
     {
         *out16++ = (data[i] & 0x00F8) << 8    //R
             | (data[i] & 0x00FC) << 3         //G
@@ -196,8 +566,9 @@ void Texture2D::convertAI88ToRGB565(const unsigned char* data, ssize_t dataLen,
 // IIIIIIII -> RRRRGGGGBBBBAAAA
 void Texture2D::convertI8ToRGBA4444(const unsigned char* data, ssize_t dataLen, unsigned char* outData)
 {
+    ssize_t i = CC_CONVERT_PIXEL_BLOCKS(loadI8, storeRGBA4444, 1, 2, data, dataLen, outData);
     unsigned short* out16 = (unsigned short*)outData;
-    for (ssize_t i = 0; i < dataLen; ++i)
+    for (; i < dataLen; ++i)
     {
         *out16++ = (data[i] & 0x00F0) << 8    //R
         | (data[i] & 0x00F0) << 4             //G
@@ -209,8 +580,9 @@ void Texture2D::convertI8ToRGBA4444(const unsigned char* data, ssize_t dataLen,
 // IIIIIIIIAAAAAAAA -> RRRRGGGGBBBBAAAA
 void Texture2D::convertAI88ToRGBA4444(const unsigned char* data, ssize_t dataLen, unsigned char* outData)
 {
+    ssize_t i = CC_CONVERT_PIXEL_BLOCKS(loadAI88, storeRGBA4444, 2, 2, data, dataLen, outData);
     unsigned short* out16 = (unsigned short*)outData;
-    for (ssize_t i = 0, l = dataLen - 1; i < l; i += 2)
+    for (ssize_t l = dataLen - 1; i < l; i += 2)
     {
         *out16++ = (data[i] & 0x00F0) << 8    //R
         | (data[i] & 0x00F0) << 4             //G
@@ -222,8 +594,9 @@ void Texture2D::convertAI88ToRGBA4444(const unsigned char* data, ssize_t dataLen
 // IIIIIIII -> RRRRRGGGGGBBBBBA
 void Texture2D::convertI8ToRGB5A1(const unsigned char* data, ssize_t dataLen, unsigned char* outData)
 {
+    ssize_t i = CC_CONVERT_PIXEL_BLOCKS(loadI8, storeRGB5A1, 1, 2, data, dataLen, outData);
     unsigned short* out16 = (unsigned short*)outData;
-    for (int i = 0; i < dataLen; ++i)
+    for (; i < dataLen; ++i)
     {
         *out16++ = (data[i] & 0x00F8) << 8    //R
             | (data[i] & 0x00F8) << 3         //G
@@ -235,8 +608,9 @@ void Texture2D::convertI8ToRGB5A1(const unsigned char* data, ssize_t dataLen, un
 // IIIIIIIIAAAAAAAA -> RRRRRGGGGGBBBBBA
 void Texture2D::convertAI88ToRGB5A1(const unsigned char* data, ssize_t dataLen, unsigned char* outData)
 {
+    ssize_t i = CC_CONVERT_PIXEL_BLOCKS(loadAI88, storeRGB5A1, 2, 2, data, dataLen, outData);
     unsigned short* out16 = (unsigned short*)outData;
-    for (ssize_t i = 0, l = dataLen - 1; i < l; i += 2)
+    for (ssize_t l = dataLen - 1; i < l; i += 2)
     {
         *out16++ = (data[i] & 0x00F8) << 8    //R
             | (data[i] & 0x00F8) << 3         //G
@@ -248,8 +622,9 @@ void Texture2D::convertAI88ToRGB5A1(const unsigned char* data, ssize_t dataLen,
 // IIIIIIII -> IIIIIIIIAAAAAAAA
 void Texture2D::convertI8ToAI88(const unsigned char* data, ssize_t dataLen, unsigned char* outData)
 {
+    ssize_t i = CC_CONVERT_PIXEL_BLOCKS(loadI8, storeGrayAI88, 1, 2, data, dataLen, outData);
     unsigned short* out16 = (unsigned short*)outData;
-    for (ssize_t i = 0; i < dataLen; ++i)
+    for (; i < dataLen; ++i)
     {
         *out16++ = 0xFF00     //A
         | data[i];            //I
@@ -259,7 +634,8 @@ void Texture2D::convertI8ToAI88(const unsigned char* data, ssize_t dataLen, unsi
 // IIIIIIIIAAAAAAAA -> AAAAAAAA
 void Texture2D::convertAI88ToA8(const unsigned char* data, ssize_t dataLen, unsigned char* outData)
 {
-    for (ssize_t i = 1; i < dataLen; i += 2)
+    ssize_t i = CC_CONVERT_PIXEL_BLOCKS(loadAI88, storeA8, 2, 1, data, dataLen, outData);
+    for (i += 1; i < dataLen; i += 2)
     {
         *outData++ = data[i]; //A
     }
@@ -268,7 +644,8 @@ void Texture2D::convertAI88ToA8(const unsigned char* data, ssize_t dataLen, unsi
 // IIIIIIIIAAAAAAAA -> IIIIIIII
 void Texture2D::convertAI88ToI8(const unsigned char* data, ssize_t dataLen, unsigned char* outData)
 {
-    for (ssize_t i = 0, l = dataLen - 1; i < l; i += 2)
+    ssize_t i = CC_CONVERT_PIXEL_BLOCKS(loadAI88, storeGrayI8, 2, 1, data, dataLen, outData);
+    for (ssize_t l = dataLen - 1; i < l; i += 2)
     {
         *outData++ = data[i]; //R
     }
@@ -277,7 +654,8 @@ void Texture2D::convertAI88ToI8(const unsigned char* data, ssize_t dataLen, unsi
 // RRRRRRRRGGGGGGGGBBBBBBBB -> RRRRRRRRGGGGGGGGBBBBBBBBAAAAAAAA
 void Texture2D::convertRGB888ToRGBA8888(const unsigned char* data, ssize_t dataLen, unsigned char* outData)
 {
-    for (ssize_t i = 0, l = dataLen - 2; i < l; i += 3)
+    ssize_t i = CC_CONVERT_PIXEL_BLOCKS(loadRGB888, storeRGBA8888, 3, 4, data, dataLen, outData);
+    for (ssize_t l = dataLen - 2; i < l; i += 3)
     {
         *outData++ = data[i];         //R
         *outData++ = data[i + 1];     //G
@@ -289,7 +667,8 @@ void Texture2D::convertRGB888ToRGBA8888(const unsigned char* data, ssize_t dataL
 // RRRRRRRRGGGGGGGGBBBBBBBBAAAAAAAA -> RRRRRRRRGGGGGGGGBBBBBBBB
 void Texture2D::convertRGBA8888ToRGB888(const unsigned char* data, ssize_t dataLen, unsigned char* outData)
 {
-    for (ssize_t i = 0, l = dataLen - 3; i < l; i += 4)
+    ssize_t i = CC_CONVERT_PIXEL_BLOCKS(loadRGBA8888, storeRGB888, 4, 3, data, dataLen, outData);
+    for (ssize_t l = dataLen - 3; i < l; i += 4)
     {
         *outData++ = data[i];         //R
         *outData++ = data[i + 1];     //G
@@ -300,8 +679,9 @@ void Texture2D::convertRGBA8888ToRGB888(const unsigned char* data, ssize_t dataL
 // RRRRRRRRGGGGGGGGBBBBBBBB -> RRRRRGGGGGGBBBBB
 void Texture2D::convertRGB888ToRGB565(const unsigned char* data, ssize_t dataLen, unsigned char* outData)
 {
+    ssize_t i = CC_CONVERT_PIXEL_BLOCKS(loadRGB888, storeRGB565, 3, 2, data, dataLen, outData);
     unsigned short* out16 = (unsigned short*)outData;
-    for (ssize_t i = 0, l = dataLen - 2; i < l; i += 3)
+    for (ssize_t l = dataLen - 2; i < l; i += 3)
     {
         *out16++ = (data[i] & 0x00F8) << 8    //R
             | (data[i + 1] & 0x00FC) << 3     //G
@@ -312,8 +692,9 @@ void Texture2D::convertRGB888ToRGB565(const unsigned char* data, ssize_t dataLen
 // RRRRRRRRGGGGGGGGBBBBBBBBAAAAAAAA -> RRRRRGGGGGGBBBBB
 void Texture2D::convertRGBA8888ToRGB565(const unsigned char* data, ssize_t dataLen, unsigned char* outData)
 {
+    ssize_t i = CC_CONVERT_PIXEL_BLOCKS(loadRGBA8888, storeRGB565, 4, 2, data, dataLen, outData);
     unsigned short* out16 = (unsigned short*)outData;
-    for (ssize_t i = 0, l = dataLen - 3; i < l; i += 4)
+    for (ssize_t l = dataLen - 3; i < l; i += 4)
     {
         *out16++ = (data[i] & 0x00F8) << 8    //R
             | (data[i + 1] & 0x00FC) << 3     //G
@@ -324,7 +705,8 @@ void Texture2D::convertRGBA8888ToRGB565(const unsigned char* data, ssize_t dataL
 // RRRRRRRRGGGGGGGGBBBBBBBB -> AAAAAAAA
 void Texture2D::convertRGB888ToA8(const unsigned char* data, ssize_t dataLen, unsigned char* outData)
 {
-    for (ssize_t i = 0, l = dataLen - 2; i < l; i += 3)
+    ssize_t i = CC_CONVERT_PIXEL_BLOCKS(loadRGB888, storeI8, 3, 1, data, dataLen, outData);
+    for (ssize_t l = dataLen - 2; i < l; i += 3)
     {
         *outData++ = (data[i] * 299 + data[i + 1] * 587 + data[i + 2] * 114 + 500) / 1000;  //A =  (R*299 + G*587 + B*114 + 500) / 1000
     }
@@ -333,7 +715,8 @@ void Texture2D::convertRGB888ToA8(const unsigned char* data, ssize_t dataLen, un
 // RRRRRRRRGGGGGGGGBBBBBBBB -> IIIIIIII
 void Texture2D::convertRGB888ToI8(const unsigned char* data, ssize_t dataLen, unsigned char* outData)
 {
-    for (ssize_t i = 0, l = dataLen - 2; i < l; i += 3)
+    ssize_t i = CC_CONVERT_PIXEL_BLOCKS(loadRGB888, storeI8, 3, 1, data, dataLen, outData);
+    for (ssize_t l = dataLen - 2; i < l; i += 3)
     {
         *outData++ = (data[i] * 299 + data[i + 1] * 587 + data[i + 2] * 114 + 500) / 1000;  //I =  (R*299 + G*587 + B*114 + 500) / 1000
     }
@@ -342,7 +725,8 @@ void Texture2D::convertRGB888ToI8(const unsigned char* data, ssize_t dataLen, un
 // RRRRRRRRGGGGGGGGBBBBBBBBAAAAAAAA -> IIIIIIII
 void Texture2D::convertRGBA8888ToI8(const unsigned char* data, ssize_t dataLen, unsigned char* outData)
 {
-    for (ssize_t i = 0, l = dataLen - 3; i < l; i += 4)
+    ssize_t i = CC_CONVERT_PIXEL_BLOCKS(loadRGBA8888, storeI8, 4, 1, data, dataLen, outData);
+    for (ssize_t l = dataLen - 3; i < l; i += 4)
     {
         *outData++ = (data[i] * 299 + data[i + 1] * 587 + data[i + 2] * 114 + 500) / 1000;  //I =  (R*299 + G*587 + B*114 + 500) / 1000
     }
@@ -351,7 +735,8 @@ void Texture2D::convertRGBA8888ToI8(const unsigned char* data, ssize_t dataLen,
 // RRRRRRRRGGGGGGGGBBBBBBBBAAAAAAAA -> AAAAAAAA
 void Texture2D::convertRGBA8888ToA8(const unsigned char* data, ssize_t dataLen, unsigned char* outData)
 {
-    for (ssize_t i = 0, l = dataLen -3; i < l; i += 4)
+    ssize_t i = CC_CONVERT_PIXEL_BLOCKS(loadRGBA8888, storeA8, 4, 1, data, dataLen, outData);
+    for (ssize_t l = dataLen -3; i < l; i += 4)
     {
         *outData++ = data[i + 3]; //A
     }
@@ -360,7 +745,8 @@ void Texture2D::convertRGBA8888ToA8(const unsigned char* data, ssize_t dataLen,
 // RRRRRRRRGGGGGGGGBBBBBBBB -> IIIIIIIIAAAAAAAA
 void Texture2D::convertRGB888ToAI88(const unsigned char* data, ssize_t dataLen, unsigned char* outData)
 {
-    for (ssize_t i = 0, l = dataLen - 2; i < l; i += 3)
+    ssize_t i = CC_CONVERT_PIXEL_BLOCKS(loadRGB888, storeAI88, 3, 2, data, dataLen, outData);
+    for (ssize_t l = dataLen - 2; i < l; i += 3)
     {
         *outData++ = (data[i] * 299 + data[i + 1] * 587 + data[i + 2] * 114 + 500) / 1000;  //I =  (R*299 + G*587 + B*114 + 500) / 1000
         *outData++ = 0xFF;
@@ -371,7 +757,8 @@ void Texture2D::convertRGB888ToAI88(const unsigned char* data, ssize_t dataLen,
 // RRRRRRRRGGGGGGGGBBBBBBBBAAAAAAAA -> IIIIIIIIAAAAAAAA
 void Texture2D::convertRGBA8888ToAI88(const unsigned char* data, ssize_t dataLen, unsigned char* outData)
 {
-    for (ssize_t i = 0, l = dataLen - 3; i < l; i += 4)
+    ssize_t i = CC_CONVERT_PIXEL_BLOCKS(loadRGBA8888, storeAI88, 4, 2, data, dataLen, outData);
+    for (ssize_t l = dataLen - 3; i < l; i += 4)
     {
         *outData++ = (data[i] * 299 + data[i + 1] * 587 + data[i + 2] * 114 + 500) / 1000;  //I =  (R*299 + G*587 + B*114 + 500) / 1000
         *outData++ = data[i + 3];
@@ -381,8 +768,9 @@ void Texture2D::convertRGBA8888ToAI88(const unsigned char* data, ssize_t dataLen
 // RRRRRRRRGGGGGGGGBBBBBBBB -> RRRRGGGGBBBBAAAA
 void Texture2D::convertRGB888ToRGBA4444(const unsigned char* data, ssize_t dataLen, unsigned char* outData)
 {
+    ssize_t i = CC_CONVERT_PIXEL_BLOCKS(loadRGB888, storeRGBA4444, 3, 2, data, dataLen, outData);
     unsigned short* out16 = (unsigned short*)outData;
-    for (ssize_t i = 0, l = dataLen - 2; i < l; i += 3)
+    for (ssize_t l = dataLen - 2; i < l; i += 3)
     {
         *out16++ = ((data[i] & 0x00F0) << 8           //R
                     | (data[i + 1] & 0x00F0) << 4     //G
@@ -394,8 +782,9 @@ void Texture2D::convertRGB888ToRGBA4444(const unsigned char* data, ssize_t dataL
 // RRRRRRRRGGGGGGGGBBBBBBBBAAAAAAAA -> RRRRGGGGBBBBAAAA
 void Texture2D::convertRGBA8888ToRGBA4444(const unsigned char* data, ssize_t dataLen, unsigned char* outData)
 {
+    ssize_t i = CC_CONVERT_PIXEL_BLOCKS(loadRGBA8888, storeRGBA4444, 4, 2, data, dataLen, outData);
     unsigned short* out16 = (unsigned short*)outData;
-    for (ssize_t i = 0, l = dataLen - 3; i < l; i += 4)
+    for (ssize_t l = dataLen - 3; i < l; i += 4)
     {
         *out16++ = (data[i] & 0x00F0) << 8    //R
         | (data[i + 1] & 0x00F0) << 4         //G
@@ -407,8 +796,9 @@ void Texture2D::convertRGBA8888ToRGBA4444(const unsigned char* data, ssize_t dat
 // RRRRRRRRGGGGGGGGBBBBBBBB -> RRRRRGGGGGBBBBBA
 void Texture2D::convertRGB888ToRGB5A1(const unsigned char* data, ssize_t dataLen, unsigned char* outData)
 {
+    ssize_t i = CC_CONVERT_PIXEL_BLOCKS(loadRGB888, storeRGB5A1, 3, 2, data, dataLen, outData);
     unsigned short* out16 = (unsigned short*)outData;
-    for (ssize_t i = 0, l = dataLen - 2; i < l; i += 3)
+    for (ssize_t l = dataLen - 2; i < l; i += 3)
     {
         *out16++ = (data[i] & 0x00F8) << 8    //R
             | (data[i + 1] & 0x00F8) << 3     //G
@@ -420,8 +810,9 @@ void Texture2D::convertRGB888ToRGB5A1(const unsigned char* data, ssize_t dataLen
 // RRRRRRRRGGGGGGGGBBBBBBBB -> RRRRRGGGGGBBBBBA
 void Texture2D::convertRGBA8888ToRGB5A1(const unsigned char* data, ssize_t dataLen, unsigned char* outData)
 {
+    ssize_t i = CC_CONVERT_PIXEL_BLOCKS(loadRGBA8888, storeRGB5A1, 4, 2, data, dataLen, outData);
     unsigned short* out16 = (unsigned short*)outData;
-    for (ssize_t i = 0, l = dataLen - 2; i < l; i += 4)
+    for (ssize_t l = dataLen - 3; i < l; i += 4)
     {
         *out16++ = (data[i] & 0x00F8) << 8    //R
             | (data[i + 1] & 0x00F8) << 3     //G
@@ -180,6 +180,21 @@ public:
     static Texture2D::PixelFormat getDefaultAlphaPixelFormat();
     CC_DEPRECATED_ATTRIBUTE static Texture2D::PixelFormat defaultAlphaPixelFormat() { return Texture2D::getDefaultAlphaPixelFormat(); };
 
+    /** Sets whether the pixel format convertors and Image::premultipliedAlpha use SIMD instructions (SSE2 or NEON),
+     * when the CPU has them. Both give the same pixels, it is mainly useful to compare them.
+     *
+     * @param enabled Whether SIMD instructions are used. Default is true.
+     * @since v3.16
+     */
+    static void setSimdConversionEnabled(bool enabled) { s_simdConversionEnabled = enabled; }
+
+    /** Whether the pixel format convertors use SIMD instructions.
+     *
+     * @return True if SIMD instructions are enabled and the CPU has them.
+     * @since v3.16
+     */
+    static bool isSimdConversionEnabled();
+
     /** Treats (or not) PVR files as if they have alpha premultiplied.
      
      @param haveAlphaPremultiplied 
@@ -417,6 +432,13 @@ public:
 public:
     /** Get pixel info map, the key-value pairs is PixelFormat and PixelFormatInfo.*/
     static const PixelFormatInfoMap& getPixelFormatInfoMap();
+
+    /**
+    Convert the format to the format param you specified, if the format is PixelFormat::Automatic, it will detect it automatically and convert to the closest format for you.
+    It will return the converted format to you. if the outData != data, you must free it manually.
+    @since v3.16 it is public.
+    */
+    static PixelFormat convertDataToFormat(const unsigned char* data, ssize_t dataLen, PixelFormat originFormat, PixelFormat format, unsigned char** outData, ssize_t* outDataLen);
     
 private:
     /**
@@ -464,12 +486,6 @@ private:
 
     /**convert functions*/
 
-    /**
-    Convert the format to the format param you specified, if the format is PixelFormat::Automatic, it will detect it automatically and convert to the closest format for you.
-    It will return the converted format to you. if the outData != data, you must delete it manually.
-    */
-    static PixelFormat convertDataToFormat(const unsigned char* data, ssize_t dataLen, PixelFormat originFormat, PixelFormat format, unsigned char** outData, ssize_t* outDataLen);
-
     static PixelFormat convertI8ToFormat(const unsigned char* data, ssize_t dataLen, PixelFormat format, unsigned char** outData, ssize_t* outDataLen);
     static PixelFormat convertAI88ToFormat(const unsigned char* data, ssize_t dataLen, PixelFormat format, unsigned char** outData, ssize_t* outDataLen);
     static PixelFormat convertRGB888ToFormat(const unsigned char* data, ssize_t dataLen, PixelFormat format, unsigned char** outData, ssize_t* outDataLen);
@@ -543,6 +559,8 @@ protected:
 
     static const PixelFormatInfoMap _pixelFormatInfoTables;
 
+    static bool s_simdConversionEnabled;
+
     bool _antialiasEnabled;
     NinePatchInfo* _ninePatchInfo;
     friend class SpriteFrameCache;
@@ -31,6 +31,8 @@ THE SOFTWARE.
 #include <stack>
 #include <cctype>
 #include <list>
+#include <algorithm>
+#include <chrono>
 
 #include "renderer/CCTexture2D.h"
 #include "base/ccMacros.h"
@@ -39,6 +41,7 @@ THE SOFTWARE.
 #include "base/CCScheduler.h"
 #include "platform/CCFileUtils.h"
 #include "base/ccUtils.h"
+#include "base/CCConfiguration.h"
 #include "base/CCNinePatchImageParser.h"
 
 
@@ -67,10 +70,25 @@ TextureCache * TextureCache::getInstance()
 }
 
 TextureCache::TextureCache()
-: _loadingThread(nullptr)
+: _asyncLoadingThreadCount(1)
 , _needQuit(false)
 , _asyncRefCount(0)
+, _asyncUploadBytesPerFrame(0)
+, _asyncUploadTimePerFrame(0)
+, _textureMemory(0)
+, _peakTextureMemory(0)
+, _memoryBudget(0)
+, _evictionCount(0)
+, _evictionScheduled(false)
+, _diskCache(nullptr)
+, _diskCacheEnabled(false)
 {
+    // keep a hardware thread for the cocos thread
+    unsigned int hardwareThreads = std::thread::hardware_concurrency();
+    if (hardwareThreads > 2)
+    {
+        _asyncLoadingThreadCount = std::min(hardwareThreads - 1, 4u);
+    }
 }
 
 TextureCache::~TextureCache()
@@ -80,7 +98,8 @@ TextureCache::~TextureCache()
     for (auto& texture : _textures)
         texture.second->release();
 
-    CC_SAFE_DELETE(_loadingThread);
+    waitForQuit();
+    CC_SAFE_DELETE(_diskCache);
 }
 
 void TextureCache::destroyInstance()
@@ -106,10 +125,13 @@ struct TextureCache::AsyncStruct
 public:
     AsyncStruct
     ( const std::string& fn,const std::function<void(Texture2D*)>& f,
-      const std::string& key )
+      const std::string& key, int p )
       : filename(fn), callback(f),callbackKey( key ),
         pixelFormat(Texture2D::getDefaultAlphaPixelFormat()),
-        loadSuccess(false)
+        priority(p),
+        loadSuccess(false),
+        cancelled(false),
+        diskCache(nullptr)
     {}
 
     std::string filename;
@@ -118,13 +140,18 @@ public:
     Image image;
     Image imageAlpha;
     Texture2D::PixelFormat pixelFormat;
+    int priority;
     bool loadSuccess;
+    bool cancelled;
+    // the pixels are loaded from the disk cache or stored in it, when it is set
+    TextureDiskCache* diskCache;
+    TextureDiskCache::Pixels pixels;
 };
 
 /**
  The addImageAsync logic follow the steps:
  - find the image has been add or not, if not add an AsyncStruct to _requestQueue  (GL thread)
- - get AsyncStruct from _requestQueue, load res and fill image data to AsyncStruct.image, then add AsyncStruct to _responseQueue (Load thread)
+ - get AsyncStruct from _requestQueue, load res and fill image data to AsyncStruct.image, then add AsyncStruct to _responseQueue (Load threads)
  - on schedule callback, get AsyncStruct from _responseQueue, convert image to texture, then delete AsyncStruct (GL thread)
 
  the Critical Area include these members:
@@ -133,7 +160,7 @@ public:
 
  the object's life time:
  - AsyncStruct: construct and destruct in GL thread
- - image data: new in Load thread, delete in GL thread(by Image instance)
+ - image data: new in Load threads, delete in GL thread(by Image instance)
 
  Note:
  - all AsyncStruct referenced in _asyncStructQueue, for unbind function use.
@@ -145,8 +172,9 @@ public:
  - In addImageAsyncCallback, will deduplicate the request to ensure only create one texture.
 
  Does process all response in addImageAsyncCallback consume more time?
- - Convert image to texture faster than load image from disk, so this isn't a
- problem.
+ - Convert image to texture faster than load image from disk, but a lot of
+ big images can take several frames, setAsyncUploadBytesPerFrame() and
+ setAsyncUploadTimePerFrame() spread them over the next frames.
 
  Call unbindImageAsync(path) to prevent the call to the callback when the
  texture is loaded.
@@ -159,7 +187,7 @@ void TextureCache::addImageAsync(const std::string &path, const std::function<vo
 /**
  The addImageAsync logic follow the steps:
  - find the image has been add or not, if not add an AsyncStruct to _requestQueue  (GL thread)
- - get AsyncStruct from _requestQueue, load res and fill image data to AsyncStruct.image, then add AsyncStruct to _responseQueue (Load thread)
+ - get AsyncStruct from _requestQueue, load res and fill image data to AsyncStruct.image, then add AsyncStruct to _responseQueue (Load threads)
  - on schedule callback, get AsyncStruct from _responseQueue, convert image to texture, then delete AsyncStruct (GL thread)
  
  the Critical Area include these members:
@@ -168,7 +196,7 @@ void TextureCache::addImageAsync(const std::string &path, const std::function<vo
  
  the object's life time:
  - AsyncStruct: construct and destruct in GL thread
- - image data: new in Load thread, delete in GL thread(by Image instance)
+ - image data: new in Load threads, delete in GL thread(by Image instance)
  
  Note:
  - all AsyncStruct referenced in _asyncStructQueue, for unbind function use.
@@ -180,8 +208,12 @@ void TextureCache::addImageAsync(const std::string &path, const std::function<vo
  - In addImageAsyncCallback, will deduplicate the request to ensure only create one texture.
  
  Does process all response in addImageAsyncCallback consume more time?
- - Convert image to texture faster than load image from disk, so this isn't a
- problem.
+ - Convert image to texture faster than load image from disk, but a lot of
+ big images can take several frames, setAsyncUploadBytesPerFrame() and
+ setAsyncUploadTimePerFrame() spread them over the next frames.
+
+ The requests are decoded by up to getAsyncLoadingThreadCount() threads, by
+ priority, so the responses don't come in the order of the requests.
 
  The callbackKey allows to unbind the callback in cases where the loading of
  path is requested by several sources simultaneously. Each source can then
@@ -189,6 +221,11 @@ void TextureCache::addImageAsync(const std::string &path, const std::function<vo
  unbindImageAsync(path) would be ambiguous.
  */
 void TextureCache::addImageAsync(const std::string &path, const std::function<void(Texture2D*)>& callback, const std::string& callbackKey)
+{
+    addImageAsync(path, callback, callbackKey, 0);
+}
+
+void TextureCache::addImageAsync(const std::string &path, const std::function<void(Texture2D*)>& callback, const std::string& callbackKey, int priority)
 {
     Texture2D *texture = nullptr;
 
@@ -200,6 +237,7 @@ void TextureCache::addImageAsync(const std::string &path, const std::function<vo
 
     if (texture != nullptr)
     {
+        updateTextureUsage(fullpath, texture);
         if (callback) callback(texture);
         return;
     }
@@ -210,12 +248,14 @@ void TextureCache::addImageAsync(const std::string &path, const std::function<vo
         return;
     }
 
-    // lazy init
-    if (_loadingThread == nullptr)
+    // lazy init, one more thread for each pending request
+    if (_loadingThreads.size() < _asyncLoadingThreadCount && _loadingThreads.size() <= _asyncStructQueue.size())
     {
-        // create a new thread to load images
-        _loadingThread = new (std::nothrow) std::thread(&TextureCache::loadImage, this);
+        // create a new thread to load images, the running ones read _needQuit
+        _requestMutex.lock();
         _needQuit = false;
+        _requestMutex.unlock();
+        _loadingThreads.emplace_back(&TextureCache::loadImage, this);
     }
 
     if (0 == _asyncRefCount)
@@ -227,12 +267,17 @@ void TextureCache::addImageAsync(const std::string &path, const std::function<vo
 
     // generate async struct
     AsyncStruct *data =
-      new (std::nothrow) AsyncStruct(fullpath, callback, callbackKey);
+      new (std::nothrow) AsyncStruct(fullpath, callback, callbackKey, priority);
+    if (_diskCacheEnabled && TextureDiskCache::isCacheable(fullpath))
+        data->diskCache = _diskCache;
     
-    // add async struct into queue
+    // add async struct into queue, after the requests with the same or a higher priority
     _asyncStructQueue.push_back(data);
     _requestMutex.lock();
-    _requestQueue.push_back(data);
+    auto position = std::upper_bound(_requestQueue.begin(), _requestQueue.end(), data, [](const AsyncStruct* a, const AsyncStruct* b) {
+        return a->priority > b->priority;
+    });
+    _requestQueue.insert(position, data);
     _requestMutex.unlock();
 
     _sleepCondition.notify_one();
@@ -267,33 +312,93 @@ void TextureCache::unbindAllImageAsync()
     }
 }
 
+void TextureCache::cancelImageAsync(const std::string& callbackKey)
+{
+    if (_asyncStructQueue.empty())
+    {
+        return;
+    }
+
+    // the requests not picked by a loading thread yet are removed
+    std::vector<AsyncStruct*> removed;
+    _requestMutex.lock();
+    auto end = std::remove_if(_requestQueue.begin(), _requestQueue.end(), [&](AsyncStruct* asyncStruct) {
+        if (asyncStruct->callbackKey != callbackKey)
+            return false;
+        removed.push_back(asyncStruct);
+        return true;
+    });
+    _requestQueue.erase(end, _requestQueue.end());
+    _requestMutex.unlock();
+
+    for (auto asyncStruct : removed)
+    {
+        _asyncStructQueue.erase(std::find(_asyncStructQueue.begin(), _asyncStructQueue.end(), asyncStruct));
+        delete asyncStruct;
+        --_asyncRefCount;
+    }
+
+    // the others are dropped when they are received
+    for (auto& asyncStruct : _asyncStructQueue)
+    {
+        if (asyncStruct->callbackKey == callbackKey)
+        {
+            asyncStruct->cancelled = true;
+            asyncStruct->callback = nullptr;
+        }
+    }
+
+    if (0 == _asyncRefCount)
+    {
+        Director::getInstance()->getScheduler()->unschedule(CC_SCHEDULE_SELECTOR(TextureCache::addImageAsyncCallBack), this);
+    }
+}
+
+void TextureCache::setDiskCacheEnabled(bool enabled)
+{
+    // the cache is kept until the TextureCache is destroyed, the loading threads may be using it
+    if (enabled && _diskCache == nullptr)
+    {
+        _diskCache = new (std::nothrow) TextureDiskCache(FileUtils::getInstance()->getWritablePath() + "texture-cache/");
+    }
+    _diskCacheEnabled = enabled;
+}
+
+void TextureCache::setAsyncLoadingThreadCount(unsigned int count)
+{
+    CCASSERT(count > 0, "At least one thread is needed to load the images");
+    _asyncLoadingThreadCount = count;
+}
+
 void TextureCache::loadImage()
 {
     AsyncStruct *asyncStruct = nullptr;
-    std::mutex signalMutex;
-    std::unique_lock<std::mutex> signal(signalMutex);
-    while (!_needQuit)
+    while (true)
     {
         // pop an AsyncStruct from request queue
-        _requestMutex.lock();
-        if (_requestQueue.empty())
-        {
-            asyncStruct = nullptr;
-        }
-        else
         {
+            std::unique_lock<std::mutex> lock(_requestMutex);
+            _sleepCondition.wait(lock, [this](){ return _needQuit || !_requestQueue.empty(); });
+            if (_needQuit)
+            {
+                break;
+            }
             asyncStruct = _requestQueue.front();
             _requestQueue.pop_front();
         }
-        _requestMutex.unlock();
 
-        if (nullptr == asyncStruct) {
-            _sleepCondition.wait(signal);
-            continue;
+        // load image, the converted pixels of the disk cache first
+        auto diskCache = asyncStruct->diskCache;
+        if (diskCache && diskCache->load(asyncStruct->filename, asyncStruct->pixelFormat, asyncStruct->pixels))
+        {
+            asyncStruct->loadSuccess = true;
+        }
+        else
+        {
+            asyncStruct->loadSuccess = asyncStruct->image.initWithImageFileThreadSafe(asyncStruct->filename);
+            if (asyncStruct->loadSuccess && diskCache)
+                diskCache->store(asyncStruct->filename, asyncStruct->pixelFormat, &asyncStruct->image, asyncStruct->pixels);
         }
-
-        // load image
-        asyncStruct->loadSuccess = asyncStruct->image.initWithImageFileThreadSafe(asyncStruct->filename);
 
         // ETC1 ALPHA supports.
         if (asyncStruct->loadSuccess && asyncStruct->image.getFileType() == Image::Format::ETC && !s_etc1AlphaFileSuffix.empty())
@@ -313,8 +418,21 @@ void TextureCache::addImageAsyncCallBack(float /*dt*/)
 {
     Texture2D *texture = nullptr;
     AsyncStruct *asyncStruct = nullptr;
+    const auto start = std::chrono::steady_clock::now();
+    size_t uploadedBytes = 0;
+    bool uploaded = false;
     while (true)
     {
+        // at least one image is uploaded each frame
+        if (uploaded)
+        {
+            if (_asyncUploadBytesPerFrame > 0 && uploadedBytes >= _asyncUploadBytesPerFrame)
+                break;
+            if (_asyncUploadTimePerFrame > 0
+                && std::chrono::duration<float>(std::chrono::steady_clock::now() - start).count() >= _asyncUploadTimePerFrame)
+                break;
+        }
+
         // pop an AsyncStruct from response queue
         _responseMutex.lock();
         if (_responseQueue.empty())
@@ -325,10 +443,6 @@ void TextureCache::addImageAsyncCallBack(float /*dt*/)
         {
             asyncStruct = _responseQueue.front();
             _responseQueue.pop_front();
-
-            // the asyncStruct's sequence order in _asyncStructQueue must equal to the order in _responseQueue
-            CC_ASSERT(asyncStruct == _asyncStructQueue.front());
-            _asyncStructQueue.pop_front();
         }
         _responseMutex.unlock();
 
@@ -336,11 +450,19 @@ void TextureCache::addImageAsyncCallBack(float /*dt*/)
             break;
         }
 
+        // the loading threads don't respond in the order of _asyncStructQueue
+        _asyncStructQueue.erase(std::find(_asyncStructQueue.begin(), _asyncStructQueue.end(), asyncStruct));
+
         // check the image has been convert to texture or not
         auto it = _textures.find(asyncStruct->filename);
-        if (it != _textures.end())
+        if (asyncStruct->cancelled)
+        {
+            texture = nullptr;
+        }
+        else if (it != _textures.end())
         {
             texture = it->second;
+            updateTextureUsage(asyncStruct->filename, texture);
         }
         else
         {
@@ -348,10 +470,16 @@ void TextureCache::addImageAsyncCallBack(float /*dt*/)
             if (asyncStruct->loadSuccess)
             {
                 Image* image = &(asyncStruct->image);
+                const TextureDiskCache::Pixels& pixels = asyncStruct->pixels;
+                uploadedBytes += (pixels.data ? pixels.dataLen : image->getDataLen()) + asyncStruct->imageAlpha.getDataLen();
+                uploaded = true;
                 // generate texture in render thread
                 texture = new (std::nothrow) Texture2D();
 
-                texture->initWithImage(image, asyncStruct->pixelFormat);
+                if (pixels.data)
+                    initTextureWithPixels(texture, pixels, asyncStruct->filename);
+                else
+                    texture->initWithImage(image, asyncStruct->pixelFormat);
                 //parse 9-patch info
                 this->parseNinePatchImage(image, texture, asyncStruct->filename);
 #if CC_ENABLE_CACHE_TEXTURE_DATA
@@ -371,6 +499,7 @@ void TextureCache::addImageAsyncCallBack(float /*dt*/)
                     }
                     CC_SAFE_RELEASE(alphaTexture);
                 }
+                updateTextureUsage(asyncStruct->filename, texture);
             }
             else {
                 texture = nullptr;
@@ -410,22 +539,37 @@ Texture2D * TextureCache::addImage(const std::string &path)
     }
     auto it = _textures.find(fullpath);
     if (it != _textures.end())
+    {
         texture = it->second;
+        updateTextureUsage(fullpath, texture);
+    }
 
     if (!texture)
     {
+        TextureDiskCache* diskCache = (_diskCacheEnabled && TextureDiskCache::isCacheable(fullpath)) ? _diskCache : nullptr;
+        const Texture2D::PixelFormat pixelFormat = Texture2D::getDefaultAlphaPixelFormat();
+        TextureDiskCache::Pixels pixels;
+
         // all images are handled by UIImage except PVR extension that is handled by our own handler
         do
         {
             image = new (std::nothrow) Image();
             CC_BREAK_IF(nullptr == image);
 
-            bool bRet = image->initWithImageFile(fullpath);
-            CC_BREAK_IF(!bRet);
+            // the pixels converted before are in the disk cache
+            bool bRet = diskCache && diskCache->load(fullpath, pixelFormat, pixels);
+            if (!bRet)
+            {
+                bRet = image->initWithImageFile(fullpath);
+                CC_BREAK_IF(!bRet);
+
+                if (diskCache)
+                    diskCache->store(fullpath, pixelFormat, image, pixels);
+            }
 
             texture = new (std::nothrow) Texture2D();
 
-            if (texture && texture->initWithImage(image))
+            if (texture && (pixels.data ? initTextureWithPixels(texture, pixels, fullpath) : texture->initWithImage(image, pixelFormat)))
             {
 #if CC_ENABLE_CACHE_TEXTURE_DATA
                 // cache the texture file name
@@ -451,6 +595,8 @@ Texture2D * TextureCache::addImage(const std::string &path)
 
                 //parse 9-patch info
                 this->parseNinePatchImage(image, texture, path);
+
+                updateTextureUsage(fullpath, texture);
             }
             else
             {
@@ -477,6 +623,24 @@ void TextureCache::parseNinePatchImage(cocos2d::Image *image, cocos2d::Texture2D
 
 }
 
+bool TextureCache::initTextureWithPixels(Texture2D* texture, const TextureDiskCache::Pixels& pixels, const std::string& path)
+{
+    // as Texture2D::initWithImage()
+    int maxTextureSize = Configuration::getInstance()->getMaxTextureSize();
+    if (pixels.width > maxTextureSize || pixels.height > maxTextureSize)
+    {
+        CCLOG("cocos2d: WARNING: Image (%u x %u) is bigger than the supported %u x %u", pixels.width, pixels.height, maxTextureSize, maxTextureSize);
+        return false;
+    }
+
+    texture->_filePath = path;
+    if (!texture->initWithData(pixels.data, pixels.dataLen, pixels.format, pixels.width, pixels.height, Size((float)pixels.width, (float)pixels.height)))
+        return false;
+
+    texture->_hasPremultipliedAlpha = pixels.premultipliedAlpha;
+    return true;
+}
+
 Texture2D* TextureCache::addImage(Image *image, const std::string &key)
 {
     CCASSERT(image != nullptr, "TextureCache: image MUST not be nil");
@@ -489,6 +653,7 @@ Texture2D* TextureCache::addImage(Image *image, const std::string &key)
         auto it = _textures.find(key);
         if (it != _textures.end()) {
             texture = it->second;
+            updateTextureUsage(key, texture);
             break;
         }
 
@@ -499,6 +664,7 @@ Texture2D* TextureCache::addImage(Image *image, const std::string &key)
             if (texture->initWithImage(image))
             {
                 _textures.emplace(key, texture);
+                updateTextureUsage(key, texture);
             }
             else
             {
@@ -552,6 +718,7 @@ bool TextureCache::reloadTexture(const std::string& fileName)
             CC_BREAK_IF(!bRet);
 
             ret = texture->initWithImage(image);
+            updateTextureUsage(fullpath, texture);
         } while (0);
     }
 
@@ -568,6 +735,10 @@ void TextureCache::removeAllTextures()
         texture.second->release();
     }
     _textures.clear();
+
+    _textureOrder.clear();
+    _textureUsage.clear();
+    _textureMemory = 0;
 }
 
 void TextureCache::removeUnusedTextures()
@@ -577,6 +748,7 @@ void TextureCache::removeUnusedTextures()
         if (tex->getReferenceCount() == 1) {
             CCLOG("cocos2d: TextureCache: removing unused texture: %s", it->first.c_str());
 
+            removeTextureUsage(it->first);
             tex->release();
             it = _textures.erase(it);
         }
@@ -596,6 +768,7 @@ void TextureCache::removeTexture(Texture2D* texture)
 
     for (auto it = _textures.cbegin(); it != _textures.cend(); /* nothing */) {
         if (it->second == texture) {
+            removeTextureUsage(it->first);
             it->second->release();
             it = _textures.erase(it);
             break;
@@ -616,11 +789,113 @@ void TextureCache::removeTextureForKey(const std::string &textureKeyName)
     }
 
     if (it != _textures.end()) {
+        removeTextureUsage(key);
         it->second->release();
         _textures.erase(it);
     }
 }
 
+void TextureCache::setMemoryBudget(size_t bytes)
+{
+    _memoryBudget = bytes;
+    checkMemoryBudget();
+}
+
+static size_t getTextureBytes(Texture2D* texture)
+{
+    // Each texture takes up width * height * bytesPerPixel bytes, and a third more for the mipmaps.
+    size_t bytes = (size_t)texture->getPixelsWide() * texture->getPixelsHigh() * texture->getBitsPerPixelForFormat() / 8;
+    if (texture->hasMipmaps())
+        bytes += bytes / 3;
+
+    Texture2D* alphaTexture = texture->getAlphaTexture();
+    if (alphaTexture)
+        bytes += (size_t)alphaTexture->getPixelsWide() * alphaTexture->getPixelsHigh() * alphaTexture->getBitsPerPixelForFormat() / 8;
+    return bytes;
+}
+
+void TextureCache::updateTextureUsage(const std::string& key, Texture2D* texture)
+{
+    // measured again each time, the mipmaps may have been generated since
+    const size_t bytes = getTextureBytes(texture);
+
+    auto it = _textureUsage.find(key);
+    if (it == _textureUsage.end())
+    {
+        TextureUsage usage;
+        usage.order = _textureOrder.insert(_textureOrder.end(), key);
+        usage.bytes = bytes;
+        _textureUsage.emplace(key, usage);
+    }
+    else
+    {
+        _textureOrder.splice(_textureOrder.end(), _textureOrder, it->second.order);
+        _textureMemory -= it->second.bytes;
+        it->second.bytes = bytes;
+    }
+
+    _textureMemory += bytes;
+    _peakTextureMemory = std::max(_peakTextureMemory, _textureMemory);
+    checkMemoryBudget();
+}
+
+void TextureCache::removeTextureUsage(const std::string& key)
+{
+    auto it = _textureUsage.find(key);
+    if (it != _textureUsage.end())
+    {
+        _textureMemory -= it->second.bytes;
+        _textureOrder.erase(it->second.order);
+        _textureUsage.erase(it);
+    }
+}
+
+void TextureCache::checkMemoryBudget()
+{
+    // the textures are evicted each frame until they fit in the budget
+    if (_memoryBudget > 0 && _textureMemory > _memoryBudget && !_evictionScheduled)
+    {
+        _evictionScheduled = true;
+        Director::getInstance()->getScheduler()->schedule(CC_SCHEDULE_SELECTOR(TextureCache::evictTextures), this, 0, false);
+    }
+}
+
+void TextureCache::evictTextures(float /*dt*/)
+{
+    for (auto it = _textureOrder.begin(); it != _textureOrder.end() && _textureMemory > _memoryBudget; /* nothing */)
+    {
+        auto textureIt = _textures.find(*it);
+
+        // every texture in the usage order is cached, forget the usage of one that isn't anyway
+        CCASSERT(textureIt != _textures.end(), "TextureCache: the usage order has a texture which isn't cached");
+        if (textureIt == _textures.end())
+        {
+            const std::string key = *it++;
+            removeTextureUsage(key);
+            continue;
+        }
+        ++it;
+
+        Texture2D* texture = textureIt->second;
+        if (texture->getReferenceCount() == 1)
+        {
+            CCLOGINFO("cocos2d: TextureCache: evicting texture: %s", textureIt->first.c_str());
+
+            removeTextureUsage(textureIt->first);
+            texture->release();
+            _textures.erase(textureIt);
+            ++_evictionCount;
+        }
+    }
+
+    // the textures still in use are checked again the next frame
+    if (_memoryBudget == 0 || _textureMemory <= _memoryBudget)
+    {
+        _evictionScheduled = false;
+        Director::getInstance()->getScheduler()->unschedule(CC_SCHEDULE_SELECTOR(TextureCache::evictTextures), this);
+    }
+}
+
 Texture2D* TextureCache::getTextureForKey(const std::string &textureKeyName) const
 {
     std::string key = textureKeyName;
@@ -659,10 +934,17 @@ std::string TextureCache::getTextureFilePath(cocos2d::Texture2D* texture) const
 
 void TextureCache::waitForQuit()
 {
-    // notify sub thread to quick
+    // notify sub threads to quit
+    _requestMutex.lock();
     _needQuit = true;
-    _sleepCondition.notify_one();
-    if (_loadingThread) _loadingThread->join();
+    _requestMutex.unlock();
+    _sleepCondition.notify_all();
+    for (auto& thread : _loadingThreads)
+    {
+        if (thread.joinable())
+            thread.join();
+    }
+    _loadingThreads.clear();
 }
 
 std::string TextureCache::getCachedTextureInfo() const
@@ -699,6 +981,20 @@ std::string TextureCache::getCachedTextureInfo() const
     snprintf(buftmp, sizeof(buftmp) - 1, "TextureCache dumpDebugInfo: %ld textures, for %lu KB (%.2f MB)\n", (long)count, (long)totalBytes / 1024, totalBytes / (1024.0f*1024.0f));
     buffer += buftmp;
 
+    snprintf(buftmp, sizeof(buftmp) - 1, "TextureCache memory: %lu KB, peak %lu KB, budget %lu KB, %u evictions\n",
+        (unsigned long)(_textureMemory / 1024), (unsigned long)(_peakTextureMemory / 1024), (unsigned long)(_memoryBudget / 1024), _evictionCount);
+    buffer += buftmp;
+
+    if (_diskCache)
+    {
+        auto stats = _diskCache->getStats();
+        snprintf(buftmp, sizeof(buftmp) - 1, "TextureCache disk cache%s: %u hits, %u misses, %u writes, %u evictions, %u entries for %lu KB of %lu KB\n",
+            _diskCacheEnabled ? "" : " (disabled)",
+            stats.hits, stats.misses, stats.writes, stats.evictions, stats.entries,
+            (unsigned long)(stats.size / 1024), (unsigned long)(stats.sizeLimit / 1024));
+        buffer += buftmp;
+    }
+
     return buffer;
 }
 
@@ -723,8 +1019,10 @@ void TextureCache::renameTextureWithKey(const std::string& srcName, const std::s
             if (ret)
             {
                 tex->initWithImage(image);
-                _textures.emplace(fullpath, tex);
+                removeTextureUsage(key);
                 _textures.erase(it);
+                _textures.emplace(fullpath, tex);
+                updateTextureUsage(fullpath, tex);
             }
             CC_SAFE_DELETE(image);
         }
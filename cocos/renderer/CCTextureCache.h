@@ -35,15 +35,14 @@ THE SOFTWARE.
 #include <string>
 #include <unordered_map>
 #include <functional>
+#include <vector>
+#include <list>
 
 #include "base/CCRef.h"
 #include "renderer/CCTexture2D.h"
+#include "renderer/CCTextureDiskCache.h"
 #include "platform/CCImage.h"
 
-#if CC_ENABLE_CACHE_TEXTURE_DATA
-    #include <list>
-#endif
-
 NS_CC_BEGIN
 
 /**
@@ -126,6 +125,78 @@ public:
     
     void addImageAsync(const std::string &path, const std::function<void(Texture2D*)>& callback, const std::string& callbackKey );
 
+    /** Loads a texture in one of the loading threads, the requests with a higher priority are decoded first.
+     * The requests with the same priority are decoded in the order they were added. The default priority is 0.
+     * @param path It's the related/absolute path of the file image.
+     * @param callback A callback function would be invoked after the image is loaded.
+     * @param callbackKey The key used to unbind or cancel the request.
+     * @param priority The priority of the request.
+     * @since v3.16
+     */
+    void addImageAsync(const std::string &path, const std::function<void(Texture2D*)>& callback, const std::string& callbackKey, int priority);
+
+    /** Cancels the asynchronous loads requested with the callbackKey.
+     * The images not decoded yet are not loaded, and no texture is created for the images already decoded.
+     * The callbacks of the cancelled requests are not invoked.
+     * @param callbackKey The key of the requests, the path of the file image if no key was given.
+     * @since v3.16
+     */
+    void cancelImageAsync(const std::string &callbackKey);
+
+    /** Sets the number of threads decoding the images loaded asynchronously.
+     * The threads are started as the requests come. Lowering it doesn't stop the running threads.
+     * By default, it is the number of hardware threads minus one, up to 4.
+     * @since v3.16
+     */
+    void setAsyncLoadingThreadCount(unsigned int count);
+
+    /** Gets the number of threads decoding the images loaded asynchronously.
+     * @since v3.16
+     */
+    unsigned int getAsyncLoadingThreadCount() const { return _asyncLoadingThreadCount; }
+
+    /** Sets the maximum size of the images uploaded to textures each frame by the asynchronous loads.
+     * At least one image is uploaded each frame. 0, the default, means no limit.
+     * @param bytes The size in bytes of the decoded images.
+     * @since v3.16
+     */
+    void setAsyncUploadBytesPerFrame(size_t bytes) { _asyncUploadBytesPerFrame = bytes; }
+
+    /** Gets the maximum size of the images uploaded to textures each frame by the asynchronous loads.
+     * @since v3.16
+     */
+    size_t getAsyncUploadBytesPerFrame() const { return _asyncUploadBytesPerFrame; }
+
+    /** Sets the maximum time spent each frame to upload the images loaded asynchronously to textures.
+     * At least one image is uploaded each frame. 0, the default, means no limit.
+     * @param seconds The time in seconds.
+     * @since v3.16
+     */
+    void setAsyncUploadTimePerFrame(float seconds) { _asyncUploadTimePerFrame = seconds; }
+
+    /** Gets the maximum time spent each frame to upload the images loaded asynchronously to textures.
+     * @since v3.16
+     */
+    float getAsyncUploadTimePerFrame() const { return _asyncUploadTimePerFrame; }
+
+    /** Enables the cache of the converted pixels of the images on disk, in "texture-cache/" under the writable path.
+     * The next time an image is loaded, even after a restart, its texture is uploaded from the cache
+     * instead of decoding and converting the image again. It is disabled by default.
+     * Disabling it keeps the files, see TextureDiskCache::purge().
+     * @since v3.16
+     */
+    void setDiskCacheEnabled(bool enabled);
+
+    /** Whether the images are cached on disk.
+     * @since v3.16
+     */
+    bool isDiskCacheEnabled() const { return _diskCacheEnabled; }
+
+    /** Gets the cache of the images on disk, nullptr until it is enabled.
+     * @since v3.16
+     */
+    TextureDiskCache* getDiskCache() const { return _diskCache; }
+
     /** Unbind a specified bound image asynchronous callback.
      * In the case an object who was bound to an image asynchronous callback was destroyed before the callback is invoked,
      * the object always need to unbind this callback manually.
@@ -188,8 +259,41 @@ public:
     */
     void removeTextureForKey(const std::string &key);
 
+    /** Sets the memory budget of the cached textures. 0, the default, means no budget.
+     * While the textures take more memory than the budget, the textures only referenced by the cache
+     * are removed each frame, the least recently requested first, until they fit in the budget again.
+     * Unlike removeUnusedTextures(), the unused textures under the budget are kept to be reused.
+     * Retain the textures used outside of the nodes, they may be removed by the next frame.
+     * @param bytes The size in bytes, as getTextureMemory().
+     * @since v3.16
+     */
+    void setMemoryBudget(size_t bytes);
+
+    /** Gets the memory budget of the cached textures.
+     * @since v3.16
+     */
+    size_t getMemoryBudget() const { return _memoryBudget; }
+
+    /** Gets the GPU memory of the cached textures, in bytes.
+     * It is estimated from their size and pixel format, with the mipmaps and ETC1 alpha textures,
+     * when they are added and requested again.
+     * @since v3.16
+     */
+    size_t getTextureMemory() const { return _textureMemory; }
+
+    /** Gets the highest GPU memory of the cached textures, in bytes.
+     * @since v3.16
+     */
+    size_t getPeakTextureMemory() const { return _peakTextureMemory; }
+
+    /** Gets the number of textures removed to keep the memory budget.
+     * @since v3.16
+     */
+    unsigned int getEvictionCount() const { return _evictionCount; }
+
     /** Output to CCLOG the current contents of this TextureCache.
-    * This will attempt to calculate the size of each texture, and the total texture memory in use.
+    * This will attempt to calculate the size of each texture, and the total texture memory in use,
+    * the memory budget and the counters of the disk cache when it is enabled.
     *
     * @since v1.0
     */
@@ -223,11 +327,17 @@ private:
     void addImageAsyncCallBack(float dt);
     void loadImage();
     void parseNinePatchImage(Image* image, Texture2D* texture, const std::string& path);
+    bool initTextureWithPixels(Texture2D* texture, const TextureDiskCache::Pixels& pixels, const std::string& path);
+    void updateTextureUsage(const std::string& key, Texture2D* texture);
+    void removeTextureUsage(const std::string& key);
+    void checkMemoryBudget();
+    void evictTextures(float dt);
 public:
 protected:
     struct AsyncStruct;
     
-    std::thread* _loadingThread;
+    std::vector<std::thread> _loadingThreads;
+    unsigned int _asyncLoadingThreadCount;
 
     std::deque<AsyncStruct*> _asyncStructQueue;
     std::deque<AsyncStruct*> _requestQueue;
@@ -242,8 +352,29 @@ protected:
 
     int _asyncRefCount;
 
+    size_t _asyncUploadBytesPerFrame;
+    float _asyncUploadTimePerFrame;
+
     std::unordered_map<std::string, Texture2D*> _textures;
 
+    struct TextureUsage
+    {
+        std::list<std::string>::iterator order;
+        size_t bytes;
+    };
+
+    // the keys of _textures, least recently requested first
+    std::list<std::string> _textureOrder;
+    std::unordered_map<std::string, TextureUsage> _textureUsage;
+    size_t _textureMemory;
+    size_t _peakTextureMemory;
+    size_t _memoryBudget;
+    unsigned int _evictionCount;
+    bool _evictionScheduled;
+
+    TextureDiskCache* _diskCache;
+    bool _diskCacheEnabled;
+
     static std::string s_etc1AlphaFileSuffix;
 };
 
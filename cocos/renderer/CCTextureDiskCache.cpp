@@ -0,0 +1,496 @@
+/****************************************************************************
+Copyright (c) 2017 Chukong Technologies Inc.
+
+http://www.cocos2d-x.org
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+****************************************************************************/
+
+#include "renderer/CCTextureDiskCache.h"
+
+#include <sys/stat.h>
+#include <stdint.h>
+#include <string.h>
+#include <sstream>
+
+#include "zlib.h"
+
+#include "platform/CCFileUtils.h"
+#include "platform/CCImage.h"
+#include "base/ccMacros.h"
+#include "base/ccUTF8.h"
+#include "base/CCNinePatchImageParser.h"
+
+NS_CC_BEGIN
+
+namespace {
+    const char CACHE_MAGIC[4] = { 'C', 'C', 'T', 'X' };
+    const uint32_t CACHE_VERSION = 1;
+    const char* const INDEX_FILE = "index";
+    const char* const INDEX_HEADER = "CCTX index 1";
+
+    // set in the stamp when it is a checksum, the modification times never reach it
+    const uint64_t STAMP_CHECKSUM = 1ULL << 63;
+
+    enum
+    {
+        FLAG_PREMULTIPLIED_ALPHA = 1,
+        FLAG_COMPRESSED = 2,
+    };
+
+    // the options which change the decoded pixels
+    enum
+    {
+        OPTION_PNG_PREMULTIPLIED_ALPHA = 1,
+    };
+
+    struct CacheHeader
+    {
+        char magic[4];
+        uint32_t version;
+        uint32_t requestedFormat;
+        uint32_t options;
+        uint32_t pixelFormat;
+        uint32_t width;
+        uint32_t height;
+        uint32_t flags;
+        uint64_t sourceStamp;
+        uint64_t sourceSize;
+        uint64_t dataLength;
+        uint64_t storedLength;
+        // the full path of the image follows the header, then the pixels at dataOffset
+        uint32_t pathLength;
+        uint32_t dataOffset;
+    };
+
+    uint32_t getCacheOptions()
+    {
+        return Image::isPNGPremultipliedAlphaEnabled() ? OPTION_PNG_PREMULTIPLIED_ALPHA : 0;
+    }
+
+    // modification time and size of the file, or a checksum of it when it has no modification time
+    bool getSourceStamp(const std::string& fullPath, uint64_t& stamp, uint64_t& size)
+    {
+        struct stat st;
+        if (stat(fullPath.c_str(), &st) == 0)
+        {
+            stamp = (uint64_t)st.st_mtime;
+            size = (uint64_t)st.st_size;
+            return true;
+        }
+
+        Data data = FileUtils::getInstance()->getDataFromFile(fullPath);
+        if (data.isNull())
+            return false;
+        stamp = adler32(adler32(0L, Z_NULL, 0), data.getBytes(), (uInt)data.getSize()) | STAMP_CHECKSUM;
+        size = (uint64_t)data.getSize();
+        return true;
+    }
+}
+
+TextureDiskCache::Pixels::Pixels()
+: format(Texture2D::PixelFormat::NONE)
+, width(0)
+, height(0)
+, premultipliedAlpha(false)
+, data(nullptr)
+, dataLen(0)
+{
+}
+
+TextureDiskCache::TextureDiskCache(const std::string& directory)
+: _directory(directory)
+, _compressionEnabled(false)
+, _size(0)
+, _sizeLimit(64 * 1024 * 1024)
+, _indexDirty(false)
+, _tempCount(0)
+{
+    memset(&_stats, 0, sizeof(_stats));
+
+    auto fileUtils = FileUtils::getInstance();
+    if (!fileUtils->isDirectoryExist(_directory) && !fileUtils->createDirectory(_directory))
+    {
+        CCLOG("cocos2d: TextureDiskCache: can't create %s", _directory.c_str());
+    }
+    loadIndex();
+}
+
+TextureDiskCache::~TextureDiskCache()
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    if (_indexDirty)
+        saveIndex();
+}
+
+bool TextureDiskCache::isCacheable(const std::string& fullPath)
+{
+    const std::string extension = FileUtils::getInstance()->getFileExtension(fullPath);
+    const bool decoded = extension == ".png" || extension == ".jpg" || extension == ".jpeg"
+        || extension == ".tif" || extension == ".tiff" || extension == ".webp" || extension == ".tga";
+    return decoded && !NinePatchImageParser::isNinePatchImage(fullPath);
+}
+
+std::string TextureDiskCache::getEntryName(const std::string& fullPath, Texture2D::PixelFormat format) const
+{
+    // FNV-1a of the path, the format and the options
+    uint64_t hash = 14695981039346656037ULL;
+    auto mix = [&hash](unsigned char byte) {
+        hash ^= byte;
+        hash *= 1099511628211ULL;
+    };
+    for (char c : fullPath)
+        mix((unsigned char)c);
+    mix((unsigned char)format);
+    mix((unsigned char)getCacheOptions());
+
+    return StringUtils::format("%08x%08x.tex", (unsigned int)(hash >> 32), (unsigned int)hash);
+}
+
+bool TextureDiskCache::load(const std::string& fullPath, Texture2D::PixelFormat format, Pixels& pixels)
+{
+    const std::string name = getEntryName(fullPath, format);
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        if (_entries.find(name) == _entries.end())
+        {
+            ++_stats.misses;
+            return false;
+        }
+    }
+
+    uint64_t stamp = 0;
+    uint64_t sourceSize = 0;
+    FileView view;
+    bool valid = getSourceStamp(fullPath, stamp, sourceSize);
+    if (valid && !view.initWithMappedFile(_directory + name))
+    {
+        view.initWithData(FileUtils::getInstance()->getDataFromFile(_directory + name));
+    }
+
+    const CacheHeader* header = (const CacheHeader*)view.getBytes();
+    valid = valid && view.getSize() >= (ssize_t)sizeof(CacheHeader)
+        && memcmp(header->magic, CACHE_MAGIC, sizeof(CACHE_MAGIC)) == 0
+        && header->version == CACHE_VERSION
+        && header->requestedFormat == (uint32_t)format
+        && header->options == getCacheOptions()
+        && header->sourceStamp == stamp
+        && header->sourceSize == sourceSize
+        && header->pathLength == fullPath.size()
+        && header->dataOffset >= sizeof(CacheHeader) + header->pathLength
+        && header->dataOffset + header->storedLength <= (uint64_t)view.getSize()
+        && memcmp(view.getBytes() + sizeof(CacheHeader), fullPath.data(), fullPath.size()) == 0;
+
+    if (valid)
+    {
+        // never upload less than the texture needs
+        const auto& infos = Texture2D::getPixelFormatInfoMap();
+        auto info = infos.find((Texture2D::PixelFormat)header->pixelFormat);
+        valid = info != infos.end()
+            && header->dataLength >= (uint64_t)header->width * header->height * info->second.bpp / 8;
+    }
+
+    if (valid)
+    {
+        pixels.format = (Texture2D::PixelFormat)header->pixelFormat;
+        pixels.width = (int)header->width;
+        pixels.height = (int)header->height;
+        pixels.premultipliedAlpha = (header->flags & FLAG_PREMULTIPLIED_ALPHA) != 0;
+        pixels.dataLen = (ssize_t)header->dataLength;
+
+        const unsigned char* stored = view.getBytes() + header->dataOffset;
+        if (header->flags & FLAG_COMPRESSED)
+        {
+            uLongf length = (uLongf)header->dataLength;
+            unsigned char* buffer = (unsigned char*)malloc(length);
+            valid = buffer != nullptr
+                && uncompress(buffer, &length, stored, (uLong)header->storedLength) == Z_OK
+                && length == header->dataLength;
+            if (valid)
+            {
+                Data data;
+                data.fastSet(buffer, pixels.dataLen);
+                pixels.storage.initWithData(std::move(data));
+                pixels.data = pixels.storage.getBytes();
+            }
+            else
+            {
+                free(buffer);
+            }
+        }
+        else
+        {
+            // the texture is uploaded from the mapped file
+            valid = header->storedLength == header->dataLength;
+            if (valid)
+            {
+                pixels.storage = std::move(view);
+                pixels.data = stored;
+            }
+        }
+    }
+
+    std::lock_guard<std::mutex> lock(_mutex);
+    auto it = _entries.find(name);
+    if (!valid)
+    {
+        // the image changed, or the file was damaged
+        if (it != _entries.end())
+        {
+            removeEntry(name);
+            saveIndex();
+        }
+        ++_stats.misses;
+        return false;
+    }
+
+    if (it != _entries.end())
+    {
+        _order.splice(_order.end(), _order, it->second.order);
+        _indexDirty = true;
+    }
+    ++_stats.hits;
+    return true;
+}
+
+bool TextureDiskCache::store(const std::string& fullPath, Texture2D::PixelFormat format, Image* image, Pixels& pixels)
+{
+    // the mipmaps and the compressed formats are uploaded as they are
+    if (image->getNumberOfMipmaps() > 1 || image->isCompressed())
+        return false;
+
+    // converts as Texture2D::initWithImage()
+    const Texture2D::PixelFormat renderFormat = image->getRenderFormat();
+    const Texture2D::PixelFormat requested = (format == Texture2D::PixelFormat::NONE || format == Texture2D::PixelFormat::AUTO) ? renderFormat : format;
+    unsigned char* outData = nullptr;
+    ssize_t outDataLen = 0;
+    pixels.format = Texture2D::convertDataToFormat(image->getData(), image->getDataLen(), renderFormat, requested, &outData, &outDataLen);
+    pixels.width = image->getWidth();
+    pixels.height = image->getHeight();
+    pixels.premultipliedAlpha = image->hasPremultipliedAlpha();
+    pixels.dataLen = outDataLen;
+    if (outData != image->getData())
+    {
+        Data data;
+        data.fastSet(outData, outDataLen);
+        pixels.storage.initWithData(std::move(data));
+        pixels.data = pixels.storage.getBytes();
+    }
+    else
+    {
+        pixels.data = outData;
+    }
+
+    uint64_t stamp = 0;
+    uint64_t sourceSize = 0;
+    if (pixels.data == nullptr || !getSourceStamp(fullPath, stamp, sourceSize))
+        return true;
+
+    CacheHeader header;
+    memcpy(header.magic, CACHE_MAGIC, sizeof(CACHE_MAGIC));
+    header.version = CACHE_VERSION;
+    header.requestedFormat = (uint32_t)format;
+    header.options = getCacheOptions();
+    header.pixelFormat = (uint32_t)pixels.format;
+    header.width = (uint32_t)pixels.width;
+    header.height = (uint32_t)pixels.height;
+    header.flags = pixels.premultipliedAlpha ? FLAG_PREMULTIPLIED_ALPHA : 0;
+    header.sourceStamp = stamp;
+    header.sourceSize = sourceSize;
+    header.dataLength = (uint64_t)pixels.dataLen;
+    header.storedLength = (uint64_t)pixels.dataLen;
+    header.pathLength = (uint32_t)fullPath.size();
+    // 16 bytes aligned pixels
+    header.dataOffset = (uint32_t)((sizeof(CacheHeader) + fullPath.size() + 15) & ~(size_t)15);
+
+    const unsigned char* stored = pixels.data;
+    Data compressed;
+    if (_compressionEnabled)
+    {
+        uLongf length = compressBound((uLong)pixels.dataLen);
+        unsigned char* buffer = (unsigned char*)malloc(length);
+        if (buffer != nullptr && compress2(buffer, &length, pixels.data, (uLong)pixels.dataLen, Z_BEST_SPEED) == Z_OK
+            && length < (uLongf)pixels.dataLen)
+        {
+            compressed.fastSet(buffer, length);
+            stored = buffer;
+            header.storedLength = length;
+            header.flags |= FLAG_COMPRESSED;
+        }
+        else
+        {
+            free(buffer);
+        }
+    }
+
+    const size_t fileSize = header.dataOffset + (size_t)header.storedLength;
+    if (fileSize > getSizeLimit())
+        return true;
+
+    unsigned char* buffer = (unsigned char*)calloc(fileSize, 1);
+    if (buffer == nullptr)
+        return true;
+    memcpy(buffer, &header, sizeof(header));
+    memcpy(buffer + sizeof(header), fullPath.data(), fullPath.size());
+    memcpy(buffer + header.dataOffset, stored, (size_t)header.storedLength);
+    Data file;
+    file.fastSet(buffer, fileSize);
+
+    // written aside and renamed, so the entries are never read half written
+    const std::string name = getEntryName(fullPath, format);
+    unsigned int tempId;
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        tempId = _tempCount++;
+    }
+    const std::string tempPath = StringUtils::format("%s%s.%u.tmp", _directory.c_str(), name.c_str(), tempId);
+    auto fileUtils = FileUtils::getInstance();
+    if (!fileUtils->writeDataToFile(file, tempPath))
+        return true;
+    if (!fileUtils->renameFile(tempPath, _directory + name))
+    {
+        fileUtils->removeFile(tempPath);
+        return true;
+    }
+
+    std::lock_guard<std::mutex> lock(_mutex);
+    auto it = _entries.find(name);
+    if (it != _entries.end())
+    {
+        _size -= it->second.size;
+        _order.erase(it->second.order);
+        _entries.erase(it);
+    }
+    Entry entry;
+    entry.order = _order.insert(_order.end(), name);
+    entry.size = fileSize;
+    _entries.emplace(name, entry);
+    _size += fileSize;
+    ++_stats.writes;
+    evictEntries(name);
+    saveIndex();
+    return true;
+}
+
+void TextureDiskCache::setSizeLimit(size_t bytes)
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    _sizeLimit = bytes;
+    if (_size > _sizeLimit)
+    {
+        evictEntries("");
+        saveIndex();
+    }
+}
+
+size_t TextureDiskCache::getSizeLimit() const
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _sizeLimit;
+}
+
+void TextureDiskCache::purge()
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    while (!_order.empty())
+    {
+        removeEntry(_order.front());
+    }
+    saveIndex();
+}
+
+TextureDiskCache::Stats TextureDiskCache::getStats() const
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    Stats stats = _stats;
+    stats.entries = (unsigned int)_entries.size();
+    stats.size = _size;
+    stats.sizeLimit = _sizeLimit;
+    return stats;
+}
+
+void TextureDiskCache::removeEntry(const std::string& name)
+{
+    auto it = _entries.find(name);
+    if (it == _entries.end())
+        return;
+
+    FileUtils::getInstance()->removeFile(_directory + name);
+    _size -= it->second.size;
+    _order.erase(it->second.order);
+    _entries.erase(it);
+}
+
+void TextureDiskCache::evictEntries(const std::string& keptName)
+{
+    auto it = _order.begin();
+    while (_size > _sizeLimit && it != _order.end())
+    {
+        if (*it == keptName)
+        {
+            ++it;
+            continue;
+        }
+        const std::string name = *it++;
+        removeEntry(name);
+        ++_stats.evictions;
+    }
+}
+
+void TextureDiskCache::loadIndex()
+{
+    // one "name size" line for each entry, the least recently used first
+    auto fileUtils = FileUtils::getInstance();
+    const std::string indexPath = _directory + INDEX_FILE;
+    if (!fileUtils->isFileExist(indexPath))
+        return;
+
+    std::istringstream index(fileUtils->getStringFromFile(indexPath));
+    std::string line;
+    if (!std::getline(index, line) || line != INDEX_HEADER)
+        return;
+
+    std::lock_guard<std::mutex> lock(_mutex);
+    std::string name;
+    size_t size;
+    while (index >> name >> size)
+    {
+        if (_entries.find(name) != _entries.end())
+            continue;
+        Entry entry;
+        entry.order = _order.insert(_order.end(), name);
+        entry.size = size;
+        _entries.emplace(name, entry);
+        _size += size;
+    }
+}
+
+void TextureDiskCache::saveIndex()
+{
+    std::string index = INDEX_HEADER;
+    index += '\n';
+    for (const auto& name : _order)
+    {
+        index += StringUtils::format("%s %lu\n", name.c_str(), (unsigned long)_entries[name].size);
+    }
+    FileUtils::getInstance()->writeStringToFile(index, _directory + INDEX_FILE);
+    _indexDirty = false;
+}
+
+NS_CC_END
@@ -0,0 +1,181 @@
+/****************************************************************************
+Copyright (c) 2017 Chukong Technologies Inc.
+
+http://www.cocos2d-x.org
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+****************************************************************************/
+
+#ifndef __CCTEXTURE_DISK_CACHE_H__
+#define __CCTEXTURE_DISK_CACHE_H__
+
+#include <atomic>
+#include <list>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+#include "renderer/CCTexture2D.h"
+#include "platform/CCFileView.h"
+
+NS_CC_BEGIN
+
+class Image;
+
+/**
+ * @addtogroup _2d
+ * @{
+ */
+
+/** @class TextureDiskCache
+ * @brief Keeps on disk the pixels of the images as they are uploaded to textures.
+ *
+ * The pixels are stored decoded, converted to the pixel format of the texture and premultiplied,
+ * so a texture can be uploaded straight from a mapped cache file the next time the image is loaded.
+ * The entries are keyed by the full path of the image, its modification time and size, and the pixel
+ * format requested. When the modification time isn't available, in the assets of an apk for example,
+ * a checksum of the file is used instead.
+ *
+ * Only the images decoded by Image (PNG, JPEG, TIFF, WebP and TGA) are cached, compressed texture formats
+ * are uploaded as they are already, and the 9-patch images need to be parsed.
+ * When the size of the files is over the limit, the entries used the least recently are removed.
+ *
+ * The methods can be called from any thread. Enable it with TextureCache::setDiskCacheEnabled().
+ * @js NA
+ * @lua NA
+ * @since v3.16
+ */
+class CC_DLL TextureDiskCache
+{
+public:
+    /** The pixels of a texture, as they are uploaded. */
+    struct Pixels
+    {
+        Pixels();
+
+        Texture2D::PixelFormat format;
+        int width;
+        int height;
+        bool premultipliedAlpha;
+        /** The pixels, in storage or in the image they were converted from. */
+        const unsigned char* data;
+        ssize_t dataLen;
+        /** The mapped cache file or the converted pixels, empty when data points into the image. */
+        FileView storage;
+    };
+
+    /** Counters of the cache, since it was created. */
+    struct Stats
+    {
+        unsigned int hits;
+        unsigned int misses;
+        unsigned int writes;
+        unsigned int evictions;
+        unsigned int entries;
+        size_t size;
+        size_t sizeLimit;
+    };
+
+    /** Creates the cache in a directory, which is created if needed.
+     *
+     * @param directory The full path of the directory, ending with a '/'.
+     */
+    explicit TextureDiskCache(const std::string& directory);
+    /** Saves the order of the entries. */
+    ~TextureDiskCache();
+
+    /** Whether an image file can be cached, from its name. */
+    static bool isCacheable(const std::string& fullPath);
+
+    /** Loads the pixels of an image converted before.
+     *
+     * @param fullPath The full path of the image.
+     * @param format The pixel format requested for the texture.
+     * @param pixels The pixels loaded.
+     * @return True if the image is in the cache and didn't change since.
+     */
+    bool load(const std::string& fullPath, Texture2D::PixelFormat format, Pixels& pixels);
+
+    /** Converts the pixels of a decoded image as Texture2D::initWithImage() does, and stores them.
+     *
+     * @param fullPath The full path of the image.
+     * @param format The pixel format requested for the texture.
+     * @param image The decoded image.
+     * @param pixels The converted pixels, which can point into the image.
+     * @return True if the pixels were converted, false if the image can't be cached.
+     * The pixels are returned even if they can't be written to the disk.
+     */
+    bool store(const std::string& fullPath, Texture2D::PixelFormat format, Image* image, Pixels& pixels);
+
+    /** Sets the maximum size of the files of the cache. Default is 64 MB. */
+    void setSizeLimit(size_t bytes);
+    /** Gets the maximum size of the files of the cache. */
+    size_t getSizeLimit() const;
+
+    /** Sets whether the pixels are compressed with zlib.
+     * The files are smaller, but they are inflated instead of mapped. Default is false.
+     */
+    void setCompressionEnabled(bool enabled) { _compressionEnabled = enabled; }
+    /** Whether the pixels are compressed with zlib. */
+    bool isCompressionEnabled() const { return _compressionEnabled; }
+
+    /** Removes all the entries. */
+    void purge();
+
+    /** Gets the counters of the cache. */
+    Stats getStats() const;
+
+    /** Gets the directory of the cache. */
+    const std::string& getDirectory() const { return _directory; }
+
+protected:
+    struct Entry
+    {
+        std::list<std::string>::iterator order;
+        size_t size;
+    };
+
+    // the file name of an entry
+    std::string getEntryName(const std::string& fullPath, Texture2D::PixelFormat format) const;
+    // the caller holds _mutex
+    void removeEntry(const std::string& name);
+    void evictEntries(const std::string& keptName);
+    void loadIndex();
+    void saveIndex();
+
+    std::string _directory;
+    std::atomic<bool> _compressionEnabled;
+
+    mutable std::mutex _mutex;
+    // least recently used first
+    std::list<std::string> _order;
+    std::unordered_map<std::string, Entry> _entries;
+    size_t _size;
+    size_t _sizeLimit;
+    bool _indexDirty;
+    unsigned int _tempCount;
+    Stats _stats;
+};
+
+// end of textures group
+/// @}
+
+NS_CC_END
+
+#endif //__CCTEXTURE_DISK_CACHE_H__
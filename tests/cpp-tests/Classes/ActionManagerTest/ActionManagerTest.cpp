@@ -1,6 +1,9 @@
 #include "ActionManagerTest.h"
 #include "../testResource.h"
 #include "cocos2d.h"
+#if CC_ENABLE_ALLOCATOR_DIAGNOSTICS
+#include "base/allocator/CCAllocatorDiagnostics.h"
+#endif
 
 USING_NS_CC;
 
@@ -21,6 +24,7 @@ ActionManagerTests::ActionManagerTests()
     ADD_TEST_CASE(StopActionsByFlagsTest);
     ADD_TEST_CASE(ResumeTest);
     ADD_TEST_CASE(Issue14050Test);
+    ADD_TEST_CASE(ActionPoolTest);
 }
 
 //------------------------------------------------------------------
@@ -378,3 +382,112 @@ std::string Issue14050Test::subtitle() const
 {
     return "Issue14050. Sprite should not leak.";
 }
+
+//------------------------------------------------------------------
+//
+// ActionPoolTest
+//
+//------------------------------------------------------------------
+#if CC_ENABLE_ACTION_POOL
+
+// a subclass without a pool of its own, its objects are bigger than the blocks of the pool of MoveBy
+class MoveByActionPoolTest : public MoveBy
+{
+public:
+    MoveByActionPoolTest()
+    {
+        memset(_padding, 0, sizeof(_padding));
+    }
+
+protected:
+    float _padding[8];
+};
+
+struct ActionPoolCounters
+{
+    int allocations;
+    int reused;
+    int fallback;
+};
+
+// reads the counters of the pool of an action from the allocator diagnostics
+static ActionPoolCounters getActionPoolCounters(const std::string& className)
+{
+    ActionPoolCounters counters = { 0, 0, 0 };
+#if CC_ENABLE_ALLOCATOR_DIAGNOSTICS
+    const std::string diagnostics = allocator::AllocatorDiagnostics::instance()->diagnostics();
+    const std::string tag = "cocos2d.x.action_pool." + className + " ";
+    auto start = diagnostics.find(tag);
+    if (start != std::string::npos)
+    {
+        const std::string line = diagnostics.substr(start, diagnostics.find('\n', start) - start);
+        auto allocations = line.find(" allocations:");
+        auto fallback = line.find(" fallback:");
+        if (allocations != std::string::npos && fallback != std::string::npos)
+        {
+            sscanf(line.c_str() + allocations, " allocations:%d reused:%d", &counters.allocations, &counters.reused);
+            sscanf(line.c_str() + fallback, " fallback:%d", &counters.fallback);
+        }
+    }
+#endif
+    return counters;
+}
+
+#endif // CC_ENABLE_ACTION_POOL
+
+void ActionPoolTest::onEnter()
+{
+    ActionManagerTest::onEnter();
+
+#if CC_ENABLE_ACTION_POOL
+    const ActionPoolCounters before = getActionPoolCounters("MoveBy");
+
+    // a released action gives its block back to the pool, the next one of the same type gets it
+    auto move = new (std::nothrow) MoveBy();
+    move->initWithDuration(1, Vec2(50, 0));
+    void* released = move;
+    move->release();
+
+    move = new (std::nothrow) MoveBy();
+    move->initWithDuration(1, Vec2(50, 0));
+    CCASSERT(move == released, "The memory of a released MoveBy should be reused by the next one");
+
+    // clones are pooled too, they are released with the autorelease pool,
+    // and a subclass falls back to the global allocator
+    move->clone();
+    auto subclass = new (std::nothrow) MoveByActionPoolTest();
+    subclass->initWithDuration(1, Vec2(0, 50));
+    subclass->release();
+
+    // and created again after being released
+    subclass = new (std::nothrow) MoveByActionPoolTest();
+    subclass->initWithDuration(1, Vec2(0, 50));
+
+    // the actions run as usual
+    auto grossini = Sprite::create(s_pathGrossini);
+    addChild(grossini, 0, kTagGrossini);
+    grossini->setPosition(VisibleRect::center());
+    grossini->runAction(Sequence::create(move, subclass, move->reverse(), subclass->reverse(), nullptr));
+    move->release();
+    subclass->release();
+
+#if CC_ENABLE_ALLOCATOR_DIAGNOSTICS
+    const ActionPoolCounters after = getActionPoolCounters("MoveBy");
+    log("ActionPoolTest: MoveBy allocations:%d reused:%d fallback:%d", after.allocations - before.allocations,
+        after.reused - before.reused, after.fallback - before.fallback);
+    // 2 moves, the clone and the 2 reversed moves, the reverse of the subclass is a MoveBy
+    CCASSERT(after.allocations - before.allocations == 5, "The pooled MoveBy should be counted");
+    CCASSERT(after.reused - before.reused >= 1, "The reused blocks should be counted");
+    CCASSERT(after.fallback - before.fallback == 2, "The subclasses should fall back to the global allocator");
+#endif
+#endif // CC_ENABLE_ACTION_POOL
+}
+
+std::string ActionPoolTest::subtitle() const
+{
+#if CC_ENABLE_ACTION_POOL
+    return "Pooled actions are recycled. See console";
+#else
+    return "Build with CC_ENABLE_ACTION_POOL (USE_ACTION_POOL in CMake)";
+#endif
+}
@@ -105,4 +105,13 @@ public:
 protected:
 };
 
+class ActionPoolTest : public ActionManagerTest
+{
+public:
+    CREATE_FUNC(ActionPoolTest);
+
+    virtual std::string subtitle() const override;
+    virtual void onEnter() override;
+};
+
 #endif
@@ -14,6 +14,9 @@ FileUtilsTests::FileUtilsTests()
     ADD_TEST_CASE(TextWritePlist);
     ADD_TEST_CASE(TestWriteString);
     ADD_TEST_CASE(TestGetContents);
+    ADD_TEST_CASE(TestGetFileRange);
+    ADD_TEST_CASE(TestGetFileViewOverriddenContents);
+    ADD_TEST_CASE(TestZipFile);
     ADD_TEST_CASE(TestWriteData);
     ADD_TEST_CASE(TestWriteValueMap);
     ADD_TEST_CASE(TestWriteValueVector);
@@ -745,6 +748,302 @@ std::string TestGetContents::subtitle() const
     return "";
 }
 
+// TestGetFileRange
+
+void TestGetFileRange::onEnter()
+{
+    FileUtilsDemo::onEnter();
+    auto fs = FileUtils::getInstance();
+
+    auto winSize = Director::getInstance()->getWinSize();
+
+    auto readResult = Label::createWithTTF("show readResult", "fonts/Thonburi.ttf", 16);
+    this->addChild(readResult);
+    readResult->setPosition(winSize.width / 2, winSize.height / 2);
+
+    std::vector<char> binary = {'0','1','2','3','\0','\r','\n','7','8','9'};
+    _generatedFile = fs->getWritablePath() + "file-range-test";
+    saveAsBinaryText(_generatedFile, binary);
+
+    auto runTests = [&]() {
+        struct Range { size_t offset; size_t size; FileUtils::Status status; size_t readSize; };
+        Range ranges[] = {
+            { 0, binary.size(), FileUtils::Status::OK, binary.size() },
+            { 3, 4, FileUtils::Status::OK, 4 },
+            { 8, 5, FileUtils::Status::ReadFailed, 2 },
+            { binary.size(), 1, FileUtils::Status::ReadFailed, 0 },
+            { binary.size() + 10, 1, FileUtils::Status::ReadFailed, 0 },
+        };
+        for (auto& range : ranges) {
+            std::string sbuf;
+            auto serr = fs->getFileRange(_generatedFile, range.offset, range.size, &sbuf);
+            if (serr != range.status)
+                return StringUtils::format("failed: range %d+%d: error: %s", (int)range.offset, (int)range.size, FileErrors[(int)serr].c_str());
+            if (sbuf.size() != range.readSize || !std::equal(sbuf.begin(), sbuf.end(), binary.begin() + range.offset))
+                return StringUtils::format("failed: range %d+%d: wrong contents", (int)range.offset, (int)range.size);
+
+            Data dbuf;
+            fs->getFileRange(_generatedFile, range.offset, range.size, &dbuf);
+            if (dbuf.getSize() != (ssize_t)sbuf.size() || memcmp(dbuf.getBytes(), sbuf.data(), sbuf.size()) != 0)
+                return StringUtils::format("failed: range %d+%d: sbuf != dbuf", (int)range.offset, (int)range.size);
+        }
+
+        std::string missing;
+        if (fs->getFileRange("not-existing-file", 0, 1, &missing) != FileUtils::Status::NotExists)
+            return std::string("failed: a missing file exists");
+
+        // the view of the whole file holds the same bytes as getContents
+        Data contents;
+        fs->getContents("fileLookup.plist", &contents);
+        FileView view = fs->getFileView("fileLookup.plist");
+        if (view.isNull() || view.getSize() != contents.getSize() || memcmp(view.getBytes(), contents.getBytes(), contents.getSize()) != 0)
+            return std::string("failed: getFileView != getContents");
+
+        return std::string("read success");
+    };
+    auto result = runTests();
+    log("FileUtils::getFileRange() %s", result.c_str());
+    CCASSERT(result == "read success", "getFileRange or getFileView read wrong bytes");
+    readResult->setString("FileUtils::getFileRange() " + result);
+}
+
+void TestGetFileRange::onExit()
+{
+    if (!_generatedFile.empty())
+        FileUtils::getInstance()->removeFile(_generatedFile);
+
+    FileUtilsDemo::onExit();
+}
+
+std::string TestGetFileRange::title() const
+{
+    return "FileUtils: TestGetFileRange";
+}
+
+std::string TestGetFileRange::subtitle() const
+{
+    return "Reads parts of a file";
+}
+
+// TestGetFileViewOverriddenContents
+
+namespace
+{
+    // Returns the files "decrypted", like the FileUtils delegates of games which encrypt their resources.
+    class XorFileUtils : public FileUtils
+    {
+    public:
+        static const unsigned char KEY = 0x5a;
+
+        virtual Status getContents(const std::string& filename, ResizableBuffer* buffer) override
+        {
+            Data data;
+            Status status = FileUtils::getInstance()->getContents(filename, &data);
+            if (status != Status::OK)
+                return status;
+            buffer->resize(data.getSize());
+            auto bytes = static_cast<unsigned char*>(buffer->buffer());
+            for (ssize_t i = 0; i < data.getSize(); ++i)
+                bytes[i] = data.getBytes()[i] ^ KEY;
+            return Status::OK;
+        }
+
+        virtual std::string fullPathForFilename(const std::string& filename) const override
+        {
+            return FileUtils::getInstance()->fullPathForFilename(filename);
+        }
+
+        virtual std::string getWritablePath() const override
+        {
+            return FileUtils::getInstance()->getWritablePath();
+        }
+
+    protected:
+        virtual bool isFileExistInternal(const std::string& filename) const override
+        {
+            return FileUtils::getInstance()->isFileExist(filename);
+        }
+    };
+}
+
+void TestGetFileViewOverriddenContents::onEnter()
+{
+    FileUtilsDemo::onEnter();
+    auto fs = FileUtils::getInstance();
+
+    auto winSize = Director::getInstance()->getWinSize();
+
+    auto readResult = Label::createWithTTF("show readResult", "fonts/Thonburi.ttf", 16);
+    this->addChild(readResult);
+    readResult->setPosition(winSize.width / 2, winSize.height / 2);
+
+    std::vector<char> binary = {'e','n','c','r','y','p','t','e','d','\0','\n'};
+    _generatedFile = fs->getWritablePath() + "file-view-overridden-contents";
+    saveAsBinaryText(_generatedFile, binary);
+
+    auto runTests = [&]() {
+        XorFileUtils xorFileUtils;
+        if (xorFileUtils.isDirectFileAccessEnabled())
+            return std::string("failed: direct file access is enabled for a FileUtils subclass");
+
+        std::string decrypted;
+        for (auto c : binary)
+            decrypted.push_back(c ^ XorFileUtils::KEY);
+
+        FileView view = xorFileUtils.getFileView(_generatedFile);
+        if (view.isNull() || view.getSize() != (ssize_t)decrypted.size() || memcmp(view.getBytes(), decrypted.data(), decrypted.size()) != 0)
+            return std::string("failed: getFileView didn't go through getContents");
+
+        std::string range;
+        if (xorFileUtils.getFileRange(_generatedFile, 2, 5, &range) != FileUtils::Status::OK || range != decrypted.substr(2, 5))
+            return std::string("failed: getFileRange didn't go through getContents");
+
+        range.clear();
+        if (xorFileUtils.getFileRange(_generatedFile, 9, 5, &range) != FileUtils::Status::ReadFailed || range != decrypted.substr(9))
+            return std::string("failed: getFileRange past the end of the file");
+
+        // opting in reads the files as they are
+        xorFileUtils.setDirectFileAccessEnabled(true);
+        view = xorFileUtils.getFileView(_generatedFile);
+        if (view.isNull() || view.getSize() != (ssize_t)binary.size() || memcmp(view.getBytes(), binary.data(), binary.size()) != 0)
+            return std::string("failed: getFileView with direct file access");
+
+        return std::string("read success");
+    };
+    auto result = runTests();
+    log("FileUtils::getFileView() %s", result.c_str());
+    CCASSERT(result == "read success", "getFileView or getFileRange bypassed getContents");
+    readResult->setString("FileUtils::getFileView() " + result);
+}
+
+void TestGetFileViewOverriddenContents::onExit()
+{
+    if (!_generatedFile.empty())
+        FileUtils::getInstance()->removeFile(_generatedFile);
+
+    FileUtilsDemo::onExit();
+}
+
+std::string TestGetFileViewOverriddenContents::title() const
+{
+    return "FileUtils: getFileView of a subclass";
+}
+
+std::string TestGetFileViewOverriddenContents::subtitle() const
+{
+    return "The subclass overrides getContents";
+}
+
+// TestZipFile
+
+void TestZipFile::onEnter()
+{
+    FileUtilsDemo::onEnter();
+    auto fs = FileUtils::getInstance();
+
+    auto winSize = Director::getInstance()->getWinSize();
+
+    auto readResult = Label::createWithTTF("show readResult", "fonts/Thonburi.ttf", 16);
+    this->addChild(readResult);
+    readResult->setPosition(winSize.width / 2, winSize.height / 2);
+
+    struct ZipTestFile { std::string name; std::string contents; };
+
+    // checks every way to read the files, the stored ones are mapped when the archive is
+    auto checkFiles = [](ZipFile& zip, const std::vector<ZipTestFile>& files) {
+        for (auto& file : files) {
+            if (!zip.fileExists(file.name))
+                return "failed: " + file.name + " doesn't exist";
+
+            ssize_t size = 0;
+            unsigned char* bytes = zip.getFileData(file.name, &size);
+            bool sameBytes = bytes && size == (ssize_t)file.contents.size() && memcmp(bytes, file.contents.data(), size) == 0;
+            free(bytes);
+            if (!sameBytes)
+                return "failed: getFileData(" + file.name + ", size)";
+
+            std::string sbuf;
+            ResizableBufferAdapter<std::string> buffer(&sbuf);
+            if (!zip.getFileData(file.name, &buffer) || sbuf != file.contents)
+                return "failed: getFileData(" + file.name + ", buffer)";
+
+            FileView view = zip.getFileView(file.name);
+            if (view.isNull() || view.getSize() != (ssize_t)file.contents.size() || memcmp(view.getBytes(), file.contents.data(), file.contents.size()) != 0)
+                return "failed: getFileView(" + file.name + ")";
+            log("ZipFile: %s read, view %s", file.name.c_str(), view.isMapped() ? "mapped" : "copied");
+        }
+        return std::string();
+    };
+
+    auto runTests = [&]() {
+        ZipFile zip(fs->fullPathForFilename("ZipFileTest/files.zip"));
+
+        // the files are listed in the order of the archive, the duplicate name too
+        std::vector<std::string> names;
+        for (auto name = zip.getFirstFilename(); !name.empty(); name = zip.getNextFilename())
+            names.push_back(name);
+        std::vector<std::string> archiveOrder = {"textures/b.txt", "a.txt", "textures/a.txt", "a.txt", "textures.txt", "empty.txt"};
+        if (names != archiveOrder)
+            return std::string("failed: getFirstFilename / getNextFilename order");
+
+        std::string deflated;
+        for (int i = 0; i < 20; ++i)
+            deflated += "deflated b ";
+
+        // the last of the files with the same name is read
+        std::string error = checkFiles(zip, {
+            {"textures/b.txt", deflated},
+            {"a.txt", "last a"},
+            {"textures/a.txt", "stored textures a"},
+            {"textures.txt", "not in textures/"},
+        });
+        if (!error.empty())
+            return error;
+
+        if (zip.fileExists("missing.txt") || zip.fileExists("textures") || !zip.getFileView("missing.txt").isNull())
+            return std::string("failed: a missing file exists");
+
+        // only the names starting with the filter are found
+        zip.setFilter("textures/");
+        if (zip.fileExists("a.txt") || zip.fileExists("textures.txt") || zip.fileExists("empty.txt"))
+            return std::string("failed: a file out of the filter exists");
+        ssize_t size = 0;
+        if (zip.getFileData("a.txt", &size) != nullptr || size != 0)
+            return std::string("failed: a file out of the filter was read");
+        error = checkFiles(zip, {{"textures/a.txt", "stored textures a"}, {"textures/b.txt", deflated}});
+        if (!error.empty())
+            return "filter " + error;
+
+        // the sizes and offsets of the central directory are in the zip64 records and extra fields
+        std::string zip64Deflated;
+        for (int i = 0; i < 10; ++i)
+            zip64Deflated += "deflated in a zip64 archive ";
+        ZipFile zip64(fs->fullPathForFilename("ZipFileTest/zip64.zip"));
+        error = checkFiles(zip64, {
+            {"zip64/stored.txt", "stored in a zip64 archive"},
+            {"zip64/deflated.txt", zip64Deflated},
+        });
+        if (!error.empty())
+            return "zip64 " + error;
+
+        return std::string("read success");
+    };
+    auto result = runTests();
+    log("ZipFile: %s", result.c_str());
+    CCASSERT(result == "read success", "ZipFile read wrong files");
+    readResult->setString("ZipFile: " + result);
+}
+
+std::string TestZipFile::title() const
+{
+    return "ZipFile: read files";
+}
+
+std::string TestZipFile::subtitle() const
+{
+    return "Stored, deflated, filtered and zip64 files, see console";
+}
+
 void TestWriteData::onEnter()
 {
     FileUtilsDemo::onEnter();
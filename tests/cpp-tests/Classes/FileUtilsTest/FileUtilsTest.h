@@ -126,6 +126,42 @@ private:
     std::string _generatedFile;
 };
 
+class TestGetFileRange : public FileUtilsDemo
+{
+public:
+    CREATE_FUNC(TestGetFileRange);
+
+    virtual void onEnter() override;
+    virtual void onExit() override;
+    virtual std::string title() const override;
+    virtual std::string subtitle() const override;
+private:
+    std::string _generatedFile;
+};
+
+class TestGetFileViewOverriddenContents : public FileUtilsDemo
+{
+public:
+    CREATE_FUNC(TestGetFileViewOverriddenContents);
+
+    virtual void onEnter() override;
+    virtual void onExit() override;
+    virtual std::string title() const override;
+    virtual std::string subtitle() const override;
+private:
+    std::string _generatedFile;
+};
+
+class TestZipFile : public FileUtilsDemo
+{
+public:
+    CREATE_FUNC(TestZipFile);
+
+    virtual void onEnter() override;
+    virtual std::string title() const override;
+    virtual std::string subtitle() const override;
+};
+
 class TestWriteData : public FileUtilsDemo
 {
 public:
@@ -32,6 +32,7 @@ EventDispatcherTests::EventDispatcherTests()
     ADD_TEST_CASE(WindowEventsTest);
     ADD_TEST_CASE(Issue8194);
     ADD_TEST_CASE(Issue9898)
+    ADD_TEST_CASE(SceneGraphPriorityOrderTest);
 }
 
 std::string EventDispatcherTestDemo::title() const
@@ -1510,3 +1511,150 @@ std::string Issue9898::subtitle() const
 {
     return  "Should not crash if dispatch event after remove\n event listener in callback";
 }
+
+// SceneGraphPriorityOrderTest
+
+static const char* SCENE_GRAPH_PRIORITY_ORDER_EVENT = "SceneGraphPriorityOrderTest";
+
+// Lists the nodes in the order visit() draws them
+static void collectDrawOrder(Node* node, std::vector<Node*>& order)
+{
+    static const Vector<Node*> noChildren;
+
+    auto protectedNode = dynamic_cast<ProtectedNode*>(node);
+    node->sortAllChildren();
+    if (protectedNode)
+        protectedNode->sortAllProtectedChildren();
+
+    const auto& children = node->getChildren();
+    const auto& protectedChildren = protectedNode ? protectedNode->getProtectedChildren() : noChildren;
+    ssize_t i = 0;
+    ssize_t j = 0;
+    for (; i < children.size() && children.at(i)->getLocalZOrder() < 0; ++i)
+        collectDrawOrder(children.at(i), order);
+    for (; j < protectedChildren.size() && protectedChildren.at(j)->getLocalZOrder() < 0; ++j)
+        collectDrawOrder(protectedChildren.at(j), order);
+    order.push_back(node);
+    for (; j < protectedChildren.size(); ++j)
+        collectDrawOrder(protectedChildren.at(j), order);
+    for (; i < children.size(); ++i)
+        collectDrawOrder(children.at(i), order);
+}
+
+void SceneGraphPriorityOrderTest::addListenerNode(Node* parent, Node* node, int localZOrder, bool isProtected)
+{
+    if (isProtected)
+        static_cast<ProtectedNode*>(parent)->addProtectedChild(node, localZOrder);
+    else
+        parent->addChild(node, localZOrder);
+
+    auto listener = EventListenerCustom::create(SCENE_GRAPH_PRIORITY_ORDER_EVENT, [this](EventCustom* event){
+        _dispatchOrder.push_back(event->getCurrentTarget());
+    });
+    _eventDispatcher->addEventListenerWithSceneGraphPriority(listener, node);
+    _listenerNodes.push_back(node);
+}
+
+void SceneGraphPriorityOrderTest::checkOrder(const std::string& step)
+{
+    // The listeners are called from the node drawn last to the node drawn first, the nodes with a higher global Z order are drawn last
+    std::vector<Node*> drawOrder;
+    collectDrawOrder(Director::getInstance()->getRunningScene(), drawOrder);
+    std::stable_sort(drawOrder.begin(), drawOrder.end(), [](const Node* n1, const Node* n2) {
+        return n1->getGlobalZOrder() < n2->getGlobalZOrder();
+    });
+
+    std::vector<Node*> expectedOrder;
+    for (auto it = drawOrder.rbegin(); it != drawOrder.rend(); ++it)
+    {
+        if (std::find(_listenerNodes.begin(), _listenerNodes.end(), *it) != _listenerNodes.end())
+            expectedOrder.push_back(*it);
+    }
+
+    _dispatchOrder.clear();
+    _eventDispatcher->dispatchCustomEvent(SCENE_GRAPH_PRIORITY_ORDER_EVENT);
+
+    bool sameOrder = (_dispatchOrder == expectedOrder);
+    log("SceneGraphPriorityOrderTest: %s: %s", step.c_str(), sameOrder ? "same order" : "different order");
+    CCASSERT(sameOrder, "The listeners should be sorted in the order the scene graph is drawn");
+}
+
+void SceneGraphPriorityOrderTest::onEnter()
+{
+    EventDispatcherTestDemo::onEnter();
+
+    _listenerNodes.clear();
+
+    // A node of every draw group: children and protected children with negative and positive local Z orders,
+    // a protected node nested in the protected children of another
+    auto root = Node::create();
+    addListenerNode(this, root, 0, false);
+
+    auto container = ProtectedNode::create();
+    addListenerNode(root, container, 1, false);
+    auto negativeChild = Node::create();
+    addListenerNode(container, negativeChild, -1, false);
+    auto child = Node::create();
+    addListenerNode(container, child, 1, false);
+    auto negativeProtectedChild = Node::create();
+    addListenerNode(container, negativeProtectedChild, -1, true);
+    auto protectedChild = Node::create();
+    addListenerNode(container, protectedChild, 0, true);
+
+    auto nestedContainer = ProtectedNode::create();
+    addListenerNode(container, nestedContainer, 2, true);
+    auto nestedChild = Node::create();
+    addListenerNode(nestedContainer, nestedChild, 0, false);
+    auto nestedProtectedChild = Node::create();
+    addListenerNode(nestedContainer, nestedProtectedChild, -2, true);
+    auto nestedLeaf = Node::create();
+    addListenerNode(nestedProtectedChild, nestedLeaf, 0, false);
+
+    auto sibling = Node::create();
+    addListenerNode(root, sibling, 0, false);
+    auto siblingChild = Node::create();
+    addListenerNode(sibling, siblingChild, 0, false);
+
+    scheduleOnce([=](float) {
+        checkOrder("initial order");
+
+        // the sorted priorities are only updated for the nodes set dirty below
+        negativeProtectedChild->setLocalZOrder(3);
+        checkOrder("protected child reordered by setLocalZOrder");
+
+        container->reorderProtectedChild(protectedChild, -2);
+        checkOrder("protected child reordered by reorderProtectedChild");
+
+        root->reorderChild(container, -1);
+        checkOrder("ancestor of protected children reordered");
+
+        container->reorderProtectedChild(nestedContainer, -5);
+        checkOrder("protected node nested in protected children reordered");
+
+        nestedLeaf->setGlobalZOrder(1);
+        checkOrder("global Z order of a node under protected children changed");
+
+        nestedContainer->setGlobalZOrder(-1);
+        nestedLeaf->setGlobalZOrder(0);
+        checkOrder("global Z orders changed back");
+
+        nestedChild->retain();
+        nestedContainer->removeChild(nestedChild, false);
+        sibling->addChild(nestedChild, -1);
+        nestedChild->release();
+        checkOrder("child moved to another parent");
+
+        root->reorderChild(sibling, -2);
+        checkOrder("parent of the moved child reordered");
+    }, 0, "checkOrder");
+}
+
+std::string SceneGraphPriorityOrderTest::title() const
+{
+    return "Scene graph priority order";
+}
+
+std::string SceneGraphPriorityOrderTest::subtitle() const
+{
+    return "Listeners are sorted like the scene graph is drawn\nafter reorders, see console";
+}
@@ -254,4 +254,21 @@ private:
     cocos2d::EventListenerCustom* _listener;
 };
 
+class SceneGraphPriorityOrderTest : public EventDispatcherTestDemo
+{
+public:
+    CREATE_FUNC(SceneGraphPriorityOrderTest);
+
+    virtual void onEnter() override;
+    virtual std::string title() const override;
+    virtual std::string subtitle() const override;
+
+private:
+    void addListenerNode(cocos2d::Node* parent, cocos2d::Node* node, int localZOrder, bool isProtected);
+    void checkOrder(const std::string& step);
+
+    std::vector<cocos2d::Node*> _listenerNodes;
+    std::vector<cocos2d::Node*> _dispatchOrder;
+};
+
 #endif /* defined(__samples__NewEventDispatcherTest__) */
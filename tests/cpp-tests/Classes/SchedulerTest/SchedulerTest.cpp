@@ -33,6 +33,7 @@ SchedulerTests::SchedulerTests()
     ADD_TEST_CASE(SchedulerIssue17149);
     ADD_TEST_CASE(SchedulerRemoveEntryWhileUpdate);
     ADD_TEST_CASE(SchedulerRemoveSelectorDuringCall);
+    ADD_TEST_CASE(SchedulerScheduleOnPausedTarget);
 };
 
 //------------------------------------------------------------------
@@ -1414,3 +1415,62 @@ void SchedulerRemoveSelectorDuringCall::callback( float )
     scheduler->unschedule
       (SEL_SCHEDULE(&SchedulerRemoveSelectorDuringCall::callback), this);
 }
+
+//------------------------------------------------------------------
+//
+// SchedulerScheduleOnPausedTarget
+//
+//------------------------------------------------------------------
+
+std::string SchedulerScheduleOnPausedTarget::title() const
+{
+    return "Schedule on a paused target";
+}
+
+std::string SchedulerScheduleOnPausedTarget::subtitle() const
+{
+    return "see console, the timer must fire 0.6s after the resume";
+}
+
+void SchedulerScheduleOnPausedTarget::onEnter()
+{
+    SchedulerTestLayer::onEnter();
+
+    // a scheduler of its own, stepped by hand
+    auto scheduler = new (std::nothrow) Scheduler();
+    auto target = Node::create();
+    const float step = 0.1f;
+
+    // the target is paused before the timer exists
+    scheduler->schedule([](float) {}, target, 10, true, "other");
+    for (int i = 0; i < 10; ++i)
+    {
+        scheduler->update(step);
+    }
+
+    float elapsed = 0;
+    float firedAt = -1;
+    scheduler->schedule([&](float) {
+        if (firedAt < 0)
+            firedAt = elapsed;
+    }, target, 0.5f, true, "timer");
+
+    // the pause doesn't count for a timer scheduled during it
+    for (int i = 0; i < 10; ++i)
+    {
+        scheduler->update(step);
+    }
+    scheduler->resumeTarget(target);
+    for (int i = 0; i < 20 && firedAt < 0; ++i)
+    {
+        elapsed += step;
+        scheduler->update(step);
+    }
+
+    scheduler->unscheduleAllForTarget(target);
+    scheduler->release();
+
+    // the first update after the resume starts counting, as for a timer scheduled on a running target
+    CCASSERT(firedAt > 0.5f - step / 2 && firedAt < 0.5f + step * 1.5f, "the timer must fire 0.5s after the first update after the resume");
+    cocos2d::log("SchedulerScheduleOnPausedTarget: fired %.2fs after the resume, expected 0.60s", firedAt);
+}
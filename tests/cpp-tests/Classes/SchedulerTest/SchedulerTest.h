@@ -422,4 +422,14 @@ private:
     bool _scheduled;
 };
 
+class SchedulerScheduleOnPausedTarget : public SchedulerTestLayer
+{
+public:
+    CREATE_FUNC(SchedulerScheduleOnPausedTarget);
+
+    virtual std::string title() const override;
+    virtual std::string subtitle() const override;
+    virtual void onEnter() override;
+};
+
 #endif
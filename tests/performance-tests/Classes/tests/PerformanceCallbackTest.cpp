@@ -40,6 +40,10 @@ PerformceCallbackTests::PerformceCallbackTests()
     ADD_TEST_CASE(SimulateNewSchedulerCallbackPerfTest);
     ADD_TEST_CASE(InvokeMemberFunctionPerfTest);
     ADD_TEST_CASE(InvokeStdFunctionPerfTest);
+    ADD_TEST_CASE(SchedulerUpdatePerfTest);
+    ADD_TEST_CASE(SchedulerUpdateChurnPerfTest);
+    ADD_TEST_CASE(SchedulerTimerPerfTest);
+    ADD_TEST_CASE(SchedulerPerformFunctionPerfTest);
 }
 
 ////////////////////////////////////////////////////////
@@ -183,3 +187,143 @@ void InvokeStdFunctionPerfTest::onUpdate(float dt)
     }
     CC_PROFILER_STOP(_profileName.c_str());
 }
+
+// SchedulerUpdatePerfTest
+
+SchedulerUpdatePerfTest::SchedulerUpdatePerfTest()
+: _scheduler(new (std::nothrow) Scheduler())
+, _churn(false)
+, _frame(0)
+{
+}
+
+SchedulerUpdatePerfTest::~SchedulerUpdatePerfTest()
+{
+    _scheduler->unscheduleAll();
+    CC_SAFE_RELEASE(_scheduler);
+}
+
+void SchedulerUpdatePerfTest::onEnter()
+{
+    PerformanceCallbackScene::onEnter();
+    _profileName = "SchedulerUpdate";
+    
+    for (int i = 0; i < LOOP_COUNT; ++i)
+    {
+        auto target = new (std::nothrow) Target();
+        _targets.pushBack(target);
+        target->release();
+        scheduleTarget(target, i);
+    }
+}
+
+void SchedulerUpdatePerfTest::scheduleTarget(Target* target, int index)
+{
+    // a few system and late updates around the default priority
+    _scheduler->scheduleUpdate(target, index % 16 == 0 ? -1 : (index % 16 == 1 ? 1 : 0), false);
+}
+
+void SchedulerUpdatePerfTest::unscheduleTarget(Target* target, int index)
+{
+    _scheduler->unscheduleUpdate(target);
+}
+
+std::string SchedulerUpdatePerfTest::title() const
+{
+    return "Scheduler::update with scheduleUpdate";
+}
+
+std::string SchedulerUpdatePerfTest::subtitle() const
+{
+    return "10000 targets. See console";
+}
+
+void SchedulerUpdatePerfTest::onUpdate(float dt)
+{
+    if (_churn)
+    {
+        // every frame 1% of the targets are unscheduled and scheduled again
+        const int churnCount = LOOP_COUNT / 100;
+        for (int i = 0; i < churnCount; ++i)
+        {
+            int index = (_frame * churnCount + i) % LOOP_COUNT;
+            unscheduleTarget(_targets.at(index), index);
+            scheduleTarget(_targets.at(index), index);
+        }
+        ++_frame;
+    }
+    
+    CC_PROFILER_START(_profileName.c_str());
+    _scheduler->update(dt);
+    CC_PROFILER_STOP(_profileName.c_str());
+}
+
+// SchedulerUpdateChurnPerfTest
+
+void SchedulerUpdateChurnPerfTest::onEnter()
+{
+    SchedulerUpdatePerfTest::onEnter();
+    _profileName = "SchedulerUpdateChurn";
+}
+
+std::string SchedulerUpdateChurnPerfTest::title() const
+{
+    return "Scheduler::update, 1% rescheduled per frame";
+}
+
+// SchedulerTimerPerfTest
+
+void SchedulerTimerPerfTest::onEnter()
+{
+    SchedulerUpdatePerfTest::onEnter();
+    _profileName = "SchedulerTimer";
+}
+
+void SchedulerTimerPerfTest::scheduleTarget(Target* target, int index)
+{
+    _scheduler->schedule([target](float dt){
+        target->update(dt);
+    }, target, 0, false, "update");
+}
+
+void SchedulerTimerPerfTest::unscheduleTarget(Target* target, int index)
+{
+    _scheduler->unschedule("update", target);
+}
+
+std::string SchedulerTimerPerfTest::title() const
+{
+    return "Scheduler::update with schedule(callback, 0)";
+}
+
+// SchedulerPerformFunctionPerfTest
+
+void SchedulerPerformFunctionPerfTest::onEnter()
+{
+    SchedulerUpdatePerfTest::onEnter();
+    _profileName = "SchedulerPerformFunction";
+}
+
+std::string SchedulerPerformFunctionPerfTest::title() const
+{
+    return "Scheduler::performFunctionInCocosThread";
+}
+
+std::string SchedulerPerformFunctionPerfTest::subtitle() const
+{
+    return "10000 functions queued and performed per frame. See console";
+}
+
+void SchedulerPerformFunctionPerfTest::onUpdate(float dt)
+{
+    CC_PROFILER_START(_profileName.c_str());
+    for (int i = 0; i < LOOP_COUNT; ++i)
+    {
+        Target* target = _targets.at(i);
+        _scheduler->performFunctionInCocosThread([target, dt](){
+            target->update(dt);
+        });
+    }
+    _scheduler->update(dt);
+    CC_PROFILER_STOP(_profileName.c_str());
+}
@@ -90,4 +90,79 @@ private:
     std::function<void(float)> _callback;
 };
 
+// SchedulerUpdatePerfTest
+class SchedulerUpdatePerfTest : public PerformanceCallbackScene
+{
+public:
+    CREATE_FUNC(SchedulerUpdatePerfTest);
+    
+    SchedulerUpdatePerfTest();
+    virtual ~SchedulerUpdatePerfTest();
+    
+    // overrides
+    virtual void onEnter() override;
+    virtual std::string title() const override;
+    virtual std::string subtitle() const override;
+    virtual void onUpdate(float dt) override;
+    
+    // A target with an 'update' method, scheduled LOOP_COUNT times on _scheduler
+    class Target : public cocos2d::Ref
+    {
+    public:
+        void update(float dt) { ++_updateCount; }
+        int _updateCount = 0;
+    };
+    
+protected:
+    virtual void scheduleTarget(Target* target, int index);
+    virtual void unscheduleTarget(Target* target, int index);
+    
+    cocos2d::Scheduler* _scheduler;
+    cocos2d::Vector<Target*> _targets;
+    bool _churn;
+    int _frame;
+};
+
+// SchedulerUpdateChurnPerfTest
+class SchedulerUpdateChurnPerfTest : public SchedulerUpdatePerfTest
+{
+public:
+    CREATE_FUNC(SchedulerUpdateChurnPerfTest);
+    
+    SchedulerUpdateChurnPerfTest() { _churn = true; }
+    
+    virtual void onEnter() override;
+    virtual std::string title() const override;
+};
+
+// SchedulerTimerPerfTest
+class SchedulerTimerPerfTest : public SchedulerUpdatePerfTest
+{
+public:
+    CREATE_FUNC(SchedulerTimerPerfTest);
+    
+    virtual void onEnter() override;
+    virtual std::string title() const override;
+    
+protected:
+    virtual void scheduleTarget(Target* target, int index) override;
+    virtual void unscheduleTarget(Target* target, int index) override;
+};
+
+// SchedulerPerformFunctionPerfTest
+class SchedulerPerformFunctionPerfTest : public SchedulerUpdatePerfTest
+{
+public:
+    CREATE_FUNC(SchedulerPerformFunctionPerfTest);
+    
+    virtual void onEnter() override;
+    virtual std::string title() const override;
+    virtual std::string subtitle() const override;
+    virtual void onUpdate(float dt) override;
+    
+protected:
+    virtual void scheduleTarget(Target* target, int index) override {}
+    virtual void unscheduleTarget(Target* target, int index) override {}
+};
+
 #endif /* __PERFORMANCE_CALLBACK_TEST_H__ */
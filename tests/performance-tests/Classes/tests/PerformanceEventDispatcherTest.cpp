@@ -4,6 +4,8 @@
 
 #include "PerformanceEventDispatcherTest.h"
 #include <algorithm>
+#include <array>
+#include <memory>
 #include "Profile.h"
 
 USING_NS_CC;
@@ -362,6 +364,58 @@ const char*  PerformanceEventDispatcherScene::testName()
 
 void TouchEventDispatchingPerfTest::generateTestFunctions()
 {
+    // buttons spread over the screen, each testing whether the touch hits it
+    auto buttonsTest = [=](bool boundsCulling){
+        auto dispatcher = Director::getInstance()->getEventDispatcher();
+        Size size = Director::getInstance()->getWinSize();
+        if (quantityOfNodes != _lastRenderedCount)
+        {
+            auto listener = EventListenerTouchOneByOne::create();
+            listener->onTouchBegan = [](Touch* touch, Event* event){
+                auto target = event->getCurrentTarget();
+                Vec2 location = target->convertToNodeSpace(touch->getLocation());
+                Rect bounds(Vec2::ZERO, target->getContentSize());
+                // the touches aren't swallowed, so every hit button is called
+                return bounds.containsPoint(location);
+            };
+            
+            listener->onTouchMoved = [](Touch* touch, Event* event){};
+            listener->onTouchEnded = [](Touch* touch, Event* event){};
+            listener->setTouchBoundsCullingEnabled(boundsCulling);
+            
+            // Create new touchable nodes
+            for (int i = 0; i < this->quantityOfNodes; ++i)
+            {
+                auto node = Node::create();
+                node->setTag(1000 + i);
+                node->setContentSize(Size(40, 40));
+                node->setPosition(CCRANDOM_0_1() * size.width, CCRANDOM_0_1() * size.height);
+                this->addChild(node);
+                this->_nodes.push_back(node);
+                dispatcher->addEventListenerWithSceneGraphPriority(listener->clone(), node);
+            }
+            
+            _lastRenderedCount = quantityOfNodes;
+        }
+        
+        EventTouch touchEvent;
+        touchEvent.setEventCode(EventTouch::EventCode::BEGAN);
+        std::vector<Touch*> touches;
+        
+        for (int i = 0; i < 4; ++i)
+        {
+            Touch* touch = new (std::nothrow) Touch();
+            touch->autorelease();
+            touch->setTouchInfo(i, CCRANDOM_0_1() * size.width, CCRANDOM_0_1() * size.height);
+            touches.push_back(touch);
+        }
+        touchEvent.setTouches(touches);
+        
+        CC_PROFILER_START(this->profilerName());
+        dispatcher->dispatchEvent(&touchEvent);
+        CC_PROFILER_STOP(this->profilerName());
+    };
+    
     TestFunction testFunctions[] = {
         { "OneByOne-scenegraph",    [=](){
             auto dispatcher = Director::getInstance()->getEventDispatcher();
@@ -407,6 +461,67 @@ void TouchEventDispatchingPerfTest::generateTestFunctions()
             CC_PROFILER_STOP(this->profilerName());
         } } ,
         
+        { "OneByOne-buttons",    [=](){ buttonsTest(false); } } ,
+        
+        { "OneByOne-buttons-culled",    [=](){ buttonsTest(true); } } ,
+        
+        { "OneByOne-scenegraph-add-remove",    [=](){
+            auto dispatcher = Director::getInstance()->getEventDispatcher();
+            auto listener = EventListenerTouchOneByOne::create();
+            listener->onTouchBegan = [](Touch* touch, Event* event){
+                return false;
+            };
+            
+            listener->onTouchMoved = [](Touch* touch, Event* event){};
+            listener->onTouchEnded = [](Touch* touch, Event* event){};
+            
+            if (quantityOfNodes != _lastRenderedCount)
+            {
+                // Create new touchable nodes
+                for (int i = 0; i < this->quantityOfNodes; ++i)
+                {
+                    auto node = Node::create();
+                    node->setTag(1000 + i);
+                    this->addChild(node, rand() % 3 - 1);
+                    this->_nodes.push_back(node);
+                    dispatcher->addEventListenerWithSceneGraphPriority(listener->clone(), node);
+                }
+                
+                _lastRenderedCount = quantityOfNodes;
+            }
+            
+            // Replace some touchable nodes every frame, which sets the scene graph priority dirty
+            for (int i = 0; i < 10 && !this->_nodes.empty(); ++i)
+            {
+                auto index = rand() % this->_nodes.size();
+                auto tag = this->_nodes[index]->getTag();
+                this->_nodes[index]->removeFromParent();
+                
+                auto node = Node::create();
+                node->setTag(tag);
+                this->addChild(node, rand() % 3 - 1);
+                this->_nodes[index] = node;
+                dispatcher->addEventListenerWithSceneGraphPriority(listener->clone(), node);
+            }
+            
+            EventTouch touchEvent;
+            touchEvent.setEventCode(EventTouch::EventCode::BEGAN);
+            std::vector<Touch*> touches;
+            
+            for (int i = 0; i < 4; ++i)
+            {
+                Touch* touch = new (std::nothrow) Touch();
+                touch->autorelease();
+                touch->setTouchInfo(i, rand() % 200, rand() % 200);
+                touches.push_back(touch);
+            }
+            touchEvent.setTouches(touches);
+            
+            CC_PROFILER_START(this->profilerName());
+            dispatcher->dispatchEvent(&touchEvent);
+            CC_PROFILER_STOP(this->profilerName());
+        } } ,
+        
         { "OneByOne-fixed",    [=](){
             auto dispatcher = Director::getInstance()->getEventDispatcher();
             if (quantityOfNodes != _lastRenderedCount)
@@ -648,6 +763,133 @@ void TouchEventDispatchingPerfTest::generateTestFunctions()
     }
 }
 
+void TouchEventDispatchingPerfTest::onEnter()
+{
+    PerformanceEventDispatcherScene::onEnter();
+    checkTouchBoundsCulling();
+}
+
+void TouchEventDispatchingPerfTest::checkTouchBoundsCulling()
+{
+    // The same buttons twice, the second time with culled listeners. The touches aren't swallowed,
+    // each set records the buttons hit by each touch in the order they are called, the first one claims the touch.
+    struct ButtonSet
+    {
+        Node* container;
+        std::vector<Node*> buttons;
+        std::vector<std::pair<int, int>> hits;
+    };
+    auto sets = std::make_shared<std::array<ButtonSet, 2>>();
+
+    const int buttonCount = 300;
+    Size size = Director::getInstance()->getWinSize();
+    for (int culled = 0; culled < 2; ++culled)
+    {
+        auto& set = (*sets)[culled];
+        set.container = Node::create();
+        addChild(set.container);
+        for (int i = 0; i < buttonCount; ++i)
+        {
+            auto button = Node::create();
+            button->setContentSize(Size(40, 40));
+            // some buttons are children of the previous one, they move with it
+            if (i % 10 == 9)
+            {
+                button->setPosition(30, 10);
+                set.buttons[i - 1]->addChild(button, i % 3 - 1);
+            }
+            else
+            {
+                button->setPosition((i * 37) % (int)size.width, (i * 53) % (int)size.height);
+                set.container->addChild(button, i % 3);
+            }
+            set.buttons.push_back(button);
+
+            auto listener = EventListenerTouchOneByOne::create();
+            listener->onTouchBegan = [sets, culled, i](Touch* touch, Event* event){
+                auto target = event->getCurrentTarget();
+                bool hit = Rect(Vec2::ZERO, target->getContentSize()).containsPoint(target->convertToNodeSpace(touch->getLocation()));
+                if (hit)
+                    (*sets)[culled].hits.emplace_back(touch->getID(), i);
+                return hit;
+            };
+            listener->onTouchEnded = [](Touch* touch, Event* event){};
+            listener->setTouchBoundsCullingEnabled(culled != 0);
+            _eventDispatcher->addEventListenerWithSceneGraphPriority(listener, button);
+        }
+    }
+
+    // touches on a grid covering the screen, a row per event
+    auto dispatchAndCompare = [this, sets, size](const char* step) {
+        for (auto& set : *sets)
+            set.hits.clear();
+
+        int touchID = 0;
+        int claimedTouches = 0;
+        for (float y = 5; y < size.height; y += 23)
+        {
+            std::vector<Touch*> touches;
+            for (float x = 3; x < size.width; x += 17)
+            {
+                Touch* touch = new (std::nothrow) Touch();
+                touch->autorelease();
+                touch->setTouchInfo(touchID++, x, y);
+                touches.push_back(touch);
+            }
+
+            EventTouch touchEvent;
+            touchEvent.setTouches(touches);
+            const size_t hitsBefore = (*sets)[0].hits.size();
+            touchEvent.setEventCode(EventTouch::EventCode::BEGAN);
+            _eventDispatcher->dispatchEvent(&touchEvent);
+            for (auto touch : touches)
+            {
+                auto& hits = (*sets)[0].hits;
+                claimedTouches += std::find_if(hits.begin() + hitsBefore, hits.end(), [touch](const std::pair<int, int>& hit) {
+                    return hit.first == touch->getID();
+                }) != hits.end();
+            }
+            // ends the touches so that the listeners forget the touches they claimed
+            touchEvent.setEventCode(EventTouch::EventCode::ENDED);
+            _eventDispatcher->dispatchEvent(&touchEvent);
+        }
+
+        bool same = (*sets)[0].hits == (*sets)[1].hits;
+        log("TouchEventDispatchingPerfTest: %s: %d touches, %d claimed, %d hits, %d hits with culling%s", step, touchID, claimedTouches,
+            (int)(*sets)[0].hits.size(), (int)(*sets)[1].hits.size(), same ? "" : ", DIFFERENT");
+        CCASSERT(same, "Culling touch listeners by node bounds should call the same listeners in the same order");
+    };
+
+    // the bounds of the culled listeners are updated when the scene is visited, so each step waits for a frame
+    scheduleOnce([sets, size, dispatchAndCompare](float) {
+        dispatchAndCompare("new buttons");
+
+        for (auto& set : *sets)
+        {
+            for (int i = 0; i < (int)set.buttons.size(); ++i)
+            {
+                auto button = set.buttons[i];
+                if (i % 4 == 0)
+                    button->setPosition((i * 71) % (int)size.width, (i * 29) % (int)size.height);
+                if (i % 5 == 1)
+                    button->setScale(i % 2 ? 2.0f : 0.5f);
+                if (i % 7 == 2)
+                    button->setRotation(30);
+                if (i % 6 == 3)
+                    button->setLocalZOrder(i % 4 - 2);
+            }
+            set.container->setPosition(15, -10);
+        }
+    }, 0, "checkTouchBoundsCulling");
+
+    scheduleOnce([this, sets, dispatchAndCompare](float) {
+        dispatchAndCompare("moved, scaled and reordered buttons");
+
+        for (auto& set : *sets)
+            set.container->removeFromParent();
+    }, 0.1f, "checkTouchBoundsCullingAfterChanges");
+}
+
 std::string TouchEventDispatchingPerfTest::title() const
 {
     return "Touch Event Dispatching Perf test";
@@ -814,6 +1056,29 @@ void CustomEventDispatchingPerfTest::generateTestFunctions()
             dispatcher->dispatchEvent(&event);
             CC_PROFILER_STOP(this->profilerName());
         } } ,
+        { "custom-fixed-interned",    [=](){
+            // the event name is resolved once, dispatching doesn't look up or copy strings
+            static const EventListener::InternedID eventID = EventListener::internListenerID("custom_event_test_interned");
+            
+            auto dispatcher = Director::getInstance()->getEventDispatcher();
+            if (quantityOfNodes != _lastRenderedCount)
+            {
+                auto listener = EventListenerCustom::create("custom_event_test_interned", [](EventCustom* event){});
+                
+                for (int i = 0; i < this->quantityOfNodes; ++i)
+                {
+                    auto l = listener->clone();
+                    this->_fixedPriorityListeners.push_back(l);
+                    dispatcher->addEventListenerWithFixedPriority(l, i+1);
+                }
+                
+                _lastRenderedCount = quantityOfNodes;
+            }
+            
+            CC_PROFILER_START(this->profilerName());
+            dispatcher->dispatchCustomEvent(eventID);
+            CC_PROFILER_STOP(this->profilerName());
+        } } ,
     };
     
     for (const auto& func : testFunctions)
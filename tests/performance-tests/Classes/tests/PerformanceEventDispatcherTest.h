@@ -69,9 +69,14 @@ public:
     CREATE_FUNC(TouchEventDispatchingPerfTest);
     
     virtual void generateTestFunctions() override;
+    virtual void onEnter() override;
     
     virtual std::string title() const override;
     virtual std::string subtitle() const override;
+
+private:
+    /** Checks over the next frames that culling touch listeners by the bounds of their nodes calls the same listeners. */
+    void checkTouchBoundsCulling();
 };
 
 class KeyboardEventDispatchingPerfTest : public PerformanceEventDispatcherScene
@@ -40,6 +40,10 @@ PerformceMathTests::PerformceMathTests()
 {
     ADD_TEST_CASE(PerformanceMathLayer1);
     ADD_TEST_CASE(PerformanceMathLayer2);
+    ADD_TEST_CASE(PerformanceMathLayer3);
+    ADD_TEST_CASE(PerformanceMathLayer4);
+    ADD_TEST_CASE(PerformanceMathLayer5);
+    ADD_TEST_CASE(PerformanceMathLayer6);
 }
 
 void PerformanceMathLayer::onEnter()
@@ -51,9 +55,13 @@ void PerformanceMathLayer::onEnter()
     
     CC_PROFILER_PURGE_ALL();
     
+    if (_autoTestLoopCounts.empty()) {
+        _autoTestLoopCounts.assign(std::begin(autoTestLoopCounts), std::end(autoTestLoopCounts));
+    }
+    
     if (isAutoTesting()) {
         autoTestIndex = 0;
-        _loopCount = autoTestLoopCounts[autoTestIndex];
+        _loopCount = _autoTestLoopCounts[autoTestIndex];
         Profile::getInstance()->testCaseBegin("MathTest",
                                               genStrVector("Type", "LoopCount", nullptr),
                                               genStrVector("Avg", "Min", "Max", nullptr));
@@ -121,7 +129,7 @@ void PerformanceMathLayer::dumpProfilerInfo(float dt)
         Profile::getInstance()->addTestResult(genStrVector(_profileName.c_str(), numStr.c_str(), nullptr),
                                               genStrVector(avgStr.c_str(), minStr.c_str(), maxStr.c_str(), nullptr));
 
-        auto testsSize = sizeof(autoTestLoopCounts)/sizeof(int);
+        auto testsSize = _autoTestLoopCounts.size();
         if (autoTestIndex >= (testsSize - 1)) {
             this->setAutoTesting(false);
             Profile::getInstance()->testCaseEnd();
@@ -130,7 +138,7 @@ void PerformanceMathLayer::dumpProfilerInfo(float dt)
         {
             // update the auto test index
             autoTestIndex++;
-            _loopCount = autoTestLoopCounts[autoTestIndex];
+            _loopCount = _autoTestLoopCounts[autoTestIndex];
             updateLoopLabel();
             CC_PROFILER_PURGE_ALL();
         }
@@ -164,3 +172,107 @@ void PerformanceMathLayer2::doPerformanceTest(float dt)
     CC_PROFILER_STOP(_profileName.c_str());
     
 }
+
+void PerformanceMathLayer3::prepareVertices()
+{
+    // _loopCount is the number of vertices, one sprite quad uses 4 vertices and 6 indices
+    size_t vertexCount = _loopCount / 4 * 4;
+    if (_srcVerts.size() == vertexCount)
+        return;
+
+    _srcVerts.resize(vertexCount);
+    _dstVerts.resize(vertexCount);
+    for (size_t i = 0; i < vertexCount; ++i)
+    {
+        _srcVerts[i].vertices.set(CCRANDOM_0_1() * 100, CCRANDOM_0_1() * 100, 0);
+        _srcVerts[i].colors = Color4B::WHITE;
+        _srcVerts[i].texCoords = Tex2F(CCRANDOM_0_1(), CCRANDOM_0_1());
+    }
+
+    static const unsigned short quadIndices[] = {0, 1, 2, 3, 2, 1};
+    _srcIndices.resize(vertexCount / 4 * 6);
+    _dstIndices.resize(_srcIndices.size());
+    for (size_t i = 0; i < _srcIndices.size(); ++i)
+    {
+        _srcIndices[i] = quadIndices[i % 6];
+    }
+}
+
+void PerformanceMathLayer3::doPerformanceTest(float dt)
+{
+    prepareVertices();
+    Mat4 src;
+    Mat4::createRotation(Vec3(1,1,1), 10, &src);
+    CC_PROFILER_START(_profileName.c_str());
+    unsigned short filledVertex = 0;
+    for (size_t i = 0; i < _srcVerts.size(); i += 4)
+    {
+        memcpy(&_dstVerts[i], &_srcVerts[i], sizeof(V3F_C4B_T2F) * 4);
+        for (size_t j = 0; j < 4; ++j)
+        {
+            src.transformPoint(&_dstVerts[i + j].vertices);
+        }
+        for (size_t j = 0; j < 6; ++j)
+        {
+            _dstIndices[i / 4 * 6 + j] = filledVertex + _srcIndices[i / 4 * 6 + j];
+        }
+        filledVertex += 4;
+    }
+    CC_PROFILER_STOP(_profileName.c_str());
+}
+
+void PerformanceMathLayer4::doPerformanceTest(float dt)
+{
+    prepareVertices();
+    Mat4 src;
+    Mat4::createRotation(Vec3(1,1,1), 10, &src);
+    CC_PROFILER_START(_profileName.c_str());
+    unsigned short filledVertex = 0;
+    for (size_t i = 0; i < _srcVerts.size(); i += 4)
+    {
+        MathUtil::transformVertices(src.m, &_srcVerts[i], &_dstVerts[i], 4);
+        MathUtil::transformIndices(&_srcIndices[i / 4 * 6], &_dstIndices[i / 4 * 6], 6, filledVertex);
+        filledVertex += 4;
+    }
+    CC_PROFILER_STOP(_profileName.c_str());
+}
+
+void PerformanceMathLayer5::prepareRenderQueue()
+{
+    // _loopCount is the number of commands, their globalZ is positive so they all land in the same sorted queue
+    if (_commands.size() != (size_t)_loopCount)
+    {
+        _commands = std::vector<CustomCommand>(_loopCount);
+        for (auto& command : _commands)
+        {
+            command.init(1 + (int)(CCRANDOM_0_1() * 1000));
+        }
+    }
+
+    _renderQueue.clear();
+    for (auto& command : _commands)
+    {
+        _renderQueue.push_back(&command);
+    }
+}
+
+void PerformanceMathLayer5::doPerformanceTest(float dt)
+{
+    prepareRenderQueue();
+    auto compare = [](RenderCommand* a, RenderCommand* b) {
+        return a->getGlobalOrder() < b->getGlobalOrder();
+    };
+    auto& queue = _renderQueue.getSubQueue(RenderQueue::QUEUE_GROUP::GLOBALZ_POS);
+    CC_PROFILER_START(_profileName.c_str());
+    std::stable_sort(queue.begin(), queue.end(), compare);
+    CC_PROFILER_STOP(_profileName.c_str());
+}
+
+void PerformanceMathLayer6::doPerformanceTest(float dt)
+{
+    prepareRenderQueue();
+    auto& queue = _renderQueue.getSubQueue(RenderQueue::QUEUE_GROUP::GLOBALZ_POS);
+    CC_PROFILER_START(_profileName.c_str());
+    _renderQueue.radixSort(queue, false);
+    CC_PROFILER_STOP(_profileName.c_str());
+}
@@ -30,6 +30,7 @@ protected:
     void updateLoopLabel();
 protected:
     int autoTestIndex;
+    std::vector<int> _autoTestLoopCounts;
     int _loopCount;
     int _stepCount;
     std::string _profileName;
@@ -67,4 +68,85 @@ public:
     
 };
 
+class PerformanceMathLayer3 : public PerformanceMathLayer
+{
+public:
+    CREATE_FUNC(PerformanceMathLayer3);
+
+    PerformanceMathLayer3()
+    {
+        _profileName = "VertexTransformScalar";
+    }
+    
+    virtual void doPerformanceTest(float dt) override;
+    
+    virtual std::string subtitle() const override{ return "Vertices: memcpy + Mat4::transformPoint"; }
+protected:
+    void prepareVertices();
+
+    std::vector<cocos2d::V3F_C4B_T2F> _srcVerts;
+    std::vector<cocos2d::V3F_C4B_T2F> _dstVerts;
+    std::vector<unsigned short> _srcIndices;
+    std::vector<unsigned short> _dstIndices;
+};
+
+class PerformanceMathLayer4 : public PerformanceMathLayer3
+{
+public:
+    CREATE_FUNC(PerformanceMathLayer4);
+
+    PerformanceMathLayer4()
+    {
+        _profileName = "VertexTransformBatched";
+    }
+    
+    virtual void doPerformanceTest(float dt) override;
+    
+    virtual std::string subtitle() const override{ return "Vertices: MathUtil::transformVertices"; }
+};
+
+// exposes the radix sort, so that it is measured below the size at which RenderQueue::sort switches to it
+class RadixSortRenderQueue : public cocos2d::RenderQueue
+{
+public:
+    using cocos2d::RenderQueue::radixSort;
+};
+
+class PerformanceMathLayer5 : public PerformanceMathLayer
+{
+public:
+    CREATE_FUNC(PerformanceMathLayer5);
+
+    PerformanceMathLayer5()
+    {
+        _profileName = "RenderQueueStableSort";
+        // RenderQueue::sort uses the radix sort from 256 commands
+        _autoTestLoopCounts = {64, 128, 256, 512, 1000, 10000, 100000};
+    }
+    
+    virtual void doPerformanceTest(float dt) override;
+    
+    virtual std::string subtitle() const override{ return "RenderQueue: std::stable_sort"; }
+protected:
+    void prepareRenderQueue();
+
+    std::vector<cocos2d::CustomCommand> _commands;
+    RadixSortRenderQueue _renderQueue;
+};
+
+class PerformanceMathLayer6 : public PerformanceMathLayer5
+{
+public:
+    CREATE_FUNC(PerformanceMathLayer6);
+
+    PerformanceMathLayer6()
+    {
+        _profileName = "RenderQueueRadixSort";
+    }
+    
+    virtual void doPerformanceTest(float dt) override;
+    
+    virtual std::string subtitle() const override{ return "RenderQueue: radix sort"; }
+};
+
 #endif //__PERFORMANCE_MATH_TEST_H__
@@ -45,6 +45,10 @@ PerformceNodeChildrenTests::PerformceNodeChildrenTests()
 //    ADD_TEST_CASE(ReorderSpriteSheet);
 //    ADD_TEST_CASE(SortAllChildrenSpriteSheet);
     ADD_TEST_CASE(VisitSceneGraph);
+    ADD_TEST_CASE(VisitStaticChildren);
+    ADD_TEST_CASE(VisitStaticChildrenHierarchy);
+    ADD_TEST_CASE(VisitMovingChildren);
+    ADD_TEST_CASE(VisitMovingChildrenHierarchy);
 }
 
 enum {
@@ -980,3 +984,82 @@ const char*  VisitSceneGraph::testName()
 {
     return "visit()";
 }
+
+////////////////////////////////////////////////////////
+//
+// VisitTransformHierarchy
+//
+////////////////////////////////////////////////////////
+void VisitTransformHierarchy::initWithQuantityOfNodes(unsigned int nodes)
+{
+    setTransformHierarchyEnabled(_transformHierarchyEnabled);
+    VisitSceneGraph::initWithQuantityOfNodes(nodes);
+}
+
+void VisitTransformHierarchy::updateQuantityOfNodes()
+{
+    // every node has a child, so the hierarchy is two levels deep
+    if( currentQuantityOfNodes < quantityOfNodes )
+    {
+        for(int i = 0; i < (quantityOfNodes-currentQuantityOfNodes); i++)
+        {
+            auto node = Node::create();
+            node->setPosition(Vec2(-1000,-1000));
+            node->setRotation(CCRANDOM_0_1() * 360);
+            node->setTag(1000 + currentQuantityOfNodes + i );
+
+            auto child = Node::create();
+            child->setPosition(Vec2(10, 10));
+            child->setScale(0.5f);
+            node->addChild(child);
+
+            this->addChild(node);
+        }
+    }
+    else if ( currentQuantityOfNodes > quantityOfNodes )
+    {
+        for(int i = 0; i < (currentQuantityOfNodes-quantityOfNodes); i++)
+        {
+            this->removeChildByTag(1000 + currentQuantityOfNodes - i -1 );
+        }
+    }
+
+    currentQuantityOfNodes = quantityOfNodes;
+}
+
+void VisitTransformHierarchy::update(float dt)
+{
+    if (_moveChildren)
+    {
+        for (const auto& child : getChildren())
+        {
+            if (child->getTag() >= 1000)
+                child->setRotation(child->getRotation() + 1);
+        }
+    }
+
+    CC_PROFILER_START( this->profilerName() );
+    this->visit();
+    CC_PROFILER_STOP( this->profilerName() );
+
+    // Call `Renderer::clean` to prevent crash if current scene is destroyed.
+    // The render commands associated with current scene should be cleaned.
+    Director::getInstance()->getRenderer()->clean();
+}
+
+std::string VisitTransformHierarchy::title() const
+{
+    return _moveChildren ? "Visit moving children" : "Visit static children";
+}
+
+std::string VisitTransformHierarchy::subtitle() const
+{
+    return _transformHierarchyEnabled ? "setTransformHierarchyEnabled(true). See console" : "setTransformHierarchyEnabled(false). See console";
+}
+
+const char*  VisitTransformHierarchy::testName()
+{
+    if (_moveChildren)
+        return _transformHierarchyEnabled ? "visit() moving, hierarchy" : "visit() moving";
+    return _transformHierarchyEnabled ? "visit() static, hierarchy" : "visit() static";
+}
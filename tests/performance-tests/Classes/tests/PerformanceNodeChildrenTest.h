@@ -218,4 +218,57 @@ public:
     virtual const char* testName() override;
 };
 
+class VisitTransformHierarchy : public VisitSceneGraph
+{
+public:
+    VisitTransformHierarchy(bool moveChildren, bool transformHierarchyEnabled)
+    : _moveChildren(moveChildren)
+    , _transformHierarchyEnabled(transformHierarchyEnabled)
+    {}
+
+    void initWithQuantityOfNodes(unsigned int nodes) override;
+
+    virtual void update(float dt) override;
+    void updateQuantityOfNodes() override;
+    virtual std::string title() const override;
+    virtual std::string subtitle() const override;
+    virtual const char* testName() override;
+
+protected:
+    bool _moveChildren;
+    bool _transformHierarchyEnabled;
+};
+
+class VisitStaticChildren : public VisitTransformHierarchy
+{
+public:
+    CREATE_FUNC(VisitStaticChildren);
+
+    VisitStaticChildren() : VisitTransformHierarchy(false, false) {}
+};
+
+class VisitStaticChildrenHierarchy : public VisitTransformHierarchy
+{
+public:
+    CREATE_FUNC(VisitStaticChildrenHierarchy);
+
+    VisitStaticChildrenHierarchy() : VisitTransformHierarchy(false, true) {}
+};
+
+class VisitMovingChildren : public VisitTransformHierarchy
+{
+public:
+    CREATE_FUNC(VisitMovingChildren);
+
+    VisitMovingChildren() : VisitTransformHierarchy(true, false) {}
+};
+
+class VisitMovingChildrenHierarchy : public VisitTransformHierarchy
+{
+public:
+    CREATE_FUNC(VisitMovingChildrenHierarchy);
+
+    VisitMovingChildrenHierarchy() : VisitTransformHierarchy(true, true) {}
+};
+
 #endif // __PERFORMANCE_NODE_CHILDREN_TEST_H__
@@ -1,5 +1,7 @@
 #include "PerformanceParticleTest.h"
 #include "Profile.h"
+#include <atomic>
+#include <chrono>
 
 USING_NS_CC;
 
@@ -36,6 +38,8 @@ PerformceParticleTests::PerformceParticleTests()
     ADD_TEST_CASE(ParticlePerformTest2);
     ADD_TEST_CASE(ParticlePerformTest3);
     ADD_TEST_CASE(ParticlePerformTest4);
+    ADD_TEST_CASE(ParticleUpdateKernelsTest);
+    ADD_TEST_CASE(ParticleEmissionTest);
 }
 
 ////////////////////////////////////////////////////////
@@ -498,3 +502,346 @@ void ParticlePerformTest4::initWithSubTest(int subtest, int particles)
     particleSize = 64;
     ParticleMainScene::initWithSubTest(subtest, particles);
 }
+
+////////////////////////////////////////////////////////
+//
+// ParticleUpdateKernelsTest
+//
+////////////////////////////////////////////////////////
+namespace
+{
+    // exposes the particles to compare them, and counts the updates and emissions split over the WorkerPool
+    class KernelTestParticleSystem : public ParticleSystemQuad
+    {
+    public:
+        KernelTestParticleSystem() : _parallelRuns(0) {}
+
+        static KernelTestParticleSystem* create(int numberOfParticles, ParticleSystem::Mode mode)
+        {
+            auto ret = new (std::nothrow) KernelTestParticleSystem();
+            if (ret && ret->initWithTotalParticles(numberOfParticles))
+            {
+                ret->autorelease();
+                ret->setup(mode);
+                return ret;
+            }
+            CC_SAFE_DELETE(ret);
+            return nullptr;
+        }
+
+        void setup(ParticleSystem::Mode mode)
+        {
+            setDuration(DURATION_INFINITY);
+            setEmitterMode(mode);
+            if (mode == Mode::GRAVITY)
+            {
+                setGravity(Vec2(0, -90));
+                setSpeed(180);
+                setSpeedVar(50);
+                setRadialAccel(-50);
+                setRadialAccelVar(20);
+                setTangentialAccel(30);
+                setTangentialAccelVar(10);
+            }
+            else
+            {
+                setStartRadius(10);
+                setStartRadiusVar(5);
+                setEndRadius(200);
+                setEndRadiusVar(50);
+                setRotatePerSecond(90);
+                setRotatePerSecondVar(30);
+            }
+            setAngle(90);
+            setAngleVar(180);
+            setPosVar(Vec2(100, 100));
+            setLife(1.0f);
+            setLifeVar(0.5f);
+            setEmissionRate(getTotalParticles() / getLife());
+            setStartColor(Color4F(0.5f, 0.5f, 0.5f, 1.0f));
+            setStartColorVar(Color4F(0.5f, 0.5f, 0.5f, 0.0f));
+            setEndColor(Color4F(0.1f, 0.1f, 0.1f, 0.2f));
+            setStartSize(16);
+            setStartSizeVar(8);
+            setEndSize(4);
+            setStartSpin(0);
+            setStartSpinVar(90);
+            setEndSpin(180);
+            // no gl buffer update
+            setVisible(false);
+        }
+
+        // emits count particles in the emptied system, count must not exceed its total particles
+        void burst(int count)
+        {
+            CCASSERT(count <= _totalParticles, "The burst doesn't fit in the system");
+            _particleCount = 0;
+            addParticles(count);
+        }
+
+        virtual void forEachParticleRange(int count, const std::function<void(int, int)>& func) override
+        {
+            std::atomic<int> ranges(0);
+            ParticleSystemQuad::forEachParticleRange(count, [&ranges, &func](int start, int end) {
+                ++ranges;
+                func(start, end);
+            });
+            if (ranges > 1)
+                ++_parallelRuns;
+        }
+
+        // the number of updates and emissions whose particles were split in several ranges
+        int getParallelRuns() const { return _parallelRuns; }
+
+        bool isSameAs(const KernelTestParticleSystem* other) const
+        {
+            if (_particleCount != other->_particleCount || _emitterMode != other->_emitterMode)
+                return false;
+
+            std::vector<std::pair<const float*, const float*>> arrays = {
+                {_particleData.posx, other->_particleData.posx},
+                {_particleData.posy, other->_particleData.posy},
+                {_particleData.startPosX, other->_particleData.startPosX},
+                {_particleData.startPosY, other->_particleData.startPosY},
+                {_particleData.colorR, other->_particleData.colorR},
+                {_particleData.colorG, other->_particleData.colorG},
+                {_particleData.colorB, other->_particleData.colorB},
+                {_particleData.colorA, other->_particleData.colorA},
+                {_particleData.deltaColorR, other->_particleData.deltaColorR},
+                {_particleData.deltaColorG, other->_particleData.deltaColorG},
+                {_particleData.deltaColorB, other->_particleData.deltaColorB},
+                {_particleData.deltaColorA, other->_particleData.deltaColorA},
+                {_particleData.size, other->_particleData.size},
+                {_particleData.deltaSize, other->_particleData.deltaSize},
+                {_particleData.rotation, other->_particleData.rotation},
+                {_particleData.deltaRotation, other->_particleData.deltaRotation},
+                {_particleData.timeToLive, other->_particleData.timeToLive},
+            };
+            // the arrays of the other mode are never written, their memory is uninitialized
+            if (_emitterMode == Mode::GRAVITY)
+            {
+                arrays.insert(arrays.end(), {
+                    {_particleData.modeA.dirX, other->_particleData.modeA.dirX},
+                    {_particleData.modeA.dirY, other->_particleData.modeA.dirY},
+                    {_particleData.modeA.radialAccel, other->_particleData.modeA.radialAccel},
+                    {_particleData.modeA.tangentialAccel, other->_particleData.modeA.tangentialAccel},
+                });
+            }
+            else
+            {
+                arrays.insert(arrays.end(), {
+                    {_particleData.modeB.angle, other->_particleData.modeB.angle},
+                    {_particleData.modeB.degreesPerSecond, other->_particleData.modeB.degreesPerSecond},
+                    {_particleData.modeB.radius, other->_particleData.modeB.radius},
+                    {_particleData.modeB.deltaRadius, other->_particleData.modeB.deltaRadius},
+                });
+            }
+
+            const size_t size = sizeof(float) * _particleCount;
+            for (auto& pair : arrays)
+            {
+                if (memcmp(pair.first, pair.second, size) != 0)
+                    return false;
+            }
+            return memcmp(_particleData.atlasIndex, other->_particleData.atlasIndex, sizeof(unsigned int) * _particleCount) == 0
+                && memcmp(_quads, other->_quads, sizeof(_quads[0]) * _particleCount) == 0;
+        }
+
+    private:
+        int _parallelRuns;
+    };
+
+    const float kKernelTestDelta = 1.0f / 60;
+    const int kKernelTestFrames = 120;
+    const unsigned int kKernelTestSeed = 42;
+    const int kKernelTestParticles = 4000;
+    const int kKernelBenchmarkSystems = 24;
+    const int kKernelBenchmarkParticles = 2000;
+    // enough particles for the emission to be split over the WorkerPool, see PARALLEL_UPDATE_MIN_PARTICLES
+    const int kBurstParticles = 4096;
+    const int kBurstCount = 200;
+    const float kPrewarmDuration = 5.0f;
+}
+
+void ParticleUpdateKernelsTest::onEnter()
+{
+    TestCase::onEnter();
+
+    if (isAutoTesting()) {
+        Profile::getInstance()->testCaseBegin("ParticleUpdateKernelsTest",
+                                              genStrVector("Kernel", "Systems", "ParticleCount", nullptr),
+                                              genStrVector("Time", nullptr));
+    }
+
+    bool identical = validate(ParticleSystem::Mode::GRAVITY) && validate(ParticleSystem::Mode::RADIUS);
+    log("ParticleUpdateKernelsTest: SIMD and parallel updates %s to the scalar update", identical ? "identical" : "DIFFERENT");
+
+    const char* kernels[] = {"scalar", "SIMD", "SIMD parallel"};
+    float times[] = {benchmark(false, false), benchmark(true, false), benchmark(true, true)};
+    _result = identical ? "identical" : "DIFFERENT";
+    for (int i = 0; i < 3; ++i)
+    {
+        log("  %s ms:%f", kernels[i], times[i]);
+        _result += StringUtils::format(", %s %.1fms", kernels[i], times[i]);
+        if (isAutoTesting())
+            Profile::getInstance()->addTestResult(genStrVector(kernels[i], genStr("%d", kKernelBenchmarkSystems).c_str(),
+                                                               genStr("%d", kKernelBenchmarkParticles).c_str(), nullptr),
+                                                  genStrVector(genStr("%fms", times[i]).c_str(), nullptr));
+    }
+    ParticleSystem::setSimdUpdateEnabled(true);
+
+    if (isAutoTesting())
+    {
+        Profile::getInstance()->testCaseEnd();
+        setAutoTesting(false);
+    }
+
+    auto s = Director::getInstance()->getWinSize();
+    auto label = Label::createWithTTF(_result, "fonts/arial.ttf", 20);
+    label->setPosition(Vec2(s.width/2, s.height/2));
+    addChild(label);
+}
+
+bool ParticleUpdateKernelsTest::validate(ParticleSystem::Mode mode)
+{
+    // the same seed emits the same particles in both systems
+    auto scalar = KernelTestParticleSystem::create(kKernelTestParticles, mode);
+    scalar->setRandomSeed(kKernelTestSeed);
+    auto simd = KernelTestParticleSystem::create(kKernelTestParticles, mode);
+    simd->setRandomSeed(kKernelTestSeed);
+    simd->setParallelUpdateEnabled(true);
+
+    for (int frame = 0; frame < kKernelTestFrames; ++frame)
+    {
+        ParticleSystem::setSimdUpdateEnabled(false);
+        scalar->update(kKernelTestDelta);
+
+        ParticleSystem::setSimdUpdateEnabled(true);
+        simd->update(kKernelTestDelta);
+
+        if (!simd->isSameAs(scalar))
+        {
+            log("ParticleUpdateKernelsTest: difference in mode %d at frame %d", (int)mode, frame);
+            return false;
+        }
+    }
+
+    // the system grows past PARALLEL_UPDATE_MIN_PARTICLES, so its later updates are split when there are several threads
+    CCASSERT(WorkerPool::getInstance()->getConcurrency() == 1 || simd->getParallelRuns() > 0, "The parallel updates should be split over the WorkerPool");
+    return true;
+}
+
+float ParticleUpdateKernelsTest::benchmark(bool simd, bool parallel)
+{
+    Vector<ParticleSystem*> systems;
+    for (int i = 0; i < kKernelBenchmarkSystems; ++i)
+    {
+        auto system = KernelTestParticleSystem::create(kKernelBenchmarkParticles, ParticleSystem::Mode::GRAVITY);
+        system->setRandomSeed(kKernelTestSeed + i);
+        system->setParallelUpdateEnabled(parallel);
+        systems.pushBack(system);
+    }
+
+    ParticleSystem::setSimdUpdateEnabled(simd);
+    auto start = std::chrono::steady_clock::now();
+    for (int frame = 0; frame < kKernelTestFrames; ++frame)
+    {
+        for (auto system : systems)
+        {
+            system->update(kKernelTestDelta);
+        }
+    }
+    return std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+std::string ParticleUpdateKernelsTest::title() const
+{
+    return "Particle update kernels";
+}
+
+std::string ParticleUpdateKernelsTest::subtitle() const
+{
+    return "Scalar, SIMD and parallel updates. See console";
+}
+
+////////////////////////////////////////////////////////
+//
+// ParticleEmissionTest
+//
+////////////////////////////////////////////////////////
+void ParticleEmissionTest::onEnter()
+{
+    TestCase::onEnter();
+
+    if (isAutoTesting()) {
+        Profile::getInstance()->testCaseBegin("ParticleEmissionTest",
+                                              genStrVector("Emission", "ParticleCount", nullptr),
+                                              genStrVector("Time", nullptr));
+    }
+
+    // the emitted particles only depend on the seed, not on how the emission is split
+    auto serial = KernelTestParticleSystem::create(kBurstParticles, ParticleSystem::Mode::GRAVITY);
+    serial->setRandomSeed(kKernelTestSeed);
+    auto parallel = KernelTestParticleSystem::create(kBurstParticles, ParticleSystem::Mode::GRAVITY);
+    parallel->setRandomSeed(kKernelTestSeed);
+    parallel->setParallelUpdateEnabled(true);
+
+    auto burstTime = [](KernelTestParticleSystem* system) {
+        auto start = std::chrono::steady_clock::now();
+        for (int i = 0; i < kBurstCount; ++i)
+        {
+            system->burst(kBurstParticles);
+        }
+        return std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - start).count() / kBurstCount;
+    };
+    float serialTime = burstTime(serial);
+    float parallelTime = burstTime(parallel);
+    bool identical = serial->isSameAs(parallel);
+
+    // a single thread doesn't split the emission
+    bool split = parallel->getParallelRuns() == kBurstCount && serial->getParallelRuns() == 0;
+    if (WorkerPool::getInstance()->getConcurrency() > 1)
+    {
+        log("ParticleEmissionTest: %d of %d bursts emitted in parallel", parallel->getParallelRuns(), kBurstCount);
+        CCASSERT(split, "The parallel bursts should be split over the WorkerPool");
+    }
+
+    auto prewarmed = KernelTestParticleSystem::create(kKernelBenchmarkParticles, ParticleSystem::Mode::GRAVITY);
+    auto start = std::chrono::steady_clock::now();
+    prewarmed->prewarm(kPrewarmDuration);
+    float prewarmTime = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+    log("ParticleEmissionTest: serial and parallel emissions %s", identical ? "identical" : "DIFFERENT");
+    log("  burst of %d particles ms:%f, parallel ms:%f", kBurstParticles, serialTime, parallelTime);
+    log("  prewarm of %.0fs with %d particles ms:%f", kPrewarmDuration, kKernelBenchmarkParticles, prewarmTime);
+
+    if (isAutoTesting())
+    {
+        auto count = genStr("%d", kBurstParticles);
+        Profile::getInstance()->addTestResult(genStrVector("burst", count.c_str(), nullptr),
+                                              genStrVector(genStr("%fms", serialTime).c_str(), nullptr));
+        Profile::getInstance()->addTestResult(genStrVector("parallel burst", count.c_str(), nullptr),
+                                              genStrVector(genStr("%fms", parallelTime).c_str(), nullptr));
+        Profile::getInstance()->addTestResult(genStrVector("prewarm", genStr("%d", kKernelBenchmarkParticles).c_str(), nullptr),
+                                              genStrVector(genStr("%fms", prewarmTime).c_str(), nullptr));
+        Profile::getInstance()->testCaseEnd();
+        setAutoTesting(false);
+    }
+
+    auto s = Director::getInstance()->getWinSize();
+    auto label = Label::createWithTTF(StringUtils::format("%s, burst %.2fms, parallel %.2fms, prewarm %.1fms",
+                                                          identical ? "identical" : "DIFFERENT", serialTime, parallelTime, prewarmTime),
+                                      "fonts/arial.ttf", 20);
+    label->setPosition(Vec2(s.width/2, s.height/2));
+    addChild(label);
+}
+
+std::string ParticleEmissionTest::title() const
+{
+    return "Particle emission";
+}
+
+std::string ParticleEmissionTest::subtitle() const
+{
+    return "Bursts and prewarm. See console";
+}
@@ -76,4 +76,32 @@ public:
     virtual void initWithSubTest(int subtest, int particles) override;
 };
 
+class ParticleUpdateKernelsTest : public TestCase
+{
+public:
+    CREATE_FUNC(ParticleUpdateKernelsTest);
+
+    virtual std::string title() const override;
+    virtual std::string subtitle() const override;
+    virtual void onEnter() override;
+
+    // checks that the SIMD and parallel updates give the same particles as the scalar one
+    bool validate(cocos2d::ParticleSystem::Mode mode);
+    // returns the time in ms of the update of several systems
+    float benchmark(bool simd, bool parallel);
+
+protected:
+    std::string _result;
+};
+
+class ParticleEmissionTest : public TestCase
+{
+public:
+    CREATE_FUNC(ParticleEmissionTest);
+
+    virtual std::string title() const override;
+    virtual std::string subtitle() const override;
+    virtual void onEnter() override;
+};
+
 #endif
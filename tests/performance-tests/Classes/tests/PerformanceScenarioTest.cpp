@@ -1,14 +1,22 @@
 #include "PerformanceScenarioTest.h"
 #include "Profile.h"
 
+#include <chrono>
+
 USING_NS_CC;
 
 #define DELAY_TIME              4
 #define STAT_TIME               3
 
+#define ACTION_NODE_COUNT       7500
+#define ACTION_UPDATE_COUNT     60
+#define ACTION_CHECK_NODE_COUNT 60
+#define ACTION_CHECK_UPDATE_COUNT 120
+
 PerformceScenarioTests::PerformceScenarioTests()
 {
     ADD_TEST_CASE(ScenarioTest);
+    ADD_TEST_CASE(ActionSteppingTest);
 }
 
 ////////////////////////////////////////////////////////
@@ -412,3 +420,174 @@ std::string ScenarioTest::title() const
 {
     return "Scenario Performance Test";
 }
+
+////////////////////////////////////////////////////////
+//
+// ActionSteppingTest
+//
+////////////////////////////////////////////////////////
+float ActionSteppingTest::measureUpdate(ActionManager* actionManager, bool specialized)
+{
+    actionManager->setSpecializedSteppingEnabled(specialized);
+
+    // the first step of the actions only starts them
+    actionManager->update(0);
+
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < ACTION_UPDATE_COUNT; ++i)
+    {
+        actionManager->update(1.0f / 60);
+    }
+    auto duration = std::chrono::steady_clock::now() - start;
+    return std::chrono::duration<float, std::milli>(duration).count() / ACTION_UPDATE_COUNT;
+}
+
+// adds the same actions to the nodes checked with and without specialized stepping, some of them finish during the check
+static void addCheckedActions(ActionManager* actionManager, Node* node, int i)
+{
+    const float duration = 0.25f + (i % 5) * 0.5f;
+    switch (i % 5)
+    {
+    case 0:
+        actionManager->addAction(MoveBy::create(duration, Vec2(100, -50)), node, false);
+        actionManager->addAction(FadeTo::create(duration, 30), node, false);
+        break;
+    case 1:
+        actionManager->addAction(MoveTo::create(duration, Vec2(-20, 70)), node, false);
+        actionManager->addAction(EaseSineInOut::create(ScaleTo::create(duration, 2, 0.5f)), node, false);
+        break;
+    case 2:
+        actionManager->addAction(EaseIn::create(RotateBy::create(duration, 270), 2), node, false);
+        actionManager->addAction(TintTo::create(duration, 255, 0, 128), node, false);
+        break;
+    case 3:
+        actionManager->addAction(EaseElasticOut::create(RotateTo::create(duration, 90), 0.3f), node, false);
+        actionManager->addAction(FadeOut::create(duration), node, false);
+        break;
+    default:
+        actionManager->addAction(EaseBackOut::create(ScaleBy::create(duration, 1.5f)), node, false);
+        actionManager->addAction(TintBy::create(duration, -100, 50, -20), node, false);
+        break;
+    }
+}
+
+// returns whether the specialized stepping leaves the nodes in the same state as the virtual one after every update
+static bool checkSpecializedStepping()
+{
+    ActionManager* actionManagers[2];
+    Vector<Node*> nodes[2];
+    for (int specialized = 0; specialized < 2; ++specialized)
+    {
+        actionManagers[specialized] = new (std::nothrow) ActionManager();
+        actionManagers[specialized]->setSpecializedSteppingEnabled(specialized != 0);
+        for (int i = 0; i < ACTION_CHECK_NODE_COUNT; ++i)
+        {
+            auto node = Node::create();
+            node->setColor(Color3B(200, 150, 100));
+            nodes[specialized].pushBack(node);
+            addCheckedActions(actionManagers[specialized], node, i);
+        }
+    }
+
+    // uneven steps, and enough of them for every action to finish, the nodes are compared after each of them
+    bool same = true;
+    for (int step = 0; step < ACTION_CHECK_UPDATE_COUNT && same; ++step)
+    {
+        const float dt = (step % 3 + 1) / 60.0f;
+        actionManagers[0]->update(dt);
+        actionManagers[1]->update(dt);
+
+        for (int i = 0; i < ACTION_CHECK_NODE_COUNT && same; ++i)
+        {
+            auto a = nodes[0].at(i);
+            auto b = nodes[1].at(i);
+            same = a->getPosition().fuzzyEquals(b->getPosition(), 0.001f)
+                && fabsf(a->getScaleX() - b->getScaleX()) < 0.001f
+                && fabsf(a->getScaleY() - b->getScaleY()) < 0.001f
+                && fabsf(a->getRotationSkewX() - b->getRotationSkewX()) < 0.001f
+                && fabsf(a->getRotationSkewY() - b->getRotationSkewY()) < 0.001f
+                && a->getOpacity() == b->getOpacity()
+                && a->getColor() == b->getColor();
+            if (!same)
+            {
+                log("ActionSteppingTest: specialized stepping differs from the virtual one, node %d after update %d", i, step);
+            }
+        }
+    }
+
+    for (int specialized = 0; specialized < 2; ++specialized)
+    {
+        actionManagers[specialized]->removeAllActions();
+        actionManagers[specialized]->release();
+    }
+    return same;
+}
+
+void ActionSteppingTest::onEnter()
+{
+    TestCase::onEnter();
+
+    if (isAutoTesting()) {
+        Profile::getInstance()->testCaseBegin("ActionSteppingTest",
+                                              genStrVector("Actions", nullptr),
+                                              genStrVector("Virtual", "Specialized", "Same", nullptr));
+    }
+
+    // nodes outside of the scene, so that only the actions are measured
+    auto actionManager = new (std::nothrow) ActionManager();
+    Vector<Node*> nodes;
+    for (int i = 0; i < ACTION_NODE_COUNT; ++i)
+    {
+        auto node = Node::create();
+        nodes.pushBack(node);
+
+        // long enough to run during all the updates
+        const float duration = 1000;
+        actionManager->addAction(MoveBy::create(duration, Vec2(100, 100)), node, false);
+        switch (i % 4)
+        {
+        case 0:
+            actionManager->addAction(FadeTo::create(duration, 0), node, false);
+            break;
+        case 1:
+            actionManager->addAction(EaseSineInOut::create(ScaleTo::create(duration, 2)), node, false);
+            break;
+        case 2:
+            actionManager->addAction(EaseIn::create(RotateBy::create(duration, 360), 2), node, false);
+            break;
+        default:
+            actionManager->addAction(TintTo::create(duration, 255, 0, 0), node, false);
+            break;
+        }
+    }
+
+    const bool same = checkSpecializedStepping();
+    const float virtualTime = measureUpdate(actionManager, false);
+    const float specializedTime = measureUpdate(actionManager, true);
+    log("ActionManager update of %d actions: virtual ms:%f, specialized ms:%f%s", ACTION_NODE_COUNT * 2, virtualTime, specializedTime,
+        same ? "" : " DIFFERENT");
+    _subtitleLabel->setString(StringUtils::format("%d actions, ms per update: virtual %.3f, specialized %.3f%s",
+                                                  ACTION_NODE_COUNT * 2, virtualTime, specializedTime, same ? "" : " DIFFERENT"));
+
+    if (isAutoTesting())
+    {
+        Profile::getInstance()->addTestResult(genStrVector(genStr("%d", ACTION_NODE_COUNT * 2).c_str(), nullptr),
+                                              genStrVector(genStr("%fms", virtualTime).c_str(), genStr("%fms", specializedTime).c_str(),
+                                                           same ? "yes" : "no", nullptr));
+        Profile::getInstance()->testCaseEnd();
+        setAutoTesting(false);
+    }
+
+    actionManager->removeAllActions();
+    actionManager->release();
+}
+
+std::string ActionSteppingTest::title() const
+{
+    return "Action Stepping Performance Test";
+}
+
+std::string ActionSteppingTest::subtitle() const
+{
+    return "MoveBy, FadeTo, ScaleTo, RotateBy, TintTo and eases";
+}
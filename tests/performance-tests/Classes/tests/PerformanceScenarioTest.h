@@ -62,4 +62,18 @@ private:
     float      maxFrameRate;
 };
 
+class ActionSteppingTest : public TestCase
+{
+public:
+    CREATE_FUNC(ActionSteppingTest);
+
+    virtual std::string title() const override;
+    virtual std::string subtitle() const override;
+    virtual void onEnter() override;
+
+private:
+    // returns the time in ms of an ActionManager update
+    float measureUpdate(cocos2d::ActionManager* actionManager, bool specialized);
+};
+
 #endif
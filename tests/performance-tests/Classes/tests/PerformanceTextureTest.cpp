@@ -1,11 +1,18 @@
 #include "PerformanceTextureTest.h"
 #include "Profile.h"
+#include <algorithm>
 
 USING_NS_CC;
 
 PerformceTextureTests::PerformceTextureTests()
 {
     ADD_TEST_CASE(TexturePerformceTest);
+    ADD_TEST_CASE(TextureAsyncPerformceTest);
+    ADD_TEST_CASE(SpriteSheetLoadPerformceTest);
+    ADD_TEST_CASE(FileViewPerformceTest);
+    ADD_TEST_CASE(FullPathLookupPerformceTest);
+    ADD_TEST_CASE(CCZInflatePerformceTest);
+    ADD_TEST_CASE(PixelConvertPerformceTest);
 }
 
 static float calculateDeltaTime( struct timeval *lastUpdate )
@@ -332,3 +339,727 @@ std::string TexturePerformceTest::subtitle() const
 {
     return "See console for results";
 }
+
+////////////////////////////////////////////////////////
+//
+// TextureAsyncPerformceTest
+//
+////////////////////////////////////////////////////////
+void TextureAsyncPerformceTest::onEnter()
+{
+    TestCase::onEnter();
+
+    _images = {
+        "Images/PlanetCute-1024x1024.png",
+        "Images/landscape-1024x1024.png",
+        "Images/texture1024x1024.png",
+        "Images/texture512x512.png",
+        "Images/spritesheet1.png",
+        "Images/grossini_dance_atlas.png",
+    };
+    for (int i = 1; i <= 14; ++i)
+    {
+        _images.push_back(StringUtils::format("Images/grossini_dance_%02d.png", i));
+    }
+
+    // the loading threads are started as needed, so from the fewest to the most
+    _defaultThreadCount = Director::getInstance()->getTextureCache()->getAsyncLoadingThreadCount();
+    _threadCounts.clear();
+    _threadCounts.push_back(1);
+    if (_defaultThreadCount > 1)
+        _threadCounts.push_back(_defaultThreadCount);
+
+    if (isAutoTesting()) {
+        Profile::getInstance()->testCaseBegin("TextureAsyncTest",
+                                              genStrVector("ThreadCount", "ImageCount", nullptr),
+                                              genStrVector("Time", nullptr));
+    }
+
+    performTests(_threadCounts.front());
+}
+
+void TextureAsyncPerformceTest::onExit()
+{
+    auto cache = Director::getInstance()->getTextureCache();
+    cache->unbindAllImageAsync();
+    cache->setAsyncLoadingThreadCount(_defaultThreadCount);
+
+    TestCase::onExit();
+}
+
+void TextureAsyncPerformceTest::performTests(unsigned int threadCount)
+{
+    auto cache = Director::getInstance()->getTextureCache();
+    cache->setAsyncLoadingThreadCount(threadCount);
+
+    for (const auto& image : _images)
+    {
+        cache->removeTextureForKey(image);
+    }
+
+    log("--- addImageAsync, %u threads ---", threadCount);
+    _loadedCount = 0;
+    gettimeofday(&_startTime, nullptr);
+    for (const auto& image : _images)
+    {
+        cache->addImageAsync(image, CC_CALLBACK_1(TextureAsyncPerformceTest::imageLoaded, this));
+    }
+}
+
+void TextureAsyncPerformceTest::imageLoaded(Texture2D* texture)
+{
+    if (++_loadedCount < (int)_images.size())
+        return;
+
+    auto dt = calculateDeltaTime(&_startTime);
+    unsigned int threadCount = _threadCounts.front();
+    log("  %d images ms:%f", (int)_images.size(), dt);
+    if (isAutoTesting())
+        Profile::getInstance()->addTestResult(genStrVector(genStr("%u", threadCount).c_str(), genStr("%d", (int)_images.size()).c_str(), nullptr),
+                                              genStrVector(genStr("%fms", dt).c_str(), nullptr));
+
+    _threadCounts.erase(_threadCounts.begin());
+    if (!_threadCounts.empty())
+    {
+        scheduleOnce([this](float /*dt*/){
+            performTests(_threadCounts.front());
+        }, 0, "nextTest");
+    }
+    else if (isAutoTesting())
+    {
+        Profile::getInstance()->testCaseEnd();
+        setAutoTesting(false);
+    }
+}
+
+std::string TextureAsyncPerformceTest::title() const
+{
+    return "Texture Async Performance Test";
+}
+
+std::string TextureAsyncPerformceTest::subtitle() const
+{
+    return "addImageAsync with 1 and the default loading threads. See console";
+}
+
+////////////////////////////////////////////////////////
+//
+// SpriteSheetLoadPerformceTest
+//
+////////////////////////////////////////////////////////
+static const int kSpriteSheetLoadCount = 50;
+
+void SpriteSheetLoadPerformceTest::onEnter()
+{
+    TestCase::onEnter();
+
+    if (isAutoTesting()) {
+        Profile::getInstance()->testCaseBegin("SpriteSheetLoadTest",
+                                              genStrVector("Sheet", "Format", nullptr),
+                                              genStrVector("Time", nullptr));
+    }
+
+    const char* sheets[] = {"Images/grossini_quad", "Images/grossini_polygon"};
+    const char* formats[] = {".plist", ".ccsf"};
+    for (auto sheet : sheets)
+    {
+        std::string frames[2];
+        for (int i = 0; i < 2; ++i)
+        {
+            float dt = performTests(std::string(sheet) + formats[i], frames[i]);
+            log("%s%s ms:%f", sheet, formats[i], dt);
+            if (isAutoTesting())
+                Profile::getInstance()->addTestResult(genStrVector(sheet, formats[i], nullptr),
+                                                      genStrVector(genStr("%fms", dt).c_str(), nullptr));
+        }
+        log("  frames %s", frames[0] == frames[1] ? "identical" : "DIFFERENT");
+    }
+
+    if (isAutoTesting())
+    {
+        Profile::getInstance()->testCaseEnd();
+        setAutoTesting(false);
+    }
+}
+
+float SpriteSheetLoadPerformceTest::performTests(const std::string& sheet, std::string& frames)
+{
+    auto cache = SpriteFrameCache::getInstance();
+
+    // the texture is loaded once, only the frames are timed
+    cache->addSpriteFramesWithFile(sheet);
+    cache->removeSpriteFramesFromFile(sheet);
+
+    struct timeval now;
+    float total = 0;
+    for (int i = 0; i < kSpriteSheetLoadCount; ++i)
+    {
+        gettimeofday(&now, nullptr);
+        cache->addSpriteFramesWithFile(sheet);
+        total += calculateDeltaTime(&now);
+
+        if (i + 1 < kSpriteSheetLoadCount)
+            cache->removeSpriteFramesFromFile(sheet);
+    }
+
+    frames.clear();
+    for (int i = 1; i <= 14; ++i)
+    {
+        auto frame = cache->getSpriteFrameByName(StringUtils::format("grossini_dance_%02d.png", i));
+        if (!frame)
+            continue;
+        const Rect& rect = frame->getRect();
+        const Vec2& offset = frame->getOffset();
+        const Size& size = frame->getOriginalSize();
+        const TrianglesCommand::Triangles& triangles = frame->getPolygonInfo().triangles;
+        frames += StringUtils::format("%d %g %g %g %g %d %g %g %g %g %d %d;", i, rect.origin.x, rect.origin.y, rect.size.width, rect.size.height,
+                                      frame->isRotated(), offset.x, offset.y, size.width, size.height, triangles.vertCount, triangles.indexCount);
+        for (int v = 0; v < triangles.vertCount; ++v)
+        {
+            frames += StringUtils::format("%g %g %g %g,", triangles.verts[v].vertices.x, triangles.verts[v].vertices.y,
+                                          triangles.verts[v].texCoords.u, triangles.verts[v].texCoords.v);
+        }
+    }
+    cache->removeSpriteFramesFromFile(sheet);
+
+    return total * 1000 / kSpriteSheetLoadCount;
+}
+
+std::string SpriteSheetLoadPerformceTest::title() const
+{
+    return "Sprite Sheet Load Performance Test";
+}
+
+std::string SpriteSheetLoadPerformceTest::subtitle() const
+{
+    return "plist and binary .ccsf sprite sheets. See console";
+}
+
+////////////////////////////////////////////////////////
+//
+// FileViewPerformceTest
+//
+////////////////////////////////////////////////////////
+static const int kFileViewReadCount = 20;
+
+// reads every page, like a decoder would
+static unsigned int touchBytes(const unsigned char* bytes, ssize_t size)
+{
+    unsigned int sum = 0;
+    for (ssize_t i = 0; i < size; i += 512)
+    {
+        sum += bytes[i];
+    }
+    return sum;
+}
+
+void FileViewPerformceTest::onEnter()
+{
+    TestCase::onEnter();
+
+    if (isAutoTesting()) {
+        Profile::getInstance()->testCaseBegin("FileViewTest",
+                                              genStrVector("File", "Access", nullptr),
+                                              genStrVector("Time", nullptr));
+    }
+
+    const char* files[] = {
+        "Images/PlanetCute-1024x1024.png",
+        "Images/landscape-1024x1024.png",
+        "Images/texture1024x1024.png",
+    };
+    auto fileUtils = FileUtils::getInstance();
+    for (auto file : files)
+    {
+        struct timeval now;
+        unsigned int dataSum = 0;
+        gettimeofday(&now, nullptr);
+        for (int i = 0; i < kFileViewReadCount; ++i)
+        {
+            Data data = fileUtils->getDataFromFile(file);
+            dataSum += touchBytes(data.getBytes(), data.getSize());
+        }
+        float dataTime = calculateDeltaTime(&now) * 1000 / kFileViewReadCount;
+
+        unsigned int viewSum = 0;
+        bool mapped = false;
+        gettimeofday(&now, nullptr);
+        for (int i = 0; i < kFileViewReadCount; ++i)
+        {
+            FileView view = fileUtils->getFileView(file);
+            viewSum += touchBytes(view.getBytes(), view.getSize());
+            mapped = view.isMapped();
+        }
+        float viewTime = calculateDeltaTime(&now) * 1000 / kFileViewReadCount;
+
+        log("%s: getDataFromFile ms:%f, getFileView ms:%f (%s)%s", file, dataTime, viewTime,
+            mapped ? "mapped" : "copied", dataSum == viewSum ? "" : " DIFFERENT");
+        if (isAutoTesting())
+        {
+            Profile::getInstance()->addTestResult(genStrVector(file, "getDataFromFile", nullptr),
+                                                  genStrVector(genStr("%fms", dataTime).c_str(), nullptr));
+            Profile::getInstance()->addTestResult(genStrVector(file, mapped ? "getFileView mapped" : "getFileView copied", nullptr),
+                                                  genStrVector(genStr("%fms", viewTime).c_str(), nullptr));
+        }
+    }
+
+    if (isAutoTesting())
+    {
+        Profile::getInstance()->testCaseEnd();
+        setAutoTesting(false);
+    }
+}
+
+std::string FileViewPerformceTest::title() const
+{
+    return "File View Performance Test";
+}
+
+std::string FileViewPerformceTest::subtitle() const
+{
+    return "getDataFromFile and mapped getFileView. See console";
+}
+
+////////////////////////////////////////////////////////
+//
+// FullPathLookupPerformceTest
+//
+////////////////////////////////////////////////////////
+static const int kFullPathLookupNameCount = 10000;
+
+float FullPathLookupPerformceTest::resolveNames(const std::vector<std::string>& names, int& found, std::vector<std::string>& paths)
+{
+    auto fileUtils = FileUtils::getInstance();
+    found = 0;
+    paths.resize(names.size());
+
+    struct timeval now;
+    gettimeofday(&now, nullptr);
+    for (size_t i = 0; i < names.size(); ++i)
+    {
+        paths[i] = fileUtils->fullPathForFilename(names[i]);
+        if (!paths[i].empty())
+            ++found;
+    }
+    return calculateDeltaTime(&now) * 1000;
+}
+
+void FullPathLookupPerformceTest::onEnter()
+{
+    TestCase::onEnter();
+
+    if (isAutoTesting()) {
+        Profile::getInstance()->testCaseBegin("FullPathLookupTest",
+                                              genStrVector("Lookup", nullptr),
+                                              genStrVector("Time", "Found", nullptr));
+    }
+
+    auto fileUtils = FileUtils::getInstance();
+    const auto searchPaths = fileUtils->getOriginalSearchPaths();
+    const bool indexEnabled = fileUtils->isPathIndexEnabled();
+    const bool popupNotify = fileUtils->isPopupNotify();
+
+    // 5 search paths and the default root
+    fileUtils->setSearchPaths({ "Images", "Particles", "Particle3D", "TileMaps", "fonts" });
+    fileUtils->setPopupNotify(false);
+
+    // one name in 8 exists, the others are looked up in every search path
+    std::vector<std::string> names;
+    names.reserve(kFullPathLookupNameCount);
+    for (int i = 0; i < kFullPathLookupNameCount; ++i)
+    {
+        if (i % 8 == 0)
+            names.push_back(StringUtils::format("grossini_dance_%02d.png", (i / 8) % 14 + 1));
+        else if (i % 8 == 2 && i % 3 == 0)
+        {
+            // files in sub directories, directories, and names which differ from the listed ones
+            static const char* const otherNames[] = {
+                "sprites_test/sprite-0-0.png", "Images/sprites_test/sprite-0-1.png", "sprites_test", "Images/",
+                "./grossini_dance_01.png", "Images//grossini_dance_02.png", "sprites_test/../grossini_dance_03.png",
+                "GROSSINI_DANCE_04.PNG", "sprites_test/missing.png",
+            };
+            names.push_back(otherNames[(i / 24) % (sizeof(otherNames) / sizeof(otherNames[0]))]);
+        }
+        else if (i % 8 == 4)
+            names.push_back(StringUtils::format("Images/missing_%d.png", i));
+        else
+            names.push_back(StringUtils::format("missing_%d.png", i));
+    }
+
+    struct Pass
+    {
+        const char* name;
+        bool indexEnabled;
+        bool purge;
+    };
+    const Pass passes[] = {
+        { "stat, cold", false, true },
+        { "stat, cached", false, false },
+        { "index, cold", true, true },
+        { "index, cached", true, false },
+    };
+    // the index must resolve every name to the path the stat-based lookup resolves it to
+    std::vector<std::string> statPaths;
+    std::vector<std::string> paths;
+    for (const auto& pass : passes)
+    {
+        fileUtils->setPathIndexEnabled(pass.indexEnabled);
+        if (pass.purge)
+            fileUtils->purgeCachedEntries();
+
+        int found = 0;
+        float time = resolveNames(names, found, paths);
+        log("fullPathForFilename %s: %d names in %fms, %d found", pass.name, kFullPathLookupNameCount, time, found);
+        if (statPaths.empty())
+        {
+            statPaths = paths;
+        }
+        else
+        {
+            auto mismatch = std::mismatch(paths.begin(), paths.end(), statPaths.begin());
+            if (mismatch.first != paths.end())
+            {
+                size_t index = mismatch.first - paths.begin();
+                log("fullPathForFilename %s: '%s' resolved to '%s' instead of '%s'", pass.name, names[index].c_str(),
+                    mismatch.first->c_str(), mismatch.second->c_str());
+            }
+            CCASSERT(mismatch.first == paths.end(), "fullPathForFilename should resolve the same paths with and without the path index");
+        }
+        if (isAutoTesting())
+        {
+            Profile::getInstance()->addTestResult(genStrVector(pass.name, nullptr),
+                                                  genStrVector(genStr("%fms", time).c_str(), genStr("%d", found).c_str(), nullptr));
+        }
+    }
+
+    fileUtils->setPopupNotify(popupNotify);
+    fileUtils->setPathIndexEnabled(indexEnabled);
+    fileUtils->setSearchPaths(searchPaths);
+
+    if (isAutoTesting())
+    {
+        Profile::getInstance()->testCaseEnd();
+        setAutoTesting(false);
+    }
+}
+
+std::string FullPathLookupPerformceTest::title() const
+{
+    return "Full Path Lookup Performance Test";
+}
+
+std::string FullPathLookupPerformceTest::subtitle() const
+{
+    return "10000 names in 6 search paths. See console";
+}
+
+////////////////////////////////////////////////////////
+//
+// CCZInflatePerformceTest
+//
+////////////////////////////////////////////////////////
+static const int kCCZInflateCount = 10;
+
+void CCZInflatePerformceTest::onEnter()
+{
+    TestCase::onEnter();
+
+    if (isAutoTesting()) {
+        Profile::getInstance()->testCaseBegin("CCZInflateTest",
+                                              genStrVector("File", "Access", nullptr),
+                                              genStrVector("Time", nullptr));
+    }
+
+    // the same 1024x1024 RGBA8888 pvr, compressed in one stream and in chunks by tools/ccz/cczconvert.py
+    const char* files[] = {
+        "Images/PlanetCute-1024x1024.pvr.ccz",
+        "Images/PlanetCute-1024x1024_chunked.pvr.ccz",
+    };
+    for (auto file : files)
+    {
+        Data data = FileUtils::getInstance()->getDataFromFile(file);
+        ssize_t len = ZipUtils::getCCZUncompressedLength(data.getBytes(), data.getSize());
+        if (len < 0)
+        {
+            log("%s: invalid ccz file", file);
+            continue;
+        }
+
+        // allocates a buffer for each file, as Image does
+        struct timeval now;
+        bool succeeded = true;
+        gettimeofday(&now, nullptr);
+        for (int i = 0; i < kCCZInflateCount; ++i)
+        {
+            unsigned char* out = nullptr;
+            succeeded = ZipUtils::inflateCCZBuffer(data.getBytes(), data.getSize(), &out) == len && succeeded;
+            free(out);
+        }
+        float allocatingTime = calculateDeltaTime(&now) * 1000 / kCCZInflateCount;
+
+        // inflates into the same buffer every time
+        std::vector<unsigned char> buffer(len);
+        gettimeofday(&now, nullptr);
+        for (int i = 0; i < kCCZInflateCount; ++i)
+        {
+            succeeded = ZipUtils::inflateCCZBuffer(data.getBytes(), data.getSize(), buffer.data(), len) && succeeded;
+        }
+        float inPlaceTime = calculateDeltaTime(&now) * 1000 / kCCZInflateCount;
+
+        log("%s: %d bytes, allocating ms:%f, into buffer ms:%f%s", file, (int)len, allocatingTime, inPlaceTime,
+            succeeded ? "" : " FAILED");
+        if (isAutoTesting())
+        {
+            Profile::getInstance()->addTestResult(genStrVector(file, "allocating", nullptr),
+                                                  genStrVector(genStr("%fms", allocatingTime).c_str(), nullptr));
+            Profile::getInstance()->addTestResult(genStrVector(file, "into buffer", nullptr),
+                                                  genStrVector(genStr("%fms", inPlaceTime).c_str(), nullptr));
+        }
+    }
+
+    if (isAutoTesting())
+    {
+        Profile::getInstance()->testCaseEnd();
+        setAutoTesting(false);
+    }
+}
+
+std::string CCZInflatePerformceTest::title() const
+{
+    return "CCZ Inflate Performance Test";
+}
+
+std::string CCZInflatePerformceTest::subtitle() const
+{
+    return "one zlib stream and parallel chunks. See console";
+}
+
+////////////////////////////////////////////////////////
+//
+// PixelConvertPerformceTest
+//
+////////////////////////////////////////////////////////
+static const int kPixelConvertCount = 10;
+static const int kPixelConvertChunk = 65536;
+
+namespace {
+    struct PixelConvertor
+    {
+        const char* name;
+        Texture2D::PixelFormat srcFormat;
+        Texture2D::PixelFormat dstFormat;
+        int srcBytes;
+    };
+
+    const PixelConvertor pixelConvertors[] = {
+        { "I8 to RGB888", Texture2D::PixelFormat::I8, Texture2D::PixelFormat::RGB888, 1 },
+        { "I8 to RGBA8888", Texture2D::PixelFormat::I8, Texture2D::PixelFormat::RGBA8888, 1 },
+        { "I8 to RGB565", Texture2D::PixelFormat::I8, Texture2D::PixelFormat::RGB565, 1 },
+        { "I8 to RGBA4444", Texture2D::PixelFormat::I8, Texture2D::PixelFormat::RGBA4444, 1 },
+        { "I8 to RGB5A1", Texture2D::PixelFormat::I8, Texture2D::PixelFormat::RGB5A1, 1 },
+        { "I8 to AI88", Texture2D::PixelFormat::I8, Texture2D::PixelFormat::AI88, 1 },
+        { "AI88 to RGB888", Texture2D::PixelFormat::AI88, Texture2D::PixelFormat::RGB888, 2 },
+        { "AI88 to RGBA8888", Texture2D::PixelFormat::AI88, Texture2D::PixelFormat::RGBA8888, 2 },
+        { "AI88 to RGB565", Texture2D::PixelFormat::AI88, Texture2D::PixelFormat::RGB565, 2 },
+        { "AI88 to RGBA4444", Texture2D::PixelFormat::AI88, Texture2D::PixelFormat::RGBA4444, 2 },
+        { "AI88 to RGB5A1", Texture2D::PixelFormat::AI88, Texture2D::PixelFormat::RGB5A1, 2 },
+        { "AI88 to A8", Texture2D::PixelFormat::AI88, Texture2D::PixelFormat::A8, 2 },
+        { "AI88 to I8", Texture2D::PixelFormat::AI88, Texture2D::PixelFormat::I8, 2 },
+        { "RGB888 to RGBA8888", Texture2D::PixelFormat::RGB888, Texture2D::PixelFormat::RGBA8888, 3 },
+        { "RGB888 to RGB565", Texture2D::PixelFormat::RGB888, Texture2D::PixelFormat::RGB565, 3 },
+        { "RGB888 to A8", Texture2D::PixelFormat::RGB888, Texture2D::PixelFormat::A8, 3 },
+        { "RGB888 to I8", Texture2D::PixelFormat::RGB888, Texture2D::PixelFormat::I8, 3 },
+        { "RGB888 to AI88", Texture2D::PixelFormat::RGB888, Texture2D::PixelFormat::AI88, 3 },
+        { "RGB888 to RGBA4444", Texture2D::PixelFormat::RGB888, Texture2D::PixelFormat::RGBA4444, 3 },
+        { "RGB888 to RGB5A1", Texture2D::PixelFormat::RGB888, Texture2D::PixelFormat::RGB5A1, 3 },
+        { "RGBA8888 to RGB888", Texture2D::PixelFormat::RGBA8888, Texture2D::PixelFormat::RGB888, 4 },
+        { "RGBA8888 to RGB565", Texture2D::PixelFormat::RGBA8888, Texture2D::PixelFormat::RGB565, 4 },
+        { "RGBA8888 to I8", Texture2D::PixelFormat::RGBA8888, Texture2D::PixelFormat::I8, 4 },
+        { "RGBA8888 to A8", Texture2D::PixelFormat::RGBA8888, Texture2D::PixelFormat::A8, 4 },
+        { "RGBA8888 to AI88", Texture2D::PixelFormat::RGBA8888, Texture2D::PixelFormat::AI88, 4 },
+        { "RGBA8888 to RGBA4444", Texture2D::PixelFormat::RGBA8888, Texture2D::PixelFormat::RGBA4444, 4 },
+        { "RGBA8888 to RGB5A1", Texture2D::PixelFormat::RGBA8888, Texture2D::PixelFormat::RGB5A1, 4 },
+    };
+
+    // exposes the premultiplication done when an image is loaded
+    class PremultipliedImage : public Image
+    {
+    public:
+        void premultiply() { premultipliedAlpha(); }
+    };
+}
+
+// converts with or without SIMD instructions, returns the converted pixels
+static std::vector<unsigned char> convertPixels(const PixelConvertor& convertor, const unsigned char* data, ssize_t dataLen, bool simd)
+{
+    Texture2D::setSimdConversionEnabled(simd);
+    unsigned char* outData = nullptr;
+    ssize_t outDataLen = 0;
+    Texture2D::convertDataToFormat(data, dataLen, convertor.srcFormat, convertor.dstFormat, &outData, &outDataLen);
+    std::vector<unsigned char> pixels(outData, outData + outDataLen);
+    if (outData != data)
+        free(outData);
+    return pixels;
+}
+
+static bool checkConvertor(const PixelConvertor& convertor)
+{
+    std::vector<unsigned char> data(kPixelConvertChunk * 4);
+
+    // a chunk has every G and B for one R, so all the colors are converted, some lengths cut the last pixel
+    const int chunks = convertor.srcBytes >= 3 ? 256 : 1;
+    for (int r = 0; r < chunks; ++r)
+    {
+        for (int p = 0; p < kPixelConvertChunk; ++p)
+        {
+            const unsigned char g = p >> 8;
+            const unsigned char b = p & 0xFF;
+            unsigned char* pixel = &data[p * convertor.srcBytes];
+            switch (convertor.srcBytes)
+            {
+            case 1: pixel[0] = b; break;
+            case 2: pixel[0] = b; pixel[1] = g; break;
+            case 3: pixel[0] = r; pixel[1] = g; pixel[2] = b; break;
+            default: pixel[0] = r; pixel[1] = g; pixel[2] = b; pixel[3] = (unsigned char)(r * 7 + g * 13 + b * 31); break;
+            }
+        }
+
+        const ssize_t dataLen = kPixelConvertChunk * convertor.srcBytes - r % convertor.srcBytes;
+        if (convertPixels(convertor, data.data(), dataLen, false) != convertPixels(convertor, data.data(), dataLen, true))
+        {
+            log("%s: SIMD conversion differs from the scalar one, R %d", convertor.name, r);
+            return false;
+        }
+    }
+
+    // lengths shorter than a block or with a tail
+    for (ssize_t length = 0; length < 100; ++length)
+    {
+        if (convertPixels(convertor, data.data(), length, false) != convertPixels(convertor, data.data(), length, true))
+        {
+            log("%s: SIMD conversion differs from the scalar one, length %d", convertor.name, (int)length);
+            return false;
+        }
+    }
+    return true;
+}
+
+static bool checkPremultipliedAlpha()
+{
+    // every channel value with every alpha, plus pixels for the tail
+    const int width = 256 * 256 + 7;
+    std::vector<unsigned char> data(width * 4);
+    for (int i = 0; i < width; ++i)
+    {
+        data[i * 4] = i & 0xFF;
+        data[i * 4 + 1] = (i * 7) & 0xFF;
+        data[i * 4 + 2] = ~i & 0xFF;
+        data[i * 4 + 3] = (i >> 8) & 0xFF;
+    }
+
+    PremultipliedImage scalarImage;
+    PremultipliedImage simdImage;
+    scalarImage.initWithRawData(data.data(), data.size(), width, 1, 8, false);
+    simdImage.initWithRawData(data.data(), data.size(), width, 1, 8, false);
+    Texture2D::setSimdConversionEnabled(false);
+    scalarImage.premultiply();
+    Texture2D::setSimdConversionEnabled(true);
+    simdImage.premultiply();
+    if (memcmp(scalarImage.getData(), simdImage.getData(), data.size()) != 0)
+    {
+        log("premultipliedAlpha: SIMD result differs from the scalar one");
+        return false;
+    }
+    return true;
+}
+
+void PixelConvertPerformceTest::onEnter()
+{
+    TestCase::onEnter();
+
+    if (isAutoTesting()) {
+        Profile::getInstance()->testCaseBegin("PixelConvertTest",
+                                              genStrVector("Convertor", nullptr),
+                                              genStrVector("Scalar", "SIMD", "Same", nullptr));
+    }
+
+    const bool simdEnabled = Texture2D::isSimdConversionEnabled();
+    if (!simdEnabled)
+        log("SIMD conversion is not available, both passes are scalar");
+
+    // 1024x1024 pixels of noise
+    const int pixels = 1024 * 1024;
+    std::vector<unsigned char> data(pixels * 4);
+    for (auto& byte : data)
+        byte = (unsigned char)(rand() & 0xFF);
+
+    for (const auto& convertor : pixelConvertors)
+    {
+        const bool same = checkConvertor(convertor);
+
+        float times[2];
+        for (int simd = 0; simd < 2; ++simd)
+        {
+            Texture2D::setSimdConversionEnabled(simd != 0);
+            struct timeval now;
+            gettimeofday(&now, nullptr);
+            for (int i = 0; i < kPixelConvertCount; ++i)
+            {
+                unsigned char* outData = nullptr;
+                ssize_t outDataLen = 0;
+                Texture2D::convertDataToFormat(data.data(), pixels * convertor.srcBytes, convertor.srcFormat, convertor.dstFormat, &outData, &outDataLen);
+                free(outData);
+            }
+            times[simd] = calculateDeltaTime(&now) * 1000 / kPixelConvertCount;
+        }
+
+        log("%s: scalar ms:%f, SIMD ms:%f%s", convertor.name, times[0], times[1], same ? "" : " DIFFERENT");
+        if (isAutoTesting())
+        {
+            Profile::getInstance()->addTestResult(genStrVector(convertor.name, nullptr),
+                                                  genStrVector(genStr("%fms", times[0]).c_str(), genStr("%fms", times[1]).c_str(),
+                                                               same ? "yes" : "no", nullptr));
+        }
+    }
+
+    const bool same = checkPremultipliedAlpha();
+    float times[2];
+    for (int simd = 0; simd < 2; ++simd)
+    {
+        PremultipliedImage image;
+        image.initWithRawData(data.data(), data.size(), 1024, 1024, 8, false);
+        Texture2D::setSimdConversionEnabled(simd != 0);
+        struct timeval now;
+        gettimeofday(&now, nullptr);
+        for (int i = 0; i < kPixelConvertCount; ++i)
+        {
+            image.premultiply();
+        }
+        times[simd] = calculateDeltaTime(&now) * 1000 / kPixelConvertCount;
+    }
+    log("premultipliedAlpha: scalar ms:%f, SIMD ms:%f%s", times[0], times[1], same ? "" : " DIFFERENT");
+    if (isAutoTesting())
+    {
+        Profile::getInstance()->addTestResult(genStrVector("premultipliedAlpha", nullptr),
+                                              genStrVector(genStr("%fms", times[0]).c_str(), genStr("%fms", times[1]).c_str(),
+                                                           same ? "yes" : "no", nullptr));
+    }
+
+    Texture2D::setSimdConversionEnabled(true);
+
+    if (isAutoTesting())
+    {
+        Profile::getInstance()->testCaseEnd();
+        setAutoTesting(false);
+    }
+}
+
+std::string PixelConvertPerformceTest::title() const
+{
+    return "Pixel Convert Performance Test";
+}
+
+std::string PixelConvertPerformceTest::subtitle() const
+{
+    return "scalar and SIMD convertors, checked against each other. See console";
+}
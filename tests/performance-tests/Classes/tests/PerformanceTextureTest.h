@@ -18,4 +18,82 @@ public:
     virtual void onEnter() override;
 };
 
+class TextureAsyncPerformceTest : public TestCase
+{
+public:
+    CREATE_FUNC(TextureAsyncPerformceTest);
+
+    // loads all the images with addImageAsync, with threadCount loading threads
+    void performTests(unsigned int threadCount);
+    void imageLoaded(cocos2d::Texture2D* texture);
+
+    virtual std::string title() const override;
+    virtual std::string subtitle() const override;
+    virtual void onEnter() override;
+    virtual void onExit() override;
+
+protected:
+    std::vector<std::string> _images;
+    std::vector<unsigned int> _threadCounts;
+    unsigned int _defaultThreadCount;
+    int _loadedCount;
+    struct timeval _startTime;
+};
+
+class SpriteSheetLoadPerformceTest : public TestCase
+{
+public:
+    CREATE_FUNC(SpriteSheetLoadPerformceTest);
+
+    // returns the average time in ms to add the frames of the sheet, and the description of its frames
+    float performTests(const std::string& sheet, std::string& frames);
+
+    virtual std::string title() const override;
+    virtual std::string subtitle() const override;
+    virtual void onEnter() override;
+};
+
+class FileViewPerformceTest : public TestCase
+{
+public:
+    CREATE_FUNC(FileViewPerformceTest);
+
+    virtual std::string title() const override;
+    virtual std::string subtitle() const override;
+    virtual void onEnter() override;
+};
+
+class CCZInflatePerformceTest : public TestCase
+{
+public:
+    CREATE_FUNC(CCZInflatePerformceTest);
+
+    virtual std::string title() const override;
+    virtual std::string subtitle() const override;
+    virtual void onEnter() override;
+};
+
+class PixelConvertPerformceTest : public TestCase
+{
+public:
+    CREATE_FUNC(PixelConvertPerformceTest);
+
+    virtual std::string title() const override;
+    virtual std::string subtitle() const override;
+    virtual void onEnter() override;
+};
+
+class FullPathLookupPerformceTest : public TestCase
+{
+public:
+    CREATE_FUNC(FullPathLookupPerformceTest);
+
+    // returns the time in ms to resolve the names, the number of names found and their full paths
+    float resolveNames(const std::vector<std::string>& names, int& found, std::vector<std::string>& paths);
+
+    virtual std::string title() const override;
+    virtual std::string subtitle() const override;
+    virtual void onEnter() override;
+};
+
 #endif
@@ -0,0 +1,102 @@
+#!/usr/bin/python
+#-*- coding: UTF-8 -*-
+# ----------------------------------------------------------------------------
+# Compress files to the CCZ format loaded by ZipUtils::inflateCCZBuffer(),
+# optionally in chunks which are inflated in parallel.
+#
+# License: MIT
+# ----------------------------------------------------------------------------
+'''
+Compress files, usually .pvr textures, to the CCZ format loaded by ZipUtils::inflateCCZBuffer().
+CCZ files given as input are inflated first, so this also converts between the plain and chunked variants.
+
+The layout, big endian, must match cocos/base/ZipUtils.h:
+
+    header    magic "CCZ!", compressionType, version, reserved, uncompressedLength
+    plain     compressionType 0 (CCZ_COMPRESSION_ZLIB): one zlib stream
+    chunked   compressionType 4 (CCZ_COMPRESSION_ZLIB_CHUNKED): chunkSize, chunkCount,
+              compressedSizes[chunkCount], then one zlib stream per chunk of chunkSize bytes
+'''
+
+import struct
+import zlib
+
+from argparse import ArgumentParser
+
+MAGIC = b'CCZ!'
+ENCRYPTED_MAGIC = b'CCZp'
+VERSION = 2
+
+CCZ_COMPRESSION_ZLIB = 0
+CCZ_COMPRESSION_ZLIB_CHUNKED = 4
+
+HEADER_FORMAT = '>4sHHII'
+CHUNK_TABLE_FORMAT = '>II'
+
+class KnownException(Exception):
+    pass
+
+def inflate_ccz(src, data):
+    header_size = struct.calcsize(HEADER_FORMAT)
+    magic, compression, version, reserved, length = struct.unpack(HEADER_FORMAT, data[:header_size])
+    if magic == ENCRYPTED_MAGIC:
+        raise KnownException('%s: encrypted CCZ files are not supported' % src)
+
+    if compression == CCZ_COMPRESSION_ZLIB:
+        inflated = zlib.decompress(data[header_size:])
+    elif compression == CCZ_COMPRESSION_ZLIB_CHUNKED:
+        table_size = struct.calcsize(CHUNK_TABLE_FORMAT)
+        chunk_size, chunk_count = struct.unpack(CHUNK_TABLE_FORMAT, data[header_size:header_size + table_size])
+        offset = header_size + table_size
+        sizes = struct.unpack('>%dI' % chunk_count, data[offset:offset + 4 * chunk_count])
+        offset += 4 * chunk_count
+        chunks = []
+        for size in sizes:
+            chunks.append(zlib.decompress(data[offset:offset + size]))
+            offset += size
+        inflated = b''.join(chunks)
+    else:
+        raise KnownException('%s: compression %d is not supported' % (src, compression))
+
+    if len(inflated) != length:
+        raise KnownException('%s: inflated %d bytes instead of %d' % (src, len(inflated), length))
+    return inflated
+
+def convert(src, dst, chunk_size, level):
+    with open(src, 'rb') as f:
+        data = f.read()
+    if data[:4] in (MAGIC, ENCRYPTED_MAGIC):
+        data = inflate_ccz(src, data)
+
+    if chunk_size <= 0:
+        header = struct.pack(HEADER_FORMAT, MAGIC, CCZ_COMPRESSION_ZLIB, VERSION, 0, len(data))
+        body = zlib.compress(data, level)
+        chunk_count = 1
+    else:
+        chunks = [zlib.compress(data[i:i + chunk_size], level) for i in range(0, len(data), chunk_size)]
+        chunk_count = len(chunks)
+        header = struct.pack(HEADER_FORMAT, MAGIC, CCZ_COMPRESSION_ZLIB_CHUNKED, VERSION, 0, len(data))
+        body = struct.pack(CHUNK_TABLE_FORMAT, chunk_size, chunk_count)
+        body += struct.pack('>%dI' % chunk_count, *[len(c) for c in chunks])
+        body += b''.join(chunks)
+
+    with open(dst, 'wb') as f:
+        f.write(header)
+        f.write(body)
+    print('%s -> %s: %d bytes in %d chunks, %d bytes compressed' % (src, dst, len(data), chunk_count, len(header) + len(body)))
+
+# -------------- entrance --------------
+if __name__ == '__main__':
+    parser = ArgumentParser(description='Compress files to the CCZ format, optionally in chunks inflated in parallel.')
+    parser.add_argument('src', help='file to compress, or CCZ file to convert')
+    parser.add_argument('dst', help='CCZ file to write')
+    parser.add_argument('-c', '--chunk-size', dest='chunk_size', type=int, default=256 * 1024,
+                        help='size of the uncompressed chunks, 0 for a plain CCZ file (default: 262144)')
+    parser.add_argument('-l', '--level', dest='level', type=int, default=9, help='zlib compression level (default: 9)')
+    args = parser.parse_args()
+
+    try:
+        convert(args.src, args.dst, args.chunk_size, args.level)
+    except KnownException as e:
+        print(e)
+        exit(1)
@@ -0,0 +1,197 @@
+#!/usr/bin/python
+#-*- coding: UTF-8 -*-
+# ----------------------------------------------------------------------------
+# Convert sprite sheet plist files to the binary .ccsf format loaded by
+# SpriteFrameCache::addSpriteFramesWithFile().
+#
+# License: MIT
+# ----------------------------------------------------------------------------
+'''
+Convert sprite sheet plist files (Zwoptex formats 0 to 3, TexturePacker polygons)
+to the binary .ccsf format loaded by SpriteFrameCache::addSpriteFramesWithFile().
+
+The layout, little endian and 4 bytes aligned, must match cocos/2d/CCSpriteFrameCache.cpp:
+
+    header    magic "CCSF", version, frameCount, aliasCount, textureWidth, textureHeight,
+              textureFileName, pixelFormat, polygonsOffset, polygonsSize, stringsOffset, stringsSize
+    frames    name, nameLength, rect x y w h, offset x y, sourceSize w h, anchor x y,
+              flags, vertexCount, indexCount, polygon
+    aliases   name, nameLength, frame
+    polygons  per frame: int32 vertices[2 * vertexCount], int32 verticesUV[2 * vertexCount],
+              uint16 triangles[indexCount], padded to 4 bytes
+    strings   NUL terminated UTF-8 strings
+'''
+
+import os.path
+import plistlib
+import re
+import struct
+
+from argparse import ArgumentParser
+
+MAGIC = b'CCSF'
+VERSION = 1
+NO_STRING = 0xffffffff
+
+FLAG_ROTATED = 1
+FLAG_ANCHOR = 2
+FLAG_POLYGON = 4
+
+HEADER_FORMAT = '<4s3I2f6I'
+FRAME_FORMAT = '<2I10f4I'
+ALIAS_FORMAT = '<3I'
+
+class KnownException(Exception):
+    pass
+
+def read_plist(path):
+    with open(path, 'rb') as f:
+        if hasattr(plistlib, 'load'):
+            return plistlib.load(f)
+        return plistlib.readPlist(f)
+
+def parse_floats(string):
+    # "{{0,0},{32,32}}" -> [0.0, 0.0, 32.0, 32.0], like RectFromString/PointFromString/SizeFromString
+    return [float(v) for v in re.findall(r'[-+]?[0-9]*\.?[0-9]+(?:[eE][-+]?[0-9]+)?', string)]
+
+def parse_ints(string):
+    return [int(v) for v in string.split()]
+
+class StringTable(object):
+    def __init__(self):
+        self.data = bytearray()
+        self.offsets = {}
+
+    def add(self, string):
+        encoded = string.encode('utf-8')
+        if encoded not in self.offsets:
+            self.offsets[encoded] = len(self.data)
+            self.data += encoded + b'\0'
+        return self.offsets[encoded], len(encoded)
+
+def convert_frame(name, frame, fmt):
+    ret = {
+        'name': name,
+        'rotated': False,
+        'anchor': None,
+        'aliases': [],
+        'polygon': None,
+    }
+    if fmt == 0:
+        ret['rect'] = [float(frame.get('x', 0)), float(frame.get('y', 0)),
+                       float(frame.get('width', 0)), float(frame.get('height', 0))]
+        ret['offset'] = [float(frame.get('offsetX', 0)), float(frame.get('offsetY', 0))]
+        ret['sourceSize'] = [float(abs(int(frame.get('originalWidth', 0)))),
+                             float(abs(int(frame.get('originalHeight', 0))))]
+    elif fmt in (1, 2):
+        ret['rect'] = parse_floats(frame['frame'])
+        ret['rotated'] = fmt == 2 and bool(frame.get('rotated', False))
+        ret['offset'] = parse_floats(frame['offset'])
+        ret['sourceSize'] = parse_floats(frame['sourceSize'])
+    else:
+        texture_rect = parse_floats(frame['textureRect'])
+        sprite_size = parse_floats(frame['spriteSize'])
+        ret['rect'] = texture_rect[0:2] + sprite_size
+        ret['rotated'] = bool(frame.get('textureRotated', False))
+        ret['offset'] = parse_floats(frame['spriteOffset'])
+        ret['sourceSize'] = parse_floats(frame['spriteSourceSize'])
+        ret['aliases'] = list(frame.get('aliases', []))
+        if 'anchor' in frame:
+            ret['anchor'] = parse_floats(frame['anchor'])
+        if 'vertices' in frame:
+            vertices = parse_ints(frame['vertices'])
+            vertices_uv = parse_ints(frame['verticesUV'])
+            triangles = parse_ints(frame['triangles'])
+            if len(vertices) != len(vertices_uv) or len(vertices) % 2:
+                raise KnownException('%s: vertices and verticesUV do not match' % name)
+            if max(triangles + [0]) > 0xffff:
+                raise KnownException('%s: too many vertices' % name)
+            ret['polygon'] = (vertices, vertices_uv, triangles)
+    return ret
+
+def convert(src, dst):
+    plist = read_plist(src)
+    if not isinstance(plist.get('frames'), dict):
+        raise KnownException('%s has no frames' % src)
+
+    metadata = plist.get('metadata', {})
+    fmt = int(metadata.get('format', 0))
+    if fmt < 0 or fmt > 3:
+        raise KnownException('%s: format %d is not supported' % (src, fmt))
+
+    frames = [convert_frame(name, plist['frames'][name], fmt) for name in sorted(plist['frames'].keys())]
+    texture_size = parse_floats(metadata['size']) if 'size' in metadata else [0.0, 0.0]
+
+    strings = StringTable()
+    texture_file_name = NO_STRING
+    if metadata.get('textureFileName'):
+        texture_file_name = strings.add(metadata['textureFileName'])[0]
+    pixel_format = NO_STRING
+    if metadata.get('pixelFormat'):
+        pixel_format = strings.add(metadata['pixelFormat'])[0]
+
+    frame_data = bytearray()
+    alias_data = bytearray()
+    polygon_data = bytearray()
+    alias_count = 0
+    for index, frame in enumerate(frames):
+        name, name_length = strings.add(frame['name'])
+        flags = 0
+        if frame['rotated']:
+            flags |= FLAG_ROTATED
+        anchor = [0.0, 0.0]
+        if frame['anchor'] is not None:
+            flags |= FLAG_ANCHOR
+            anchor = frame['anchor']
+        vertex_count = 0
+        index_count = 0
+        polygon = 0
+        if frame['polygon'] is not None:
+            flags |= FLAG_POLYGON
+            vertices, vertices_uv, triangles = frame['polygon']
+            vertex_count = len(vertices) // 2
+            index_count = len(triangles)
+            polygon = len(polygon_data)
+            polygon_data += struct.pack('<%di' % len(vertices), *vertices)
+            polygon_data += struct.pack('<%di' % len(vertices_uv), *vertices_uv)
+            polygon_data += struct.pack('<%dH' % len(triangles), *triangles)
+            polygon_data += b'\0' * (-len(polygon_data) % 4)
+        frame_data += struct.pack(FRAME_FORMAT, name, name_length,
+                                  *(frame['rect'] + frame['offset'] + frame['sourceSize'] + anchor +
+                                    [flags, vertex_count, index_count, polygon]))
+        for alias in frame['aliases']:
+            alias_name, alias_length = strings.add(alias)
+            alias_data += struct.pack(ALIAS_FORMAT, alias_name, alias_length, index)
+            alias_count += 1
+
+    strings.data += b'\0' * (-len(strings.data) % 4)
+    polygons_offset = struct.calcsize(HEADER_FORMAT) + len(frame_data) + len(alias_data)
+    strings_offset = polygons_offset + len(polygon_data)
+    header = struct.pack(HEADER_FORMAT, MAGIC, VERSION, len(frames), alias_count,
+                         texture_size[0], texture_size[1], texture_file_name, pixel_format,
+                         polygons_offset, len(polygon_data), strings_offset, len(strings.data))
+
+    with open(dst, 'wb') as f:
+        f.write(header)
+        f.write(frame_data)
+        f.write(alias_data)
+        f.write(polygon_data)
+        f.write(strings.data)
+    print('%s -> %s: %d frames, %d aliases' % (src, dst, len(frames), alias_count))
+
+# -------------- entrance --------------
+if __name__ == '__main__':
+    parser = ArgumentParser(description='Convert sprite sheet plist files to the binary .ccsf format.')
+    parser.add_argument('files', nargs='+', help='plist files to convert')
+    parser.add_argument('-o', '--output', dest='output', help='output directory, next to the plist files by default')
+    args = parser.parse_args()
+
+    try:
+        for src in args.files:
+            dst = os.path.splitext(src)[0] + '.ccsf'
+            if args.output:
+                dst = os.path.join(args.output, os.path.basename(dst))
+            convert(src, dst)
+    except KnownException as e:
+        print(e)
+        exit(1)